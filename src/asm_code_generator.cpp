@@ -12,6 +12,79 @@
  * TODO: agregar lo de la identificación del Main!: tiene que ser sólo main!
  * y no main.main*/
 
+// Order in which register_tracker::acquire hands out free registers.
+const register_id tracked_scratch_registers[] = {register_id::R8,
+												register_id::R9,
+												register_id::R10,
+												register_id::R11,
+												register_id::RCX,
+												register_id::RSI,
+												register_id::RDI,
+												register_id::RDX,
+												register_id::RAX};
+
+// 64-bit name of the integer register reg.
+register_id get_tracked_register(register_id reg){
+	register_id ret = get_register64(reg);
+
+	return ret == register_id::NONE ? reg : ret;
+}
+
+void register_tracker::hold(register_id reg){
+	this->live.insert(get_tracked_register(reg));
+}
+
+void register_tracker::release(register_id reg){
+	this->live.erase(get_tracked_register(reg));
+}
+
+void register_tracker::clear(){
+	this->live.clear();
+	this->scratch.clear();
+}
+
+bool register_tracker::is_live(register_id reg) const{
+	return this->live.find(get_tracked_register(reg)) != this->live.end();
+}
+
+bool register_tracker::is_free(register_id reg) const{
+	return not is_live(reg) and
+		   this->scratch.find(get_tracked_register(reg)) == this->scratch.end();
+}
+
+void register_tracker::reserve(register_id reg){
+	this->scratch.insert(get_tracked_register(reg));
+}
+
+register_id register_tracker::acquire(register_id preferred){
+	register_id ret = register_id::NONE;
+
+	if(is_free(preferred)){
+		ret = get_tracked_register(preferred);
+	}
+	for(const register_id* reg = tracked_scratch_registers;
+	reg != std::end(tracked_scratch_registers) and ret == register_id::NONE;
+	++reg){
+		if(is_free(*reg)){
+			ret = *reg;
+		}
+	}
+
+	if(ret != register_id::NONE){
+		this->scratch.insert(ret);
+		if(get_register64(preferred) != register_id::NONE){
+			// {preferred is a 32-bit register}
+			ret = get_register32(ret);
+		}
+	}
+
+	return ret;
+}
+
+void register_tracker::release_scratch(){
+	this->scratch.clear();
+}
+
 asm_code_generator::asm_code_generator(instructions_list *_ir,
 										ids_info *_s_table) :
 ir(_ir), s_table(_s_table) {
@@ -25,9 +98,190 @@ ir(_ir), s_table(_s_table) {
 	this->stack_params = nullptr;
 	this->last_reg_used = register_id::NONE;
 	this->params_in_registers = 0;
+	this->passes_frame_addresses = false;
 	this->offset = -1;
     this->nmbr_parameter = -1;
     this->contains_main_method = false;
+	this->allocating_registers = false;
+	this->profile = nullptr;
+	this->allocation = register_allocation();
+	this->callee_saved_offset = 0;
+	this->frameless = false;
+	this->float_params_in_registers = 0;
+	this->unordered_labels = 0;
+	this->selecting_instructions = false;
+	this->quad_position = 0;
+}
+
+bool asm_code_generator::holds_float(const address_pointer& address){
+	bool ret = false;
+
+	if(address != nullptr){
+		switch(get_address_type(address)){
+			case address_type::ADDRESS_CONSTANT:
+				ret = get_constant_address_type(address) == value_type::FLOAT;
+				break;
+
+			case address_type::ADDRESS_NAME:
+				ret = this->float_names.find(get_address_name(address)) !=
+					  this->float_names.end();
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	return ret;
+}
+
+void asm_code_generator::set_register_allocation(bool allocate,
+											const execution_profile* profile){
+	this->allocating_registers = allocate;
+	this->profile = profile;
+}
+
+void asm_code_generator::set_instruction_selection(bool select){
+	this->selecting_instructions = select;
+}
+
+void asm_code_generator::begin_method(unsigned int label){
+	instructions_list method;
+
+	method.push_back((*ir)[label]);
+	for(unsigned int i = label + 1; i < ir->size() and
+	not is_method_label_inst((*ir)[i]); i++){
+		method.push_back((*ir)[i]);
+	}
+
+	if(this->allocating_registers){
+		this->allocation = allocate_registers(method, *s_table, this->profile);
+	}
+	else{
+		this->allocation = register_allocation();
+	}
+
+	// The registers assigned to names are never taken as scratch.
+	this->registers.clear();
+	for(std::unordered_map<std::string, register_id>::iterator it =
+	this->allocation.registers.begin(); it != this->allocation.registers.end();
+	++it){
+		this->registers.hold(it->second);
+	}
+
+	this->method_labels = get_label_positions(*ir, label);
+	this->index_trees.clear();
+	this->folded_quads.clear();
+	this->fused_comparisons.clear();
+	std::unordered_set<unsigned int> fused = find_fused_comparisons(method);
+	for(std::unordered_set<unsigned int>::iterator it = fused.begin();
+	it != fused.end(); ++it){
+		this->fused_comparisons.insert(label + *it);
+	}
+	if(this->selecting_instructions){
+		std::unordered_set<unsigned int> folded;
+		std::unordered_map<unsigned int, expression_pointer> trees =
+						build_index_trees(method, *s_table, this->float_names,
+										folded);
+
+		// Positions into ir.
+		for(std::unordered_map<unsigned int, expression_pointer>::iterator it =
+		trees.begin(); it != trees.end(); ++it){
+			this->index_trees[label + it->first] = it->second;
+		}
+		for(std::unordered_set<unsigned int>::iterator it = folded.begin();
+		it != folded.end(); ++it){
+			this->folded_quads.insert(label + *it);
+		}
+	}
+
+	// Names read or written by the method, by first appearance, and whether
+	// it calls.
+	bool calls = false;
+	std::vector<std::string> appearance;
+	this->method_names.clear();
+	for(instructions_list::iterator it = method.begin(); it != method.end();
+	++it){
+		address_pointer definition = get_inst_definition(*it);
+		std::vector<address_pointer*> uses = get_inst_uses(*it);
+
+		if(get_inst_type(*it) == quad_type::PROCEDURE_CALL or
+		get_inst_type(*it) == quad_type::FUNCTION_CALL){
+			calls = true;
+		}
+
+		for(std::vector<address_pointer*>::iterator use = uses.begin();
+		use != uses.end(); ++use){
+			if(**use != nullptr and
+			(**use)->type == address_type::ADDRESS_NAME and
+			this->method_names.insert(get_address_name(**use)).second){
+				appearance.push_back(get_address_name(**use));
+			}
+		}
+
+		if(definition != nullptr and
+		definition->type == address_type::ADDRESS_NAME and
+		this->method_names.insert(get_address_name(definition)).second){
+			appearance.push_back(get_address_name(definition));
+		}
+	}
+
+	// Locals and temporaries not kept into registers live into the frame.
+	this->frame_names.clear();
+	for(std::vector<std::string>::iterator it = appearance.begin();
+	it != appearance.end(); ++it){
+		if(this->allocation.registers.find(*it) !=
+		this->allocation.registers.end() or not this->s_table->id_exists(*it) or
+		this->s_table->is_parameter(*it)){
+			continue;
+		}
+
+		id_kind kind = this->s_table->get_kind(*it);
+		if(kind == id_kind::K_VAR or kind == id_kind::K_OBJECT or
+		kind == id_kind::K_TEMP){
+			this->frame_names.push_back(*it);
+		}
+	}
+
+	// A leaf method that keeps every name into a caller-saved register,
+	// doesn't touch the stack: it needs no frame.
+	this->frameless = not calls and this->allocation.callee_saved.empty();
+	for(std::unordered_set<std::string>::iterator it = method_names.begin();
+	this->frameless and it != method_names.end(); ++it){
+		this->frameless = this->allocation.registers.find(*it) !=
+						  this->allocation.registers.end();
+	}
+}
+
+void asm_code_generator::translate_epilogue(){
+	restore_callee_saved_registers();
+	if(not this->frameless){
+		this->translation->push_back(new_leave_instruction());
+	}
+}
+
+void asm_code_generator::save_callee_saved_registers(){
+	for(unsigned int j = 0; j < allocation.callee_saved.size(); j++){
+		translation->push_back(new_mov_instruction(
+								new_register_operand(allocation.callee_saved[j]),
+								new_memory_operand(callee_saved_offset + 8*j,
+													register_id::RBP,
+													register_id::NONE,
+													1),
+								data_type::Q));
+	}
+}
+
+void asm_code_generator::restore_callee_saved_registers(){
+	for(unsigned int j = 0; j < allocation.callee_saved.size(); j++){
+		translation->push_back(new_mov_instruction(
+								new_memory_operand(callee_saved_offset + 8*j,
+													register_id::RBP,
+													register_id::NONE,
+													1),
+								new_register_operand(allocation.callee_saved[j]),
+								data_type::Q));
+	}
 }
 
 // TODO: se usa???
@@ -89,6 +343,24 @@ register_id asm_code_generator::get_next_reg_av(register_id reg){
 	return ret;
 }
 
+register_id asm_code_generator::acquire_scratch(register_id preferred){
+	register_id ret = this->registers.acquire(preferred);
+
+	// POST
+	#ifdef __DEBUG
+		assert(ret != register_id::NONE);
+	#endif
+
+	return ret;
+}
+
+void asm_code_generator::release_parameter_registers(){
+	for(register_id reg = get_next_reg_av(register_id::NONE);
+	reg != register_id::NONE; reg = get_next_reg_av(reg)){
+		this->registers.release(reg);
+	}
+}
+
 // TODO: esto debería estar en ids_info? se usa?
 bool asm_code_generator::is_attribute(std::string var_name){
 	bool ret = false;
@@ -104,6 +376,22 @@ bool asm_code_generator::is_attribute(std::string var_name){
 	return ret;
 }
 
+t_params asm_code_generator::get_register_params(const t_params& params,
+												id_type type){
+	t_params ret;
+	unsigned int registers = type == T_FLOAT ? FLOAT_PARAMS_INTO_REG :
+											   INT_PARAMS_INTO_REG;
+
+	for(t_params::const_iterator it = params.begin(); it != params.end() and
+	ret.size() < registers; ++it){
+		if(s_table->get_type(*it) == type){
+			ret.push_back(*it);
+		}
+	}
+
+	return ret;
+}
+
 void asm_code_generator::print_translation_intel_syntax(){
 	for(asm_instructions_list::iterator it = translation->begin();
 		it != translation->end();
@@ -124,6 +412,15 @@ operand_pointer asm_code_generator::convert_to_asm_operand(address_pointer addre
 	switch(address->type){
 		case address_type::ADDRESS_NAME:{
 			std::string var_name = get_address_name(address);
+			std::unordered_map<std::string, register_id>::iterator reg =
+										allocation.registers.find(var_name);
+
+			if(reg != allocation.registers.end()){
+				// {var_name is kept into a register}
+				ret = new_register_operand(reg->second);
+				break;
+			}
+
             ret = new_memory_operand(
 								    s_table->get_offset(get_address_name(address)),
 								    register_id::RBP,
@@ -174,162 +471,91 @@ operand_pointer asm_code_generator::convert_to_asm_operand(address_pointer addre
 }
 
 void asm_code_generator::translate_binary_op(const quad_pointer& instruction){
+	quad_oper op = get_inst_op(instruction);
+
+	if(holds_float(get_binary_assign_result(instruction)) and
+	(op == quad_oper::PLUS or op == quad_oper::MINUS or
+	 op == quad_oper::TIMES or op == quad_oper::DIVIDE)){
+		// BINARY_ASSIGN x = y op z, for floats:
+		//		movss y,%xmm8
+		//		[add|sub|mul|div]ss z,%xmm8
+		//		movss %xmm8,x
+            address_pointer result = get_binary_assign_result(instruction);
+		address_pointer y = get_binary_assign_arg1(instruction);
+		address_pointer z = get_binary_assign_arg2(instruction);
+
+		translate_float_arithmetic(*translation,
+									this->float_literals,
+									op,
+									this->convert_to_asm_operand(result),
+									this->convert_to_asm_operand(y),
+									holds_float(y),
+									this->convert_to_asm_operand(z),
+									holds_float(z));
+		return;
+	}
 
-	switch(get_inst_op(instruction)){
+	switch(op){
 		case quad_oper::TIMES:{
 			// BINARY_ASSIGN x = y * z:
 			//		mov[b|w|l|q] z,register
 			// 		imulw y,z (z = z ∗ y, z debe ser un registro)
 			// 		mov[b|w|l|q] z,x (x = z)
-			operand_pointer new_register = new_register_operand(register_id::R8D);
-
-            // The value is saved into x. Check if its offset is updated:
-            address_pointer result = get_binary_assign_result(instruction);
-            std::string result_id = get_address_name(result);
-            if(not this->s_table->is_parameter(result_id) and this->s_table->get_offset(result_id) >= 0){
-                // Then, its offset is not updated. We assume that
-                // this->offset contains the correct offset.
-                s_table->set_offset(get_address_name(result), 
-                                    this->offset);
-
-                this->offset -= this->get_value_width(get_constant_address_type(result));
-            }
-
-			operand_pointer x = this->convert_to_asm_operand(result);
-			operand_pointer y = this->convert_to_asm_operand(get_binary_assign_arg1(instruction));
-			operand_pointer z = this->convert_to_asm_operand(get_binary_assign_arg2(instruction));
-			// We use a new register to ensure that the second operand can be
-			// the destination of the product.
-			data_type ops_type = data_type::L;
-			translation->push_back(new_mov_instruction(y,
-														new_register,
-														data_type::L));
-			translation->push_back(new_mul_instruction(z,
-														new_register,
-														data_type::L,
-														true));
-			translation->push_back(new_mov_instruction(new_register,
-														x,
-														data_type::L));
-			break;
-		}
-
-		case quad_oper::DIVIDE:{
-			// Register to store the dividend.
-			operand_pointer edx_reg = new_register_operand(register_id::EDX);
-			operand_pointer aux_edx_reg = new_register_operand(register_id::R8D);
-			operand_pointer eax_reg = new_register_operand(register_id::EAX);
-			operand_pointer aux_eax_reg = new_register_operand(register_id::R9D);
-
-			// Operands are always of 32-bit long.
-			data_type ops_type = data_type::L;
-            // The value is saved into x. Check if its offset is updated:
             address_pointer result = get_binary_assign_result(instruction);
-            std::string result_id = get_address_name(result);
-            if(not this->s_table->is_parameter(result_id) and this->s_table->get_offset(result_id) >= 0){
-                // Then, its offset is not updated. We assume that
-                // this->offset contains the correct offset.
-                s_table->set_offset(get_address_name(result), 
-                                    this->offset);
-
-                this->offset -= this->get_value_width(get_constant_address_type(result));
-            }
-
-			// Operands.
 			operand_pointer x = this->convert_to_asm_operand(result);
 			operand_pointer y = this->convert_to_asm_operand(get_binary_assign_arg1(instruction));
 			operand_pointer z = this->convert_to_asm_operand(get_binary_assign_arg2(instruction));
-			// TODO: quizás deberíamos guardar "y" en algún registro, hacer corrimiento
-			// de 32 posiciones hacia la derecha (para quedarnos con los 32 bits
-			// de mayor peso), y guardar el resultado en EDX
-			operand_pointer zero = new_immediate_integer_operand(0);
-
-			// Save content of registers edx and eax (because they could be
-			// used for store parameters of a procedure).
-			translation->push_back(new_mov_instruction(edx_reg,
-														aux_edx_reg,
-														ops_type));
-			translation->push_back(new_mov_instruction(eax_reg,
-														aux_eax_reg,
-														ops_type));
-			// Copy operand y into register eax: COMPI's integers are signed
-			// 32 bits long.
-			translation->push_back(new_mov_instruction(y, eax_reg, ops_type));
-			// Copy the immediate value 0 into register edx.
-			translation->push_back(new_mov_instruction(zero, edx_reg, ops_type));
-			// Divide %edx::%eax by operand z.
-			// TODO: no hace falta indicar que signed, ya que...siempre es signed
-			translation->push_back(new_div_instruction(z, ops_type, true));
-			// Quotient is into register eax, move it to x.
-			translation->push_back(new_mov_instruction(eax_reg, x, ops_type));
-			// Restore the content of registers edx and eax.
-			translation->push_back(new_mov_instruction(aux_edx_reg,
-														edx_reg,
-														ops_type));
-			translation->push_back(new_mov_instruction(aux_eax_reg,
-														eax_reg,
-														ops_type));
-
+			// A scratch register (%r8d, if free) is used to ensure that the
+			// second operand can be the destination of the product. Products
+			// by constants are computed by lea, shl, add and sub, when they
+			// are faster.
+			translate_integer_multiplication(*translation, x, y, z,
+										acquire_scratch(register_id::R8D));
 			break;
 		}
 
+		case quad_oper::DIVIDE:
 		case quad_oper::MOD:{
-			// Register to store the dividend.
 			operand_pointer edx_reg = new_register_operand(register_id::EDX);
-			operand_pointer aux_edx_reg = new_register_operand(register_id::R8D);
-			operand_pointer eax_reg = new_register_operand(register_id::EAX);
-			operand_pointer aux_eax_reg = new_register_operand(register_id::R9D);
 
 			// Operands are always of 32-bit long.
 			data_type ops_type = data_type::L;
-            // The value is saved into x. Check if its offset is updated:
             address_pointer result = get_binary_assign_result(instruction);
-            std::string result_id = get_address_name(result);
-            if(not this->s_table->is_parameter(result_id) and this->s_table->get_offset(result_id) >= 0){
-                // Then, its offset is not updated. We assume that
-                // this->offset contains the correct offset.
-                s_table->set_offset(get_address_name(result), 
-                                    this->offset);
-
-                this->offset -= this->get_value_width(get_constant_address_type(result));
-            }
-
 			// Operands.
 			operand_pointer x = this->convert_to_asm_operand(result);
 			operand_pointer y = this->convert_to_asm_operand(get_binary_assign_arg1(instruction));
 			operand_pointer z = this->convert_to_asm_operand(get_binary_assign_arg2(instruction));
-			// TODO: quizás deberíamos guardar "y" en algún registro, hacer corrimiento
-			// de 32 posiciones hacia la derecha (para quedarnos con los 32 bits
-			// de mayor peso), y guardar el resultado en EDX
-			operand_pointer zero = new_immediate_integer_operand(0);
-
-			// Save content of registers edx and eax (because they could be
-			// used for store parameters of a procedure).
-			translation->push_back(new_mov_instruction(edx_reg,
-														aux_edx_reg,
-														ops_type));
-			translation->push_back(new_mov_instruction(eax_reg,
-														aux_eax_reg,
-														ops_type));
-			// Copy operand y into register eax: COMPI's integers are signed
-			// 32 bits long.
-			translation->push_back(new_mov_instruction(y, eax_reg, ops_type));
-			// Copy the immediate value 0 into register edx.
-			translation->push_back(new_mov_instruction(zero,
-														edx_reg,
-														ops_type));
-			// Divide %edx::%eax by operand z.
-			// TODO: no hace falta indicar que signed, ya que...siempre es signed
-			translation->push_back(new_div_instruction(z, ops_type, true));
-			// Quotient is into register eax, move it to x.
-			translation->push_back(new_mov_instruction(edx_reg, x, ops_type));
-			// Restore the content of registers edx and eax.
-			translation->push_back(new_mov_instruction(aux_edx_reg,
-														edx_reg,
-														ops_type));
-			translation->push_back(new_mov_instruction(aux_eax_reg,
-														eax_reg,
-														ops_type));
+			// %eax never holds a value between quads, but %edx holds the
+			// third integer parameter of the call being prepared, if any:
+			// only then, it must be saved, into a free register or, when
+			// every one is taken, below the stack pointer (into the red zone,
+			// [4]).
+			bool saves_edx = this->registers.is_live(register_id::EDX);
+			operand_pointer aux_edx_reg = nullptr;
+
+			this->registers.reserve(register_id::EAX);
+			this->registers.reserve(register_id::EDX);
+			if(saves_edx){
+				register_id aux = this->registers.acquire(register_id::R8D);
+
+				aux_edx_reg = aux != register_id::NONE ?
+							  new_register_operand(aux) :
+							  new_memory_operand(-INTEGER_WIDTH,
+												register_id::RSP,
+												register_id::NONE,
+												1);
+				translation->push_back(new_mov_instruction(edx_reg,
+															aux_edx_reg,
+															ops_type));
+			}
+			translate_integer_division(*translation, x, y, z,
+									get_inst_op(instruction) == quad_oper::MOD,
+									acquire_scratch(register_id::R9D));
+			if(saves_edx){
+				translation->push_back(new_mov_instruction(aux_edx_reg,
+															edx_reg,
+															ops_type));
+			}
 
 			break;
 		}
@@ -340,23 +566,18 @@ void asm_code_generator::translate_binary_op(const quad_pointer& instruction){
 			// 		mov[b|w|l|q] z,x (tendremos que ver el tipo de los operandos
 			//		para determinar el tipo de instrucción?)
 			// TODO: cómo lo defino?
-			operand_pointer new_register = new_register_operand(register_id::R8D);
+			register_id scratch = acquire_scratch(register_id::R8D);
+			operand_pointer new_register = new_register_operand(scratch);
 
-            // The value is saved into x. Check if its offset is updated:
             address_pointer result = get_binary_assign_result(instruction);
-            std::string result_id = get_address_name(result);
-            if(not this->s_table->is_parameter(result_id) and this->s_table->get_offset(result_id) >= 0){
-                // Then, its offset is not updated. We assume that
-                // this->offset contains the correct offset.
-                s_table->set_offset(get_address_name(result), 
-                                    this->offset);
-
-                this->offset -= this->get_value_width(get_constant_address_type(result));
-            }
 			operand_pointer x = this->convert_to_asm_operand(result);
 			operand_pointer y = this->convert_to_asm_operand(get_binary_assign_arg1(instruction));
 			operand_pointer z = this->convert_to_asm_operand(get_binary_assign_arg2(instruction));
 			data_type ops_type = data_type::L; // TODO: cómo determino el tipo de los operandos?
+			if(this->selecting_instructions){
+				select_additive_operation(*translation, op, x, y, z, scratch);
+				break;
+			}
 			translation->push_back(new_mov_instruction(y, new_register, ops_type));
 			translation->push_back(new_add_instruction(z, new_register, ops_type));
 			translation->push_back(new_mov_instruction(new_register, x, ops_type));
@@ -368,51 +589,108 @@ void asm_code_generator::translate_binary_op(const quad_pointer& instruction){
 			//		subw y,z (z = z − y)
 			//		mov[b|w|l|q] z,x
 			// TODO: cómo lo defino?
-			operand_pointer new_register = new_register_operand(register_id::R8D);
-            // The value is saved into x. Check if its offset is updated:
+			register_id scratch = acquire_scratch(register_id::R8D);
+			operand_pointer new_register = new_register_operand(scratch);
             address_pointer result = get_binary_assign_result(instruction);
-            std::string result_id = get_address_name(result);
-            if(not this->s_table->is_parameter(result_id) and this->s_table->get_offset(result_id) >= 0){
-                // Then, its offset is not updated. We assume that
-                // this->offset contains the correct offset.
-                s_table->set_offset(get_address_name(result), 
-                                    this->offset);
-
-                this->offset -= this->get_value_width(get_constant_address_type(result));
-            }
 			operand_pointer x = this->convert_to_asm_operand(result);
 			operand_pointer y = this->convert_to_asm_operand(get_binary_assign_arg1(instruction));
 			operand_pointer z = this->convert_to_asm_operand(get_binary_assign_arg2(instruction));
 			data_type ops_type = data_type::L; // TODO: cómo determino el tipo de los operandos?
+			if(this->selecting_instructions){
+				select_additive_operation(*translation, op, x, y, z, scratch);
+				break;
+			}
 			translation->push_back(new_mov_instruction(y, new_register, ops_type));
 			translation->push_back(new_sub_instruction(z, new_register, ops_type));
 			translation->push_back(new_mov_instruction(new_register, x, ops_type));
 			break;
 		}
+
+		case quad_oper::LESS:
+		case quad_oper::LESS_EQUAL:
+		case quad_oper::GREATER:
+		case quad_oper::GREATER_EQUAL:
+		case quad_oper::EQUAL:
+		case quad_oper::DISTINCT:{
+			// BINARY_ASSIGN x = y relop z, not fused with a jump:
+			//		mov[l] y,register
+			//		cmp[l] z,register (set flags based on y - z)
+			//		set<relop> register8
+			//		movzbl register8,register
+			//		mov[l] register,x
+			register_id scratch = acquire_scratch(register_id::R8D);
+			operand_pointer new_register = new_register_operand(scratch);
+			operand_pointer new_register8 = new_register_operand(
+													get_register8(scratch));
+
+            address_pointer result = get_binary_assign_result(instruction);
+			address_pointer y_address = get_binary_assign_arg1(instruction);
+			address_pointer z_address = get_binary_assign_arg2(instruction);
+			operand_pointer x = this->convert_to_asm_operand(result);
+			operand_pointer y = this->convert_to_asm_operand(y_address);
+			operand_pointer z = this->convert_to_asm_operand(z_address);
+			data_type ops_type = data_type::L;
+
+			if(holds_float(y_address) or holds_float(z_address)){
+				// Compared by ucomiss: the relation doesn't hold for NaN,
+				// but for !=.
+				translate_float_relational_assign(*translation,
+											this->float_literals,
+											op,
+											x,
+											y,
+											holds_float(y_address),
+											z,
+											holds_float(z_address),
+											scratch,
+											acquire_scratch(register_id::R9D));
+				break;
+			}
+			if(this->selecting_instructions){
+				select_relational_assign(*translation, op, x, y, z, scratch);
+				break;
+			}
+			translation->push_back(new_mov_instruction(y, new_register, ops_type));
+			translation->push_back(new_cmp_instruction(z, new_register, ops_type));
+			translation->push_back(new_relational_set_instruction(op,
+																new_register8));
+			translation->push_back(new_movzbl_instruction(new_register8,
+														new_register));
+			translation->push_back(new_mov_instruction(new_register, x, ops_type));
+			break;
+		}
 	}
 }
 
 void asm_code_generator::translate_unary_op(const quad_pointer& instruction){
 
+	if(instruction->op == quad_oper::NEGATIVE and
+	holds_float(get_unary_assign_dest(instruction))){
+		// UNARY_ASSIGN x = -y, for floats:
+		//		movss y,%xmm8
+		//		mulss -1.0,%xmm8
+		//		movss %xmm8,x
+            address_pointer result = get_unary_assign_dest(instruction);
+		address_pointer y = get_unary_assign_src(instruction);
+
+		translate_float_negation(*translation,
+								this->float_literals,
+								this->convert_to_asm_operand(result),
+								this->convert_to_asm_operand(y),
+								holds_float(y));
+		return;
+	}
+
 	switch(instruction->op){
 		case quad_oper::NEGATIVE:{
 			// UNARY_ASSIGN x = -y
 			// 		negw y (y = −y)
 			// 		mov[b|w|l|q] y,x
 			// TODO: cómo lo defino?
-			operand_pointer new_register = new_register_operand(register_id::R8D);
+			operand_pointer new_register = new_register_operand(
+											acquire_scratch(register_id::R8D));
 
-            // The value is saved into x. Check if its offset is updated:
             address_pointer result = get_unary_assign_dest(instruction);
-            std::string result_id = get_address_name(result);
-            if(not this->s_table->is_parameter(result_id) and this->s_table->get_offset(result_id) >= 0){
-                // Then, its offset is not updated. We assume that
-                // this->offset contains the correct offset.
-                s_table->set_offset(get_address_name(result), 
-                                    this->offset);
-
-                this->offset -= this->get_value_width(get_constant_address_type(result));
-            }
 			operand_pointer x = this->convert_to_asm_operand(result);
 			operand_pointer y = this->convert_to_asm_operand(get_unary_assign_src(instruction));
 			data_type ops_type = data_type::L; // TODO: cómo determino el tipo de los operandos?
@@ -428,30 +706,25 @@ void asm_code_generator::translate_unary_op(const quad_pointer& instruction){
 
 		case quad_oper::NEGATION:{
 			// UNARY_ASSIGN x = not y
-			// notw y (y =∼ y (bitwise complement))
+			// xorl $1,y (y = y ^ 1)
 			// mov[b|w|l|q] y,x
 			// TODO: cómo lo defino?
 			// TODO: estamos asumiendo que los booleanos los representamos con
 			// 32-bits.
-			operand_pointer new_register = new_register_operand(register_id::R8D);
+			operand_pointer new_register = new_register_operand(
+											acquire_scratch(register_id::R8D));
 
-            // The value is saved into x. Check if its offset is updated:
             address_pointer result = get_unary_assign_dest(instruction);
-            std::string result_id = get_address_name(result);
-            if(not this->s_table->is_parameter(result_id) and this->s_table->get_offset(result_id) >= 0){
-                // Then, its offset is not updated. We assume that
-                // this->offset contains the correct offset.
-                s_table->set_offset(get_address_name(result), 
-                                    this->offset);
-
-                this->offset -= this->get_value_width(get_constant_address_type(result));
-            }
 			operand_pointer x = this->convert_to_asm_operand(result);
 			operand_pointer y = this->convert_to_asm_operand(get_unary_assign_src(instruction));
 			data_type ops_type = data_type::L;
 
+			// Booleans are 0 or 1 (notl would give -1 or -2).
 			translation->push_back(new_mov_instruction(y, new_register, ops_type));
-			translation->push_back(new_not_instruction(new_register, ops_type));
+			translation->push_back(new_xor_instruction(
+											new_immediate_integer_operand(1),
+											new_register,
+											ops_type));
 			translation->push_back(new_mov_instruction(new_register, x, ops_type));
 			break;
 		}
@@ -459,22 +732,26 @@ void asm_code_generator::translate_unary_op(const quad_pointer& instruction){
 		default:{
 			// UNARY_ASSIGN x = & y
 			// lea[b|w|l|q] y,x
-            // The value is saved into x. Check if its offset is updated:
             address_pointer result = get_unary_assign_dest(instruction);
-            std::string result_id = get_address_name(result);
-            if(not this->s_table->is_parameter(result_id) and this->s_table->get_offset(result_id) >= 0){
-                // Then, its offset is not updated. We assume that
-                // this->offset contains the correct offset.
-                s_table->set_offset(get_address_name(result), 
-                                    this->offset);
-
-                this->offset -= this->get_value_width(get_constant_address_type(result));
-            }
 			operand_pointer x = this->convert_to_asm_operand(result);
 			operand_pointer y = this->convert_to_asm_operand(get_unary_assign_src(instruction));
 			data_type ops_type = data_type::L;
 
-			translation->push_back(new_lea_instruction(y, x, ops_type));
+			if(get_operand_addressing(x) == operand_addressing::REGISTER){
+				translation->push_back(new_lea_instruction(y, x, ops_type));
+			}
+			else{
+				// The destination of lea must be a register.
+				operand_pointer new_register = new_register_operand(
+											acquire_scratch(register_id::R8D));
+
+				translation->push_back(new_lea_instruction(y,
+														new_register,
+														ops_type));
+				translation->push_back(new_mov_instruction(new_register,
+														x,
+														ops_type));
+			}
 			break;
 		}
 	}
@@ -483,17 +760,7 @@ void asm_code_generator::translate_unary_op(const quad_pointer& instruction){
 void asm_code_generator::translate_copy(const quad_pointer& instruction){
 	// COPY x = y:
 	// 		mov[b|w|l|q] y,x
-    // The value is saved into x. Check if its offset is updated:
     address_pointer result = get_copy_inst_dest(instruction);
-    std::string result_id = get_address_name(result);
-    if(not this->s_table->is_parameter(result_id) and this->s_table->get_offset(result_id) >= 0){
-        // Then, its offset is not updated. We assume that
-        // this->offset contains the correct offset.
-        s_table->set_offset(get_address_name(result), 
-                            this->offset);
-
-        this->offset -= this->get_value_width(get_constant_address_type(result));
-    }
 	operand_pointer x = this->convert_to_asm_operand(result);
 	operand_pointer y = this->convert_to_asm_operand(get_copy_inst_orig(instruction));
 
@@ -503,6 +770,28 @@ void asm_code_generator::translate_copy(const quad_pointer& instruction){
 			   type == address_type::ADDRESS_TEMP);
 	#endif
 
+	address_pointer orig = get_copy_inst_orig(instruction);
+	if(holds_float(result) and not holds_float(orig)){
+		// An integer widened into a float: at compile time, for constants,
+		// or by cvtsi2ssl.
+		if(get_operand_addressing(y) == operand_addressing::IMMEDIATE){
+			translation->push_back(new_mov_instruction(
+							new_immediate_float_operand(
+								(float) get_constant_address_integer_value(orig)),
+							x,
+							data_type::L));
+		}
+		else{
+			operand_pointer acc = new_register_operand(FLOAT_ACCUMULATOR);
+
+			translation->push_back(new_cvtsi2ss_instruction(y, acc,
+															data_type::L));
+			translation->push_back(new_movss_instruction(acc, x));
+		}
+		return;
+	}
+
+	// Floats are moved as their 32 bits.
 	translation->push_back(new_mov_instruction(y, x, data_type::L));
 }
 
@@ -516,16 +805,26 @@ void asm_code_generator::translate_indexed_copy_to(const quad_pointer&
 
 	// TODO: que hay de la directiva PTR?
     address_pointer dest_add = get_indexed_copy_to_dest(instruction);
-    std::string dest_id = get_address_name(dest_add);
-    if(not this->s_table->is_parameter(dest_id) and this->s_table->get_offset(dest_id) >= 0){
-        // Then, its offset is not updated. We assume that
-        // this->offset contains the correct offset.
-        s_table->set_offset(dest_id, this->offset);
-        this->offset -= this->get_value_width(get_constant_address_type(dest_add));
-    }
 	operand_pointer dest = this->convert_to_asm_operand(dest_add);
 
 	address_pointer index_add = get_indexed_copy_to_index(instruction);
+
+	if(this->selecting_instructions){
+		// mov y,disp(base,%r9,scale), being y into a register or immediate.
+		operand_pointer pos = translate_indexed_address(dest_add, index_add);
+		operand_pointer src = this->convert_to_asm_operand(
+										get_indexed_copy_to_src(instruction));
+
+		if(get_operand_addressing(src) == operand_addressing::MEMORY){
+			operand_pointer acc = new_register_operand(
+								acquire_scratch(SELECTION_VALUE_REGISTER));
+
+			translation->push_back(new_mov_instruction(src, acc, data_type::L));
+			src = acc;
+		}
+		translation->push_back(new_mov_instruction(src, pos, data_type::L));
+		return;
+	}
 	//operand_pointer index = this->convert_to_asm_operand(index);
 
 	int offset = get_constant_address_integer_value(index_add);
@@ -540,10 +839,11 @@ void asm_code_generator::translate_indexed_copy_to(const quad_pointer&
 	std::string name = get_address_name(dest_add);
 	operand_pointer pos = nullptr;
 	if(s_table->get_kind(name) == id_kind::K_OBJECT){
-		// TODO: está bien este registro?
-		operand_pointer reg = new_register_operand(register_id::RDI);
+		// %rdi, unless it holds a parameter of the call being prepared.
+		register_id base = acquire_scratch(register_id::RDI);
+		operand_pointer reg = new_register_operand(base);
 
-		// Move the address of the object into register register_id::RDI.
+		// Move the address of the object into the base register.
 		translation->push_back(new_mov_instruction(dest, reg, data_type::L));
 
 		// TODO: quizás nos podamos ahorrar la instrucción que pasa el address
@@ -552,7 +852,7 @@ void asm_code_generator::translate_indexed_copy_to(const quad_pointer&
 		// Define the position of the attribute, as an offset with respect
 		// to the initial address of the instance.
 		pos = new_memory_operand(offset,
-								register_id::RDI,
+								base,
 								register_id::NONE,
 								1);
 	}
@@ -575,17 +875,29 @@ void asm_code_generator::translate_indexed_copy_from(const quad_pointer& instruc
 	// 		mov[b|w|l|q] y[i], x (idem caso anterior)
 	// TODO: que hay de la directiva PTR?
     address_pointer dest_add = get_indexed_copy_from_dest(instruction);
-    std::string dest_id = get_address_name(dest_add);
-    if(not this->s_table->is_parameter(dest_id) and this->s_table->get_offset(dest_id) >= 0){
-        // Then, its offset is not updated. We assume that
-        // this->offset contains the correct offset.
-        s_table->set_offset(dest_id, this->offset);
-        this->offset -= this->get_value_width(get_constant_address_type(dest_add));
-    }
 	operand_pointer dest = this->convert_to_asm_operand(dest_add);
 
 	address_pointer index_add = get_indexed_copy_from_index(instruction);
 
+	if(this->selecting_instructions){
+		// mov disp(base,%r9,scale),x, being x a register.
+		operand_pointer pos = translate_indexed_address(
+									get_indexed_copy_from_src(instruction),
+									index_add);
+
+		if(get_operand_addressing(dest) == operand_addressing::MEMORY){
+			operand_pointer acc = new_register_operand(
+								acquire_scratch(SELECTION_VALUE_REGISTER));
+
+			translation->push_back(new_mov_instruction(pos, acc, data_type::L));
+			translation->push_back(new_mov_instruction(acc, dest, data_type::L));
+		}
+		else{
+			translation->push_back(new_mov_instruction(pos, dest, data_type::L));
+		}
+		return;
+	}
+
 	int offset = get_constant_address_integer_value(index_add);
 
 	address_pointer orig_add = get_indexed_copy_from_src(instruction);
@@ -599,10 +911,11 @@ void asm_code_generator::translate_indexed_copy_from(const quad_pointer& instruc
 	std::string name = get_address_name(orig_add);
 	operand_pointer pos = nullptr;
 	if(s_table->get_kind(name) == id_kind::K_OBJECT){
-		// TODO: está bien este registro?
-		operand_pointer reg = new_register_operand(register_id::RDI);
+		// %rdi, unless it holds a parameter of the call being prepared.
+		register_id base = acquire_scratch(register_id::RDI);
+		operand_pointer reg = new_register_operand(base);
 
-		// Move the address of the object into register register_id::RDI.
+		// Move the address of the object into the base register.
 		translation->push_back(new_mov_instruction(orig, reg, data_type::L));
 
 		// TODO: quizás nos podamos ahorrar la instrucción que pasa el address
@@ -611,7 +924,7 @@ void asm_code_generator::translate_indexed_copy_from(const quad_pointer& instruc
 		// Define the position of the attribute, as an offset with respect
 		// to the initial address of the instance.
 		pos = new_memory_operand(offset,
-								register_id::RDI,
+								base,
 								register_id::NONE,
 								1);
 	}
@@ -625,8 +938,63 @@ void asm_code_generator::translate_indexed_copy_from(const quad_pointer& instruc
 								1);
 	}
 
-	// Move the desired value to the defined position.
-	translation->push_back(new_mov_instruction(pos, dest, data_type::L));
+	// Move the desired value to the defined position (through a register,
+	// if dest is into memory).
+	if(get_operand_addressing(dest) == operand_addressing::MEMORY){
+		operand_pointer acc = new_register_operand(
+										acquire_scratch(register_id::R8D));
+
+		translation->push_back(new_mov_instruction(pos, acc, data_type::L));
+		translation->push_back(new_mov_instruction(acc, dest, data_type::L));
+	}
+	else{
+		translation->push_back(new_mov_instruction(pos, dest, data_type::L));
+	}
+}
+
+operand_pointer asm_code_generator::translate_indexed_address(
+												const address_pointer& base,
+												const address_pointer& index){
+	std::unordered_map<unsigned int, expression_pointer>::iterator tree =
+								this->index_trees.find(this->quad_position);
+	address_tile tile;
+	bool matched = match_address_tile(tree != this->index_trees.end() ?
+									  tree->second :
+									  new_expression_leaf(index),
+									  tile);
+
+	#ifdef __DEBUG
+		assert(matched);
+	#endif
+
+	operand_pointer base_operand = this->convert_to_asm_operand(base);
+	register_id base_register = register_id::RBP;
+	int base_displacement = 0;
+
+	if(s_table->get_kind(get_address_name(base)) == id_kind::K_OBJECT){
+		// Attributes are addressed from the address of the object, moved
+		// into %rdi (or into another free register).
+		base_register = acquire_scratch(register_id::RDI);
+		translation->push_back(new_mov_instruction(base_operand,
+										new_register_operand(base_register),
+										data_type::L));
+	}
+	else{
+		// {s_table->get_kind(get_address_name(base)) != id_kind::K_OBJECT}
+		// An array, into the actual stack frame.
+		base_displacement = get_memory_operand_offset(base_operand);
+	}
+
+	return translate_address_tile(*translation,
+								base_register,
+								base_displacement,
+								tile,
+								tile.index == nullptr ?
+								nullptr :
+								this->convert_to_asm_operand(tile.index),
+								tile.index == nullptr ?
+								register_id::NONE :
+								acquire_scratch(SELECTION_INDEX_REGISTER));
 }
 
 void asm_code_generator::translate_unconditional_jump(
@@ -640,35 +1008,63 @@ void asm_code_generator::translate_unconditional_jump(
 
 void asm_code_generator::translate_conditional_jump(const quad_pointer& instruction){
 	// CONDITIONAL_JUMP,	// if x goto L
-	// 		TODO: primero debemos transformar el testeo de x en la comparación
-	// 		con el valor 0 o signo del mismo. Usaremos estas instrucciones
-	// 		cmp[b|w|l|q] s 2 ,s 1       set flags based on s 1 − s 2
-	//		test[b|w|l|q] s 2 ,s 1      set flags based on s 1 & s 2 (logical and)
-	//		Luego usar:
-	//			jcc L  donde cc es la condición adecuada, para que salte si x es verdadero
-	operand_pointer aux_reg = new_register_operand(register_id::R8D);
+	// Booleans are 0 or 1: x is compared with 0,
+	//		test[l] x,x (or cmp[l] $0,x, when x is into memory)
+	//		jne L (je L, for ifFalse)
+	// reusing the flags of the instruction that computed x, if they are still
+	// there.
 	operand_pointer x = this->convert_to_asm_operand(get_conditional_jmp_guard(instruction));
-	// TODO: en la generación de código intermedio, no nos aseguramos de
-	// esto?
-	operand_pointer aux = new_immediate_integer_operand(1);
-	translation->push_back(new_mov_instruction(aux,
-												aux_reg,
-												data_type::L));
-	translation->push_back(new_cmp_instruction(x, aux_reg, data_type::L));
+	std::string label = get_conditional_jmp_label(instruction);
 
-	switch(instruction->op){
-		case quad_oper::IFTRUE:
-			translation->push_back(new_je_instruction(
-										get_conditional_jmp_label(instruction)));
-			break;
+	#ifdef __DEBUG
+		assert(instruction->op == quad_oper::IFTRUE or
+			   instruction->op == quad_oper::IFFALSE);
+	#endif
 
-		case quad_oper::IFFALSE:
-			translation->push_back(new_jne_instruction(
-										get_conditional_jmp_label(instruction)));
-			break;
+	if(get_operand_addressing(x) == operand_addressing::IMMEDIATE){
+		if((x->value.imm.val.ival != 0) ==
+		(instruction->op == quad_oper::IFTRUE)){
+			translation->push_back(new_jmp_instruction(label));
+		}
+		return;
+	}
 
-		default:
-			assert(false);
+	select_zero_test(*translation, x, quad_oper::DISTINCT);
+	if(instruction->op == quad_oper::IFTRUE){
+		translation->push_back(new_jne_instruction(label));
+	}
+	else{
+		translation->push_back(new_je_instruction(label));
+	}
+}
+
+void asm_code_generator::translate_fused_comparison(
+											const quad_pointer& comparison,
+											const quad_pointer& jump){
+	quad_oper relop = get_inst_op(comparison);
+	address_pointer y = get_binary_assign_arg1(comparison);
+	address_pointer z = get_binary_assign_arg2(comparison);
+	std::string label = get_conditional_jmp_label(jump);
+
+	if(jump->op == quad_oper::IFTRUE){
+		translate_relational_jump(new_relational_jump_inst(y, z, relop,
+												new_label_address(label)));
+	}
+	else if(not holds_float(y) and not holds_float(z)){
+		translate_relational_jump(new_relational_jump_inst(y, z,
+												get_negated_relop(relop),
+												new_label_address(label)));
+	}
+	else{
+		// The negated relation doesn't hold for NaN, while the original one
+		// doesn't hold either: the jump goes around a jmp to label.
+		std::string holds = std::string("LU") +
+							std::to_string(this->unordered_labels++);
+
+		translate_relational_jump(new_relational_jump_inst(y, z, relop,
+												new_label_address(holds)));
+		translation->push_back(new_jmp_instruction(label));
+		translation->push_back(new_label_instruction(holds));
 	}
 }
 
@@ -676,6 +1072,29 @@ void asm_code_generator::translate_relational_jump(const quad_pointer& instructi
 	operand_pointer x = this->convert_to_asm_operand(instruction->arg1);
 	operand_pointer y = this->convert_to_asm_operand(instruction->arg2);
 	data_type ops_type = data_type::L;
+
+	if(holds_float(instruction->arg1) or holds_float(instruction->arg2)){
+		// Compared by ucomiss, that must not jump for NaN.
+		translate_float_relational_jump(*translation,
+									this->float_literals,
+									get_inst_op(instruction),
+									x,
+									holds_float(instruction->arg1),
+									y,
+									holds_float(instruction->arg2),
+									get_relational_jmp_label(instruction),
+									std::string("LU") +
+									std::to_string(this->unordered_labels++));
+		return;
+	}
+
+	if(this->selecting_instructions){
+		select_relational_jump(*translation, get_inst_op(instruction), x, y,
+								get_relational_jmp_label(instruction),
+								acquire_scratch(SELECTION_VALUE_REGISTER));
+		return;
+	}
+
 	translation->push_back(new_cmp_instruction(x, y, ops_type));
 
 	switch(get_inst_op(instruction)){
@@ -747,6 +1166,8 @@ bool asm_code_generator::allocate_integer_param(const operand_pointer& val,
 													data_type::L));
 		}
 
+		// Live until the call.
+		this->registers.hold(reg);
 		this->last_reg_used = reg;
 		this->params_in_registers++;
         using_registers = true;
@@ -763,9 +1184,10 @@ bool asm_code_generator::allocate_integer_param(const operand_pointer& val,
 		}
 
 		if(pass_address){
-			// TODO: tengo que definir otro registro, ya que RDI puede estar
-			// siendo utilizado a esta altura.
-			operand_pointer reg = new_register_operand(register_id::RDI);
+			// Pushed at the call, when every register of the parameters is
+			// taken: the address goes through a free one.
+			operand_pointer reg = new_register_operand(
+										acquire_scratch(register_id::RDI));
 			stack_params->insert(stack_params->begin(),
 								new_lea_instruction(val,
 													reg,
@@ -784,19 +1206,52 @@ bool asm_code_generator::allocate_integer_param(const operand_pointer& val,
     return using_registers;
 }
 
+void asm_code_generator::allocate_float_param(const address_pointer& param){
+	operand_pointer val = this->convert_to_asm_operand(param);
+
+	if(this->float_params_in_registers < FLOAT_PARAMS_INTO_REG){
+		register_id reg = static_cast<register_id>(
+								static_cast<int>(register_id::XMM0) +
+								this->float_params_in_registers);
+
+		translation->push_back(new_movss_instruction(
+								translate_float_operand(*translation,
+														this->float_literals,
+														val,
+														true,
+														reg),
+								new_register_operand(reg)));
+		this->float_params_in_registers++;
+	}
+	else{
+		// {float_params_in_registers >= FLOAT_PARAMS_INTO_REG}
+		if(stack_params == nullptr){
+			stack_params = new asm_instructions_list();
+		}
+		stack_params->insert(stack_params->begin(),
+							new_pushq_instruction(val, data_type::L));
+	}
+}
+
 void asm_code_generator::translate_parameter(const quad_pointer& instruction){
 	address_pointer param = get_param_inst_param(instruction);
-    std::string name = get_address_name(param);	
     operand_pointer param_address = this->convert_to_asm_operand(param);
 
 	address_type addr_type = get_address_type(param);
 
 	if(addr_type == address_type::ADDRESS_NAME or
 	addr_type == address_type::ADDRESS_TEMP){
+			std::string name = get_address_name(param);
+
 			switch(s_table->get_kind(name)){
 				case K_OBJECT:{
 					    // Objects are managed by reference.
                         allocate_integer_param(param_address, true);
+                        // The object of a parameter belongs to the frame of
+                        // a caller.
+                        if(not s_table->is_parameter(name)){
+                            this->passes_frame_addresses = true;
+                        }
                     }
                     break;
 
@@ -819,7 +1274,7 @@ void asm_code_generator::translate_parameter(const quad_pointer& instruction){
                             break;
 
 						case T_FLOAT:
-							// TODO: terminar
+							allocate_float_param(param);
 							break;
 
 						case T_STRING:
@@ -830,7 +1285,13 @@ void asm_code_generator::translate_parameter(const quad_pointer& instruction){
 
 						default:
 							// {type == T_UNDEFINED}
-							break;
+							// A temporary.
+							if(holds_float(param)){
+								allocate_float_param(param);
+							}
+							else{
+								allocate_integer_param(param_address, false);
+							}
 					}
 			}
 		}
@@ -843,7 +1304,7 @@ void asm_code_generator::translate_parameter(const quad_pointer& instruction){
 			}
 
 			case value_type::FLOAT:
-				// TODO
+				allocate_float_param(param);
 				break;
 
 			default:
@@ -865,14 +1326,13 @@ void asm_code_generator::translate_procedure_call(const quad_pointer& instructio
 		this->stack_params = nullptr;
 	}
 
-	// TODO: por ahora, no pasamos ningún parámetro que requiera el uso del
-	// vector-registers...
 	// Indicate, in register %rax, the total number of floating point
 	// parameters passed to the function in vector registers.
-	operand_pointer const_0 = new_immediate_integer_operand(0);
+	operand_pointer float_params = new_immediate_integer_operand(
+											this->float_params_in_registers);
 	operand_pointer reg_rax = new_register_operand(register_id::RAX);
 
-	this->translation->push_back(new_mov_instruction(const_0,
+	this->translation->push_back(new_mov_instruction(float_params,
 												reg_rax,
 												data_type::L));
 
@@ -883,8 +1343,42 @@ void asm_code_generator::translate_procedure_call(const quad_pointer& instructio
 
 	// Reset the state of attributes used to manage the passing of parameters.
 	this->last_reg_used = register_id::NONE;
+	release_parameter_registers();
+	this->params_in_registers = 0;
+	this->float_params_in_registers = 0;
+	this->passes_frame_addresses = false;
+}
+
+bool asm_code_generator::can_reuse_frame(unsigned int call){
+	return this->stack_params == nullptr and
+		   not this->passes_frame_addresses and
+		   is_tail_call(*this->ir, call, this->method_labels);
+}
+
+void asm_code_generator::translate_tail_call(const quad_pointer& instruction){
+	// PRE
+	#ifdef __DEBUG
+		assert(this->stack_params == nullptr);
+	#endif
+
+	operand_pointer float_params = new_immediate_integer_operand(
+											this->float_params_in_registers);
+	operand_pointer reg_rax = new_register_operand(register_id::RAX);
+
+	this->translation->push_back(new_mov_instruction(float_params,
+												reg_rax,
+												data_type::L));
+	// Release the frame: the called procedure returns to our caller, with
+	// its result into %rax.
+	translate_epilogue();
+	this->translation->push_back(new_jmp_instruction(
+						get_procedure_or_function_call_label(instruction)));
+
+	this->last_reg_used = register_id::NONE;
+	release_parameter_registers();
 	this->params_in_registers = 0;
-    this->offset = -1;
+	this->float_params_in_registers = 0;
+	this->passes_frame_addresses = false;
 }
 
 void asm_code_generator::translate_function_call(const quad_pointer& instruction){
@@ -893,28 +1387,58 @@ void asm_code_generator::translate_function_call(const quad_pointer& instruction
 
 	translate_procedure_call(instruction);
 
-	translation->push_back(new_mov_instruction(reg_rax, dest, data_type::L));
+	if(holds_float(instruction->result)){
+		// Floats are returned into %xmm0.
+		translation->push_back(new_movss_instruction(
+									new_register_operand(register_id::XMM0),
+									dest));
+	}
+	else{
+		translation->push_back(new_mov_instruction(reg_rax, dest, data_type::L));
+	}
 }
 
 void asm_code_generator::translate_return(const quad_pointer& instruction){
 	data_type ops_type = data_type::L;
-	// TODO: por ahora sólo resolvemos el caso para los enteros.
 	operand_pointer rax = new_register_operand(register_id::RAX);
 	operand_pointer x = this->convert_to_asm_operand(instruction->arg1);
-	translation->push_back(new_mov_instruction(x, rax, ops_type));
-	translation->push_back(new_leave_instruction());
+
+	if(holds_float(instruction->arg1)){
+		operand_pointer xmm0 = new_register_operand(register_id::XMM0);
+
+		translation->push_back(new_movss_instruction(
+								translate_float_operand(*translation,
+														this->float_literals,
+														x,
+														true,
+														register_id::XMM0),
+								xmm0));
+	}
+	else{
+		translation->push_back(new_mov_instruction(x, rax, ops_type));
+	}
+	translate_epilogue();
 	translation->push_back(new_ret_instruction());
 }
 
 void asm_code_generator::translate_label(const quad_pointer& instruction){
-	// If the label doesn't represents the beginning of a method's definition,
-	// this strings are not used, so their actual values are of no interest.
-	this->actual_method_name = get_label_inst_method_name(instruction);
+	this->last_label = get_label_inst_label(instruction);
+
+	if(not is_method_label_inst(instruction)){
+		// A label into the body of the method being translated.
+		translation->push_back(new_label_instruction(this->last_label));
+		return;
+	}
+
+	// Methods are registered into s_table as "method::class".
+	this->actual_method_name = get_label_inst_method_name(instruction) + "::" +
+							   get_label_inst_class_name(instruction);
 	this->actual_class_name = get_label_inst_class_name(instruction);
-	this->actual_class_attributes = this->s_table->get_list_attributes(
+	this->actual_class_attributes = t_attributes();
+	if(this->s_table->id_exists(this->actual_class_name)){
+		this->actual_class_attributes = this->s_table->get_list_attributes(
 													this->actual_class_name);
-
-	this->last_label = get_label_inst_label(instruction);
+	}
     // TODO: hack to make it compatible with g++'s assembly.
     // TODO: debería ser main.main.
     if(this->last_label == std::string("Main.main")){
@@ -927,24 +1451,36 @@ void asm_code_generator::translate_label(const quad_pointer& instruction){
     // System V ABI: update the offsets of the parameters' position into the
     // stack frame, taking into account that integer parameters are passed
     // into registers.
-    t_params params = s_table->get_list_params(this->actual_method_name);
+    t_params params;
+    if(s_table->id_exists(this->actual_method_name)){
+        params = s_table->get_list_params(this->actual_method_name);
+    }
 	std::string param_name;
     
     // Update the offset of each parameter, to make them compatible with
     // the System V's ABI: parameters have positive offsets, with respect to 
     // the rBP pointer, and are passed in reversed order (first parameter 
-    // closest to the rBP rgister). Integer parameters are passed by
-    // registers, and then put into the stack frame, with negative
-    // offsets.
-    int pos_offset = RBP_REGISTER_SIZE;
+    // closest to the rBP rgister), above the saved rBP and the return
+    // address. Integer parameters are passed by registers, and then put
+    // into the stack frame, with negative offsets. The same for the first
+    // FLOAT_PARAMS_INTO_REG float parameters, below them.
+    int pos_offset = RBP_REGISTER_SIZE + RETURN_ADDRESS_SIZE;
     int neg_offset = -RBP_REGISTER_SIZE;
+    int float_offset = -RBP_REGISTER_SIZE - INTEGER_WIDTH*get_register_params(
+													params, T_INT).size();
+    int float_params = 0;
 
 	for(t_params::iterator it = params.begin(); it != params.end(); it++){
 		param_name = *it;
         id_type type = s_table->get_type(param_name);
 
+        if(type == T_FLOAT and float_params < FLOAT_PARAMS_INTO_REG){
+            s_table->set_offset(param_name, float_offset);
+            float_offset -= FLOAT_WIDTH;
+            float_params++;
+        }
         // TODO: param_name es el id único que representa al parámetro?
-		if(type != T_INT){
+		else if(type != T_INT){
 			s_table->set_offset(param_name, pos_offset);
             
             // Update the offset.
@@ -970,7 +1506,7 @@ void asm_code_generator::translate_label(const quad_pointer& instruction){
         else{
             // {type == T_INT}
             s_table->set_offset(param_name, neg_offset);
-            neg_offset += INTEGER_WIDTH;
+            neg_offset -= INTEGER_WIDTH;
         }
 	}
 }
@@ -980,56 +1516,112 @@ void asm_code_generator::translate_enter_procedure(const quad_pointer&
 	// Update the stack space to be allocated, taking into account the
 	// integer parameters.
 	// TODO: estoy asumiendo que siempre last_label tiene la etiqueta correcta.
-	t_params params = s_table->get_list_params(this->actual_method_name);
-	std::string param_name;
-	t_params int_params;
+	t_params params;
+	if(s_table->id_exists(this->actual_method_name)){
+		params = s_table->get_list_params(this->actual_method_name);
+	}
+	t_params int_params = get_register_params(params, T_INT);
+	t_params float_params = get_register_params(params, T_FLOAT);
 
-	for(t_params::iterator it = params.begin(); it != params.end(); it++){
-		param_name = *it;
+    // Local and temporal variables have negatives offsets, with respect
+    // to the rBP pointer, below the integer and float parameters. Every name
+    // gets its slot before the body is translated: blocks may be placed
+    // before the one that writes a name first (see place_blocks).
+    int locals_offset = -RBP_REGISTER_SIZE - INTEGER_WIDTH*int_params.size()
+						- FLOAT_WIDTH*float_params.size();
+	this->offset = locals_offset;
+	for(std::vector<std::string>::iterator it = this->frame_names.begin();
+	it != this->frame_names.end(); ++it){
+		s_table->set_offset(*it, this->offset);
+		this->offset -= this->float_names.find(*it) != this->float_names.end() ?
+						FLOAT_WIDTH : INTEGER_WIDTH;
+	}
 
-		if(s_table->get_type(param_name) == T_INT){
-			int_params.push_back(*it);
+	// Space for local and temporal variables AND for the integer (and float)
+	// parameters passed by registers, that are moved to the stack frame. The
+	// callee-saved registers assigned to variables, are saved below them.
+	int frame_size = RBP_REGISTER_SIZE
+					 + integer_width*int_params.size()
+					 + float_width*float_params.size()
+					 + std::max(get_enter_inst_bytes(instruction),
+								locals_offset - this->offset)
+					 + 8*allocation.callee_saved.size();
+	// After the return address and rBP are pushed, rSP is aligned to 16
+	// bytes: keep it aligned for the calls made ([4]).
+	frame_size = (frame_size + STACK_ALIGNMENT - 1) / STACK_ALIGNMENT
+				 * STACK_ALIGNMENT;
+	this->callee_saved_offset = -frame_size;
+
+	if(not this->frameless){
+		operand_pointer rbp = new_register_operand(register_id::RBP);
+		operand_pointer rsp = new_register_operand(register_id::RSP);
+
+		translation->push_back(new_pushq_instruction(rbp, data_type::Q));
+		translation->push_back(new_mov_instruction(rsp, rbp, data_type::Q));
+		if(frame_size > 0){
+			translation->push_back(new_sub_instruction(
+									new_immediate_integer_operand(frame_size),
+									rsp,
+									data_type::Q));
 		}
 	}
 
-	#ifdef __DEBUG
-		assert(int_params.size() <= 6);
-	#endif
+	// Take the integer parameters used by the method, from the registers in
+	// which they are received, to the register assigned to them, or to
+	// their slot at the beginning of the stack frame.
+    register_id reg = register_id::NONE;
+	for(t_params::iterator it = int_params.begin(); it != int_params.end(); it++){
+		reg = this->get_next_reg_av(reg);
 
-	// Enter instruction, that allocates space into the stack frame,
-    // for local, temporal variables AND for the integer parameters
-    // passed by registers, that are moved to the stack frame.
-	operand_pointer stack_space = new_immediate_integer_operand(
-								get_enter_inst_bytes(instruction)
-								+ integer_width*int_params.size());
+		if(this->method_names.find(*it) == this->method_names.end()){
+			// {*it is never used}
+			continue;
+		}
 
-	operand_pointer nesting = new_immediate_integer_operand(0);
-	translation->push_back(new_enter_instruction(stack_space, nesting));
+		this->translation->push_back(
+					new_mov_instruction(
+						new_register_operand(get_register32(reg)),
+						this->convert_to_asm_operand(new_name_address(*it)),
+						data_type::L));
+	}
 
-    // Local and temporal variables have negatives offsets, with respect
-    // to the rBP pointer.
-    this->offset = -RBP_REGISTER_SIZE;
+	// The same for the float parameters, from %xmm0-7 into the frame.
+	int xmm = static_cast<int>(register_id::XMM0);
+	for(t_params::iterator it = float_params.begin(); it != float_params.end();
+	it++, xmm++){
+		if(this->method_names.find(*it) == this->method_names.end()){
+			continue;
+		}
 
-	// Put the parameters into the stack, right at the beginning of the stack
-	// frame.
-    register_id reg = register_id::NONE;
-	for(t_params::iterator it = int_params.begin(); it != int_params.end(); it++){
-		reg = this->get_next_reg_av(reg);
 		this->translation->push_back(
-					new_mov_instruction(new_register_operand(reg),
-										new_memory_operand(this->offset,
-															register_id::RBP,
-															register_id::NONE,
-															1),
-										data_type::L));
-        this->offset -= INTEGER_WIDTH;
+					new_movss_instruction(
+						new_register_operand(static_cast<register_id>(xmm)),
+						this->convert_to_asm_operand(new_name_address(*it))));
 	}
+
+	save_callee_saved_registers();
 }
 
 void asm_code_generator::translate_ir(void){
-    // Translator with window size of 1
+	this->float_names = get_float_names(*ir, *s_table);
+
+    // Translator with window size of 1 (but for the quads folded into the
+    // index trees of indexed copies, when selecting instructions).
 	for(instructions_list::iterator it = ir->begin();
 	it != ir->end(); ++it){
+		this->quad_position = it - ir->begin();
+		// Scratch registers are taken by a single quad.
+		this->registers.release_scratch();
+		if(this->folded_quads.find(this->quad_position) !=
+		this->folded_quads.end()){
+			// Computed by the addressing of an indexed copy.
+			continue;
+		}
+		if(this->fused_comparisons.find(this->quad_position) !=
+		this->fused_comparisons.end()){
+			// Translated with the jump that follows it.
+			continue;
+		}
 
 		switch((*it)->type){
 			case quad_type::BINARY_ASSIGN:
@@ -1057,7 +1649,13 @@ void asm_code_generator::translate_ir(void){
 				break;
 
 			case quad_type::CONDITIONAL_JUMP:
-				translate_conditional_jump(*it);
+				if(this->fused_comparisons.find(this->quad_position - 1) !=
+				this->fused_comparisons.end()){
+					translate_fused_comparison(*(it - 1), *it);
+				}
+				else{
+					translate_conditional_jump(*it);
+				}
 				break;
 
 			case quad_type::RELATIONAL_JUMP:
@@ -1069,11 +1667,21 @@ void asm_code_generator::translate_ir(void){
 				break;
 
 			case quad_type::PROCEDURE_CALL:
-				translate_procedure_call(*it);
-				break;
-
 			case quad_type::FUNCTION_CALL:
-				translate_function_call(*it);
+				if(can_reuse_frame(it - ir->begin())){
+					translate_tail_call(*it);
+					// A return just after the call is never reached.
+					if(it + 1 != ir->end() and
+					(*(it + 1))->type == quad_type::RETURN){
+						++it;
+					}
+				}
+				else if((*it)->type == quad_type::PROCEDURE_CALL){
+					translate_procedure_call(*it);
+				}
+				else{
+					translate_function_call(*it);
+				}
 				break;
 
 			case quad_type::RETURN:
@@ -1081,6 +1689,9 @@ void asm_code_generator::translate_ir(void){
 				break;
 
 			case quad_type::LABEL:
+				if(is_method_label_inst(*it)){
+					begin_method(it - ir->begin());
+				}
 				translate_label(*it);
 				break;
 
@@ -1094,4 +1705,135 @@ void asm_code_generator::translate_ir(void){
         this->translation->insert(this->translation->begin(),
                                 new_global_directive(std::string("main")));
     }
+
+	this->float_literals.emit(*this->translation);
+}
+
+/* Operand of the translation of address, for count_asm_instructions:
+ * integer constants are immediate, and the rest are taken as into memory. */
+operand_pointer get_counted_operand(const address_pointer& address){
+	operand_pointer ret = new_memory_operand(0, register_id::RBP,
+											register_id::NONE, 1);
+
+	if(address->type == address_type::ADDRESS_CONSTANT &&
+	get_constant_address_type(address) == value_type::INTEGER){
+		ret = new_immediate_integer_operand(
+								get_constant_address_integer_value(address));
+	}
+
+	return ret;
+}
+
+unsigned int count_asm_instructions(const quad_pointer& instruction,
+									ids_info& ids){
+	unsigned int ret = 0;
+
+	switch(get_inst_type(instruction)){
+		case quad_type::BINARY_ASSIGN:
+			switch(get_inst_op(instruction)){
+				case quad_oper::PLUS:
+				case quad_oper::MINUS:
+					ret = 3;
+					break;
+
+				case quad_oper::TIMES:{
+					asm_instructions_list code;
+
+					translate_integer_multiplication(code,
+						get_counted_operand(get_binary_assign_result(instruction)),
+						get_counted_operand(get_binary_assign_arg1(instruction)),
+						get_counted_operand(get_binary_assign_arg2(instruction)),
+						register_id::R8D);
+					ret = code.size();
+					break;
+				}
+
+				case quad_oper::DIVIDE:
+				case quad_oper::MOD:{
+					// It depends on the divisor (the saving of %edx isn't
+					// counted).
+					asm_instructions_list code;
+
+					translate_integer_division(code,
+						get_counted_operand(get_binary_assign_result(instruction)),
+						get_counted_operand(get_binary_assign_arg1(instruction)),
+						get_counted_operand(get_binary_assign_arg2(instruction)),
+						get_inst_op(instruction) == quad_oper::MOD,
+						register_id::R9D);
+					ret = code.size();
+					break;
+				}
+
+				default:
+					// Not translated.
+					break;
+			}
+			break;
+
+		case quad_type::UNARY_ASSIGN:
+			ret = get_inst_op(instruction) == quad_oper::ADDRESS_OF ? 1 : 3;
+			break;
+
+		case quad_type::INDEXED_COPY_TO:
+		case quad_type::INDEXED_COPY_FROM:{
+			address_pointer base =
+						get_inst_type(instruction) == quad_type::INDEXED_COPY_TO ?
+						get_indexed_copy_to_dest(instruction) :
+						get_indexed_copy_from_src(instruction);
+			std::string name = get_address_name(base);
+
+			// The address of an object is moved into a register, first.
+			ret = ids.id_exists(name) && ids.get_kind(name) == K_OBJECT ? 2 : 1;
+			break;
+		}
+
+		case quad_type::CONDITIONAL_JUMP:
+			ret = 3;
+			break;
+
+		case quad_type::RELATIONAL_JUMP:
+		case quad_type::PROCEDURE_CALL:
+			ret = 2;
+			break;
+
+		case quad_type::FUNCTION_CALL:
+		case quad_type::RETURN:
+			ret = 3;
+			break;
+
+		case quad_type::ENTER_PROCEDURE:
+			// Prologue: pushq, movq and subq.
+			ret = 3;
+			break;
+
+		case quad_type::PHI:
+			// Not translated: only into SSA form.
+			break;
+
+		default:
+			// COPY, UNCONDITIONAL_JUMP, PARAMETER, LABEL.
+			ret = 1;
+	}
+
+	return ret;
+}
+
+unsigned int remove_asm_jumps_to_next(asm_instructions_list& code){
+	asm_instructions_list kept;
+	unsigned int ret = 0;
+
+	for(unsigned int i = 0; i < code.size(); i++){
+		if(code[i]->op == operation::JMP and i + 1 < code.size() and
+		code[i + 1]->op == operation::LABEL and
+		is_jmp_instruction(code[i], *code[i + 1]->destination->value.label)){
+			ret++;
+		}
+		else{
+			kept.push_back(code[i]);
+		}
+	}
+
+	code = kept;
+
+	return ret;
 }
@@ -1,8 +1,15 @@
 #ifndef CODE_GENERATOR_H
 #define CODE_GENERATOR_H
 
+#include <set>
+#include <unordered_set>
 #include "inter_code_gen_visitor.h"
 #include "asm_instruction.h"
+#include "register_allocation.h"
+#include "integer_division.h"
+#include "integer_multiplication.h"
+#include "float_arithmetic.h"
+#include "instruction_selection.h"
 
 /* Bibliography adopted:
  * [1] "Notes on x86-64 programming",
@@ -22,22 +29,31 @@
  * 		Supplement", available at http://www.x86-64.org/documentation/abi.pdf
  * */
 
-/* BINARY_ASSIGN x = y + z:
+/* Floats are translated into SSE instructions, over the scalar single-
+ * precision value of the %xmm registers (see float_arithmetic): a quad
+ * works with floats if its result (or any operand, for jumps) is one of the
+ * names of get_float_names, or a float constant. Float constants are read
+ * from a literal pool, into the .rodata section (at the end of the
+ * translation).
+ *
+ * BINARY_ASSIGN x = y + z:
  * 		addw y,z (z = y+z) Los operandos son de tipo word?
  * 		mov[b|w|l|q] z,x (tendremos que ver el tipo de los operandos
  *		para determinar el tipo de instrucción?)
  * BINARY_ASSIGN x = y * z:
  * 		imulw y,z (z = z ∗ y (throws away high-order half of result; d must be a register))
  * 		mov[b|w|l|q] z,x
+ * 		Products by constants use lea, shl, add and sub, when they are faster
+ * 		(see translate_integer_multiplication).
  * BINARY_ASSIGN x = y/z:
- * 		mov[b|w|l|q] y,%edx::%eax (puede ir así?)
+ * 		movl y,%eax
+ * 		cltd (sign-extends %eax into %edx::%eax)
  * 		idivl z (signed divide of %edx::%eax by z; quotient in %eax, remainder in %edx)
- * 		mov[b|w|l|q] %eax,x
+ * 		movl %eax,x
  *
  * BINARY_ASSIGN x = y % z:
- * 		mov[b|w|l|q] y,%edx::%eax (puede ir así?)
- * 		idivl z (signed divide of %edx::%eax by z; quotient in %eax, remainder in %edx)
- * 		Podemos hacer lo mismo que con la división, y tomar el resto de %edx)
+ * 		Lo mismo que con la división, tomando el resto de %edx.
+ * 		Divisions by constants don't use idiv (see translate_integer_division).
  *
  * 		mov[b|w|l|q] %edx,x
  *
@@ -96,6 +112,8 @@
  * RELATIONAL_JUMP,	// if x != y goto L
  * 		cmp[b|w|l|q] x , y (set flags based on y − x)
  *		jne L 				(salta si la comparación resultó not equal to zero)
+ *		For floats, ucomiss and ja, jae, je, jne and jp (see
+ *		translate_float_relational_jump).
  * PARAMETER,			// param x
  * 		Integer arguments (up to the first six) are passed in registers,
  * 		namely: %rdi, %rsi, %rdx, %rcx, %r8, %r9. Así es que la traducción
@@ -121,17 +139,64 @@
  * 			mov y, %rax
  * 			leave				(The leave instruction sets %rsp to %rbp and then
  * 								pops the stack into %rbp, effectively popping the
- * 								entire current stack frame. It is nominally
- * 								intended to reverse the action of a previous
- * 								enter instruction.)
+ * 								entire current stack frame. It reverses the
+ * 								prologue of BEGIN_PROCEDURE. It is omitted
+ * 								for methods without frame.)
  * 			ret					(ret pops the top of stack into %rip, thus resuming
  * 								execution in the calling routine)
  *	LABEL,				// L: skip
  *		L:
  *	BEGIN_PROCEDURE n
- *		enter n
+ *		pushq %rbp
+ *		movq %rsp, %rbp
+ *		subq $m, %rsp		(m: n, or the slots of the locals and
+ *							temporaries not kept into registers, if
+ *							more, plus the integer parameters and the
+ *							callee-saved registers, rounded up to
+ *							STACK_ALIGNMENT. The three of them are
+ *							omitted for methods without frame.)
  * */
 
+/* State of the integer registers along the translation of a quad: which of
+ * them hold a live value (a parameter of the call being prepared, or the
+ * names assigned by the register allocation), and which ones were taken as
+ * scratch by the quad. Registers are tracked by their 64-bit name: %edx is
+ * %rdx. */
+class register_tracker {
+public:
+	// Marks reg as holding a live value, until it is released.
+	void hold(register_id reg);
+	void release(register_id reg);
+
+	// Releases every register, live or scratch.
+	void clear();
+
+	// Does reg hold a live value?
+	bool is_live(register_id reg) const;
+
+	// Is reg free: neither live nor taken as scratch?
+	bool is_free(register_id reg) const;
+
+	/* Takes reg as scratch, until release_scratch, even if it is live (then,
+	 * the caller must save its value). */
+	void reserve(register_id reg);
+
+	/* Returns a free register, with the width of preferred: preferred itself,
+	 * if it is free, or else the first free caller-saved register, in the
+	 * order: %r8, %r9, %r10, %r11 (that no parameter uses), %rcx, %rsi, %rdi,
+	 * %rdx (those of the parameters, from the last one, the least likely to
+	 * be pending), and %rax. It is taken as scratch until release_scratch.
+	 * Returns register_id::NONE when there is none. */
+	register_id acquire(register_id preferred);
+
+	// Frees the registers taken as scratch.
+	void release_scratch();
+
+private:
+	std::set<register_id> live;
+	std::set<register_id> scratch;
+};
+
 class asm_code_generator {
 public:
 	asm_code_generator(instructions_list*, ids_info*);
@@ -140,6 +205,23 @@ public:
 	void print_translation_intel_syntax();
 	asm_instructions_list* get_translation();
 
+	/* Keeps the integer locals and temporaries of each method into registers,
+	 * as assigned by allocate_registers (guided by profile, if it isn't
+	 * nullptr), instead of into the stack frame. The callee-saved registers
+	 * used are saved at the bottom of the frame, by the ENTER_PROCEDURE of the
+	 * method, and restored before leaving it. Leaf methods that keep all
+	 * their names into caller-saved registers get no frame at all.
+	 * PRE : {translate_ir wasn't called yet} */
+	void set_register_allocation(bool allocate, const execution_profile* profile);
+
+	/* Selects the instructions of PLUS, MINUS, integer relational jumps and
+	 * indexed copies by the cost model of instruction_selection, instead of
+	 * by their fixed templates: the indexes of indexed copies are rebuilt as
+	 * trees (see build_index_trees), and addressed by a single memory
+	 * operand, that takes the place of the quads that computed them.
+	 * PRE : {translate_ir wasn't called yet} */
+	void set_instruction_selection(bool select);
+
 private:
 	instructions_list *ir;
 	// Auxiliary list of pushq instructions, that put parameters passed to a
@@ -150,6 +232,9 @@ private:
 	register_id last_reg_used; // Last register used for integer parameters.
 	bool using_registers;
 	int params_in_registers; // Quantity of integer parameters put into registers.
+	// Do the parameters of the call being translated point into the frame of
+	// the caller?
+	bool passes_frame_addresses;
 	int offset;
     int nmbr_parameter; // Number of the method's parameter being analyzed.s 
 	std::string actual_method_name; // Name of the method being translated, and
@@ -160,6 +245,65 @@ private:
                                 // Used to know when to add the corresponding 
                                 // assembler's directives, to make the method 
                                 // globally accesible.
+	bool allocating_registers;
+	const execution_profile* profile;
+	register_allocation allocation; // Registers of the method being translated.
+	int callee_saved_offset; // Offset of the slot of allocation.callee_saved[0].
+	// Names read or written by the method being translated.
+	std::unordered_set<std::string> method_names;
+	// Positions into ir of the labels of the method being translated.
+	std::unordered_map<std::string, unsigned int> method_labels;
+	// Its locals and temporaries kept into the stack frame, by first
+	// appearance: they get their slots at its ENTER_PROCEDURE.
+	std::vector<std::string> frame_names;
+	bool frameless; // Is the method being translated translated without frame?
+	// Names of ir that hold floats (see get_float_names).
+	std::unordered_set<std::string> float_names;
+	float_literal_pool float_literals; // Float constants of the translation.
+	int float_params_in_registers; // Quantity of float parameters put into
+								   // %xmm registers.
+	unsigned int unordered_labels; // Labels created for NaN comparisons.
+	bool selecting_instructions;
+	// Trees of the indexes of the indexed copies of the method being
+	// translated, and quads folded into them, by position into ir.
+	std::unordered_map<unsigned int, expression_pointer> index_trees;
+	std::unordered_set<unsigned int> folded_quads;
+	// Comparisons translated with the conditional jump that follows them (see
+	// find_fused_comparisons), by position into ir.
+	std::unordered_set<unsigned int> fused_comparisons;
+	unsigned int quad_position; // Position into ir of the quad translated.
+	// Registers live along the translation, and the ones taken as scratch by
+	// the quad being translated (released after it).
+	register_tracker registers;
+
+	/* Returns a scratch register for the quad being translated, preferred if
+	 * it is free (see register_tracker::acquire).
+	 * PRE : {there is a free register} */
+	register_id acquire_scratch(register_id preferred);
+
+	// Releases the registers of the integer parameters, at a call.
+	void release_parameter_registers();
+
+	/* Appends to translation the memory operand of base[index], being base
+	 * an array or an object, and returns it. */
+	operand_pointer translate_indexed_address(const address_pointer& base,
+											const address_pointer& index);
+
+	// Is address a float constant or a name that holds a float?
+	bool holds_float(const address_pointer& address);
+
+	/* Prepares the translation of the method that begins at position label
+	 * of ir: assigns its registers (if allocating_registers), and finds its
+	 * names, the ones that need a slot into the frame, and whether it needs
+	 * a stack frame. */
+	void begin_method(unsigned int label);
+
+	// Restores the callee-saved registers and releases the frame, if any.
+	void translate_epilogue();
+
+	// Saves and restores the callee-saved registers of allocation.
+	void save_callee_saved_registers();
+	void restore_callee_saved_registers();
 
 
     /* Translates a thress-address code's operand into an assembly's operand's.
@@ -176,6 +320,13 @@ private:
 	void translate_conditional_jump(const quad_pointer&);
 	void translate_relational_jump(const quad_pointer&);
 
+	/* Translates comparison, x = y relop z, and jump, a conditional jump on x,
+	 * as the relational jump if y relop z goto L (if y not relop z goto L,
+	 * for ifFalse). x is never written.
+	 * PRE : {the position of comparison is into fused_comparisons} */
+	void translate_fused_comparison(const quad_pointer& comparison,
+									const quad_pointer& jump);
+
 	/* Translates the 3-address "call" instruction. Also, if there are
 	 * parameters to put into the stack, the procedure introduces the
 	 * corresponding instructions, to save them in reverse order (the
@@ -200,13 +351,33 @@ private:
 	void translate_procedure_call(const quad_pointer&);
 	void translate_function_call(const quad_pointer&);
 
+	/* Translates a call in tail position (see is_tail_call), reusing the
+	 * stack frame of the caller: it is released before jumping to the called
+	 * procedure, that returns directly to the caller of the caller:
+	 * 			mov $0, %eax
+	 * 			leave
+	 * 			jmp procedure_label
+	 *
+	 * The frame can only be released if every argument is passed into a
+	 * register, and none of them is the address of something stored into it
+	 * (see can_reuse_frame).
+	 *
+	 * PARAMETER: 3-address code instruction: call label, n
+	 * */
+	void translate_tail_call(const quad_pointer&);
+
+	/* Can the call at position call of ir, whose parameters were already
+	 * translated, reuse the frame of the caller? */
+	bool can_reuse_frame(unsigned int call);
+
 	/* Translates a param instruction, following the C calling convention,
 	 * adopted by linux and GNU tools for the x86-64 ([1] and [4]):
 	 * 		_ Integer arguments (up to the first six) are passed in registers,
 	 * 		namely: %rdi, %rsi, %rdx, %rcx, %r8, %r9.
 	 *
 	 * 		_ Floating arguments (up to 8) are passed in SSE registers
-	 * 		%xmm0, %xmm1, ..., %xmm7
+	 * 		%xmm0, %xmm1, ..., %xmm7 (movss). Temporaries that aren't floats
+	 * 		are taken as integers.
 	 *
 	 * 		_ Any arguments passed on the stack are pushed in reverse
 	 * 		(right-to-left) order.
@@ -220,7 +391,8 @@ private:
 	 * ([1] and [4]):
 	 *		_ An integer value is returned into register rax or rdx. As we
 	 *		do not use register rax for other purpose, we use it to return
-	 *		integer values from procedures.
+	 *		integer values from procedures. A float value is returned into
+	 *		%xmm0.
 	 *
 	 *		_ Sets %rsp to %rbp and then pops the stack into %rbp, effectively
 	 *		popping the entire current stack frame (from [1], which is done by
@@ -250,7 +422,9 @@ private:
 	 *  	for local variables used in the procedure.
 	 *
 	 *		_ If there are integer parameters into registers, take them into
-	 *		the stack frame.
+	 *		the stack frame (or into the registers assigned to them). The
+	 *		same for the float parameters into %xmm registers, that are
+	 *		always taken into the stack frame.
 	 *		TODO: la razón, aparente, para realizar esto:
 	 *		"Parameters send to function in registers rdi-r9 aren't preserved
 	 *		in stack area ? What happens when child function is called ?", de
@@ -259,14 +433,20 @@ private:
 	 *  Notes:
 	 *  	_ "the callee is responsible for preserving the value of registers
 	 *  %rbp %rbx, and %r12-r15, as these registers are owned by the caller.",
-	 *  from [3]. As we only use rBP, into every procedure, we just make sure
-	 *  to save only the value of it.
+	 *  from [3]. rBP is saved by the prologue. %rbx and %r12-r15 are
+	 *  only used when assigned by the register allocation: then, the ones
+	 *  used are saved at the bottom of the stack frame.
 	 *
-	 *  	_ All the steps needed to set the stack frame, are performed by
-	 *  the assembly's enter instruction [2].
+	 *  	_ The steps are performed by pushq, movq and subq, instead of the
+	 *  microcoded enter instruction (which is slower on every recent
+	 *  processor, and only needed for nested procedures, that COMPI doesn't
+	 *  have). The size of the frame is rounded up to STACK_ALIGNMENT, so rSP
+	 *  is aligned at the calls made ([4]).
 	 *
-	 *  	_ In COMPI, we don't have nested procedures. Thus, the second
-	 *  parameter of assembly's enter instruction, is always 0.
+	 *  	_ Integer parameters never used by the method aren't taken into
+	 *  the frame. Methods that don't call, and keep every name into
+	 *  caller-saved registers (see begin_method), get no frame at all: only
+	 *  the parameters are moved into their registers.
 	 *
 	 *  PARAMETER: 3-address code instruction: enter x, where x is the number
 	 *  of bytes to allocate into the stack frame, for the local variables
@@ -281,10 +461,30 @@ private:
 
 	bool allocate_integer_param(const operand_pointer& val, bool pass_address);
 
+	/* Passes the float param into the next %xmm register, or into the stack,
+	 * when the FLOAT_PARAMS_INTO_REG registers are taken. */
+	void allocate_float_param(const address_pointer& param);
+
 	bool is_attribute(std::string var_name);
 
+	/* Returns the parameters of params of type type (T_INT or T_FLOAT) that
+	 * are passed into registers, in order. */
+	t_params get_register_params(const t_params& params, id_type type);
+
     // Returns the width in bytes for an indicated three-address value's type. 
     int get_value_width(value_type);
 };
 
+/* Returns the number of asm instructions that translate_ir emits for
+ * instruction, with the symbols of ids. The moves of the parameters of a
+ * method, at its label and ENTER_PROCEDURE, and the pushes of the parameters
+ * of a call (counted with their PARAMETER quads) are not included. Methods
+ * are taken as translated with a frame. */
+unsigned int count_asm_instructions(const quad_pointer& instruction,
+									ids_info& ids);
+
+/* Removes the jmp instructions whose target is the label that follows them.
+ * Returns the number of instructions removed. */
+unsigned int remove_asm_jumps_to_next(asm_instructions_list& code);
+
 #endif
@@ -1,3 +1,4 @@
+#include <cstring> // std::memcpy
 #include "asm_instruction.h"
 
 /******************************************************************
@@ -32,6 +33,157 @@ operand_pointer new_register_operand(register_id reg){
 	return op;
 }
 
+register_id get_register32(register_id reg){
+	register_id ret = register_id::NONE;
+
+	switch(reg){
+		case register_id::RAX:
+			ret = register_id::EAX;
+			break;
+
+		case register_id::RBX:
+			ret = register_id::EBX;
+			break;
+
+		case register_id::RCX:
+			ret = register_id::ECX;
+			break;
+
+		case register_id::RDX:
+			ret = register_id::EDX;
+			break;
+
+		case register_id::RSI:
+			ret = register_id::ESI;
+			break;
+
+		case register_id::RDI:
+			ret = register_id::EDI;
+			break;
+
+		case register_id::R8:
+			ret = register_id::R8D;
+			break;
+
+		case register_id::R9:
+			ret = register_id::R9D;
+			break;
+
+		case register_id::R10:
+			ret = register_id::R10D;
+			break;
+
+		case register_id::R11:
+			ret = register_id::R11D;
+			break;
+
+		case register_id::R12:
+			ret = register_id::R12D;
+			break;
+
+		case register_id::R13:
+			ret = register_id::R13D;
+			break;
+
+		case register_id::R14:
+			ret = register_id::R14D;
+			break;
+
+		case register_id::R15:
+			ret = register_id::R15D;
+			break;
+
+		default:
+			// {reg has no 32-bit register (%rbp, %rsp) or it isn't a 64-bit
+			// register}
+			break;
+	}
+
+	return ret;
+}
+
+register_id get_register8(register_id reg){
+	register_id ret = register_id::NONE;
+
+	switch(get_register64(reg) != register_id::NONE ? get_register64(reg) : reg){
+		case register_id::RAX:
+			ret = register_id::AL;
+			break;
+
+		case register_id::RBX:
+			ret = register_id::BL;
+			break;
+
+		case register_id::RCX:
+			ret = register_id::CL;
+			break;
+
+		case register_id::RDX:
+			ret = register_id::DL;
+			break;
+
+		case register_id::RSI:
+			ret = register_id::SIL;
+			break;
+
+		case register_id::RDI:
+			ret = register_id::DIL;
+			break;
+
+		case register_id::R8:
+			ret = register_id::R8B;
+			break;
+
+		case register_id::R9:
+			ret = register_id::R9B;
+			break;
+
+		case register_id::R10:
+			ret = register_id::R10B;
+			break;
+
+		case register_id::R11:
+			ret = register_id::R11B;
+			break;
+
+		case register_id::R12:
+			ret = register_id::R12B;
+			break;
+
+		case register_id::R13:
+			ret = register_id::R13B;
+			break;
+
+		case register_id::R14:
+			ret = register_id::R14B;
+			break;
+
+		case register_id::R15:
+			ret = register_id::R15B;
+			break;
+
+		default:
+			// {reg has no 8-bit register used by us (%rbp, %rsp) or it isn't
+			// a 64-bit or 32-bit register}
+			break;
+	}
+
+	return ret;
+}
+
+register_id get_register64(register_id reg){
+	register_id ret = register_id::NONE;
+
+	for(int r = static_cast<int>(register_id::RAX);
+	r <= static_cast<int>(register_id::R15) and ret == register_id::NONE; r++){
+		if(get_register32(static_cast<register_id>(r)) == reg){
+			ret = static_cast<register_id>(r);
+		}
+	}
+
+	return ret;
+}
+
 operand_pointer new_immediate_integer_operand(int imm_int){
 	operand_pointer op = operand_pointer(new operand);
 	op->op_addr = operand_addressing::IMMEDIATE;
@@ -50,6 +202,18 @@ operand_pointer new_immediate_float_operand(float imm_float){
 	return op;
 }
 
+unsigned int get_float_bits(float value){
+	unsigned int ret;
+
+	std::memcpy(&ret, &value, sizeof(ret));
+
+	return ret;
+}
+
+bool is_xmm_register(register_id reg){
+	return reg >= register_id::XMM0 && reg <= register_id::XMM15;
+}
+
 operand_pointer new_memory_operand(int offset,
 									register_id base,
 									register_id index,
@@ -74,6 +238,14 @@ operand_pointer new_label_operand(std::string label){
 	return op;
 }
 
+operand_pointer new_rip_relative_operand(std::string label){
+	operand_pointer op = operand_pointer(new operand);
+	op->op_addr = operand_addressing::RIP_RELATIVE;
+	op->value.label = new std::string(label);
+
+	return op;
+}
+
 /////////////////////////////
 // @ASSEMBLER'S DIRECTIVE
 /////////////////////////////
@@ -93,6 +265,37 @@ asm_instruction_pointer new_global_directive(std::string global_label){
 	return inst;
 }
 
+// Directive of type dir_t, with argument.
+asm_instruction_pointer new_directive(directive_type dir_t,
+									const std::string& argument){
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::DIRECTIVE;
+	inst->ops_type = data_type::NONE;
+
+	operand_pointer op = operand_pointer(new operand);
+	op->op_addr = operand_addressing::DIRECTIVE;
+	op->value.dir.dir_t = dir_t;
+	op->value.dir.data.argument = new std::string(argument);
+
+	inst->source = op;
+	inst->destination = nullptr;
+	inst->is_signed = false;
+
+	return inst;
+}
+
+asm_instruction_pointer new_section_directive(std::string name){
+	return new_directive(directive_type::SECTION, name);
+}
+
+asm_instruction_pointer new_align_directive(unsigned int bytes){
+	return new_directive(directive_type::ALIGN, std::to_string(bytes));
+}
+
+asm_instruction_pointer new_long_directive(unsigned int value){
+	return new_directive(directive_type::LONG, std::to_string(value));
+}
+
 /******************************************************************
  * Constructors of instructions.
  ******************************************************************/
@@ -142,6 +345,60 @@ asm_instruction_pointer new_lea_instruction(const operand_pointer& source,
 
 }
 
+asm_instruction_pointer new_movslq_instruction(const operand_pointer& source,
+											const operand_pointer& destination){
+	// PRE
+	#ifdef __DEBUG
+		assert(source->op_addr == operand_addressing::REGISTER ||
+			   source->op_addr == operand_addressing::MEMORY);
+		assert(destination->op_addr == operand_addressing::REGISTER);
+	#endif
+
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::MOVSLQ;
+	inst->ops_type = data_type::Q;
+	inst->source = source;
+	inst->destination = destination;
+	inst->is_signed = true;
+
+	return inst;
+}
+
+asm_instruction_pointer new_movzbl_instruction(const operand_pointer& source,
+											const operand_pointer& destination){
+	// PRE
+	#ifdef __DEBUG
+		assert(source->op_addr == operand_addressing::REGISTER ||
+			   source->op_addr == operand_addressing::MEMORY);
+		assert(destination->op_addr == operand_addressing::REGISTER);
+	#endif
+
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::MOVZBL;
+	inst->ops_type = data_type::L;
+	inst->source = source;
+	inst->destination = destination;
+	inst->is_signed = false;
+
+	return inst;
+}
+
+asm_instruction_pointer new_scaled_lea_instruction(register_id base,
+												register_id index,
+												unsigned int scale,
+												const operand_pointer& destination,
+												data_type ops_type){
+
+	#ifdef __DEBUG
+		assert(scale == 1 || scale == 2 || scale == 4 || scale == 8);
+		assert(destination->op_addr == operand_addressing::REGISTER);
+	#endif
+
+	return new_lea_instruction(new_memory_operand(0, base, index, scale),
+								destination,
+								ops_type);
+}
+
 asm_instruction_pointer new_pushq_instruction(const operand_pointer& source,
 												data_type ops_type){
 	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
@@ -271,6 +528,137 @@ asm_instruction_pointer new_shr_instruction(const operand_pointer& imm,
 	return inst;
 }
 
+asm_instruction_pointer new_shl_instruction(const operand_pointer& imm,
+											const operand_pointer& destination,
+											data_type ops_type){
+
+	#ifdef __DEBUG
+		assert(imm->op_addr == operand_addressing::IMMEDIATE &&
+			   (destination->op_addr == operand_addressing::REGISTER ||
+			    destination->op_addr == operand_addressing::MEMORY));
+	#endif
+
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::SHL;
+	inst->ops_type = ops_type;
+	inst->source = imm;
+	inst->destination = destination;
+	inst->is_signed = false;
+
+	return inst;
+}
+
+asm_instruction_pointer new_sar_instruction(const operand_pointer& imm,
+											const operand_pointer& destination,
+											data_type ops_type){
+
+	#ifdef __DEBUG
+		assert(imm->op_addr == operand_addressing::IMMEDIATE &&
+			   (destination->op_addr == operand_addressing::REGISTER ||
+			    destination->op_addr == operand_addressing::MEMORY));
+	#endif
+
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::SAR;
+	inst->ops_type = ops_type;
+	inst->source = imm;
+	inst->destination = destination;
+	inst->is_signed = true;
+
+	return inst;
+}
+
+asm_instruction_pointer new_and_instruction(const operand_pointer& source,
+											const operand_pointer& destination,
+											data_type ops_type){
+
+	#ifdef __DEBUG
+		assert(destination->op_addr == operand_addressing::REGISTER ||
+			   destination->op_addr == operand_addressing::MEMORY);
+	#endif
+
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::AND;
+	inst->ops_type = ops_type;
+	inst->source = source;
+	inst->destination = destination;
+	inst->is_signed = false;
+
+	return inst;
+}
+
+asm_instruction_pointer new_xor_instruction(const operand_pointer& source,
+											const operand_pointer& destination,
+											data_type ops_type){
+
+	#ifdef __DEBUG
+		assert(destination->op_addr == operand_addressing::REGISTER ||
+			   destination->op_addr == operand_addressing::MEMORY);
+	#endif
+
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::XOR;
+	inst->ops_type = ops_type;
+	inst->source = source;
+	inst->destination = destination;
+	inst->is_signed = false;
+
+	return inst;
+}
+
+asm_instruction_pointer new_or_instruction(const operand_pointer& source,
+											const operand_pointer& destination,
+											data_type ops_type){
+
+	#ifdef __DEBUG
+		assert(destination->op_addr == operand_addressing::REGISTER ||
+			   destination->op_addr == operand_addressing::MEMORY);
+	#endif
+
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::OR;
+	inst->ops_type = ops_type;
+	inst->source = source;
+	inst->destination = destination;
+	inst->is_signed = false;
+
+	return inst;
+}
+
+asm_instruction_pointer new_cltd_instruction(){
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::CLTD;
+	inst->ops_type = data_type::L;
+	inst->is_signed = true;
+
+	return inst;
+}
+
+asm_instruction_pointer new_widening_mul_instruction(const operand_pointer& source,
+													data_type ops_type,
+													bool is_signed){
+
+	#ifdef __DEBUG
+		assert(source->op_addr == operand_addressing::REGISTER ||
+			   source->op_addr == operand_addressing::MEMORY);
+	#endif
+
+	// As for the division, the only operand is kept as destination.
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	if(is_signed){
+		inst->op = operation::IMUL;
+	}
+	else{
+		// {not is_signed}
+		inst->op = operation::MUL;
+	}
+	inst->ops_type = ops_type;
+	inst->destination = source;
+	inst->is_signed = is_signed;
+
+	return inst;
+}
+
 asm_instruction_pointer new_neg_instruction(const operand_pointer& destination,
 											data_type ops_type){
 
@@ -405,6 +793,54 @@ asm_instruction_pointer new_jge_instruction(std::string label){
 	return inst;
 }
 
+asm_instruction_pointer new_ja_instruction(std::string label){
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::JA;
+	inst->ops_type = data_type::NONE;
+	inst->destination = new_label_operand(label);
+	inst->is_signed = false;
+
+	return inst;
+}
+
+asm_instruction_pointer new_jae_instruction(std::string label){
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::JAE;
+	inst->ops_type = data_type::NONE;
+	inst->destination = new_label_operand(label);
+	inst->is_signed = false;
+
+	return inst;
+}
+
+asm_instruction_pointer new_jp_instruction(std::string label){
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::JP;
+	inst->ops_type = data_type::NONE;
+	inst->destination = new_label_operand(label);
+	inst->is_signed = false;
+
+	return inst;
+}
+
+asm_instruction_pointer new_set_instruction(operation op,
+											const operand_pointer& destination){
+	// PRE
+	#ifdef __DEBUG
+		assert(op >= operation::SETE && op <= operation::SETNP);
+		assert(destination->op_addr == operand_addressing::REGISTER ||
+			   destination->op_addr == operand_addressing::MEMORY);
+	#endif
+
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = op;
+	inst->ops_type = data_type::B;
+	inst->destination = destination;
+	inst->is_signed = false;
+
+	return inst;
+}
+
 asm_instruction_pointer new_call_instruction(std::string label){
 	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
 	inst->op = operation::CALL;
@@ -434,6 +870,20 @@ asm_instruction_pointer new_cmp_instruction(const operand_pointer& op_1,
 	return inst;
 }
 
+asm_instruction_pointer new_test_instruction(const operand_pointer& op_1,
+											const operand_pointer& op_2,
+											data_type ops_type){
+
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::TEST;
+	inst->ops_type = ops_type;
+	inst->source = op_1;
+	inst->destination = op_2;
+	inst->is_signed = false;
+
+	return inst;
+}
+
 asm_instruction_pointer new_leave_instruction(){
 
 	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
@@ -487,6 +937,83 @@ asm_instruction_pointer new_enter_instruction(const operand_pointer& stack_space
 	return inst;
 }
 
+// Instruction op of SSE, over single-precision floats.
+asm_instruction_pointer new_sse_instruction(operation op,
+											const operand_pointer& source,
+											const operand_pointer& destination){
+	// PRE
+	#ifdef __DEBUG
+		assert((source->op_addr == operand_addressing::REGISTER &&
+				is_xmm_register(source->value.reg)) ||
+			   source->op_addr == operand_addressing::MEMORY ||
+			   source->op_addr == operand_addressing::RIP_RELATIVE);
+		assert((destination->op_addr == operand_addressing::REGISTER &&
+				is_xmm_register(destination->value.reg)) ||
+			   (op == operation::MOVSS &&
+				destination->op_addr == operand_addressing::MEMORY));
+	#endif
+
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = op;
+	inst->ops_type = data_type::S;
+	inst->source = source;
+	inst->destination = destination;
+	inst->is_signed = true;
+
+	return inst;
+}
+
+asm_instruction_pointer new_movss_instruction(const operand_pointer& source,
+											const operand_pointer& destination){
+	return new_sse_instruction(operation::MOVSS, source, destination);
+}
+
+asm_instruction_pointer new_addss_instruction(const operand_pointer& source,
+											const operand_pointer& destination){
+	return new_sse_instruction(operation::ADDSS, source, destination);
+}
+
+asm_instruction_pointer new_subss_instruction(const operand_pointer& source,
+											const operand_pointer& destination){
+	return new_sse_instruction(operation::SUBSS, source, destination);
+}
+
+asm_instruction_pointer new_mulss_instruction(const operand_pointer& source,
+											const operand_pointer& destination){
+	return new_sse_instruction(operation::MULSS, source, destination);
+}
+
+asm_instruction_pointer new_divss_instruction(const operand_pointer& source,
+											const operand_pointer& destination){
+	return new_sse_instruction(operation::DIVSS, source, destination);
+}
+
+asm_instruction_pointer new_ucomiss_instruction(const operand_pointer& source,
+											const operand_pointer& destination){
+	return new_sse_instruction(operation::UCOMISS, source, destination);
+}
+
+asm_instruction_pointer new_cvtsi2ss_instruction(const operand_pointer& source,
+												const operand_pointer& destination,
+												data_type ops_type){
+	// PRE
+	#ifdef __DEBUG
+		assert(source->op_addr == operand_addressing::REGISTER ||
+			   source->op_addr == operand_addressing::MEMORY);
+		assert(destination->op_addr == operand_addressing::REGISTER &&
+			   is_xmm_register(destination->value.reg));
+	#endif
+
+	asm_instruction_pointer inst = asm_instruction_pointer(new asm_instruction);
+	inst->op = operation::CVTSI2SS;
+	inst->ops_type = ops_type;
+	inst->source = source;
+	inst->destination = destination;
+	inst->is_signed = true;
+
+	return inst;
+}
+
 /******************************************************************
  * Printing
  ******************************************************************/
@@ -580,6 +1107,14 @@ std::string print_register(register_id reg){
 			ret = std::string("%edx");
 			break;
 
+		case register_id::ESI:
+			ret = std::string("%esi");
+			break;
+
+		case register_id::EDI:
+			ret = std::string("%edi");
+			break;
+
 		case register_id::R8D:
 			ret = std::string("%r8d");
 			break;
@@ -612,6 +1147,30 @@ std::string print_register(register_id reg){
 			ret = std::string("%r15d");
 			break;
 
+		case register_id::AL:
+			ret = std::string("%al");
+			break;
+
+		case register_id::BL:
+			ret = std::string("%bl");
+			break;
+
+		case register_id::CL:
+			ret = std::string("%cl");
+			break;
+
+		case register_id::DL:
+			ret = std::string("%dl");
+			break;
+
+		case register_id::SIL:
+			ret = std::string("%sil");
+			break;
+
+		case register_id::DIL:
+			ret = std::string("%dil");
+			break;
+
 		case register_id::R8B:
 			ret = std::string("%r8b");
 			break;
@@ -643,6 +1202,11 @@ std::string print_register(register_id reg){
 		case register_id::R15B:
 			ret = std::string("%r15b");
 			break;
+
+		default:
+			// {is_xmm_register(reg)}
+			ret = std::string("%xmm") + std::to_string(
+						static_cast<int>(reg) - static_cast<int>(register_id::XMM0));
 	}
 
 	return ret;
@@ -661,8 +1225,10 @@ std::string print_operand_intel_syntax(const operand_pointer& operand){
 		case operand_addressing::IMMEDIATE:{
 			switch(operand->value.imm.imm_op_type){
 				case immediate_op_type::FLOAT:
-					// Single-precision float
-					// TODO:?
+					// Single-precision float: only moved as 32 bits, so its
+					// bit pattern is enough.
+					ret = std::string("$" + std::to_string(
+									get_float_bits(operand->value.imm.val.fval)));
 					break;
 
 				default:
@@ -689,11 +1255,19 @@ std::string print_operand_intel_syntax(const operand_pointer& operand){
 			break;
 		}
 
+		case operand_addressing::RIP_RELATIVE:{
+			ret = *operand->value.label + std::string("(%rip)");
+			break;
+		}
+
         case operand_addressing::DIRECTIVE:{
             switch(operand->value.dir.dir_t){
                 case directive_type::GLOBAL:
                     ret = std::string(*operand->value.dir.data.global_label);
                     break;
+
+                default:
+                    ret = std::string(*operand->value.dir.data.argument);
             }
 			break;
 		}
@@ -767,16 +1341,48 @@ std::string print_binary_op_intel_syntax(const asm_instruction_pointer& instruct
 			prefix = std::string("imul" + obtain_data_type(instruction->ops_type));
 			break;
 
-		case operation::SUB:
-			prefix = std::string("sub" + obtain_data_type(instruction->ops_type));
+		case operation::SUB:
+			prefix = std::string("sub" + obtain_data_type(instruction->ops_type));
+			break;
+
+		case operation::MOV:
+			prefix = std::string("mov" + obtain_data_type(instruction->ops_type));
+			break;
+
+		case operation::LEA:
+			prefix = std::string("lea" + obtain_data_type(instruction->ops_type));
+			break;
+
+		case operation::MOVSLQ:
+			prefix = "movslq";
+			break;
+
+		case operation::MOVZBL:
+			prefix = "movzbl";
+			break;
+
+		case operation::SAR:
+			prefix = std::string("sar" + obtain_data_type(instruction->ops_type));
+			break;
+
+		case operation::SHR:
+			prefix = std::string("shr" + obtain_data_type(instruction->ops_type));
+			break;
+
+		case operation::AND:
+			prefix = std::string("and" + obtain_data_type(instruction->ops_type));
+			break;
+
+		case operation::XOR:
+			prefix = std::string("xor" + obtain_data_type(instruction->ops_type));
 			break;
 
-		case operation::MOV:
-			prefix = std::string("mov" + obtain_data_type(instruction->ops_type));
+		case operation::OR:
+			prefix = std::string("or" + obtain_data_type(instruction->ops_type));
 			break;
 
-		case operation::LEA:
-			prefix = std::string("lea" + obtain_data_type(instruction->ops_type));
+		case operation::SHL:
+			prefix = std::string("shl" + obtain_data_type(instruction->ops_type));
 			break;
 
 		case operation::ENTER:
@@ -786,6 +1392,38 @@ std::string print_binary_op_intel_syntax(const asm_instruction_pointer& instruct
 		case operation::CMP:
 			prefix = std::string("cmp" + obtain_data_type(instruction->ops_type));
 			break;
+
+		case operation::TEST:
+			prefix = std::string("test" + obtain_data_type(instruction->ops_type));
+			break;
+
+		case operation::MOVSS:
+			prefix = "movss";
+			break;
+
+		case operation::ADDSS:
+			prefix = "addss";
+			break;
+
+		case operation::SUBSS:
+			prefix = "subss";
+			break;
+
+		case operation::MULSS:
+			prefix = "mulss";
+			break;
+
+		case operation::DIVSS:
+			prefix = "divss";
+			break;
+
+		case operation::UCOMISS:
+			prefix = "ucomiss";
+			break;
+
+		case operation::CVTSI2SS:
+			prefix = std::string("cvtsi2ss" + obtain_data_type(instruction->ops_type));
+			break;
 	}
 
 	ret =  prefix + " " + print_operand_intel_syntax(instruction->source) + " , "
@@ -809,6 +1447,18 @@ std::string print_directive_intel_syntax(const asm_instruction_pointer& instruct
 		case directive_type::GLOBAL:
 			prefix = std::string(".global");
 			break;
+
+		case directive_type::SECTION:
+			prefix = std::string(".section");
+			break;
+
+		case directive_type::ALIGN:
+			prefix = std::string(".align");
+			break;
+
+		case directive_type::LONG:
+			prefix = std::string(".long");
+			break;
 	}
 
 	ret = prefix + " " + print_operand_intel_syntax(instruction->source);
@@ -836,6 +1486,11 @@ std::string print_unary_op_intel_syntax(const asm_instruction_pointer& instructi
 			prefix = std::string("neg" + obtain_data_type(instruction->ops_type));
 			break;
 
+		case operation::IMUL:
+			// One-operand form.
+			prefix = std::string("imul" + obtain_data_type(instruction->ops_type));
+			break;
+
 		case operation::IDIV:
 			if(instruction->is_signed){
 				prefix = std::string("idiv" + obtain_data_type(instruction->ops_type));;
@@ -874,6 +1529,58 @@ std::string print_unary_op_intel_syntax(const asm_instruction_pointer& instructi
 			prefix = "jge";
 			break;
 
+		case operation::JA:
+			prefix = "ja";
+			break;
+
+		case operation::JAE:
+			prefix = "jae";
+			break;
+
+		case operation::JP:
+			prefix = "jp";
+			break;
+
+		case operation::SETE:
+			prefix = "sete";
+			break;
+
+		case operation::SETNE:
+			prefix = "setne";
+			break;
+
+		case operation::SETL:
+			prefix = "setl";
+			break;
+
+		case operation::SETLE:
+			prefix = "setle";
+			break;
+
+		case operation::SETG:
+			prefix = "setg";
+			break;
+
+		case operation::SETGE:
+			prefix = "setge";
+			break;
+
+		case operation::SETA:
+			prefix = "seta";
+			break;
+
+		case operation::SETAE:
+			prefix = "setae";
+			break;
+
+		case operation::SETP:
+			prefix = "setp";
+			break;
+
+		case operation::SETNP:
+			prefix = "setnp";
+			break;
+
 		case operation::CALL:
 			prefix = "call";
 			break;
@@ -908,7 +1615,13 @@ std::string print_intel_syntax(const asm_instruction_pointer& instruction){
 			break;
 
 		case operation::IMUL:
-			ret += "\t" + print_binary_op_intel_syntax(instruction) + "\n";
+			if(instruction->source == nullptr){
+				// {one-operand form}
+				ret += "\t" + print_unary_op_intel_syntax(instruction) + "\n";
+			}
+			else{
+				ret += "\t" + print_binary_op_intel_syntax(instruction) + "\n";
+			}
 			break;
 
 		case operation::IDIV:
@@ -924,6 +1637,31 @@ std::string print_intel_syntax(const asm_instruction_pointer& instruction){
 			break;
 
 		case operation::SAR:
+			ret += "\t" + print_binary_op_intel_syntax(instruction) + "\n";
+			break;
+
+		case operation::SHR:
+			ret += "\t" + print_binary_op_intel_syntax(instruction) + "\n";
+			break;
+
+		case operation::AND:
+			ret += "\t" + print_binary_op_intel_syntax(instruction) + "\n";
+			break;
+
+		case operation::XOR:
+			ret += "\t" + print_binary_op_intel_syntax(instruction) + "\n";
+			break;
+
+		case operation::OR:
+			ret += "\t" + print_binary_op_intel_syntax(instruction) + "\n";
+			break;
+
+		case operation::SHL:
+			ret += "\t" + print_binary_op_intel_syntax(instruction) + "\n";
+			break;
+
+		case operation::CLTD:
+			ret += "\tcltd\n";
 			break;
 
 		case operation::NOT:
@@ -938,6 +1676,11 @@ std::string print_intel_syntax(const asm_instruction_pointer& instruction){
 			ret += "\t" + print_binary_op_intel_syntax(instruction) + "\n";
 			break;
 
+		case operation::MOVSLQ:
+		case operation::MOVZBL:
+			ret += "\t" + print_binary_op_intel_syntax(instruction) + "\n";
+			break;
+
 		case operation::JMP:
 			ret += "\t" + print_unary_op_intel_syntax(instruction) + "\n";
 			break;
@@ -966,10 +1709,44 @@ std::string print_intel_syntax(const asm_instruction_pointer& instruction){
 			ret += "\t" + print_unary_op_intel_syntax(instruction) + "\n";
 			break;
 
+		case operation::JA:
+		case operation::JAE:
+		case operation::JP:
+			ret += "\t" + print_unary_op_intel_syntax(instruction) + "\n";
+			break;
+
+		case operation::SETE:
+		case operation::SETNE:
+		case operation::SETL:
+		case operation::SETLE:
+		case operation::SETG:
+		case operation::SETGE:
+		case operation::SETA:
+		case operation::SETAE:
+		case operation::SETP:
+		case operation::SETNP:
+			ret += "\t" + print_unary_op_intel_syntax(instruction) + "\n";
+			break;
+
+		case operation::MOVSS:
+		case operation::ADDSS:
+		case operation::SUBSS:
+		case operation::MULSS:
+		case operation::DIVSS:
+		case operation::UCOMISS:
+		case operation::CVTSI2SS:
+			ret += "\t" + print_binary_op_intel_syntax(instruction) + "\n";
+			break;
+
 		case operation::CALL:
 			ret += "\t" + print_unary_op_intel_syntax(instruction) + "\n";
 			break;
 
+		case operation::PUSHQ:
+			ret += "\tpush" + obtain_data_type(instruction->ops_type) + " " +
+					print_operand_intel_syntax(instruction->source) + "\n";
+			break;
+
 		case operation::LEAVE:
 			ret += "\tleave\n";
 			break;
@@ -986,6 +1763,10 @@ std::string print_intel_syntax(const asm_instruction_pointer& instruction){
 			ret += "\t" + print_binary_op_intel_syntax(instruction) + "\n";
 			break;
 
+		case operation::TEST:
+			ret += "\t" + print_binary_op_intel_syntax(instruction) + "\n";
+			break;
+
 		case operation::LABEL:
 			ret += print_unary_op_intel_syntax(instruction) + "\n";
 			break;
@@ -1127,6 +1908,26 @@ bool is_add_instruction(const asm_instruction_pointer& inst,
 			are_equal_operands(inst->destination, destination);
 }
 
+bool is_sub_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type){
+
+	return	inst->op == operation::SUB &&
+			inst->ops_type == ops_type &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_pushq_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						data_type ops_type){
+
+	return	inst->op == operation::PUSHQ &&
+			inst->ops_type == ops_type &&
+			are_equal_operands(inst->source, source);
+}
+
 bool is_mul_instruction(const asm_instruction_pointer& inst,
 						const operand_pointer& source,
 						const operand_pointer& destination,
@@ -1183,6 +1984,104 @@ bool is_not_instruction(const asm_instruction_pointer& inst,
 			are_equal_operands(inst->destination, destination);
 }
 
+bool is_sar_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type){
+	return	inst->op == operation::SAR &&
+			inst->ops_type == ops_type &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_and_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type){
+	return	inst->op == operation::AND &&
+			inst->ops_type == ops_type &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_xor_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type){
+	return	inst->op == operation::XOR &&
+			inst->ops_type == ops_type &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_or_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type){
+	return	inst->op == operation::OR &&
+			inst->ops_type == ops_type &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_movzbl_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination){
+	return	inst->op == operation::MOVZBL &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_set_instruction(const asm_instruction_pointer& inst,
+						operation op,
+						const operand_pointer& destination){
+	return	inst->op == op &&
+			inst->source == nullptr &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_cltd_instruction(const asm_instruction_pointer& inst){
+	return inst->op == operation::CLTD;
+}
+
+bool is_widening_mul_instruction(const asm_instruction_pointer& inst,
+								const operand_pointer& source,
+								data_type ops_type,
+								bool is_signed){
+	return	inst->op == (is_signed ? operation::IMUL : operation::MUL) &&
+			inst->source == nullptr &&
+			inst->ops_type == ops_type &&
+			are_equal_operands(inst->destination, source);
+}
+
+bool is_shl_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type){
+	return	inst->op == operation::SHL &&
+			inst->ops_type == ops_type &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_movslq_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination){
+	return	inst->op == operation::MOVSLQ &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_lea_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type){
+	return	inst->op == operation::LEA &&
+			inst->ops_type == ops_type &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
 bool is_shr_instruction(const asm_instruction_pointer& inst,
 						const operand_pointer& source,
 						const operand_pointer& destination,
@@ -1256,6 +2155,97 @@ bool is_jge_instruction(const asm_instruction_pointer& inst,
 	return	ret;
 }
 
+bool is_ja_instruction(const asm_instruction_pointer& inst,
+						const std::string& label){
+	operand_pointer aux = new_label_operand(label);
+	bool ret = inst->op == operation::JA &&
+			are_equal_operands(inst->destination, aux);
+
+	return	ret;
+}
+
+bool is_jae_instruction(const asm_instruction_pointer& inst,
+						const std::string& label){
+	operand_pointer aux = new_label_operand(label);
+	bool ret = inst->op == operation::JAE &&
+			are_equal_operands(inst->destination, aux);
+
+	return	ret;
+}
+
+bool is_jp_instruction(const asm_instruction_pointer& inst,
+						const std::string& label){
+	operand_pointer aux = new_label_operand(label);
+	bool ret = inst->op == operation::JP &&
+			are_equal_operands(inst->destination, aux);
+
+	return	ret;
+}
+
+bool is_movss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination){
+	return	inst->op == operation::MOVSS &&
+			inst->ops_type == data_type::S &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_addss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination){
+	return	inst->op == operation::ADDSS &&
+			inst->ops_type == data_type::S &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_subss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination){
+	return	inst->op == operation::SUBSS &&
+			inst->ops_type == data_type::S &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_mulss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination){
+	return	inst->op == operation::MULSS &&
+			inst->ops_type == data_type::S &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_divss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination){
+	return	inst->op == operation::DIVSS &&
+			inst->ops_type == data_type::S &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_ucomiss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination){
+	return	inst->op == operation::UCOMISS &&
+			inst->ops_type == data_type::S &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
+bool is_cvtsi2ss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type){
+	return	inst->op == operation::CVTSI2SS &&
+			inst->ops_type == ops_type &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
 bool is_call_instruction(const asm_instruction_pointer& inst,
 						const std::string& label){
 	operand_pointer aux = new_label_operand(label);
@@ -1284,6 +2274,17 @@ bool is_cmp_instruction(const asm_instruction_pointer& inst,
 			are_equal_operands(inst->destination, destination);
 }
 
+bool is_test_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type){
+
+	return	inst->op == operation::TEST &&
+			inst->ops_type == ops_type &&
+			are_equal_operands(inst->source, source) &&
+			are_equal_operands(inst->destination, destination);
+}
+
 bool is_enter_instruction(const asm_instruction_pointer& inst,
 						const operand_pointer& source,
 						const operand_pointer& destination){
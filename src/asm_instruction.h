@@ -36,6 +36,8 @@ enum class register_id {
 	EBX,
 	ECX,
 	EDX,
+	ESI,
+	EDI,
 	R8D,
 	R9D,
 	R10D,
@@ -45,6 +47,12 @@ enum class register_id {
 	R14D,
 	R15D,
 	// 8-bits registers
+	AL,
+	BL,
+	CL,
+	DL,
+	SIL,
+	DIL,
 	R8B,
 	R9B,
 	R10B,
@@ -53,16 +61,38 @@ enum class register_id {
 	R13B,
 	R14B,
 	R15B,
+	// SSE registers (128-bits, only their low-order single-precision float
+	// is used)
+	XMM0,
+	XMM1,
+	XMM2,
+	XMM3,
+	XMM4,
+	XMM5,
+	XMM6,
+	XMM7,
+	XMM8,
+	XMM9,
+	XMM10,
+	XMM11,
+	XMM12,
+	XMM13,
+	XMM14,
+	XMM15,
 };
 
 enum class directive_type{
-    GLOBAL
+    GLOBAL,
+    SECTION, // Switches to the section named by the argument.
+    ALIGN, // Aligns the location counter to the argument (in bytes).
+    LONG // Emits the argument as a 32-bit value.
 };
 
 enum class operand_addressing {
 	IMMEDIATE, // Immediate value
 	REGISTER, // Register
 	MEMORY,   // Memory value
+	RIP_RELATIVE, // Memory value at a label, addressed relative to %rip
     DIRECTIVE, // The operand contains data about an assembler's directive,
                 // rather than data for an instruction.
 	NONE	  // For labels or other kind of data
@@ -128,6 +158,8 @@ struct operand {
             union{
                 // Label globally accesible.
                 std::string *global_label;
+                // Argument of the rest of the directives.
+                std::string *argument;
             } data;
         } dir;
 	} value;
@@ -150,20 +182,40 @@ enum class operation {
 	DIV,
 	SUB,
 	NEG,
-	// TODO: para que usamos esta instruccion?
 	SAR, // sar[b|w|l|q] imm,d -> d = d>>imm (arithmetic right shift: the
 		 // spaces are filled in such a way to preserve the sign of the number
 		 // being slid)
+	CLTD, // cltd -> %edx::%eax = sign extension of %eax (cdq, in Intel's
+		  // notation)
+
+	// Scalar single-precision floating point (SSE). The destination is
+	// always a %xmm register, but for movss.
+	MOVSS, // movss s,d -> d = s
+	ADDSS, // addss s,d -> d = d + s
+	SUBSS, // subss s,d -> d = d - s
+	MULSS, // mulss s,d -> d = d * s
+	DIVSS, // divss s,d -> d = d / s
+	UCOMISS, // ucomiss s,d set flags based on d - s, as an unsigned
+			 // comparison (ZF, PF and CF are set if any of them is NaN)
+	CVTSI2SS, // cvtsi2ss[l|q] s,d -> d = (float) s, being s an integer
 
 	// Logic
 	NOT,
 	SHR, // shr[b|w|l|q] imm,d -> d = d>>imm (logical right shift: the spaces
 		 // are always filled with zeros)
+	AND, // and[b|w|l|q] s,d -> d = s & d
+	OR, // or[b|w|l|q] s,d -> d = s | d
+	XOR, // xor[b|w|l|q] s,d -> d = s ^ d
+	SHL, // shl[b|w|l|q] imm,d -> d = d<<imm
 
 	// Data transfer
 	MOV,
+	MOVSLQ, // movslq s,d -> d = sign extension of the 32-bit s, into the
+			// 64-bit register d
 	LEA,
 	PUSHQ,
+	MOVZBL, // movzbl s,d -> d = zero extension of the byte s, into the
+			// 32-bit register d
 
 	// Control transfer
 	JMP, // Unconditional jump
@@ -173,12 +225,28 @@ enum class operation {
 	JLE, // Jump if less or equal
 	JG,  // Jump if greater
 	JGE, // Jump if greater of equal
+	JA,  // Jump if above (unsigned >)
+	JAE, // Jump if above or equal (unsigned >=)
+	JP,  // Jump if parity (unordered, after ucomiss)
 	CALL,
 	LEAVE,
 	RET,
 
 	// Data comparison
 	CMP, // CMP s1, s2 set flags based on s 1 − s 2
+	TEST, // TEST s1, s2 set flags based on s1 & s2 (OF and CF are cleared)
+	// set<cc> d -> d = 1 if the condition holds for the flags, 0 otherwise,
+	// being d a byte. Conditions are those of the jumps.
+	SETE,
+	SETNE,
+	SETL,
+	SETLE,
+	SETG,
+	SETGE,
+	SETA,
+	SETAE,
+	SETP,
+	SETNP,
 
 	// Misc
 	ENTER,
@@ -205,14 +273,44 @@ class asm_instructions_list : public std::vector<asm_instruction_pointer> {};
  ******************************************************************/
 operand_pointer new_register_operand(register_id);
 
+/* Returns the 32-bit register contained into the 64-bit register reg (e.g.:
+ * %edi for %rdi), or register_id::NONE if there is none. */
+register_id get_register32(register_id reg);
+
+/* Returns the 64-bit register that contains the 32-bit register reg (e.g.:
+ * %rdi for %edi), or register_id::NONE if there is none. */
+register_id get_register64(register_id reg);
+
+/* Returns the 8-bit register contained into the 64-bit or 32-bit register
+ * reg (e.g.: %dil for %rdi or %edi), or register_id::NONE if there is none. */
+register_id get_register8(register_id reg);
+
 operand_pointer new_immediate_integer_operand(int);
+
+/* Immediate single-precision float: it can only be moved into general
+ * purpose registers or memory, and it is printed as its bit pattern. */
 operand_pointer new_immediate_float_operand(float);
 
+// Bit pattern of value, as an IEEE 754 single-precision float.
+unsigned int get_float_bits(float value);
+
+// Is reg one of the SSE registers?
+bool is_xmm_register(register_id reg);
+
 /////////////////////////////
 // @ASSEMBLER'S DIRECTIVE
 /////////////////////////////
 asm_instruction_pointer new_global_directive(std::string);
 
+// .section name
+asm_instruction_pointer new_section_directive(std::string name);
+
+// .align bytes
+asm_instruction_pointer new_align_directive(unsigned int bytes);
+
+// .long value
+asm_instruction_pointer new_long_directive(unsigned int value);
+
 /////////////////////////////
 // @OPERAND
 /////////////////////////////
@@ -233,6 +331,9 @@ int get_memory_operand_offset(const operand_pointer& operand);
 
 operand_pointer new_label_operand(std::string label);
 
+// Memory operand at label(%rip).
+operand_pointer new_rip_relative_operand(std::string label);
+
 /******************************************************************
  * Constructors of instructions.
  ******************************************************************/
@@ -244,12 +345,60 @@ asm_instruction_pointer new_lea_instruction(const operand_pointer& source,
 											const operand_pointer& destination,
 											data_type ops_type);
 
+/* PRE : {destination is a 64-bit register, and source is a 32-bit register
+ * or memory} */
+asm_instruction_pointer new_movslq_instruction(const operand_pointer& source,
+											const operand_pointer& destination);
+
+/* PRE : {destination is a 32-bit register, and source is an 8-bit register
+ * or memory} */
+asm_instruction_pointer new_movzbl_instruction(const operand_pointer& source,
+											const operand_pointer& destination);
+
+/* Three-operand form of lea: destination = base + index * scale, with a
+ * single instruction that doesn't modify the flags.
+ * PRE : {scale is 1, 2, 4 or 8, and base and index are 64-bit registers (or
+ * base is register_id::NONE)} */
+asm_instruction_pointer new_scaled_lea_instruction(register_id base,
+												register_id index,
+												unsigned int scale,
+												const operand_pointer& destination,
+												data_type ops_type);
+
 asm_instruction_pointer new_shr_instruction(const operand_pointer& imm,
 											const operand_pointer& destination,
 											data_type ops_type);
 
+asm_instruction_pointer new_shl_instruction(const operand_pointer& imm,
+											const operand_pointer& destination,
+											data_type ops_type);
+
+asm_instruction_pointer new_sar_instruction(const operand_pointer& imm,
+											const operand_pointer& destination,
+											data_type ops_type);
+
+asm_instruction_pointer new_and_instruction(const operand_pointer& source,
+											const operand_pointer& destination,
+											data_type ops_type);
+
+asm_instruction_pointer new_xor_instruction(const operand_pointer& source,
+											const operand_pointer& destination,
+											data_type ops_type);
+
+asm_instruction_pointer new_or_instruction(const operand_pointer& source,
+											const operand_pointer& destination,
+											data_type ops_type);
+
 asm_instruction_pointer new_div_instruction(const operand_pointer&, data_type, bool);
 
+asm_instruction_pointer new_cltd_instruction();
+
+/* One-operand form of the multiplication: %edx::%eax = %eax * source (for
+ * ops_type == data_type::L). */
+asm_instruction_pointer new_widening_mul_instruction(const operand_pointer& source,
+													data_type ops_type,
+													bool is_signed);
+
 asm_instruction_pointer new_mul_instruction(const operand_pointer& source,
 											const operand_pointer& destination,
 											data_type ops_type,
@@ -273,6 +422,10 @@ asm_instruction_pointer new_cmp_instruction(const operand_pointer&,
 											const operand_pointer&,
 											data_type);
 
+asm_instruction_pointer new_test_instruction(const operand_pointer&,
+											const operand_pointer&,
+											data_type);
+
 asm_instruction_pointer new_jmp_instruction(std::string);
 
 asm_instruction_pointer new_je_instruction(std::string);
@@ -287,6 +440,18 @@ asm_instruction_pointer new_jg_instruction(std::string);
 
 asm_instruction_pointer new_jge_instruction(std::string);
 
+asm_instruction_pointer new_ja_instruction(std::string);
+
+asm_instruction_pointer new_jae_instruction(std::string);
+
+asm_instruction_pointer new_jp_instruction(std::string);
+
+/* set<cc> destination, being op one of operation::SETE, ...,
+ * operation::SETNP.
+ * PRE : {destination is an 8-bit register or memory} */
+asm_instruction_pointer new_set_instruction(operation op,
+											const operand_pointer& destination);
+
 asm_instruction_pointer new_call_instruction(std::string);
 
 asm_instruction_pointer new_leave_instruction();
@@ -301,6 +466,34 @@ asm_instruction_pointer new_enter_instruction(const operand_pointer& stack_space
 asm_instruction_pointer new_pushq_instruction(const operand_pointer& source,
 												data_type ops_type);
 
+/* Scalar single-precision instructions (ops_type is data_type::S).
+ * PRE : {destination is a %xmm register (or memory, for movss), and source
+ * is a %xmm register or memory} */
+asm_instruction_pointer new_movss_instruction(const operand_pointer& source,
+											const operand_pointer& destination);
+
+asm_instruction_pointer new_addss_instruction(const operand_pointer& source,
+											const operand_pointer& destination);
+
+asm_instruction_pointer new_subss_instruction(const operand_pointer& source,
+											const operand_pointer& destination);
+
+asm_instruction_pointer new_mulss_instruction(const operand_pointer& source,
+											const operand_pointer& destination);
+
+asm_instruction_pointer new_divss_instruction(const operand_pointer& source,
+											const operand_pointer& destination);
+
+asm_instruction_pointer new_ucomiss_instruction(const operand_pointer& source,
+												const operand_pointer& destination);
+
+/* Conversion of the signed integer source, of type ops_type, into a float.
+ * PRE : {destination is a %xmm register, and source is a general purpose
+ * register or memory} */
+asm_instruction_pointer new_cvtsi2ss_instruction(const operand_pointer& source,
+												const operand_pointer& destination,
+												data_type ops_type);
+
 /******************************************************************
  * Printing
  ******************************************************************/
@@ -327,6 +520,15 @@ bool is_add_instruction(const asm_instruction_pointer& inst,
 						const operand_pointer& destination,
 						data_type ops_type);
 
+bool is_sub_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type);
+
+bool is_pushq_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						data_type ops_type);
+
 bool is_mul_instruction(const asm_instruction_pointer& inst,
 						const operand_pointer& source,
 						const operand_pointer& destination,
@@ -347,10 +549,59 @@ bool is_shr_instruction(const asm_instruction_pointer& inst,
 						const operand_pointer& destination,
 						data_type ops_type);
 
+bool is_shl_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type);
+
+bool is_movslq_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination);
+
+bool is_lea_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type);
+
 bool is_not_instruction(const asm_instruction_pointer& inst,
 						const operand_pointer& destination,
 						data_type ops_type);
 
+bool is_sar_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type);
+
+bool is_and_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type);
+
+bool is_xor_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type);
+
+bool is_or_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type);
+
+bool is_movzbl_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination);
+
+bool is_set_instruction(const asm_instruction_pointer& inst,
+						operation op,
+						const operand_pointer& destination);
+
+bool is_cltd_instruction(const asm_instruction_pointer& inst);
+
+bool is_widening_mul_instruction(const asm_instruction_pointer& inst,
+								const operand_pointer& source,
+								data_type ops_type,
+								bool is_signed);
+
 // TODO: acá sí puede tener sentido el pasar por referencia los strings.
 bool is_jmp_instruction(const asm_instruction_pointer& inst,
 						const std::string& label);
@@ -373,6 +624,44 @@ bool is_jg_instruction(const asm_instruction_pointer& inst,
 bool is_jge_instruction(const asm_instruction_pointer& inst,
 						const std::string& label);
 
+bool is_ja_instruction(const asm_instruction_pointer& inst,
+						const std::string& label);
+
+bool is_jae_instruction(const asm_instruction_pointer& inst,
+						const std::string& label);
+
+bool is_jp_instruction(const asm_instruction_pointer& inst,
+						const std::string& label);
+
+bool is_movss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination);
+
+bool is_addss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination);
+
+bool is_subss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination);
+
+bool is_mulss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination);
+
+bool is_divss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination);
+
+bool is_ucomiss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination);
+
+bool is_cvtsi2ss_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type);
+
 bool is_call_instruction(const asm_instruction_pointer& inst,
 						const std::string& label);
 
@@ -385,6 +674,11 @@ bool is_cmp_instruction(const asm_instruction_pointer& inst,
 						const operand_pointer& destination,
 						data_type ops_type);
 
+bool is_test_instruction(const asm_instruction_pointer& inst,
+						const operand_pointer& source,
+						const operand_pointer& destination,
+						data_type ops_type);
+
 bool is_enter_instruction(const asm_instruction_pointer& inst,
 						const operand_pointer& source,
 						const operand_pointer& destination);
@@ -392,6 +686,8 @@ bool is_enter_instruction(const asm_instruction_pointer& inst,
 bool is_label_instruction(const asm_instruction_pointer& inst,
 						const std::string& label);
 
+bool are_equal_operands(const operand_pointer&, const operand_pointer&);
+
 bool are_equal_instructions(const asm_instruction_pointer&,
 							const asm_instruction_pointer&);
 
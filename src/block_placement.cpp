@@ -0,0 +1,410 @@
+#include <algorithm>
+#include <cmath>
+#include "block_placement.h"
+#include "register_allocation.h"
+
+/////////////////////////
+// @AUXILIARY
+/////////////////////////
+// Last quad of block.
+const quad_pointer& get_block_last_quad(const control_flow_graph& cfg,
+										unsigned int block){
+	return cfg.get_method()[cfg.get_block(block).last - 1];
+}
+
+/* Block to which the jump that ends block goes, or UNDEFINED_BLOCK if it
+ * doesn't end with a jump (or it jumps out of the method). */
+int get_layout_jump_block(const control_flow_graph& cfg, unsigned int block){
+	const quad_pointer& last = get_block_last_quad(cfg, block);
+
+	switch(get_inst_type(last)){
+		case quad_type::UNCONDITIONAL_JUMP:
+			return cfg.get_label_block(get_unconditional_jmp_label(last));
+
+		case quad_type::CONDITIONAL_JUMP:
+			return cfg.get_label_block(get_conditional_jmp_label(last));
+
+		case quad_type::RELATIONAL_JUMP:
+			return cfg.get_label_block(get_relational_jmp_label(last));
+
+		default:
+			return UNDEFINED_BLOCK;
+	}
+}
+
+/* Does control reach the end of block, when it doesn't jump? (That is, it
+ * doesn't end with a goto or a return). */
+bool falls_off_block(const control_flow_graph& cfg, unsigned int block){
+	quad_type type = get_inst_type(get_block_last_quad(cfg, block));
+
+	return type != quad_type::UNCONDITIONAL_JUMP and
+		   type != quad_type::RETURN;
+}
+
+/* Block into which block falls through, or UNDEFINED_BLOCK if it doesn't
+ * (or it is the last one). */
+int get_layout_fall_block(const control_flow_graph& cfg, unsigned int block){
+	int ret = UNDEFINED_BLOCK;
+
+	if(block + 1 < cfg.size() and falls_off_block(cfg, block)){
+		ret = block + 1;
+	}
+
+	return ret;
+}
+
+bool is_conditional_layout_jump(const quad_pointer& instruction){
+	return get_inst_type(instruction) == quad_type::CONDITIONAL_JUMP or
+		   get_inst_type(instruction) == quad_type::RELATIONAL_JUMP;
+}
+
+// Does the block begin with a label, other than the label of the method?
+bool has_block_label(const control_flow_graph& cfg, unsigned int block){
+	const quad_pointer& first = cfg.get_method()[cfg.get_block(block).first];
+
+	return get_inst_type(first) == quad_type::LABEL and
+		   not is_method_label_inst(first);
+}
+
+bool is_loop_block(const natural_loop& loop, unsigned int block){
+	return std::binary_search(loop.blocks.begin(), loop.blocks.end(), block);
+}
+
+// Is block the header of a loop that doesn't contain from?
+bool enters_loop(const control_flow_graph& cfg,
+				unsigned int from,
+				unsigned int block){
+	const std::vector<natural_loop>& loops = cfg.get_loops();
+
+	for(unsigned int l = 0; l < loops.size(); l++){
+		if(loops[l].header == block and not is_loop_block(loops[l], from)){
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/* Probability that the conditional jump of block, to target, is taken,
+ * being fall the block into which it falls through.
+ * PRE : {target != fall} */
+double get_static_taken_probability(const control_flow_graph& cfg,
+									unsigned int block,
+									unsigned int target,
+									unsigned int fall){
+	const basic_block& b = cfg.get_block(block);
+
+	// Loop branch.
+	if(b.loop != -1){
+		const natural_loop& loop = cfg.get_loops()[b.loop];
+		bool stays_on_target = is_loop_block(loop, target);
+
+		if(stays_on_target != is_loop_block(loop, fall)){
+			return stays_on_target ? LOOP_BRANCH_PROBABILITY :
+									 1 - LOOP_BRANCH_PROBABILITY;
+		}
+	}
+
+	// Loop header.
+	bool enters_on_target = enters_loop(cfg, block, target);
+
+	if(enters_on_target != enters_loop(cfg, block, fall)){
+		return enters_on_target ? LOOP_HEADER_PROBABILITY :
+								  1 - LOOP_HEADER_PROBABILITY;
+	}
+
+	// Return.
+	bool returns_on_target = get_inst_type(get_block_last_quad(cfg, target)) ==
+							 quad_type::RETURN;
+
+	if(returns_on_target != (get_inst_type(get_block_last_quad(cfg, fall)) ==
+							 quad_type::RETURN)){
+		return returns_on_target ? 1 - RETURN_BRANCH_PROBABILITY :
+								   RETURN_BRANCH_PROBABILITY;
+	}
+
+	return 0.5;
+}
+
+/* Adds to edges the edges that leave block, executed executions times. If it
+ * ends with a conditional jump, it is taken taken times, and falls through
+ * fallen times. */
+void add_layout_edges(const control_flow_graph& cfg,
+					unsigned int block,
+					double executions,
+					double taken,
+					double fallen,
+					std::vector<layout_edge>& edges){
+	int target = get_layout_jump_block(cfg, block);
+	int fall = get_layout_fall_block(cfg, block);
+
+	if(target != UNDEFINED_BLOCK and fall != UNDEFINED_BLOCK and
+	target != fall){
+		edges.push_back({block, (unsigned int) target, taken, false});
+		edges.push_back({block, (unsigned int) fall, fallen, true});
+	}
+	else if(fall != UNDEFINED_BLOCK){
+		edges.push_back({block, (unsigned int) fall, executions, true});
+	}
+	else if(target != UNDEFINED_BLOCK){
+		edges.push_back({block, (unsigned int) target, executions, false});
+	}
+}
+
+// Does a over b, when edges are visited by chain_blocks?
+bool precedes_layout_edge(const layout_edge& a, const layout_edge& b){
+	return a.weight > b.weight or
+		   (a.weight == b.weight and a.falls_through and not b.falls_through);
+}
+
+/* Inverts the conditional jump, so it jumps to label when it wouldn't have
+ * jumped. */
+quad_pointer invert_layout_jump(const quad_pointer& jump,
+								const address_pointer& label){
+	if(get_inst_type(jump) == quad_type::CONDITIONAL_JUMP){
+		return new_conditional_jump_inst(get_conditional_jmp_guard(jump),
+										label,
+										get_inst_op(jump) ==
+										quad_oper::IFTRUE ?
+										quad_oper::IFFALSE :
+										quad_oper::IFTRUE);
+	}
+
+	// {get_inst_type(jump) == quad_type::RELATIONAL_JUMP}
+	return new_relational_jump_inst(jump->arg1,
+									jump->arg2,
+									get_negated_relop(get_inst_op(jump)),
+									label);
+}
+
+/////////////////////////
+// @INTERFACE
+/////////////////////////
+std::vector<layout_edge> estimate_edge_weights(const control_flow_graph& cfg){
+	std::vector<layout_edge> ret;
+
+	for(unsigned int b = 0; b < cfg.size(); b++){
+		double executions = 0;
+		double taken = 0;
+
+		if(cfg.is_reachable(b)){
+			executions = std::pow(LOOP_USE_WEIGHT,
+								std::min(cfg.get_block(b).loop_depth,
+										(unsigned int)MAX_WEIGHTED_LOOP_DEPTH));
+		}
+
+		int target = get_layout_jump_block(cfg, b);
+		int fall = get_layout_fall_block(cfg, b);
+
+		if(target != UNDEFINED_BLOCK and fall != UNDEFINED_BLOCK and
+		target != fall){
+			taken = executions * get_static_taken_probability(cfg, b, target,
+															fall);
+		}
+		add_layout_edges(cfg, b, executions, taken, executions - taken, ret);
+	}
+
+	return ret;
+}
+
+std::vector<layout_edge> get_profiled_edge_weights(
+											const control_flow_graph& cfg,
+											const execution_profile& profile,
+											const std::string& method_label){
+	std::vector<double> executions(cfg.size(), 0);
+	std::vector<layout_edge> ret;
+
+	executions[0] = get_block_count(profile, method_label, method_label);
+	for(unsigned int b = 1; b < cfg.size(); b++){
+		if(has_block_label(cfg, b)){
+			executions[b] = get_block_count(profile, method_label,
+							get_label_inst_label(
+								cfg.get_method()[cfg.get_block(b).first]));
+		}
+	}
+
+	for(unsigned int b = 0; b < cfg.size(); b++){
+		int target = get_layout_jump_block(cfg, b);
+		int fall = get_layout_fall_block(cfg, b);
+		double taken = 0;
+		double fallen = executions[b];
+
+		if(target != UNDEFINED_BLOCK and fall != UNDEFINED_BLOCK and
+		target != fall){
+			taken = std::min(executions[b], executions[target]);
+			fallen = executions[b] - taken;
+			if(has_block_label(cfg, fall)){
+				fallen = std::min(executions[b], executions[fall]);
+			}
+		}
+
+		if(fall != UNDEFINED_BLOCK and not has_block_label(cfg, fall)){
+			// {b is the only predecessor of fall}
+			executions[fall] = fallen;
+		}
+		add_layout_edges(cfg, b, executions[b], taken, fallen, ret);
+	}
+
+	return ret;
+}
+
+std::vector<unsigned int> chain_blocks(const control_flow_graph& cfg,
+									const std::vector<layout_edge>& edges){
+	std::vector<std::vector<unsigned int> > chains(cfg.size());
+	std::vector<unsigned int> chain_of(cfg.size());
+	std::vector<layout_edge> sorted = edges;
+	std::vector<unsigned int> ret;
+
+	for(unsigned int b = 0; b < cfg.size(); b++){
+		chains[b].push_back(b);
+		chain_of[b] = b;
+	}
+
+	std::stable_sort(sorted.begin(), sorted.end(), precedes_layout_edge);
+	for(std::vector<layout_edge>::const_iterator it = sorted.begin();
+	it != sorted.end(); ++it){
+		unsigned int source = chain_of[it->source];
+		unsigned int target = chain_of[it->target];
+
+		if(it->target == 0 or source == target or
+		chains[source].back() != it->source or
+		chains[target].front() != it->target){
+			continue;
+		}
+
+		for(std::vector<unsigned int>::const_iterator b =
+		chains[target].begin(); b != chains[target].end(); ++b){
+			chains[source].push_back(*b);
+			chain_of[*b] = source;
+		}
+		chains[target].clear();
+	}
+
+	// {chains[0] begins with the entry block, and each remaining chain is at
+	//  the position of the block that begins it}
+	unsigned int last = cfg.size() - 1;
+	bool keeps_last = falls_off_block(cfg, last);
+
+	for(unsigned int c = 0; c < chains.size(); c++){
+		for(std::vector<unsigned int>::const_iterator b = chains[c].begin();
+		b != chains[c].end(); ++b){
+			if(not keeps_last or *b != last){
+				ret.push_back(*b);
+			}
+		}
+	}
+	if(keeps_last){
+		ret.push_back(last);
+	}
+
+	return ret;
+}
+
+unsigned int apply_block_layout(instructions_list& method,
+								const std::vector<unsigned int>& order,
+								ids_info& ids){
+	instructions_list original = method;
+	control_flow_graph cfg(original);
+
+	// PRE
+	#ifdef __DEBUG
+		assert(order.size() == cfg.size() and order[0] == 0);
+	#endif
+
+	std::vector<address_pointer> labels(cfg.size(), nullptr);
+	std::vector<bool> new_labels(cfg.size(), false);
+	unsigned int ret = 0;
+
+	// Labels of the blocks that will be reached by a new jump.
+	for(unsigned int i = 0; i < order.size(); i++){
+		int fall = get_layout_fall_block(cfg, order[i]);
+
+		if(fall != UNDEFINED_BLOCK and
+		(i + 1 == order.size() or order[i + 1] != (unsigned int) fall)){
+			if(has_block_label(cfg, fall)){
+				labels[fall] = original[cfg.get_block(fall).first]->arg1;
+			}
+			else if(labels[fall] == nullptr){
+				labels[fall] = new_label_address(*ids.new_temp(0,
+																T_UNDEFINED));
+				new_labels[fall] = true;
+			}
+		}
+	}
+
+	method.clear();
+	for(unsigned int i = 0; i < order.size(); i++){
+		unsigned int b = order[i];
+		const basic_block& block = cfg.get_block(b);
+		const quad_pointer& last = original[block.last - 1];
+		int next = i + 1 < order.size() ? (int) order[i + 1] : UNDEFINED_BLOCK;
+		int target = get_layout_jump_block(cfg, b);
+		int fall = get_layout_fall_block(cfg, b);
+
+		if(i > 0 and b != order[i - 1] + 1){
+			ret++;
+		}
+		if(new_labels[b]){
+			method.push_back(new_label_inst(labels[b]));
+		}
+		for(unsigned int q = block.first; q + 1 < block.last; q++){
+			method.push_back(original[q]);
+		}
+
+		if(get_inst_type(last) == quad_type::UNCONDITIONAL_JUMP and
+		target != UNDEFINED_BLOCK and target == next){
+			// goto L; L:
+			ret++;
+		}
+		else if(fall != UNDEFINED_BLOCK and fall != next and
+		is_conditional_layout_jump(last) and target != UNDEFINED_BLOCK and
+		target == next){
+			// if c goto T; goto F; T:
+			method.push_back(invert_layout_jump(last, labels[fall]));
+			ret++;
+		}
+		else{
+			method.push_back(last);
+			if(fall != UNDEFINED_BLOCK and fall != next){
+				method.push_back(new_unconditional_jump_inst(labels[fall]));
+				ret++;
+			}
+		}
+	}
+
+	return ret;
+}
+
+unsigned int place_blocks(instructions_list& method, ids_info& ids){
+	if(method.empty() or not is_method_label_inst(method[0])){
+		return 0;
+	}
+
+	std::vector<unsigned int> order;
+	{
+		control_flow_graph cfg(method);
+
+		order = chain_blocks(cfg, estimate_edge_weights(cfg));
+	}
+
+	return apply_block_layout(method, order, ids);
+}
+
+unsigned int place_blocks_with_profile(instructions_list& method,
+										ids_info& ids,
+										const execution_profile& profile){
+	if(method.empty() or not is_method_label_inst(method[0])){
+		return 0;
+	}
+
+	std::vector<unsigned int> order;
+	{
+		control_flow_graph cfg(method);
+
+		order = chain_blocks(cfg,
+							get_profiled_edge_weights(cfg, profile,
+											get_label_inst_label(method[0])));
+	}
+
+	return apply_block_layout(method, order, ids);
+}
@@ -0,0 +1,105 @@
+#ifndef BLOCK_PLACEMENT_H_
+#define BLOCK_PLACEMENT_H_
+
+#include <string>
+#include <vector>
+#include "three_address_code.h"
+#include "intermediate_symtable.h"
+#include "control_flow_graph.h"
+#include "profile.h"
+
+/* Bibliography adopted:
+ * [1] "Profile Guided Code Positioning", Karl Pettis and Robert C. Hansen.
+ * 		PLDI 1990. Section 4: "Basic block positioning".
+ *
+ * [2] "Branch Prediction for Free", Thomas Ball and James R. Larus. PLDI
+ * 		1993.
+ *
+ * [3] "Static Branch Frequency and Program Profile Analysis", Youfeng Wu and
+ * 		James R. Larus. MICRO 27, 1994. Table 1: probabilities of the
+ * 		heuristics of [2].
+ * */
+
+// Probabilities of the successors favoured by the static heuristics ([3]).
+#define LOOP_BRANCH_PROBABILITY 0.88
+#define LOOP_HEADER_PROBABILITY 0.75
+#define RETURN_BRANCH_PROBABILITY 0.72
+
+// An edge of the control-flow graph, weighted by its expected executions.
+struct layout_edge {
+	unsigned int source;
+	unsigned int target;
+	double weight;
+	bool falls_through; // Is target the block that follows source?
+};
+
+/* Estimates the weights of the edges of cfg without a profile. A block is
+ * expected to execute LOOP_USE_WEIGHT^d times, being d its loop nesting depth
+ * (up to MAX_WEIGHTED_LOOP_DEPTH), and unreachable blocks never. That weight
+ * is split between the two successors of a conditional jump by the first
+ * heuristic of [2] that tells them apart:
+ * 		_ loop branch: the successor that stays into the innermost loop of
+ * 		the block (taking the back edge, or not exiting) is taken with
+ * 		probability LOOP_BRANCH_PROBABILITY.
+ *
+ * 		_ loop header: the successor that enters a loop is taken with
+ * 		probability LOOP_HEADER_PROBABILITY.
+ *
+ * 		_ return: the successor that doesn't return is taken with probability
+ * 		RETURN_BRANCH_PROBABILITY.
+ * Otherwise, each one is taken half of the times. */
+std::vector<layout_edge> estimate_edge_weights(const control_flow_graph& cfg);
+
+/* Weights of the edges of cfg, the graph of method method_label, by the
+ * executions of its labels into profile (the label of the method counts the
+ * calls to it). Blocks without a label are only entered by falling through,
+ * so they execute what their predecessor doesn't jump away. For a
+ * conditional jump, the taken edge is estimated as the least of the
+ * executions of its block and of the target (as the fall-through edge, when
+ * it begins with a label). Labels added after the profile was taken count as
+ * never executed. */
+std::vector<layout_edge> get_profiled_edge_weights(
+											const control_flow_graph& cfg,
+											const execution_profile& profile,
+											const std::string& method_label);
+
+/* Orders the blocks of cfg into chains, following [1]: each block begins as
+ * a chain of its own, and edges are visited by decreasing weight (on ties,
+ * fall-through edges first, and then in the order of their source), joining
+ * the chain that ends with the source of an edge with the one that begins
+ * with its target. The entry block stays at the beginning, and the chain
+ * that begins with it goes first; the others follow in the order of the
+ * blocks that begin them. A last block that falls off the end of the method
+ * is kept at the end. */
+std::vector<unsigned int> chain_blocks(const control_flow_graph& cfg,
+									const std::vector<layout_edge>& edges);
+
+/* Rewrites method with its blocks (those of its control-flow graph) in
+ * order, keeping the flow of control:
+ * 		_ a block whose fall-through successor doesn't follow it anymore, gets
+ * 		a goto to it (labelling the successor if needed, with a new label).
+ *
+ * 		_ if c goto T; goto F; T: becomes if not c goto F (negating the
+ * 		relational operator, or swapping if and ifFalse).
+ *
+ * 		_ goto L; L: drops the goto.
+ * Returns the number of blocks placed after a block other than their
+ * original predecessor, plus the jumps added, inverted and removed.
+ * PRE : {order is a permutation of the blocks of method, that begins with
+ * 		  the entry block} */
+unsigned int apply_block_layout(instructions_list& method,
+								const std::vector<unsigned int>& order,
+								ids_info& ids);
+
+/* Places the blocks of method so the likely successor of each branch, by
+ * estimate_edge_weights, is reached by falling through, and the blocks of
+ * loops stay together. Returns what apply_block_layout does.
+ * PRE : {method is the code of a single method, out of SSA form} */
+unsigned int place_blocks(instructions_list& method, ids_info& ids);
+
+// The same as place_blocks, weighting edges by profile.
+unsigned int place_blocks_with_profile(instructions_list& method,
+										ids_info& ids,
+										const execution_profile& profile);
+
+#endif // BLOCK_PLACEMENT_H_
@@ -0,0 +1,764 @@
+#include <climits>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include "constant_propagation.h"
+#include "control_flow_graph.h"
+#include "ssa.h"
+
+/////////////////////////
+// @FOLDING
+/////////////////////////
+bool is_constant_operand(const address_pointer& operand){
+	return operand != nullptr &&
+		   get_address_type(operand) == address_type::ADDRESS_CONSTANT;
+}
+
+/* Integer arithmetic, wrapping around on overflow. */
+int wrap_integer_operation(quad_oper op, int x, int y){
+	unsigned int ux = (unsigned int)x;
+	unsigned int uy = (unsigned int)y;
+	unsigned int ret;
+
+	switch(op){
+		case quad_oper::PLUS:
+			ret = ux + uy;
+			break;
+
+		case quad_oper::MINUS:
+			ret = ux - uy;
+			break;
+
+		default:
+			// {op == quad_oper::TIMES}
+			#ifdef __DEBUG
+				assert(op == quad_oper::TIMES);
+			#endif
+			ret = ux * uy;
+	}
+
+	return (int)ret;
+}
+
+address_pointer fold_integer_operation(quad_oper op, int x, int y){
+	address_pointer ret = nullptr;
+
+	switch(op){
+		case quad_oper::PLUS:
+		case quad_oper::MINUS:
+		case quad_oper::TIMES:
+			ret = new_integer_constant(wrap_integer_operation(op, x, y));
+			break;
+
+		case quad_oper::DIVIDE:
+			if(y != 0 && !(x == INT_MIN && y == -1)){
+				ret = new_integer_constant(x / y);
+			}
+			break;
+
+		case quad_oper::MOD:
+			if(y != 0 && !(x == INT_MIN && y == -1)){
+				ret = new_integer_constant(x % y);
+			}
+			break;
+
+		case quad_oper::LESS:
+			ret = new_boolean_constant(x < y);
+			break;
+
+		case quad_oper::LESS_EQUAL:
+			ret = new_boolean_constant(x <= y);
+			break;
+
+		case quad_oper::GREATER:
+			ret = new_boolean_constant(x > y);
+			break;
+
+		case quad_oper::GREATER_EQUAL:
+			ret = new_boolean_constant(x >= y);
+			break;
+
+		case quad_oper::EQUAL:
+			ret = new_boolean_constant(x == y);
+			break;
+
+		case quad_oper::DISTINCT:
+			ret = new_boolean_constant(x != y);
+			break;
+
+		default:
+			break;
+	}
+
+	return ret;
+}
+
+address_pointer fold_float_operation(quad_oper op, float x, float y){
+	address_pointer ret = nullptr;
+
+	switch(op){
+		case quad_oper::PLUS:
+			ret = new_float_constant(x + y);
+			break;
+
+		case quad_oper::MINUS:
+			ret = new_float_constant(x - y);
+			break;
+
+		case quad_oper::TIMES:
+			ret = new_float_constant(x * y);
+			break;
+
+		case quad_oper::DIVIDE:
+			if(y != 0){
+				ret = new_float_constant(x / y);
+			}
+			break;
+
+		case quad_oper::LESS:
+			ret = new_boolean_constant(x < y);
+			break;
+
+		case quad_oper::LESS_EQUAL:
+			ret = new_boolean_constant(x <= y);
+			break;
+
+		case quad_oper::GREATER:
+			ret = new_boolean_constant(x > y);
+			break;
+
+		case quad_oper::GREATER_EQUAL:
+			ret = new_boolean_constant(x >= y);
+			break;
+
+		case quad_oper::EQUAL:
+			ret = new_boolean_constant(x == y);
+			break;
+
+		case quad_oper::DISTINCT:
+			ret = new_boolean_constant(x != y);
+			break;
+
+		default:
+			break;
+	}
+
+	return ret;
+}
+
+address_pointer fold_boolean_operation(quad_oper op, bool x, bool y){
+	address_pointer ret = nullptr;
+
+	switch(op){
+		case quad_oper::AND:
+			ret = new_boolean_constant(x && y);
+			break;
+
+		case quad_oper::OR:
+			ret = new_boolean_constant(x || y);
+			break;
+
+		case quad_oper::EQUAL:
+			ret = new_boolean_constant(x == y);
+			break;
+
+		case quad_oper::DISTINCT:
+			ret = new_boolean_constant(x != y);
+			break;
+
+		default:
+			break;
+	}
+
+	return ret;
+}
+
+address_pointer fold_binary_operation(quad_oper op,
+									const address_pointer& x,
+									const address_pointer& y){
+	address_pointer ret = nullptr;
+
+	if(is_constant_operand(x) && is_constant_operand(y) &&
+	get_constant_address_type(x) == get_constant_address_type(y)){
+		switch(get_constant_address_type(x)){
+			case value_type::INTEGER:
+				ret = fold_integer_operation(op,
+										get_constant_address_integer_value(x),
+										get_constant_address_integer_value(y));
+				break;
+
+			case value_type::FLOAT:
+				ret = fold_float_operation(op,
+										get_constant_address_float_value(x),
+										get_constant_address_float_value(y));
+				break;
+
+			case value_type::BOOLEAN:
+				ret = fold_boolean_operation(op,
+										get_constant_address_boolean_value(x),
+										get_constant_address_boolean_value(y));
+				break;
+
+			default:
+				// {get_constant_address_type(x) == value_type::STRING}
+				break;
+		}
+	}
+
+	return ret;
+}
+
+address_pointer fold_unary_operation(quad_oper op, const address_pointer& x){
+	address_pointer ret = nullptr;
+
+	if(is_constant_operand(x)){
+		value_type type = get_constant_address_type(x);
+
+		if(op == quad_oper::NEGATIVE && type == value_type::INTEGER){
+			ret = new_integer_constant(wrap_integer_operation(quad_oper::MINUS,
+								0, get_constant_address_integer_value(x)));
+		}
+		else if(op == quad_oper::NEGATIVE && type == value_type::FLOAT){
+			ret = new_float_constant(-get_constant_address_float_value(x));
+		}
+		else if(op == quad_oper::NEGATION && type == value_type::BOOLEAN){
+			ret = new_boolean_constant(!get_constant_address_boolean_value(x));
+		}
+	}
+
+	return ret;
+}
+
+/* Returns the label to which jump transfers control. */
+address_pointer get_jump_target(const quad_pointer& jump){
+	address_pointer ret;
+
+	switch(get_inst_type(jump)){
+		case quad_type::UNCONDITIONAL_JUMP:
+			ret = jump->arg1;
+			break;
+
+		case quad_type::CONDITIONAL_JUMP:
+			ret = jump->arg2;
+			break;
+
+		default:
+			// {get_inst_type(jump) == quad_type::RELATIONAL_JUMP}
+			#ifdef __DEBUG
+				assert(get_inst_type(jump) == quad_type::RELATIONAL_JUMP);
+			#endif
+			ret = jump->result;
+	}
+
+	return ret;
+}
+
+/* Returns 1 if a conditional or relational jump, with operands x (and y), is
+ * taken, 0 if it is not, and -1 if it can't be known at compile time. */
+int get_jump_outcome(const quad_pointer& jump,
+					const address_pointer& x,
+					const address_pointer& y){
+	address_pointer condition = nullptr;
+	int ret = -1;
+
+	if(get_inst_type(jump) == quad_type::CONDITIONAL_JUMP){
+		if(is_constant_operand(x) &&
+		get_constant_address_type(x) == value_type::BOOLEAN){
+			condition = new_boolean_constant(
+						get_constant_address_boolean_value(x) ==
+						(get_inst_op(jump) == quad_oper::IFTRUE));
+		}
+	}
+	else{
+		// {get_inst_type(jump) == quad_type::RELATIONAL_JUMP}
+		condition = fold_binary_operation(get_inst_op(jump), x, y);
+	}
+
+	if(condition != nullptr){
+		ret = get_constant_address_boolean_value(condition) ? 1 : 0;
+	}
+
+	return ret;
+}
+
+/* Returns the quad that replaces instruction, once its operands are known
+ * to be constants, or nullptr if the instruction must be removed. Returns
+ * the instruction itself if it can't be folded. */
+quad_pointer fold_instruction(const quad_pointer& instruction){
+	quad_pointer ret = instruction;
+	address_pointer value = nullptr;
+
+	switch(get_inst_type(instruction)){
+		case quad_type::BINARY_ASSIGN:
+			value = fold_binary_operation(get_inst_op(instruction),
+										instruction->arg1, instruction->arg2);
+			if(value != nullptr){
+				ret = new_copy(instruction->result, value);
+			}
+			break;
+
+		case quad_type::UNARY_ASSIGN:
+			value = fold_unary_operation(get_inst_op(instruction),
+										instruction->arg1);
+			if(value != nullptr){
+				ret = new_copy(instruction->result, value);
+			}
+			break;
+
+		case quad_type::CONDITIONAL_JUMP:
+		case quad_type::RELATIONAL_JUMP:
+			switch(get_jump_outcome(instruction, instruction->arg1,
+									instruction->arg2)){
+				case 1:
+					ret = new_unconditional_jump_inst(
+											get_jump_target(instruction));
+					break;
+
+				case 0:
+					ret = nullptr;
+					break;
+
+				default:
+					break;
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	return ret;
+}
+
+unsigned int fold_constants(instructions_list& code){
+	instructions_list folded;
+	unsigned int changes = 0;
+
+	for(instructions_list::iterator it = code.begin(); it != code.end(); ++it){
+		quad_pointer instruction = fold_instruction(*it);
+
+		if(instruction != *it){
+			changes++;
+		}
+		if(instruction != nullptr){
+			folded.push_back(instruction);
+		}
+	}
+
+	code = folded;
+
+	return changes;
+}
+
+
+/////////////////////////
+// @PROPAGATION
+/////////////////////////
+enum class lattice_level {
+	UNDEFINED, // No definition executed, yet.
+	CONSTANT,
+	VARYING
+};
+
+struct lattice_value {
+	lattice_level level;
+	address_pointer constant;
+};
+
+/* Solver of [1]: the values of the SSA names, and the blocks and edges that
+ * can be executed. */
+class sccp_solver {
+public:
+	sccp_solver(const instructions_list& method);
+
+	void solve();
+
+	const control_flow_graph& get_cfg() const;
+
+	bool is_executable(unsigned int block) const;
+
+	bool is_executable(unsigned int source, unsigned int target) const;
+
+	/* Returns the constant value of operand, or nullptr if it's not known to
+	 * be a constant. */
+	address_pointer get_constant(const address_pointer& operand) const;
+
+private:
+	const instructions_list& method;
+	control_flow_graph cfg;
+	std::vector<unsigned int> block_of; // Block of each quad.
+	std::unordered_map<std::string, lattice_value> values;
+	// Quads that use each SSA value.
+	std::unordered_map<std::string, std::vector<unsigned int> > uses;
+	std::vector<bool> executable_blocks;
+	std::set<std::pair<unsigned int, unsigned int> > executable_edges;
+	std::vector<std::pair<unsigned int, unsigned int> > flow_worklist;
+	std::vector<unsigned int> ssa_worklist;
+
+	lattice_value get_value(const address_pointer&) const;
+	void lower(const address_pointer& name, const lattice_value& value);
+	void mark_edge(unsigned int source, unsigned int target);
+	void visit_instruction(unsigned int i);
+	void visit_block(unsigned int block);
+};
+
+lattice_value new_lattice_value(lattice_level level,
+								const address_pointer& constant){
+	lattice_value ret;
+	ret.level = level;
+	ret.constant = constant;
+
+	return ret;
+}
+
+lattice_value meet(const lattice_value& x, const lattice_value& y){
+	lattice_value ret = x;
+
+	if(x.level == lattice_level::UNDEFINED){
+		ret = y;
+	}
+	else if(x.level == lattice_level::CONSTANT &&
+	y.level != lattice_level::UNDEFINED &&
+	(y.level == lattice_level::VARYING ||
+	!are_equal_address_pointers(x.constant, y.constant))){
+		ret = new_lattice_value(lattice_level::VARYING, nullptr);
+	}
+
+	return ret;
+}
+
+sccp_solver::sccp_solver(const instructions_list& _method) :
+method(_method), cfg(_method) {
+
+	std::unordered_set<std::string> ssa_values = get_ssa_values(method);
+
+	this->block_of.assign(method.size(), 0);
+	for(unsigned int b = 0; b < this->cfg.size(); b++){
+		for(unsigned int i = this->cfg.get_block(b).first;
+		i < this->cfg.get_block(b).last; i++){
+			this->block_of[i] = b;
+		}
+	}
+
+	for(std::unordered_set<std::string>::iterator it = ssa_values.begin();
+	it != ssa_values.end(); ++it){
+		this->values.insert(std::make_pair(*it,
+						new_lattice_value(lattice_level::UNDEFINED, nullptr)));
+	}
+
+	for(unsigned int i = 0; i < method.size(); i++){
+		std::vector<address_pointer*> operands = get_inst_uses(method[i]);
+
+		for(std::vector<address_pointer*>::iterator it = operands.begin();
+		it != operands.end(); ++it){
+			if(**it != nullptr &&
+			get_address_type(**it) == address_type::ADDRESS_NAME &&
+			this->values.find(get_address_name(**it)) != this->values.end()){
+				this->uses[get_address_name(**it)].push_back(i);
+			}
+		}
+	}
+
+	this->executable_blocks.assign(this->cfg.size(), false);
+}
+
+const control_flow_graph& sccp_solver::get_cfg() const{
+	return this->cfg;
+}
+
+bool sccp_solver::is_executable(unsigned int block) const{
+	return this->executable_blocks[block];
+}
+
+bool sccp_solver::is_executable(unsigned int source, unsigned int target) const{
+	return this->executable_edges.find(std::make_pair(source, target)) !=
+			this->executable_edges.end();
+}
+
+lattice_value sccp_solver::get_value(const address_pointer& operand) const{
+	lattice_value ret = new_lattice_value(lattice_level::VARYING, nullptr);
+
+	if(is_constant_operand(operand)){
+		ret = new_lattice_value(lattice_level::CONSTANT, operand);
+	}
+	else if(operand != nullptr &&
+	get_address_type(operand) == address_type::ADDRESS_NAME){
+		std::unordered_map<std::string, lattice_value>::const_iterator it =
+								this->values.find(get_address_name(operand));
+
+		if(it != this->values.end()){
+			ret = it->second;
+		}
+	}
+
+	return ret;
+}
+
+address_pointer sccp_solver::get_constant(const address_pointer& operand) const{
+	lattice_value value = this->get_value(operand);
+
+	return value.level == lattice_level::CONSTANT ? value.constant : nullptr;
+}
+
+void sccp_solver::lower(const address_pointer& name, const lattice_value& value){
+	if(name == nullptr || get_address_type(name) != address_type::ADDRESS_NAME){
+		return;
+	}
+
+	std::unordered_map<std::string, lattice_value>::iterator it =
+										this->values.find(get_address_name(name));
+
+	// Values only go down into the lattice.
+	if(it != this->values.end() && it->second.level != value.level){
+		it->second = value;
+
+		std::vector<unsigned int>& users = this->uses[it->first];
+		this->ssa_worklist.insert(this->ssa_worklist.end(), users.begin(),
+								users.end());
+	}
+}
+
+void sccp_solver::mark_edge(unsigned int source, unsigned int target){
+	if(this->executable_edges.insert(std::make_pair(source, target)).second){
+		this->flow_worklist.push_back(std::make_pair(source, target));
+	}
+}
+
+void sccp_solver::visit_instruction(unsigned int i){
+	const quad_pointer& instruction = this->method[i];
+	unsigned int block = this->block_of[i];
+	lattice_value value = new_lattice_value(lattice_level::VARYING, nullptr);
+
+	switch(get_inst_type(instruction)){
+		case quad_type::PHI:{
+			value = new_lattice_value(lattice_level::UNDEFINED, nullptr);
+
+			const std::vector<phi_argument>& args =
+											get_phi_arguments(instruction);
+
+			for(std::vector<phi_argument>::const_iterator it = args.begin();
+			it != args.end(); ++it){
+				int pred = this->cfg.get_label_block(
+											get_label_address_value(it->label));
+
+				if(pred != UNDEFINED_BLOCK && this->is_executable(pred, block)){
+					value = meet(value, this->get_value(it->value));
+				}
+			}
+			this->lower(instruction->result, value);
+			break;
+		}
+
+		case quad_type::COPY:
+			this->lower(instruction->result, this->get_value(instruction->arg1));
+			break;
+
+		case quad_type::BINARY_ASSIGN:
+		case quad_type::UNARY_ASSIGN:{
+			lattice_value x = this->get_value(instruction->arg1);
+			lattice_value y = get_inst_type(instruction) ==
+								quad_type::BINARY_ASSIGN ?
+								this->get_value(instruction->arg2) : x;
+
+			if(x.level == lattice_level::UNDEFINED ||
+			y.level == lattice_level::UNDEFINED){
+				value = new_lattice_value(lattice_level::UNDEFINED, nullptr);
+			}
+			else if(x.level == lattice_level::CONSTANT &&
+			y.level == lattice_level::CONSTANT){
+				address_pointer constant =
+						get_inst_type(instruction) == quad_type::BINARY_ASSIGN ?
+						fold_binary_operation(get_inst_op(instruction),
+											x.constant, y.constant) :
+						fold_unary_operation(get_inst_op(instruction),
+											x.constant);
+
+				if(constant != nullptr){
+					value = new_lattice_value(lattice_level::CONSTANT, constant);
+				}
+			}
+			this->lower(instruction->result, value);
+			break;
+		}
+
+		case quad_type::UNCONDITIONAL_JUMP:{
+			int target = this->cfg.get_label_block(
+										get_unconditional_jmp_label(instruction));
+			if(target != UNDEFINED_BLOCK){
+				this->mark_edge(block, target);
+			}
+			break;
+		}
+
+		case quad_type::CONDITIONAL_JUMP:
+		case quad_type::RELATIONAL_JUMP:{
+			lattice_value x = this->get_value(instruction->arg1);
+			lattice_value y = get_inst_type(instruction) ==
+								quad_type::RELATIONAL_JUMP ?
+								this->get_value(instruction->arg2) : x;
+
+			if(x.level == lattice_level::UNDEFINED ||
+			y.level == lattice_level::UNDEFINED){
+				break;
+			}
+
+			int outcome = -1;
+			if(x.level == lattice_level::CONSTANT &&
+			y.level == lattice_level::CONSTANT){
+				outcome = get_jump_outcome(instruction, x.constant, y.constant);
+			}
+
+			int target = this->cfg.get_label_block(get_label_address_value(
+												get_jump_target(instruction)));
+			if(outcome != 0 && target != UNDEFINED_BLOCK){
+				this->mark_edge(block, target);
+			}
+			if(outcome != 1 && block + 1 < this->cfg.size()){
+				this->mark_edge(block, block + 1);
+			}
+			break;
+		}
+
+		default:
+			// Calls, indexed copies and ADDRESS_OF define varying values.
+			this->lower(get_inst_definition(instruction), value);
+	}
+}
+
+void sccp_solver::visit_block(unsigned int block){
+	const basic_block& b = this->cfg.get_block(block);
+
+	for(unsigned int i = b.first; i < b.last; i++){
+		this->visit_instruction(i);
+	}
+
+	// Fall-through.
+	if(!ends_block(this->method[b.last - 1]) && block + 1 < this->cfg.size()){
+		this->mark_edge(block, block + 1);
+	}
+}
+
+void sccp_solver::solve(){
+	if(this->cfg.size() == 0){
+		return;
+	}
+
+	this->executable_blocks[0] = true;
+	this->visit_block(0);
+
+	while(!this->flow_worklist.empty() || !this->ssa_worklist.empty()){
+		while(!this->flow_worklist.empty()){
+			unsigned int target = this->flow_worklist.back().second;
+			this->flow_worklist.pop_back();
+
+			if(!this->executable_blocks[target]){
+				this->executable_blocks[target] = true;
+				this->visit_block(target);
+			}
+			else{
+				// {the block has already been visited: only its PHIs can
+				// change, because of the new edge}
+				const basic_block& b = this->cfg.get_block(target);
+
+				for(unsigned int i = b.first; i < b.last; i++){
+					if(get_inst_type(this->method[i]) == quad_type::PHI){
+						this->visit_instruction(i);
+					}
+				}
+			}
+		}
+
+		while(!this->ssa_worklist.empty()){
+			unsigned int i = this->ssa_worklist.back();
+			this->ssa_worklist.pop_back();
+
+			if(this->executable_blocks[this->block_of[i]]){
+				this->visit_instruction(i);
+			}
+		}
+	}
+}
+
+unsigned int propagate_constants(instructions_list& method){
+	sccp_solver solver(method);
+	const control_flow_graph& cfg = solver.get_cfg();
+	instructions_list propagated;
+	unsigned int changes = 0;
+
+	solver.solve();
+
+	for(unsigned int b = 0; b < cfg.size(); b++){
+		const basic_block& block = cfg.get_block(b);
+
+		if(!solver.is_executable(b)){
+			changes += block.last - block.first;
+			continue;
+		}
+
+		for(unsigned int i = block.first; i < block.last; i++){
+			quad_pointer instruction = copy_instruction(method[i]);
+			bool changed = false;
+
+			if(get_inst_type(instruction) == quad_type::PHI){
+				if(solver.get_constant(instruction->result) != nullptr){
+					changes++;
+					continue;
+				}
+
+				// Arguments that flow through edges never executed.
+				std::vector<phi_argument>& args =
+											get_phi_arguments(instruction);
+				std::vector<phi_argument> arguments;
+				for(std::vector<phi_argument>::iterator it = args.begin();
+				it != args.end(); ++it){
+					int pred = cfg.get_label_block(
+											get_label_address_value(it->label));
+
+					if(pred != UNDEFINED_BLOCK && solver.is_executable(pred, b)){
+						arguments.push_back(*it);
+					}
+					else{
+						changed = true;
+					}
+				}
+				args = arguments;
+			}
+
+			std::vector<address_pointer*> operands = get_inst_uses(instruction);
+			for(std::vector<address_pointer*>::iterator it = operands.begin();
+			it != operands.end(); ++it){
+				address_pointer constant = solver.get_constant(**it);
+
+				if(constant != nullptr && !is_constant_operand(**it)){
+					**it = constant;
+					changed = true;
+				}
+			}
+
+			address_pointer definition = get_inst_definition(instruction);
+			address_pointer constant = solver.get_constant(definition);
+			if(constant != nullptr && !(get_inst_type(instruction) ==
+			quad_type::COPY && is_constant_operand(instruction->arg1))){
+				instruction = new_copy(definition, constant);
+				changed = true;
+			}
+			else{
+				quad_pointer folded = fold_instruction(instruction);
+
+				changed = changed || folded != instruction;
+				instruction = folded;
+			}
+
+			if(changed){
+				changes++;
+			}
+			if(instruction != nullptr){
+				propagated.push_back(changed ? instruction : method[i]);
+			}
+		}
+	}
+
+	method = propagated;
+
+	return changes;
+}
@@ -0,0 +1,54 @@
+#ifndef CONSTANT_PROPAGATION_H_
+#define CONSTANT_PROPAGATION_H_
+
+#include "three_address_code.h"
+
+/* Bibliography adopted:
+ * [1] "Constant Propagation with Conditional Branches", Mark N. Wegman and
+ * 		F. Kenneth Zadeck. ACM TOPLAS, 1991.
+ * */
+
+/////////////////////////
+// @FOLDING
+/////////////////////////
+/* Returns the constant x op y, or nullptr if it can't be computed at compile
+ * time: operands are not constants of the same type, op is not defined for
+ * them, or the operation would fail at run time (division by zero, or the
+ * overflow of the division of the minimum integer by -1). Integer arithmetic
+ * wraps around, as the generated code does. Relational operators give a
+ * boolean constant. */
+address_pointer fold_binary_operation(quad_oper op,
+									const address_pointer& x,
+									const address_pointer& y);
+
+/* Returns the constant op x (NEGATIVE or NEGATION), or nullptr if it can't be
+ * computed at compile time. */
+address_pointer fold_unary_operation(quad_oper op, const address_pointer& x);
+
+/* Folds, one quad at a time, assignments whose operands are constants into
+ * copies of the result, and jumps whose condition is constant into a goto
+ * (if taken) or nothing (otherwise). Doesn't need SSA form. Returns the
+ * number of quads modified or removed. */
+unsigned int fold_constants(instructions_list& code);
+
+
+/////////////////////////
+// @PROPAGATION
+/////////////////////////
+/* Sparse conditional constant propagation ([1]) over a method into SSA form.
+ * Values are propagated through copies and PHIs, and only along the edges
+ * that can be executed, assuming that a branch with a constant condition
+ * always goes the same way. Then:
+ * 		_ uses of constant values are replaced by the constant, and their
+ * 		definitions become copies of the constant (or are removed, for PHIs),
+ *
+ * 		_ jumps with a constant condition become a goto or are removed,
+ *
+ * 		_ blocks never executed are removed, along with the arguments of the
+ * 		PHIs that flow from them.
+ *
+ * Returns the number of quads modified or removed.
+ * PRE : {method is the code of a single method, into SSA form} */
+unsigned int propagate_constants(instructions_list& method);
+
+#endif // CONSTANT_PROPAGATION_H_
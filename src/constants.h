@@ -23,6 +23,11 @@ const unsigned int reference_width = 4;
 
 // Quantity of integer parameters that are passed into registers.
 #define INT_PARAMS_INTO_REG 6
+// Quantity of float parameters that are passed into registers (%xmm0-7).
+#define FLOAT_PARAMS_INTO_REG 8
 #define RBP_REGISTER_SIZE 8
+#define RETURN_ADDRESS_SIZE 8
+// Alignment of rSP (in bytes) at every call, following the System V ABI.
+#define STACK_ALIGNMENT 16
 
 #endif
@@ -0,0 +1,584 @@
+#include <algorithm>
+#include <unordered_set>
+#include "control_flow_graph.h"
+
+/////////////////////////
+// @AUXILIARY
+/////////////////////////
+bool ends_block(const quad_pointer& instruction){
+	quad_type type = get_inst_type(instruction);
+
+	return type == quad_type::UNCONDITIONAL_JUMP ||
+		   type == quad_type::CONDITIONAL_JUMP ||
+		   type == quad_type::RELATIONAL_JUMP ||
+		   type == quad_type::RETURN;
+}
+
+/* Escapes the characters of text that have a special meaning into a DOT
+ * string. */
+std::string escape_dot(const std::string& text){
+	std::string ret;
+
+	for(std::string::const_iterator it = text.begin(); it != text.end(); ++it){
+		if(*it == '"' || *it == '\\'){
+			ret += '\\';
+		}
+		ret += *it;
+	}
+
+	return ret;
+}
+
+
+/////////////////////////
+// @CONSTRUCTION
+/////////////////////////
+control_flow_graph::control_flow_graph(const instructions_list& _method) :
+method(_method) {
+
+	this->split_into_blocks();
+	this->add_edges();
+	this->compute_reverse_postorder();
+	this->compute_dominators();
+	this->number_dominator_tree();
+	this->compute_dominance_frontiers();
+	this->find_loops();
+}
+
+void control_flow_graph::split_into_blocks(){
+	for(unsigned int i = 0; i < this->method.size(); i++){
+		const quad_pointer& instruction = this->method[i];
+
+		// Leaders: the first quad, every label, and every quad that follows
+		// a jump or a return.
+		if(i == 0 || get_inst_type(instruction) == quad_type::LABEL ||
+		ends_block(this->method[i-1])){
+			basic_block block;
+			block.first = i;
+			block.last = i;
+			block.idom = UNDEFINED_BLOCK;
+			block.loop = -1;
+			block.loop_depth = 0;
+			this->blocks.push_back(block);
+		}
+
+		if(get_inst_type(instruction) == quad_type::LABEL &&
+		this->blocks.back().first == i){
+			this->label_blocks.insert(
+					std::make_pair(get_label_inst_label(instruction),
+									this->blocks.size() - 1));
+		}
+
+		this->blocks.back().last = i + 1;
+	}
+}
+
+void control_flow_graph::add_edge(unsigned int source, unsigned int target){
+	std::vector<unsigned int>& successors = this->blocks[source].successors;
+
+	// Blocks have, at most, two successors.
+	if(std::find(successors.begin(), successors.end(), target) ==
+	successors.end()){
+		successors.push_back(target);
+		this->blocks[target].predecessors.push_back(source);
+	}
+}
+
+void control_flow_graph::add_edges(){
+	for(unsigned int b = 0; b < this->blocks.size(); b++){
+		const quad_pointer& last = this->method[this->blocks[b].last - 1];
+		bool falls_through = true;
+		int target = UNDEFINED_BLOCK;
+
+		switch(get_inst_type(last)){
+			case quad_type::UNCONDITIONAL_JUMP:
+				target = this->get_label_block(get_unconditional_jmp_label(last));
+				falls_through = false;
+				break;
+
+			case quad_type::CONDITIONAL_JUMP:
+				target = this->get_label_block(get_conditional_jmp_label(last));
+				break;
+
+			case quad_type::RELATIONAL_JUMP:
+				target = this->get_label_block(get_relational_jmp_label(last));
+				break;
+
+			case quad_type::RETURN:
+				falls_through = false;
+				break;
+
+			default:
+				;
+		}
+
+		if(target != UNDEFINED_BLOCK){
+			this->add_edge(b, target);
+		}
+
+		if(falls_through && b + 1 < this->blocks.size()){
+			this->add_edge(b, b + 1);
+		}
+	}
+}
+
+void control_flow_graph::compute_reverse_postorder(){
+	this->postorder_number.assign(this->blocks.size(), -1);
+
+	if(this->blocks.empty()){
+		return;
+	}
+
+	// Iterative depth-first search, from the entry block. Each element of the
+	// stack is a block, and the next successor to visit.
+	std::vector<bool> visited(this->blocks.size(), false);
+	std::vector<std::pair<unsigned int, unsigned int> > stack;
+	std::vector<unsigned int> postorder;
+
+	visited[0] = true;
+	stack.push_back(std::make_pair(0, 0));
+
+	while(!stack.empty()){
+		unsigned int block = stack.back().first;
+		unsigned int next = stack.back().second;
+		const std::vector<unsigned int>& successors =
+											this->blocks[block].successors;
+
+		if(next < successors.size()){
+			stack.back().second++;
+
+			if(!visited[successors[next]]){
+				visited[successors[next]] = true;
+				stack.push_back(std::make_pair(successors[next], 0));
+			}
+		}
+		else{
+			// {every successor of block has been visited}
+			this->postorder_number[block] = postorder.size();
+			postorder.push_back(block);
+			stack.pop_back();
+		}
+	}
+
+	this->reverse_postorder.assign(postorder.rbegin(), postorder.rend());
+}
+
+unsigned int control_flow_graph::intersect(unsigned int x,
+											unsigned int y) const{
+	// Walk up the dominator tree, using the postorder numbers to determine
+	// which finger must be moved ([1]).
+	while(x != y){
+		while(this->postorder_number[x] < this->postorder_number[y]){
+			x = this->blocks[x].idom;
+		}
+		while(this->postorder_number[y] < this->postorder_number[x]){
+			y = this->blocks[y].idom;
+		}
+	}
+
+	return x;
+}
+
+void control_flow_graph::compute_dominators(){
+	if(this->blocks.empty()){
+		return;
+	}
+
+	// During the computation, the entry block is its own immediate dominator.
+	this->blocks[0].idom = 0;
+	bool changed = true;
+
+	while(changed){
+		changed = false;
+
+		for(std::vector<unsigned int>::iterator it = this->reverse_postorder.begin() + 1;
+		it != this->reverse_postorder.end(); ++it){
+			basic_block& block = this->blocks[*it];
+			int new_idom = UNDEFINED_BLOCK;
+
+			for(std::vector<unsigned int>::iterator p = block.predecessors.begin();
+			p != block.predecessors.end(); ++p){
+				// Only predecessors already processed.
+				if(this->blocks[*p].idom != UNDEFINED_BLOCK){
+					if(new_idom == UNDEFINED_BLOCK){
+						new_idom = *p;
+					}
+					else{
+						// {new_idom != UNDEFINED_BLOCK}
+						new_idom = this->intersect(*p, new_idom);
+					}
+				}
+			}
+
+			if(block.idom != new_idom){
+				block.idom = new_idom;
+				changed = true;
+			}
+		}
+	}
+
+	this->blocks[0].idom = UNDEFINED_BLOCK;
+
+	for(std::vector<unsigned int>::iterator it = this->reverse_postorder.begin() + 1;
+	it != this->reverse_postorder.end(); ++it){
+		this->blocks[this->blocks[*it].idom].dominated.push_back(*it);
+	}
+}
+
+void control_flow_graph::number_dominator_tree(){
+	this->dom_tree_pre.assign(this->blocks.size(), 0);
+	this->dom_tree_post.assign(this->blocks.size(), 0);
+
+	if(this->blocks.empty()){
+		return;
+	}
+
+	unsigned int pre = 0;
+	unsigned int post = 0;
+	std::vector<std::pair<unsigned int, unsigned int> > stack;
+
+	this->dom_tree_pre[0] = pre++;
+	stack.push_back(std::make_pair(0, 0));
+
+	while(!stack.empty()){
+		unsigned int block = stack.back().first;
+		unsigned int next = stack.back().second;
+		const std::vector<unsigned int>& children = this->blocks[block].dominated;
+
+		if(next < children.size()){
+			stack.back().second++;
+			this->dom_tree_pre[children[next]] = pre++;
+			stack.push_back(std::make_pair(children[next], 0));
+		}
+		else{
+			// {every child of block has been visited}
+			this->dom_tree_post[block] = post++;
+			stack.pop_back();
+		}
+	}
+}
+
+void control_flow_graph::compute_dominance_frontiers(){
+	for(std::vector<unsigned int>::iterator it = this->reverse_postorder.begin();
+	it != this->reverse_postorder.end(); ++it){
+		const basic_block& block = this->blocks[*it];
+
+		if(block.predecessors.size() < 2){
+			continue;
+		}
+
+		for(std::vector<unsigned int>::const_iterator p =
+		block.predecessors.begin(); p != block.predecessors.end(); ++p){
+			if(!this->is_reachable(*p)){
+				continue;
+			}
+
+			// Every block from the predecessor up to (but excluding) the
+			// immediate dominator of the join point, has it into its frontier.
+			int runner = *p;
+			while(runner != block.idom){
+				std::vector<unsigned int>& frontier = this->blocks[runner].frontier;
+
+				if(!frontier.empty() && frontier.back() == *it){
+					// The rest of the path has already been walked.
+					break;
+				}
+				frontier.push_back(*it);
+				runner = this->blocks[runner].idom;
+			}
+		}
+	}
+}
+
+bool control_flow_graph::is_back_edge(unsigned int source,
+									unsigned int target) const{
+
+	return this->is_reachable(source) && this->dominates(target, source);
+}
+
+void control_flow_graph::find_loops(){
+	// Loops are numbered following the reverse postorder of their headers,
+	// so an enclosing loop always precedes the loops nested into it.
+	for(std::vector<unsigned int>::iterator it = this->reverse_postorder.begin();
+	it != this->reverse_postorder.end(); ++it){
+		const std::vector<unsigned int>& predecessors =
+											this->blocks[*it].predecessors;
+		natural_loop loop;
+		loop.header = *it;
+		loop.parent = -1;
+		loop.depth = 1;
+
+		for(std::vector<unsigned int>::const_iterator p = predecessors.begin();
+		p != predecessors.end(); ++p){
+			if(this->is_reachable(*p) && this->is_back_edge(*p, *it)){
+				loop.latches.push_back(*p);
+			}
+		}
+
+		if(!loop.latches.empty()){
+			this->loops.push_back(loop);
+		}
+	}
+
+	// The body of each loop: the header, plus every block that reaches a
+	// latch without going through the header ([2]).
+	std::vector<int> mark(this->blocks.size(), -1);
+
+	for(unsigned int l = 0; l < this->loops.size(); l++){
+		natural_loop& loop = this->loops[l];
+		std::vector<unsigned int> worklist;
+
+		mark[loop.header] = l;
+		loop.blocks.push_back(loop.header);
+
+		for(std::vector<unsigned int>::iterator it = loop.latches.begin();
+		it != loop.latches.end(); ++it){
+			if(mark[*it] != (int)l){
+				mark[*it] = l;
+				loop.blocks.push_back(*it);
+				worklist.push_back(*it);
+			}
+		}
+
+		while(!worklist.empty()){
+			unsigned int block = worklist.back();
+			worklist.pop_back();
+			const std::vector<unsigned int>& predecessors =
+											this->blocks[block].predecessors;
+
+			for(std::vector<unsigned int>::const_iterator p = predecessors.begin();
+			p != predecessors.end(); ++p){
+				if(mark[*p] != (int)l && this->is_reachable(*p)){
+					mark[*p] = l;
+					loop.blocks.push_back(*p);
+					worklist.push_back(*p);
+				}
+			}
+		}
+
+		std::sort(loop.blocks.begin(), loop.blocks.end());
+	}
+
+	// Nesting: visiting the loops from the biggest to the smallest, the
+	// innermost loop already visited that contains the header of a loop,
+	// is its parent.
+	std::vector<unsigned int> order;
+	for(unsigned int l = 0; l < this->loops.size(); l++){
+		order.push_back(l);
+	}
+	std::stable_sort(order.begin(), order.end(),
+		[this](unsigned int x, unsigned int y){
+			return this->loops[x].blocks.size() > this->loops[y].blocks.size();
+		});
+
+	for(std::vector<unsigned int>::iterator it = order.begin();
+	it != order.end(); ++it){
+		natural_loop& loop = this->loops[*it];
+
+		loop.parent = this->blocks[loop.header].loop;
+		if(loop.parent != -1){
+			loop.depth = this->loops[loop.parent].depth + 1;
+		}
+
+		for(std::vector<unsigned int>::iterator b = loop.blocks.begin();
+		b != loop.blocks.end(); ++b){
+			this->blocks[*b].loop = *it;
+			this->blocks[*b].loop_depth = loop.depth;
+		}
+	}
+}
+
+
+/////////////////////////
+// @QUERIES
+/////////////////////////
+unsigned int control_flow_graph::size() const{
+	return this->blocks.size();
+}
+
+const basic_block& control_flow_graph::get_block(unsigned int block) const{
+	// PRE
+	#ifdef __DEBUG
+		assert(block < this->blocks.size());
+	#endif
+
+	return this->blocks[block];
+}
+
+const instructions_list& control_flow_graph::get_method() const{
+	return this->method;
+}
+
+int control_flow_graph::get_label_block(const std::string& label) const{
+	std::unordered_map<std::string, unsigned int>::const_iterator it =
+												this->label_blocks.find(label);
+
+	return it == this->label_blocks.end() ? UNDEFINED_BLOCK : it->second;
+}
+
+const std::vector<unsigned int>& control_flow_graph::get_reverse_postorder() const{
+	return this->reverse_postorder;
+}
+
+bool control_flow_graph::is_reachable(unsigned int block) const{
+	return this->postorder_number[block] != -1;
+}
+
+bool control_flow_graph::dominates(unsigned int x, unsigned int y) const{
+	// PRE
+	#ifdef __DEBUG
+		assert(this->is_reachable(x) && this->is_reachable(y));
+	#endif
+
+	return this->dom_tree_pre[x] <= this->dom_tree_pre[y] &&
+		   this->dom_tree_post[y] <= this->dom_tree_post[x];
+}
+
+const std::vector<natural_loop>& control_flow_graph::get_loops() const{
+	return this->loops;
+}
+
+
+/////////////////////////
+// @PRINTING
+/////////////////////////
+std::string control_flow_graph::print_dot(const std::string& name) const{
+	std::string prefix = "\"" + escape_dot(name) + ".B";
+	std::string ret = "\tsubgraph \"cluster_" + escape_dot(name) + "\" {\n"
+					  "\t\tlabel=\"" + escape_dot(name) + "\";\n";
+
+	for(unsigned int b = 0; b < this->blocks.size(); b++){
+		const basic_block& block = this->blocks[b];
+		std::string title = "B" + std::to_string(b);
+
+		if(!this->is_reachable(b)){
+			title += " (unreachable)";
+		}
+		else if(block.loop_depth > 0){
+			title += " (loop depth " + std::to_string(block.loop_depth) + ")";
+		}
+
+		ret += "\t\t" + prefix + std::to_string(b) + "\" [label=\"" + title +
+				"\\l";
+		for(unsigned int i = block.first; i < block.last; i++){
+			ret += escape_dot(print_instruction(this->method[i])) + "\\l";
+		}
+		ret += "\"];\n";
+	}
+
+	for(unsigned int b = 0; b < this->blocks.size(); b++){
+		const std::vector<unsigned int>& successors = this->blocks[b].successors;
+
+		for(std::vector<unsigned int>::const_iterator s = successors.begin();
+		s != successors.end(); ++s){
+			ret += "\t\t" + prefix + std::to_string(b) + "\" -> " + prefix +
+					std::to_string(*s) + "\"";
+			if(this->is_back_edge(b, *s)){
+				ret += " [style=dashed]";
+			}
+			ret += ";\n";
+		}
+	}
+
+	return ret + "\t}\n";
+}
+
+unsigned int remove_unreachable_blocks(instructions_list& method){
+	control_flow_graph cfg(method);
+	instructions_list reachable;
+
+	for(unsigned int b = 0; b < cfg.size(); b++){
+		if(cfg.is_reachable(b)){
+			const basic_block& block = cfg.get_block(b);
+			reachable.insert(reachable.end(), method.begin() + block.first,
+							method.begin() + block.last);
+		}
+	}
+
+	unsigned int removed = method.size() - reachable.size();
+	method = reachable;
+
+	return removed;
+}
+
+unsigned int remove_unreferenced_labels(instructions_list& method){
+	std::unordered_set<std::string> targets;
+	instructions_list referenced;
+
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		switch(get_inst_type(*it)){
+			case quad_type::UNCONDITIONAL_JUMP:
+				targets.insert(get_unconditional_jmp_label(*it));
+				break;
+
+			case quad_type::CONDITIONAL_JUMP:
+				targets.insert(get_conditional_jmp_label(*it));
+				break;
+
+			case quad_type::RELATIONAL_JUMP:
+				targets.insert(get_relational_jmp_label(*it));
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		if(get_inst_type(*it) != quad_type::LABEL ||
+		is_method_label_inst(*it) ||
+		targets.find(get_label_inst_label(*it)) != targets.end()){
+			referenced.push_back(*it);
+		}
+	}
+
+	unsigned int removed = method.size() - referenced.size();
+	method = referenced;
+
+	return removed;
+}
+
+std::vector<instructions_list> split_into_methods(const instructions_list& code){
+	std::vector<instructions_list> ret;
+
+	for(instructions_list::const_iterator it = code.begin();
+	it != code.end(); ++it){
+		if(ret.empty() || is_method_label_inst(*it)){
+			ret.push_back(instructions_list());
+		}
+		ret.back().push_back(*it);
+	}
+
+	return ret;
+}
+
+instructions_list* join_methods(const std::vector<instructions_list>& methods){
+	instructions_list *ret = new instructions_list();
+
+	for(std::vector<instructions_list>::const_iterator it = methods.begin();
+	it != methods.end(); ++it){
+		ret->insert(ret->end(), it->begin(), it->end());
+	}
+
+	return ret;
+}
+
+std::string print_cfg_dot(const instructions_list& code){
+	std::vector<instructions_list> methods = split_into_methods(code);
+	std::string ret = "digraph cfg {\n"
+					  "\tnode [shape=box, fontname=\"monospace\"];\n";
+
+	for(std::vector<instructions_list>::iterator it = methods.begin();
+	it != methods.end(); ++it){
+		std::string name = is_method_label_inst(it->front()) ?
+							get_label_inst_label(it->front()) :
+							std::string("global");
+		control_flow_graph cfg(*it);
+
+		ret += cfg.print_dot(name);
+	}
+
+	return ret + "}\n";
+}
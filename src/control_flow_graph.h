@@ -0,0 +1,146 @@
+#ifndef CONTROL_FLOW_GRAPH_H_
+#define CONTROL_FLOW_GRAPH_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "three_address_code.h"
+
+/* Bibliography adopted:
+ * [1] "A Simple, Fast Dominance Algorithm", Keith D. Cooper, Timothy J.
+ * 		Harvey and Ken Kennedy. Available at
+ * 		https://www.cs.rice.edu/~keith/EMBED/dom.pdf
+ *
+ * [2] "Compilers: Principles, Techniques, and Tools" (2nd edition), Aho,
+ * 		Lam, Sethi, Ullman. Section 8.4 (basic blocks and flow graphs) and
+ * 		9.6 (loops in flow graphs).
+ * */
+
+// Special value to denote an undefined block (e.g.: the immediate dominator
+// of the entry block, or of an unreachable block).
+#define UNDEFINED_BLOCK -1
+
+struct basic_block {
+	// Quads of the block: positions [first, last) into the method's
+	// instructions_list from which the graph was built.
+	unsigned int first;
+	unsigned int last;
+	std::vector<unsigned int> predecessors;
+	std::vector<unsigned int> successors;
+	int idom; // Immediate dominator.
+	std::vector<unsigned int> dominated; // Children into the dominator tree.
+	std::vector<unsigned int> frontier; // Dominance frontier.
+	int loop; // Innermost natural loop that contains the block.
+	unsigned int loop_depth; // 0 => the block is not into a loop.
+};
+
+struct natural_loop {
+	unsigned int header;
+	std::vector<unsigned int> latches; // Sources of the back edges.
+	std::vector<unsigned int> blocks; // In increasing order.
+	int parent; // Innermost enclosing loop.
+	unsigned int depth; // 1 => outermost loop.
+};
+
+/* Control-flow graph of a single method. Blocks are numbered following the
+ * order of the quads, so block 0 is always the entry block. Edges are
+ * determined by the jumps (and fall-through); a RETURN has no successors.
+ * Jumps to labels not defined into the method, add no edges.
+ *
+ * Besides predecessors and successors, the graph computes:
+ * 		_ The dominator tree, using the iterative algorithm of [1], over a
+ * 		reverse postorder of the reachable blocks.
+ *
+ * 		_ The dominance frontier of each reachable block, walking up the
+ * 		dominator tree from the predecessors of each join point ([1]).
+ *
+ * 		_ The natural loops, identified by their back edges (an edge whose
+ * 		target dominates its source). Loops that share their header are merged
+ * 		into one ([2]). Then, every loop knows its enclosing loop and its
+ * 		nesting depth.
+ *
+ * Every step is linear on the number of quads and edges, except for the
+ * dominators' fix-point, which needs very few iterations in practice (two
+ * for reducible graphs visited in reverse postorder, [1]).
+ *
+ * The graph keeps positions into the instructions_list: it must be rebuilt
+ * after modifying the list. */
+class control_flow_graph {
+public:
+	control_flow_graph(const instructions_list& method);
+
+	unsigned int size() const;
+
+	const basic_block& get_block(unsigned int) const;
+
+	const instructions_list& get_method() const;
+
+	/* Returns the block that begins with label, or UNDEFINED_BLOCK if there is
+	 * no such block. */
+	int get_label_block(const std::string& label) const;
+
+	// Reachable blocks, in reverse postorder.
+	const std::vector<unsigned int>& get_reverse_postorder() const;
+
+	bool is_reachable(unsigned int block) const;
+
+	/* Does block x dominate block y?
+	 * PRE : {is_reachable(x) and is_reachable(y)} */
+	bool dominates(unsigned int x, unsigned int y) const;
+
+	// Loops in reverse postorder of their headers: outer loops come first.
+	const std::vector<natural_loop>& get_loops() const;
+
+	/* Returns the graph in Graphviz's DOT format, as a subgraph named name.
+	 * Dashed edges are back edges. */
+	std::string print_dot(const std::string& name) const;
+
+private:
+	const instructions_list& method;
+	std::vector<basic_block> blocks;
+	std::unordered_map<std::string, unsigned int> label_blocks;
+	std::vector<unsigned int> reverse_postorder;
+	// Position of each block into the postorder (-1 if unreachable).
+	std::vector<int> postorder_number;
+	// Preorder and postorder numbers of each block into the dominator tree,
+	// to answer dominance queries in constant time.
+	std::vector<unsigned int> dom_tree_pre;
+	std::vector<unsigned int> dom_tree_post;
+	std::vector<natural_loop> loops;
+
+	void split_into_blocks();
+	void add_edges();
+	void compute_reverse_postorder();
+	void compute_dominators();
+	void number_dominator_tree();
+	void compute_dominance_frontiers();
+	void find_loops();
+
+	unsigned int intersect(unsigned int, unsigned int) const;
+	bool is_back_edge(unsigned int source, unsigned int target) const;
+	void add_edge(unsigned int source, unsigned int target);
+};
+
+// Does the instruction end a basic block? (jumps and returns).
+bool ends_block(const quad_pointer& instruction);
+
+/* Removes from method the quads of the blocks that are not reachable from the
+ * entry block. Returns the number of quads removed. */
+unsigned int remove_unreachable_blocks(instructions_list& method);
+
+/* Removes from method the labels that are not the label of a method, and are
+ * not the target of any jump. Returns the number of labels removed. */
+unsigned int remove_unreferenced_labels(instructions_list& method);
+
+/* Splits code into the instructions of each method: each one begins with the
+ * label of the method. Quads before the first method's label, if any, form
+ * a list on their own. */
+std::vector<instructions_list> split_into_methods(const instructions_list&);
+
+// Concatenates the instructions of every method.
+instructions_list* join_methods(const std::vector<instructions_list>&);
+
+// Returns the DOT representation of the graph of every method of code.
+std::string print_cfg_dot(const instructions_list& code);
+
+#endif // CONTROL_FLOW_GRAPH_H_
@@ -0,0 +1,362 @@
+#include <unordered_map>
+#include <unordered_set>
+#include "copy_propagation.h"
+#include "control_flow_graph.h"
+#include "ssa.h"
+
+typedef std::unordered_set<std::string> names_set;
+
+bool is_name(const address_pointer& operand){
+	return operand != nullptr &&
+		   get_address_type(operand) == address_type::ADDRESS_NAME;
+}
+
+// Names whose value can only change through the quads that define them.
+names_set get_propagable_names(const instructions_list& method){
+	names_set ret = get_scalar_variables(method);
+	names_set entry_values = get_entry_values(method);
+
+	ret.insert(entry_values.begin(), entry_values.end());
+
+	return ret;
+}
+
+/////////////////////////
+// @PROPAGATION
+/////////////////////////
+// Copies available at some point of a method.
+class copy_table {
+public:
+	/* Returns the source of the copy available into dest, or nullptr if
+	 * there is none. */
+	address_pointer get_source(const std::string& dest) const;
+
+	void add(const std::string& dest, const address_pointer& source);
+
+	// Removes the copies into name, or from name.
+	void kill(const std::string& name);
+
+	// Keeps only the copies that are available into other, too.
+	void intersect(const copy_table& other);
+
+	bool operator==(const copy_table& other) const;
+
+private:
+	std::unordered_map<std::string, address_pointer> sources;
+	// Destinations of the copies from each name.
+	std::unordered_map<std::string, names_set> dests;
+};
+
+address_pointer copy_table::get_source(const std::string& dest) const{
+	std::unordered_map<std::string, address_pointer>::const_iterator it =
+													this->sources.find(dest);
+
+	return it != this->sources.end() ? it->second : nullptr;
+}
+
+void copy_table::add(const std::string& dest, const address_pointer& source){
+	this->sources[dest] = source;
+	if(is_name(source)){
+		this->dests[get_address_name(source)].insert(dest);
+	}
+}
+
+void copy_table::kill(const std::string& name){
+	address_pointer source = this->get_source(name);
+
+	if(source != nullptr){
+		if(is_name(source)){
+			this->dests[get_address_name(source)].erase(name);
+		}
+		this->sources.erase(name);
+	}
+
+	std::unordered_map<std::string, names_set>::iterator it =
+													this->dests.find(name);
+	if(it != this->dests.end()){
+		for(names_set::iterator dest = it->second.begin();
+		dest != it->second.end(); ++dest){
+			this->sources.erase(*dest);
+		}
+		this->dests.erase(it);
+	}
+}
+
+void copy_table::intersect(const copy_table& other){
+	std::vector<std::string> killed;
+
+	for(std::unordered_map<std::string, address_pointer>::iterator it =
+	this->sources.begin(); it != this->sources.end(); ++it){
+		address_pointer source = other.get_source(it->first);
+
+		if(source == nullptr ||
+		!are_equal_address_pointers(source, it->second)){
+			killed.push_back(it->first);
+		}
+	}
+
+	for(std::vector<std::string>::iterator it = killed.begin();
+	it != killed.end(); ++it){
+		address_pointer source = this->get_source(*it);
+
+		if(is_name(source)){
+			this->dests[get_address_name(source)].erase(*it);
+		}
+		this->sources.erase(*it);
+	}
+}
+
+bool copy_table::operator==(const copy_table& other) const{
+	bool ret = this->sources.size() == other.sources.size();
+
+	for(std::unordered_map<std::string, address_pointer>::const_iterator it =
+	this->sources.begin(); ret && it != this->sources.end(); ++it){
+		address_pointer source = other.get_source(it->first);
+
+		ret = source != nullptr &&
+			  are_equal_address_pointers(source, it->second);
+	}
+
+	return ret;
+}
+
+// Updates copies, available before instruction, to the ones available after.
+void transfer_copies(const quad_pointer& instruction,
+					const names_set& propagable,
+					copy_table& copies){
+	address_pointer definition = get_inst_definition(instruction);
+
+	if(is_name(definition)){
+		copies.kill(get_address_name(definition));
+	}
+
+	if(get_inst_type(instruction) == quad_type::COPY &&
+	propagable.find(get_address_name(instruction->result)) !=
+	propagable.end()){
+		address_pointer source = get_copy_inst_orig(instruction);
+
+		if(get_address_type(source) == address_type::ADDRESS_CONSTANT ||
+		(is_name(source) &&
+		propagable.find(get_address_name(source)) != propagable.end() &&
+		get_address_name(source) != get_address_name(instruction->result))){
+			copies.add(get_address_name(instruction->result), source);
+		}
+	}
+}
+
+/* Returns the copies available at the entry of block b: the ones available
+ * at the end of every predecessor already computed. */
+copy_table get_available_copies(const control_flow_graph& cfg,
+								unsigned int b,
+								const std::vector<copy_table>& out,
+								const std::vector<bool>& computed){
+	const basic_block& block = cfg.get_block(b);
+	copy_table ret;
+	bool first = true;
+
+	if(b == 0){
+		// Nothing is available at the entry of the method.
+		return ret;
+	}
+
+	for(std::vector<unsigned int>::const_iterator it =
+	block.predecessors.begin(); it != block.predecessors.end(); ++it){
+		if(computed[*it]){
+			if(first){
+				ret = out[*it];
+				first = false;
+			}
+			else{
+				ret.intersect(out[*it]);
+			}
+		}
+	}
+
+	return ret;
+}
+
+unsigned int propagate_copies(instructions_list& method){
+	control_flow_graph cfg(method);
+	names_set propagable = get_propagable_names(method);
+	const std::vector<unsigned int>& order = cfg.get_reverse_postorder();
+	std::vector<copy_table> out(cfg.size());
+	std::vector<bool> computed(cfg.size(), false);
+	unsigned int replaced = 0;
+	bool changed = true;
+
+	// Forward data-flow analysis, optimistic about the predecessors not
+	// computed yet (back edges).
+	while(changed){
+		changed = false;
+
+		for(std::vector<unsigned int>::const_iterator b = order.begin();
+		b != order.end(); ++b){
+			const basic_block& block = cfg.get_block(*b);
+			copy_table copies = get_available_copies(cfg, *b, out, computed);
+
+			for(unsigned int i = block.first; i < block.last; i++){
+				transfer_copies(method[i], propagable, copies);
+			}
+
+			if(!computed[*b] || !(copies == out[*b])){
+				out[*b] = copies;
+				computed[*b] = true;
+				changed = true;
+			}
+		}
+	}
+
+	for(std::vector<unsigned int>::const_iterator b = order.begin();
+	b != order.end(); ++b){
+		const basic_block& block = cfg.get_block(*b);
+		copy_table copies = get_available_copies(cfg, *b, out, computed);
+
+		for(unsigned int i = block.first; i < block.last; i++){
+			if(get_inst_type(method[i]) != quad_type::PHI){
+				quad_pointer instruction = copy_instruction(method[i]);
+				std::vector<address_pointer*> uses = get_inst_uses(instruction);
+				bool modified = false;
+
+				for(std::vector<address_pointer*>::iterator it = uses.begin();
+				it != uses.end(); ++it){
+					address_pointer source = is_name(**it) ?
+									copies.get_source(get_address_name(**it)) :
+									nullptr;
+
+					if(source != nullptr){
+						**it = source;
+						modified = true;
+						replaced++;
+					}
+				}
+
+				if(modified){
+					// Quads could be shared with other lists.
+					method[i] = instruction;
+				}
+			}
+
+			transfer_copies(method[i], propagable, copies);
+		}
+	}
+
+	return replaced;
+}
+
+
+/////////////////////////
+// @COALESCING
+/////////////////////////
+bool is_temporary(const std::string& name){
+	return !name.empty() && name[0] == '@';
+}
+
+bool accesses_memory(const quad_pointer& instruction){
+	quad_type type = get_inst_type(instruction);
+
+	return type == quad_type::INDEXED_COPY_TO ||
+		   type == quad_type::INDEXED_COPY_FROM ||
+		   type == quad_type::PROCEDURE_CALL ||
+		   type == quad_type::FUNCTION_CALL;
+}
+
+// Does instruction read or modify the variable name?
+bool refers_to(const quad_pointer& instruction, const std::string& name){
+	address_pointer definition = get_inst_definition(instruction);
+	bool ret = is_name(definition) && get_address_name(definition) == name;
+	std::vector<address_pointer*> uses = get_inst_uses(instruction);
+
+	for(std::vector<address_pointer*>::iterator it = uses.begin();
+	!ret && it != uses.end(); ++it){
+		ret = is_name(**it) && get_address_name(**it) == name;
+	}
+
+	return ret;
+}
+
+unsigned int coalesce_temporaries(instructions_list& method){
+	control_flow_graph cfg(method);
+	names_set scalars = get_propagable_names(method);
+	std::unordered_map<std::string, unsigned int> definitions;
+	std::unordered_map<std::string, unsigned int> uses;
+	std::vector<bool> removed(method.size(), false);
+	unsigned int coalesced = 0;
+
+	for(instructions_list::iterator it = method.begin(); it != method.end();
+	++it){
+		address_pointer definition = get_inst_definition(*it);
+		std::vector<address_pointer*> operands = get_inst_uses(*it);
+
+		if(is_name(definition)){
+			definitions[get_address_name(definition)]++;
+		}
+		for(std::vector<address_pointer*>::iterator u = operands.begin();
+		u != operands.end(); ++u){
+			if(is_name(**u)){
+				uses[get_address_name(**u)]++;
+			}
+		}
+	}
+
+	for(unsigned int b = 0; b < cfg.size(); b++){
+		const basic_block& block = cfg.get_block(b);
+		// Quad that defines each temporary of the block that can be coalesced.
+		std::unordered_map<std::string, unsigned int> candidates;
+
+		for(unsigned int i = block.first; i < block.last; i++){
+			const quad_pointer& instruction = method[i];
+			address_pointer definition = get_inst_definition(instruction);
+
+			if(get_inst_type(instruction) == quad_type::COPY &&
+			is_name(get_copy_inst_orig(instruction)) &&
+			candidates.find(get_address_name(get_copy_inst_orig(instruction)))
+			!= candidates.end()){
+				// {instruction is x = t, and t can be coalesced}
+				std::string x = get_address_name(instruction->result);
+				unsigned int def = candidates[get_address_name(
+											get_copy_inst_orig(instruction))];
+				bool is_pointed = scalars.find(x) == scalars.end();
+				bool safe = true;
+
+				for(unsigned int j = def + 1; safe && j < i; j++){
+					safe = removed[j] || (!refers_to(method[j], x) &&
+						   !(is_pointed && accesses_memory(method[j])));
+				}
+
+				if(safe){
+					quad_pointer coalesced_def = copy_instruction(
+																method[def]);
+					coalesced_def->result = instruction->result;
+					method[def] = coalesced_def;
+					removed[i] = true;
+					coalesced++;
+
+					candidates.erase(get_address_name(
+											get_copy_inst_orig(instruction)));
+					// Chains of copies: x could be coalesced, too.
+					if(is_temporary(x) && definitions[x] == 1 && uses[x] == 1){
+						candidates[x] = def;
+					}
+					continue;
+				}
+			}
+
+			if(is_name(definition) && get_inst_type(instruction) !=
+			quad_type::PHI && is_temporary(get_address_name(definition)) &&
+			definitions[get_address_name(definition)] == 1 &&
+			uses[get_address_name(definition)] == 1){
+				candidates[get_address_name(definition)] = i;
+			}
+		}
+	}
+
+	instructions_list kept;
+	for(unsigned int i = 0; i < method.size(); i++){
+		if(!removed[i]){
+			kept.push_back(method[i]);
+		}
+	}
+	method = kept;
+
+	return coalesced;
+}
@@ -0,0 +1,26 @@
+#ifndef COPY_PROPAGATION_H_
+#define COPY_PROPAGATION_H_
+
+#include "three_address_code.h"
+
+/* Replaces the uses of x by y, wherever the copy x = y reaches them along
+ * every path, and neither x nor y have been redefined since (available copies
+ * analysis). Only copies between scalar variables (see get_scalar_variables
+ * and get_entry_values), or of constants into them, are propagated. Copies
+ * left without uses are removed afterwards by remove_dead_quads. Arguments of
+ * PHIs are not modified. Returns the number of operands replaced.
+ * PRE : {method is the code of a single method} */
+unsigned int propagate_copies(instructions_list& method);
+
+/* Coalesces each temporary t, defined and used once, with the variable x
+ * that receives its value, when both quads are into the same block:
+ * 		t = expr; ...; x = t
+ * becomes
+ * 		x = expr; ...
+ * if x is not read or modified in between (and, when x could be accessed
+ * through a pointer, there is no call nor indexed copy in between either).
+ * Returns the number of copies removed.
+ * PRE : {method is the code of a single method} */
+unsigned int coalesce_temporaries(instructions_list& method);
+
+#endif // COPY_PROPAGATION_H_
@@ -0,0 +1,275 @@
+#include <sstream>
+#include <unordered_set>
+#include "dead_code_elimination.h"
+#include "control_flow_graph.h"
+#include "ssa.h"
+#include "asm_code_generator.h"
+
+typedef std::unordered_set<std::string> live_variables;
+
+/////////////////////////
+// @DEAD QUADS
+/////////////////////////
+/* Can instruction be removed, when the variable it defines is dead? */
+bool is_removable(const quad_pointer& instruction){
+	bool ret = false;
+
+	switch(get_inst_type(instruction)){
+		case quad_type::BINARY_ASSIGN:
+			// Only divisions that can't fail.
+			ret = !may_fail(instruction);
+			break;
+
+		case quad_type::UNARY_ASSIGN:
+		case quad_type::COPY:
+		case quad_type::INDEXED_COPY_FROM:
+		case quad_type::PHI:
+			ret = true;
+			break;
+
+		default:
+			// Calls, stores, jumps, etc.
+			break;
+	}
+
+	return ret;
+}
+
+/* Updates live, the scalar variables live after instruction, into the
+ * variables live before it. The arguments of PHIs are considered used at the
+ * beginning of their block. */
+void update_liveness(const quad_pointer& instruction,
+					const live_variables& scalars,
+					live_variables& live){
+	address_pointer definition = get_inst_definition(instruction);
+
+	if(definition != nullptr &&
+	get_address_type(definition) == address_type::ADDRESS_NAME){
+		live.erase(get_address_name(definition));
+	}
+
+	std::vector<address_pointer*> uses = get_inst_uses(instruction);
+	for(std::vector<address_pointer*>::iterator it = uses.begin();
+	it != uses.end(); ++it){
+		if(**it != nullptr &&
+		get_address_type(**it) == address_type::ADDRESS_NAME &&
+		scalars.find(get_address_name(**it)) != scalars.end()){
+			live.insert(get_address_name(**it));
+		}
+	}
+}
+
+bool is_dead(const quad_pointer& instruction,
+			const live_variables& scalars,
+			const live_variables& live){
+	address_pointer definition = get_inst_definition(instruction);
+
+	return is_removable(instruction) && definition != nullptr &&
+		   get_address_type(definition) == address_type::ADDRESS_NAME &&
+		   scalars.find(get_address_name(definition)) != scalars.end() &&
+		   live.find(get_address_name(definition)) == live.end();
+}
+
+live_variables get_live_out(const basic_block& block,
+							const std::vector<live_variables>& live_in){
+	live_variables ret;
+
+	for(std::vector<unsigned int>::const_iterator it =
+	block.successors.begin(); it != block.successors.end(); ++it){
+		ret.insert(live_in[*it].begin(), live_in[*it].end());
+	}
+
+	return ret;
+}
+
+/* Removes the quads that are dead, according to the liveness of the variables
+ * of method, before removing any of them. Returns the number of quads
+ * removed. */
+unsigned int remove_dead_quads_once(instructions_list& method,
+									const live_variables& scalars){
+	control_flow_graph cfg(method);
+	std::vector<live_variables> live_in(cfg.size());
+	const std::vector<unsigned int>& order = cfg.get_reverse_postorder();
+	bool changed = true;
+
+	// Backward data-flow analysis, visiting blocks in postorder.
+	while(changed){
+		changed = false;
+
+		for(std::vector<unsigned int>::const_reverse_iterator b = order.rbegin();
+		b != order.rend(); ++b){
+			const basic_block& block = cfg.get_block(*b);
+			live_variables live = get_live_out(block, live_in);
+
+			for(int i = block.last - 1; i >= (int)block.first; i--){
+				if(!is_dead(method[i], scalars, live)){
+					update_liveness(method[i], scalars, live);
+				}
+			}
+
+			if(live.size() != live_in[*b].size()){
+				// {live_in only grows}
+				live_in[*b] = live;
+				changed = true;
+			}
+		}
+	}
+
+	std::vector<bool> dead(method.size(), false);
+	for(unsigned int b = 0; b < cfg.size(); b++){
+		const basic_block& block = cfg.get_block(b);
+		live_variables live = get_live_out(block, live_in);
+
+		for(int i = block.last - 1; i >= (int)block.first; i--){
+			dead[i] = is_dead(method[i], scalars, live);
+			if(!dead[i]){
+				update_liveness(method[i], scalars, live);
+			}
+		}
+	}
+
+	instructions_list alive;
+	for(unsigned int i = 0; i < method.size(); i++){
+		if(!dead[i]){
+			alive.push_back(method[i]);
+		}
+	}
+
+	unsigned int removed = method.size() - alive.size();
+	method = alive;
+
+	return removed;
+}
+
+unsigned int remove_dead_quads(instructions_list& method){
+	live_variables scalars = get_scalar_variables(method);
+	unsigned int removed = 0;
+	unsigned int pass;
+
+	// Removing a quad can kill the variables it uses.
+	do{
+		pass = remove_dead_quads_once(method, scalars);
+		removed += pass;
+	} while(pass > 0);
+
+	return removed;
+}
+
+
+/////////////////////////
+// @DEAD CONTROL FLOW
+/////////////////////////
+unsigned int remove_jumps_to_next(instructions_list& code){
+	instructions_list kept;
+
+	for(unsigned int i = 0; i < code.size(); i++){
+		std::string target;
+
+		switch(get_inst_type(code[i])){
+			case quad_type::UNCONDITIONAL_JUMP:
+				target = get_unconditional_jmp_label(code[i]);
+				break;
+
+			case quad_type::CONDITIONAL_JUMP:
+				target = get_conditional_jmp_label(code[i]);
+				break;
+
+			case quad_type::RELATIONAL_JUMP:
+				target = get_relational_jmp_label(code[i]);
+				break;
+
+			default:
+				break;
+		}
+
+		bool to_next = false;
+		// The labels that follow the jump.
+		for(unsigned int j = i + 1; !target.empty() && j < code.size() &&
+		get_inst_type(code[j]) == quad_type::LABEL && !to_next; j++){
+			to_next = get_label_inst_label(code[j]) == target;
+		}
+
+		if(!to_next){
+			kept.push_back(code[i]);
+		}
+	}
+
+	unsigned int removed = code.size() - kept.size();
+	code = kept;
+
+	return removed;
+}
+
+unsigned int eliminate_dead_code(instructions_list& method){
+	unsigned int removed = 0;
+	unsigned int pass;
+
+	do{
+		pass = remove_unreachable_blocks(method);
+		pass += remove_jumps_to_next(method);
+		pass += remove_unreferenced_labels(method);
+		pass += remove_dead_quads(method);
+		removed += pass;
+	} while(pass > 0);
+
+	return removed;
+}
+
+
+/////////////////////////
+// @REPORT
+/////////////////////////
+// Returns the number of asm instructions generated for method.
+int count_asm_instructions(const instructions_list& method, ids_info& ids){
+	int ret = 0;
+
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		ret += count_asm_instructions(*it, ids);
+	}
+
+	return ret;
+}
+
+std::vector<dead_code_report> eliminate_dead_code(instructions_list& code,
+												ids_info& ids){
+	std::vector<instructions_list> methods = split_into_methods(code);
+	std::vector<dead_code_report> ret;
+
+	for(std::vector<instructions_list>::iterator it = methods.begin();
+	it != methods.end(); ++it){
+		if(it->empty() || !is_method_label_inst((*it)[0])){
+			// {quads outside of any method}
+			continue;
+		}
+
+		dead_code_report report;
+		int asm_instructions = count_asm_instructions(*it, ids);
+
+		report.method = get_label_inst_label((*it)[0]);
+		report.quads = eliminate_dead_code(*it);
+		report.asm_instructions = asm_instructions -
+								count_asm_instructions(*it, ids);
+		ret.push_back(report);
+	}
+
+	instructions_list *joined = join_methods(methods);
+	code = *joined;
+	delete joined;
+
+	return ret;
+}
+
+std::string print_dead_code_report(
+								const std::vector<dead_code_report>& reports){
+	std::ostringstream ret;
+
+	for(std::vector<dead_code_report>::const_iterator it = reports.begin();
+	it != reports.end(); ++it){
+		ret << it->method << ": " << it->quads << " quads, "
+			<< it->asm_instructions << " asm instructions saved."
+			<< std::endl;
+	}
+
+	return ret.str();
+}
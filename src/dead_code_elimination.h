@@ -0,0 +1,44 @@
+#ifndef DEAD_CODE_ELIMINATION_H_
+#define DEAD_CODE_ELIMINATION_H_
+
+#include <string>
+#include <vector>
+#include "three_address_code.h"
+#include "intermediate_symtable.h"
+
+// Savings of the elimination of dead code from a method.
+struct dead_code_report {
+	std::string method; // Label of the method.
+	unsigned int quads; // Quads removed.
+	int asm_instructions; // Asm instructions that are no longer generated.
+};
+
+/* Removes the quads whose only effect is to define a scalar variable (see
+ * get_scalar_variables) that is not live after them. Calls, stores through
+ * indexed copies and divisions that could fail at run time are always kept.
+ * Works both into and out of SSA form. Returns the number of quads removed.
+ * PRE : {method is the code of a single method} */
+unsigned int remove_dead_quads(instructions_list& method);
+
+/* Removes jumps to the quad that follows them. Returns the number of quads
+ * removed. */
+unsigned int remove_jumps_to_next(instructions_list& code);
+
+/* Removes from method unreachable blocks (e.g.: code after a return, break or
+ * continue), jumps to the next quad, labels not referenced and dead quads,
+ * until there is nothing else to remove. Returns the number of quads removed.
+ * PRE : {method is the code of a single method, out of SSA form} */
+unsigned int eliminate_dead_code(instructions_list& method);
+
+/* Eliminates the dead code of every method of code. For each method, reports
+ * the quads removed and the decrease of the asm instructions that
+ * asm_code_generator emits for it (see count_asm_instructions), with the
+ * symbols of ids.
+ * PRE : {code is out of SSA form} */
+std::vector<dead_code_report> eliminate_dead_code(instructions_list& code,
+												ids_info& ids);
+
+// Returns a line per method, with the savings reported.
+std::string print_dead_code_report(const std::vector<dead_code_report>&);
+
+#endif // DEAD_CODE_ELIMINATION_H_
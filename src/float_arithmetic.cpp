@@ -0,0 +1,450 @@
+#include "float_arithmetic.h"
+#include "constants.h"
+
+/////////////////////////
+// @AUXILIARY
+/////////////////////////
+
+// Is address a float constant, or a name of float_names?
+bool is_float_address(const address_pointer& address,
+					const std::unordered_set<std::string>& float_names){
+	bool ret = false;
+
+	if(address != nullptr){
+		switch(get_address_type(address)){
+			case address_type::ADDRESS_CONSTANT:
+				ret = get_constant_address_type(address) == value_type::FLOAT;
+				break;
+
+			case address_type::ADDRESS_NAME:
+				ret = float_names.find(get_address_name(address)) !=
+					  float_names.end();
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	return ret;
+}
+
+/* Adds the name of address to float_names, unless it is declared into ids
+ * with a type other than T_FLOAT. Returns true if it wasn't there. */
+bool add_float_name(const address_pointer& address,
+					ids_info& ids,
+					std::unordered_set<std::string>& float_names){
+	bool ret = false;
+
+	if(address != nullptr and
+	get_address_type(address) == address_type::ADDRESS_NAME){
+		std::string name = get_address_name(address);
+
+		if(not ids.id_exists(name) or ids.get_type(name) == T_UNDEFINED or
+		ids.get_type(name) == T_FLOAT){
+			ret = float_names.insert(name).second;
+		}
+	}
+
+	return ret;
+}
+
+// Value of the immediate operand, as a float.
+float get_immediate_float(const operand_pointer& operand){
+	// PRE
+	#ifdef __DEBUG
+		assert(get_operand_addressing(operand) ==
+			   operand_addressing::IMMEDIATE);
+	#endif
+
+	float ret;
+
+	if(operand->value.imm.imm_op_type == immediate_op_type::FLOAT){
+		ret = operand->value.imm.val.fval;
+	}
+	else{
+		ret = (float) operand->value.imm.val.ival;
+	}
+
+	return ret;
+}
+
+bool is_immediate_operand(const operand_pointer& operand){
+	return get_operand_addressing(operand) == operand_addressing::IMMEDIATE;
+}
+
+/////////////////////////
+// @INTERFACE
+/////////////////////////
+operand_pointer float_literal_pool::get_operand(float value){
+	unsigned int bits = get_float_bits(value);
+	unsigned int i = 0;
+
+	while(i < literals.size() and literals[i] != bits){
+		i++;
+	}
+
+	if(i == literals.size()){
+		literals.push_back(bits);
+	}
+
+	return new_rip_relative_operand(std::string("LC") + std::to_string(i));
+}
+
+void float_literal_pool::emit(asm_instructions_list& code) const{
+	if(literals.empty()){
+		return;
+	}
+
+	code.push_back(new_section_directive(std::string(".rodata")));
+	code.push_back(new_align_directive(FLOAT_WIDTH));
+	for(unsigned int i = 0; i < literals.size(); i++){
+		code.push_back(new_label_instruction(std::string("LC") +
+											std::to_string(i)));
+		code.push_back(new_long_directive(literals[i]));
+	}
+}
+
+bool float_literal_pool::empty() const{
+	return literals.empty();
+}
+
+std::unordered_set<std::string> get_float_names(const instructions_list& ir,
+												ids_info& ids){
+	std::unordered_set<std::string> ret;
+	// Labels of the methods that return a float.
+	std::unordered_set<std::string> float_methods;
+	bool changes = true;
+
+	// A definition can be found after its uses (e.g., into loops, or calls
+	// of methods defined later): iterate until nothing changes.
+	while(changes){
+		changes = false;
+		std::string method;
+
+		for(instructions_list::const_iterator it = ir.begin(); it != ir.end();
+		++it){
+			const quad_pointer& inst = *it;
+			address_pointer definition = get_inst_definition(inst);
+			std::vector<address_pointer*> uses = get_inst_uses(inst);
+			bool defines_float = false;
+
+			switch(get_inst_type(inst)){
+				case quad_type::LABEL:
+					if(is_method_label_inst(inst)){
+						method = get_label_inst_label(inst);
+					}
+					break;
+
+				case quad_type::BINARY_ASSIGN:
+					switch(get_inst_op(inst)){
+						case quad_oper::PLUS:
+						case quad_oper::MINUS:
+						case quad_oper::TIMES:
+						case quad_oper::DIVIDE:
+							defines_float = is_float_address(inst->arg1, ret) or
+											is_float_address(inst->arg2, ret);
+							break;
+
+						default:
+							break;
+					}
+					break;
+
+				case quad_type::UNARY_ASSIGN:
+					defines_float = get_inst_op(inst) == quad_oper::NEGATIVE and
+									is_float_address(inst->arg1, ret);
+					break;
+
+				case quad_type::COPY:
+					defines_float = is_float_address(inst->arg1, ret);
+					break;
+
+				case quad_type::INDEXED_COPY_FROM:{
+					std::string array = get_address_name(
+										get_indexed_copy_from_src(inst));
+
+					defines_float = ids.id_exists(array) and
+									ids.get_kind(array) != K_OBJECT and
+									ids.get_type(array) == T_FLOAT;
+					break;
+				}
+
+				case quad_type::FUNCTION_CALL:
+					defines_float = float_methods.find(
+									get_procedure_or_function_call_label(inst)) !=
+									float_methods.end();
+					break;
+
+				case quad_type::RETURN:
+					if(is_float_address(inst->arg1, ret)){
+						changes = float_methods.insert(method).second or changes;
+					}
+					break;
+
+				default:
+					break;
+			}
+
+			if(defines_float){
+				changes = add_float_name(definition, ids, ret) or changes;
+			}
+
+			// Declared floats.
+			if(definition != nullptr and
+			get_address_type(definition) == address_type::ADDRESS_NAME and
+			ids.id_exists(get_address_name(definition)) and
+			ids.get_type(get_address_name(definition)) == T_FLOAT){
+				changes = add_float_name(definition, ids, ret) or changes;
+			}
+			for(std::vector<address_pointer*>::iterator use = uses.begin();
+			use != uses.end(); ++use){
+				if(**use != nullptr and
+				get_address_type(**use) == address_type::ADDRESS_NAME and
+				ids.id_exists(get_address_name(**use)) and
+				ids.get_type(get_address_name(**use)) == T_FLOAT and
+				ids.get_kind(get_address_name(**use)) != K_OBJECT){
+					changes = add_float_name(**use, ids, ret) or changes;
+				}
+			}
+		}
+	}
+
+	return ret;
+}
+
+operand_pointer translate_float_operand(asm_instructions_list& code,
+										float_literal_pool& pool,
+										const operand_pointer& operand,
+										bool is_float,
+										register_id scratch){
+	operand_pointer ret = operand;
+
+	if(is_immediate_operand(operand)){
+		ret = pool.get_operand(get_immediate_float(operand));
+	}
+	else if(not is_float){
+		// {operand is an integer into a register or memory}
+		ret = new_register_operand(scratch);
+		code.push_back(new_cvtsi2ss_instruction(operand, ret, data_type::L));
+	}
+
+	return ret;
+}
+
+void translate_float_arithmetic(asm_instructions_list& code,
+								float_literal_pool& pool,
+								quad_oper op,
+								const operand_pointer& x,
+								const operand_pointer& y,
+								bool y_is_float,
+								const operand_pointer& z,
+								bool z_is_float){
+	// PRE
+	#ifdef __DEBUG
+		assert(op == quad_oper::PLUS or op == quad_oper::MINUS or
+			   op == quad_oper::TIMES or op == quad_oper::DIVIDE);
+	#endif
+
+	if(is_immediate_operand(y) and is_immediate_operand(z)){
+		// Single-precision arithmetic, as SSE does it.
+		float a = get_immediate_float(y), b = get_immediate_float(z), value;
+
+		switch(op){
+			case quad_oper::PLUS:
+				value = a + b;
+				break;
+
+			case quad_oper::MINUS:
+				value = a - b;
+				break;
+
+			case quad_oper::TIMES:
+				value = a * b;
+				break;
+
+			default:
+				// {op == quad_oper::DIVIDE}
+				value = a / b;
+		}
+
+		code.push_back(new_mov_instruction(new_immediate_float_operand(value),
+											x,
+											data_type::L));
+		return;
+	}
+
+	operand_pointer acc = new_register_operand(FLOAT_ACCUMULATOR);
+	operand_pointer source = translate_float_operand(code, pool, y, y_is_float,
+													FLOAT_ACCUMULATOR);
+
+	if(get_operand_addressing(source) != operand_addressing::REGISTER){
+		// {y wasn't converted into acc}
+		code.push_back(new_movss_instruction(source, acc));
+	}
+	source = translate_float_operand(code, pool, z, z_is_float, FLOAT_SCRATCH);
+
+	switch(op){
+		case quad_oper::PLUS:
+			code.push_back(new_addss_instruction(source, acc));
+			break;
+
+		case quad_oper::MINUS:
+			code.push_back(new_subss_instruction(source, acc));
+			break;
+
+		case quad_oper::TIMES:
+			code.push_back(new_mulss_instruction(source, acc));
+			break;
+
+		default:
+			// {op == quad_oper::DIVIDE}
+			code.push_back(new_divss_instruction(source, acc));
+	}
+
+	code.push_back(new_movss_instruction(acc, x));
+}
+
+void translate_float_negation(asm_instructions_list& code,
+							float_literal_pool& pool,
+							const operand_pointer& x,
+							const operand_pointer& y,
+							bool y_is_float){
+	if(is_immediate_operand(y)){
+		code.push_back(new_mov_instruction(
+								new_immediate_float_operand(
+											-get_immediate_float(y)),
+								x,
+								data_type::L));
+		return;
+	}
+
+	operand_pointer acc = new_register_operand(FLOAT_ACCUMULATOR);
+	operand_pointer source = translate_float_operand(code, pool, y, y_is_float,
+													FLOAT_ACCUMULATOR);
+
+	if(get_operand_addressing(source) != operand_addressing::REGISTER){
+		code.push_back(new_movss_instruction(source, acc));
+	}
+	code.push_back(new_mulss_instruction(pool.get_operand(-1.0f), acc));
+	code.push_back(new_movss_instruction(acc, x));
+}
+
+/* Appends to code the ucomiss of translate_float_relational_jump: for < and
+ * <=, z is compared with y, so that their conditions are those of > and >=
+ * (ja and jae, or seta and setae, that don't hold for NaN). */
+void translate_float_comparison(asm_instructions_list& code,
+								float_literal_pool& pool,
+								quad_oper relop,
+								const operand_pointer& y,
+								bool y_is_float,
+								const operand_pointer& z,
+								bool z_is_float){
+	bool swaps = relop == quad_oper::LESS or relop == quad_oper::LESS_EQUAL;
+	operand_pointer acc = new_register_operand(FLOAT_ACCUMULATOR);
+	operand_pointer source = translate_float_operand(code, pool,
+													swaps ? z : y,
+													swaps ? z_is_float :
+															y_is_float,
+													FLOAT_ACCUMULATOR);
+
+	if(get_operand_addressing(source) != operand_addressing::REGISTER){
+		code.push_back(new_movss_instruction(source, acc));
+	}
+	source = translate_float_operand(code, pool,
+									swaps ? y : z,
+									swaps ? y_is_float : z_is_float,
+									FLOAT_SCRATCH);
+	// Flags based on acc - source.
+	code.push_back(new_ucomiss_instruction(source, acc));
+}
+
+void translate_float_relational_jump(asm_instructions_list& code,
+									float_literal_pool& pool,
+									quad_oper relop,
+									const operand_pointer& y,
+									bool y_is_float,
+									const operand_pointer& z,
+									bool z_is_float,
+									const std::string& label,
+									const std::string& unordered_label){
+	translate_float_comparison(code, pool, relop, y, y_is_float, z, z_is_float);
+
+	switch(relop){
+		case quad_oper::LESS:
+		case quad_oper::GREATER:
+			code.push_back(new_ja_instruction(label));
+			break;
+
+		case quad_oper::LESS_EQUAL:
+		case quad_oper::GREATER_EQUAL:
+			code.push_back(new_jae_instruction(label));
+			break;
+
+		case quad_oper::EQUAL:
+			// ZF is set for NaN too.
+			code.push_back(new_jp_instruction(unordered_label));
+			code.push_back(new_je_instruction(label));
+			code.push_back(new_label_instruction(unordered_label));
+			break;
+
+		default:
+			// {relop == quad_oper::DISTINCT}
+			code.push_back(new_jne_instruction(label));
+			code.push_back(new_jp_instruction(label));
+	}
+}
+
+void translate_float_relational_assign(asm_instructions_list& code,
+									float_literal_pool& pool,
+									quad_oper relop,
+									const operand_pointer& x,
+									const operand_pointer& y,
+									bool y_is_float,
+									const operand_pointer& z,
+									bool z_is_float,
+									register_id scratch,
+									register_id second_scratch){
+	// PRE
+	#ifdef __DEBUG
+		assert(get_register8(scratch) != register_id::NONE and
+			   get_register8(second_scratch) != register_id::NONE);
+	#endif
+
+	operand_pointer value = new_register_operand(scratch);
+	operand_pointer value_byte = new_register_operand(get_register8(scratch));
+	operand_pointer parity_byte = new_register_operand(
+											get_register8(second_scratch));
+
+	translate_float_comparison(code, pool, relop, y, y_is_float, z, z_is_float);
+
+	switch(relop){
+		case quad_oper::LESS:
+		case quad_oper::GREATER:
+			code.push_back(new_set_instruction(operation::SETA, value_byte));
+			break;
+
+		case quad_oper::LESS_EQUAL:
+		case quad_oper::GREATER_EQUAL:
+			code.push_back(new_set_instruction(operation::SETAE, value_byte));
+			break;
+
+		case quad_oper::EQUAL:
+			// ZF is set for NaN too.
+			code.push_back(new_set_instruction(operation::SETE, value_byte));
+			code.push_back(new_set_instruction(operation::SETNP, parity_byte));
+			code.push_back(new_and_instruction(parity_byte, value_byte,
+												data_type::B));
+			break;
+
+		default:
+			// {relop == quad_oper::DISTINCT}
+			code.push_back(new_set_instruction(operation::SETNE, value_byte));
+			code.push_back(new_set_instruction(operation::SETP, parity_byte));
+			code.push_back(new_or_instruction(parity_byte, value_byte,
+												data_type::B));
+	}
+
+	code.push_back(new_movzbl_instruction(value_byte, value));
+	code.push_back(new_mov_instruction(value, x, data_type::L));
+}
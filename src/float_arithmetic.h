@@ -0,0 +1,135 @@
+#ifndef FLOAT_ARITHMETIC_H_
+#define FLOAT_ARITHMETIC_H_
+
+#include <unordered_set>
+#include <vector>
+#include "asm_instruction.h"
+#include "three_address_code.h"
+#include "intermediate_symtable.h"
+
+/* Bibliography adopted:
+ * [1] "Intel 64 and IA-32 Architectures Software Developer's Manual, Volume
+ * 		2: Instruction Set Reference". Entries of MOVSS, ADDSS, SUBSS, MULSS,
+ * 		DIVSS, UCOMISS and CVTSI2SS.
+ *
+ * [2] "System V Application Binary Interface AMD64 Architecture Processor
+ * 		Supplement", available at http://www.x86-64.org/documentation/abi.pdf
+ * */
+
+// Scratch registers of the translations of this module: floats are never
+// kept into %xmm registers between quads.
+#define FLOAT_ACCUMULATOR register_id::XMM8
+#define FLOAT_SCRATCH register_id::XMM9
+
+/* Single-precision constants of a translation. SSE instructions don't take
+ * immediate operands: constants are read from memory, at a label of the
+ * .rodata section. */
+class float_literal_pool {
+public:
+	/* Returns the operand at the label of value, adding value to the pool if
+	 * it isn't there yet. Values are told apart by their bit pattern (0.0 and
+	 * -0.0 are different). */
+	operand_pointer get_operand(float value);
+
+	// Appends the pool to code, as a .rodata section (nothing, if empty).
+	void emit(asm_instructions_list& code) const;
+
+	bool empty() const;
+
+private:
+	std::vector<unsigned int> literals; // Bit patterns, by label number.
+};
+
+/* Returns the names of ir that hold single-precision floats. Temporaries
+ * are registered without type, so it is inferred from their definitions,
+ * following the rules of get_wider_type (semantic_analysis): a name is a
+ * float if:
+ * 		_ it is declared T_FLOAT into ids.
+ * 		_ it is defined by an arithmetic operation with a float operand, or
+ * 		by the copy or the negation of a float.
+ * 		_ it is defined by reading an element of a float array.
+ * 		_ it is defined by the call of a method that returns a float: one
+ * 		whose return instructions return a float.
+ * Names declared as integers or booleans are never floats. */
+std::unordered_set<std::string> get_float_names(const instructions_list& ir,
+												ids_info& ids);
+
+/* Returns an SSE source operand with the value of operand, as a float:
+ * 		_ immediate values (integers are converted at compile time) are read
+ * 		from pool.
+ * 		_ integer registers and memory (not is_float) are converted into
+ * 		scratch, by a cvtsi2ssl appended to code.
+ * 		_ float memory is used as it is. */
+operand_pointer translate_float_operand(asm_instructions_list& code,
+										float_literal_pool& pool,
+										const operand_pointer& operand,
+										bool is_float,
+										register_id scratch);
+
+/* Appends to code the translation of x = y op z, being op PLUS, MINUS,
+ * TIMES or DIVIDE, and at least one of y and z a float ([1]):
+ * 		movss y,%xmm8
+ * 		[add|sub|mul|div]ss z,%xmm8
+ * 		movss %xmm8,x
+ * Integer operands are widened by cvtsi2ssl (z into %xmm9). When y and z
+ * are immediate values, the result is computed at compile time, and moved
+ * into x as its bit pattern.
+ * PRE : {x is a memory operand} */
+void translate_float_arithmetic(asm_instructions_list& code,
+								float_literal_pool& pool,
+								quad_oper op,
+								const operand_pointer& x,
+								const operand_pointer& y,
+								bool y_is_float,
+								const operand_pointer& z,
+								bool z_is_float);
+
+/* Appends to code the translation of x = -y, as the product by -1.0 (that
+ * is exact, and keeps the sign of 0.0).
+ * PRE : {x is a memory operand} */
+void translate_float_negation(asm_instructions_list& code,
+							float_literal_pool& pool,
+							const operand_pointer& x,
+							const operand_pointer& y,
+							bool y_is_float);
+
+/* Appends to code the translation of if y relop z goto label, for floats.
+ * ucomiss sets the flags as an unsigned comparison, and ZF, PF and CF when
+ * y or z is NaN (unordered). Every relation, but !=, is false for NaN:
+ * 		_ <, <=: movss z,%xmm8; ucomiss y,%xmm8; ja (jae) label
+ * 		_ >, >=: movss y,%xmm8; ucomiss z,%xmm8; ja (jae) label
+ * 		_ ==: jp unordered_label; je label; unordered_label:
+ * 		_ !=: jne label; jp label
+ * PRE : {relop is a relational operator} */
+void translate_float_relational_jump(asm_instructions_list& code,
+									float_literal_pool& pool,
+									quad_oper relop,
+									const operand_pointer& y,
+									bool y_is_float,
+									const operand_pointer& z,
+									bool z_is_float,
+									const std::string& label,
+									const std::string& unordered_label);
+
+/* Appends to code the translation of x = y relop z, for floats, by the
+ * comparison of translate_float_relational_jump, followed by
+ * 		_ <, >: seta r8
+ * 		_ <=, >=: setae r8
+ * 		_ ==: sete r8; setnp s8; andb s8,r8
+ * 		_ !=: setne r8; setp s8; orb s8,r8
+ * and by movzbl r8,r; mov r,x. r is the scratch register scratch, and r8 and
+ * s8 the low bytes of scratch and of second_scratch.
+ * PRE : {relop is a relational operator, and scratch and second_scratch are
+ * 		  32-bit registers with an 8-bit register (get_register8)} */
+void translate_float_relational_assign(asm_instructions_list& code,
+									float_literal_pool& pool,
+									quad_oper relop,
+									const operand_pointer& x,
+									const operand_pointer& y,
+									bool y_is_float,
+									const operand_pointer& z,
+									bool z_is_float,
+									register_id scratch,
+									register_id second_scratch);
+
+#endif // FLOAT_ARITHMETIC_H_
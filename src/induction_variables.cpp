@@ -0,0 +1,645 @@
+#include <unordered_map>
+#include <unordered_set>
+#include <climits>
+#include "induction_variables.h"
+#include "control_flow_graph.h"
+#include "ssa.h"
+#include "constants.h"
+
+typedef std::unordered_set<std::string> names_set;
+
+/////////////////////////
+// @INDUCTION VARIABLES
+/////////////////////////
+// Value factor * basic + addend, where basic is the value of a basic induction
+// variable at the beginning of the iteration. Arithmetic wraps around.
+struct linear_value {
+	std::string basic;
+	int factor;
+	int addend;
+	bool multiplied; // Does computing it need a multiplication?
+};
+
+// Variable introduced to replace the derived ones with a given linear value:
+// current = phi(init, next), where next = current + step * factor.
+struct reduced_variable {
+	address_pointer current;
+	address_pointer next;
+	int factor;
+	int addend;
+};
+
+// basic = phi(init, next), where next = basic + step.
+struct basic_induction_variable {
+	std::string name;
+	address_pointer init; // Value at the entry of the loop.
+	std::string next;
+	int step;
+	unsigned int phi; // Positions of the PHI and the increment.
+	unsigned int increment;
+};
+
+/* Is operand an integer constant? If it is, its value is put into value. */
+bool get_integer_operand(const address_pointer& operand, int& value){
+	if(operand != nullptr &&
+	get_address_type(operand) == address_type::ADDRESS_CONSTANT &&
+	get_constant_address_type(operand) == value_type::INTEGER){
+		value = get_constant_address_integer_value(operand);
+		return true;
+	}
+
+	return false;
+}
+
+bool is_name_of(const address_pointer& operand, const std::string& name){
+	return operand != nullptr &&
+		   get_address_type(operand) == address_type::ADDRESS_NAME &&
+		   get_address_name(operand) == name;
+}
+
+/* Is operand an integer constant, or an SSA value copied from one? If it is,
+ * its value is put into value. */
+bool get_constant_value(const instructions_list& method,
+						const address_pointer& operand,
+						int& value){
+	if(get_integer_operand(operand, value)){
+		return true;
+	}
+	if(operand == nullptr ||
+	get_address_type(operand) != address_type::ADDRESS_NAME){
+		return false;
+	}
+
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		if(get_inst_type(*it) == quad_type::COPY &&
+		is_name_of(get_copy_inst_dest(*it), get_address_name(operand))){
+			return get_integer_operand(get_copy_inst_orig(*it), value);
+		}
+	}
+
+	return false;
+}
+
+int wrapping_multiply(int x, int y){
+	return (int)((unsigned int)x * (unsigned int)y);
+}
+
+int wrapping_add(int x, int y){
+	return (int)((unsigned int)x + (unsigned int)y);
+}
+
+// Does factor * x + addend fit into 32 bits, without wrapping around?
+bool fits_linear_value(long long x, int factor, int addend){
+	long long value = factor * x + addend;
+
+	return value >= INT_MIN && value <= INT_MAX;
+}
+
+/* If instruction computes an induction variable from the ones into families,
+ * puts its value into value. */
+bool get_linear_value(const quad_pointer& instruction,
+					const std::unordered_map<std::string, linear_value>& families,
+					linear_value& value){
+	if(get_inst_type(instruction) != quad_type::BINARY_ASSIGN){
+		return false;
+	}
+
+	address_pointer variable = instruction->arg1;
+	int constant;
+
+	if(!get_integer_operand(instruction->arg2, constant)){
+		if(get_inst_op(instruction) == quad_oper::MINUS ||
+		!get_integer_operand(instruction->arg1, constant)){
+			return false;
+		}
+		// {constant op variable, with a commutative op}
+		variable = instruction->arg2;
+	}
+
+	if(variable == nullptr ||
+	get_address_type(variable) != address_type::ADDRESS_NAME){
+		return false;
+	}
+
+	std::unordered_map<std::string, linear_value>::const_iterator it =
+									families.find(get_address_name(variable));
+
+	if(it == families.end()){
+		return false;
+	}
+
+	value = it->second;
+	switch(get_inst_op(instruction)){
+		case quad_oper::TIMES:
+			value.factor = wrapping_multiply(value.factor, constant);
+			value.addend = wrapping_multiply(value.addend, constant);
+			value.multiplied = true;
+			return true;
+
+		case quad_oper::PLUS:
+			value.addend = wrapping_add(value.addend, constant);
+			return true;
+
+		case quad_oper::MINUS:
+			value.addend = wrapping_add(value.addend,
+										wrapping_multiply(constant, -1));
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+/* Appends to code the quads that compute factor * x + addend, and returns the
+ * name (or constant) that holds the result. New temporaries are counted into
+ * temps. */
+address_pointer emit_linear_value(const address_pointer& x,
+								int factor,
+								int addend,
+								instructions_list& code,
+								ids_info& ids,
+								unsigned int& temps){
+	int constant;
+
+	if(get_integer_operand(x, constant)){
+		return new_integer_constant(wrapping_add(
+									wrapping_multiply(factor, constant),
+									addend));
+	}
+
+	address_pointer ret = x;
+
+	if(factor != 1){
+		address_pointer product = new_name_address(
+											*ids.new_temp(0, T_INT));
+		temps++;
+		code.push_back(new_binary_assign(product, ret,
+										new_integer_constant(factor),
+										quad_oper::TIMES));
+		ret = product;
+	}
+
+	if(addend != 0){
+		address_pointer sum = new_name_address(*ids.new_temp(0, T_INT));
+		temps++;
+		code.push_back(new_binary_assign(sum, ret,
+										new_integer_constant(addend),
+										quad_oper::PLUS));
+		ret = sum;
+	}
+
+	return ret;
+}
+
+
+/////////////////////////
+// @LOOPS
+/////////////////////////
+/* Reduces the induction variables of the loop whose header begins with
+ * header_label. Returns the number of variables reduced or removed. */
+unsigned int reduce_loop(instructions_list& method,
+						const std::string& header_label,
+						ids_info& ids,
+						unsigned int& temps){
+	control_flow_graph cfg(method);
+	int header = cfg.get_label_block(header_label);
+	const natural_loop* loop = nullptr;
+
+	for(std::vector<natural_loop>::const_iterator it = cfg.get_loops().begin();
+	it != cfg.get_loops().end(); ++it){
+		if((int)it->header == header){
+			loop = &(*it);
+			break;
+		}
+	}
+
+	if(loop == nullptr || header == 0 || loop->latches.size() != 1 ||
+	cfg.get_block(header).predecessors.size() != 2){
+		return 0;
+	}
+
+	const basic_block& header_block = cfg.get_block(header);
+	unsigned int latch = loop->latches[0];
+	unsigned int entry = header_block.predecessors[0] == latch ?
+						header_block.predecessors[1] :
+						header_block.predecessors[0];
+	const basic_block& entry_block = cfg.get_block(entry);
+	quad_type entry_last = get_inst_type(method[entry_block.last - 1]);
+
+	if(entry_block.successors.size() != 1 ||
+	entry_last == quad_type::CONDITIONAL_JUMP ||
+	entry_last == quad_type::RELATIONAL_JUMP){
+		return 0;
+	}
+
+	std::vector<unsigned int> loop_quads;
+	std::vector<bool> is_loop_quad(method.size(), false);
+
+	for(std::vector<unsigned int>::const_iterator it = loop->blocks.begin();
+	it != loop->blocks.end(); ++it){
+		for(unsigned int i = cfg.get_block(*it).first;
+		i < cfg.get_block(*it).last; i++){
+			loop_quads.push_back(i);
+			is_loop_quad[i] = true;
+		}
+	}
+
+	names_set values = get_ssa_values(method);
+	names_set entry_values = get_entry_values(method);
+	values.insert(entry_values.begin(), entry_values.end());
+
+	// Definitions into the loop, and readers of each name into the method.
+	std::unordered_map<std::string, unsigned int> definitions;
+	std::unordered_map<std::string, std::vector<unsigned int> > users;
+
+	for(std::vector<unsigned int>::iterator it = loop_quads.begin();
+	it != loop_quads.end(); ++it){
+		address_pointer definition = get_inst_definition(method[*it]);
+
+		if(definition != nullptr &&
+		get_address_type(definition) == address_type::ADDRESS_NAME){
+			definitions[get_address_name(definition)] = *it;
+		}
+	}
+
+	for(unsigned int i = 0; i < method.size(); i++){
+		std::vector<address_pointer*> uses = get_inst_uses(method[i]);
+
+		for(std::vector<address_pointer*>::iterator it = uses.begin();
+		it != uses.end(); ++it){
+			if(**it != nullptr &&
+			get_address_type(**it) == address_type::ADDRESS_NAME){
+				users[get_address_name(**it)].push_back(i);
+			}
+		}
+	}
+
+	// Basic induction variables.
+	std::string entry_label = get_label_inst_label(method[entry_block.first]);
+	std::string latch_label = get_label_inst_label(
+											method[cfg.get_block(latch).first]);
+	std::vector<basic_induction_variable> basics;
+	std::unordered_map<std::string, linear_value> families;
+
+	for(unsigned int i = header_block.first; i < header_block.last; i++){
+		if(get_inst_type(method[i]) != quad_type::PHI ||
+		get_phi_arguments(method[i]).size() != 2){
+			continue;
+		}
+
+		basic_induction_variable basic;
+		basic.name = get_address_name(get_phi_inst_dest(method[i]));
+		basic.init = get_phi_argument(method[i], entry_label);
+		address_pointer next = get_phi_argument(method[i], latch_label);
+
+		if(basic.init == nullptr || next == nullptr ||
+		get_address_type(next) != address_type::ADDRESS_NAME ||
+		definitions.find(get_address_name(next)) == definitions.end() ||
+		values.find(basic.name) == values.end()){
+			continue;
+		}
+		basic.next = get_address_name(next);
+		basic.phi = i;
+		basic.increment = definitions[basic.next];
+
+		linear_value value;
+		families[basic.name] = linear_value{basic.name, 1, 0, false};
+		if(get_linear_value(method[basic.increment], families, value) &&
+		value.basic == basic.name && value.factor == 1){
+			basic.step = value.addend;
+			families[basic.next] = value;
+			basics.push_back(basic);
+		}
+		else{
+			families.erase(basic.name);
+		}
+	}
+
+	if(basics.empty()){
+		return 0;
+	}
+
+	// Derived induction variables.
+	bool changed = true;
+
+	while(changed){
+		changed = false;
+		for(std::vector<unsigned int>::iterator it = loop_quads.begin();
+		it != loop_quads.end(); ++it){
+			address_pointer definition = get_inst_definition(method[*it]);
+			linear_value value;
+
+			if(definition != nullptr &&
+			get_address_type(definition) == address_type::ADDRESS_NAME &&
+			values.find(get_address_name(definition)) != values.end() &&
+			families.find(get_address_name(definition)) == families.end() &&
+			get_linear_value(method[*it], families, value)){
+				families[get_address_name(definition)] = value;
+				changed = true;
+			}
+		}
+	}
+
+	// Derived variables computed with a multiplication, used by something
+	// else than another one of them, are reduced.
+	std::vector<bool> removed(method.size(), false);
+	std::vector<unsigned int> reduced;
+
+	for(std::vector<unsigned int>::iterator it = loop_quads.begin();
+	it != loop_quads.end(); ++it){
+		address_pointer definition = get_inst_definition(method[*it]);
+
+		if(definition == nullptr ||
+		get_address_type(definition) != address_type::ADDRESS_NAME ||
+		families.find(get_address_name(definition)) == families.end() ||
+		!families[get_address_name(definition)].multiplied){
+			continue;
+		}
+
+		std::vector<unsigned int>& readers = users[get_address_name(
+																definition)];
+
+		for(std::vector<unsigned int>::iterator reader = readers.begin();
+		reader != readers.end(); ++reader){
+			address_pointer defined = get_inst_definition(method[*reader]);
+
+			if(defined == nullptr ||
+			get_address_type(defined) != address_type::ADDRESS_NAME ||
+			families.find(get_address_name(defined)) == families.end() ||
+			!families[get_address_name(defined)].multiplied){
+				reduced.push_back(*it);
+				removed[*it] = true;
+				break;
+			}
+		}
+	}
+
+	if(reduced.empty()){
+		return 0;
+	}
+
+	// Derived variables only used to compute the ones reduced, are dead now.
+	std::unordered_set<unsigned int> increments;
+
+	for(std::vector<basic_induction_variable>::iterator it = basics.begin();
+	it != basics.end(); ++it){
+		increments.insert(it->increment);
+	}
+
+	changed = true;
+	while(changed){
+		changed = false;
+		for(std::vector<unsigned int>::iterator it = loop_quads.begin();
+		it != loop_quads.end(); ++it){
+			address_pointer definition = get_inst_definition(method[*it]);
+
+			if(removed[*it] || increments.count(*it) > 0 ||
+			get_inst_type(method[*it]) != quad_type::BINARY_ASSIGN ||
+			definition == nullptr ||
+			get_address_type(definition) != address_type::ADDRESS_NAME ||
+			families.find(get_address_name(definition)) == families.end()){
+				continue;
+			}
+
+			bool dead = true;
+			std::vector<unsigned int>& readers = users[get_address_name(
+																definition)];
+
+			for(std::vector<unsigned int>::iterator reader = readers.begin();
+			reader != readers.end() && dead; ++reader){
+				dead = removed[*reader];
+			}
+
+			if(dead){
+				removed[*it] = true;
+				changed = true;
+			}
+		}
+	}
+
+	// New induction variables: initialization before the loop, PHI into the
+	// header, and increment after the one of their basic variable.
+	instructions_list entry_code;
+	instructions_list phis;
+	std::unordered_map<unsigned int, instructions_list> steps;
+	std::unordered_map<std::string, address_pointer> replacements;
+	// Each new variable, by basic variable, factor and addend.
+	std::unordered_map<std::string, reduced_variable> created;
+	// First new variable with a positive factor of each basic variable.
+	std::unordered_map<std::string, std::string> test_variables;
+	unsigned int ret = 0;
+
+	for(std::vector<unsigned int>::iterator it = reduced.begin();
+	it != reduced.end(); ++it){
+		std::string name = get_address_name(get_inst_definition(method[*it]));
+		const linear_value& value = families[name];
+		std::string key = value.basic + "*" + std::to_string(value.factor) +
+						  "+" + std::to_string(value.addend);
+
+		if(created.find(key) == created.end()){
+			const basic_induction_variable* basic = nullptr;
+
+			for(std::vector<basic_induction_variable>::iterator b =
+			basics.begin(); b != basics.end(); ++b){
+				if(b->name == value.basic){
+					basic = &(*b);
+				}
+			}
+
+			address_pointer init = emit_linear_value(basic->init,
+													value.factor,
+													value.addend,
+													entry_code, ids, temps);
+			address_pointer current = new_name_address(
+												*ids.new_temp(0, T_INT));
+			address_pointer next = new_name_address(*ids.new_temp(0, T_INT));
+			quad_pointer phi = new_phi_inst(current, current);
+
+			temps += 2;
+			add_phi_argument(phi, init, new_label_address(entry_label));
+			add_phi_argument(phi, next, new_label_address(latch_label));
+			phis.push_back(phi);
+			steps[basic->increment].push_back(new_binary_assign(next, current,
+									new_integer_constant(wrapping_multiply(
+										basic->step, value.factor)),
+									quad_oper::PLUS));
+			created[key] = reduced_variable{current, next, value.factor,
+											value.addend};
+
+			if(value.factor > 0 &&
+			test_variables.find(value.basic) == test_variables.end()){
+				test_variables[value.basic] = key;
+			}
+		}
+		replacements[name] = created[key].current;
+		ret++;
+	}
+
+	// Removal of the basic variables only used to be increased and tested.
+	std::unordered_map<unsigned int, quad_pointer> tests;
+
+	for(std::vector<basic_induction_variable>::iterator it = basics.begin();
+	it != basics.end(); ++it){
+		if(test_variables.find(it->name) == test_variables.end()){
+			continue;
+		}
+
+		// Readers still alive, besides the PHI and the increment.
+		std::vector<unsigned int> readers;
+
+		for(std::vector<unsigned int>::iterator reader =
+		users[it->name].begin(); reader != users[it->name].end(); ++reader){
+			if(!removed[*reader] && *reader != it->increment){
+				readers.push_back(*reader);
+			}
+		}
+		for(std::vector<unsigned int>::iterator reader =
+		users[it->next].begin(); reader != users[it->next].end(); ++reader){
+			if(!removed[*reader] && *reader != it->phi){
+				readers.push_back(*reader);
+			}
+		}
+
+		if(readers.size() != 1 || !is_loop_quad[readers[0]] ||
+		get_inst_type(method[readers[0]]) != quad_type::RELATIONAL_JUMP){
+			continue;
+		}
+
+		const quad_pointer& test = method[readers[0]];
+		bool tests_first = is_name_of(test->arg1, it->name) ||
+						   is_name_of(test->arg1, it->next);
+		address_pointer bound = tests_first ? test->arg2 : test->arg1;
+		const reduced_variable& reduced_iv = created[test_variables[it->name]];
+		int init;
+		int limit;
+
+		/* The scaled test is the same one only if the scaled values don't
+		 * wrap around: the new variable goes from the scaled init to, at
+		 * most, one step past the scaled bound. */
+		if(!get_constant_value(method, it->init, init) ||
+		!get_constant_value(method, bound, limit) ||
+		!fits_linear_value(init, reduced_iv.factor, reduced_iv.addend) ||
+		!fits_linear_value(limit, reduced_iv.factor, reduced_iv.addend) ||
+		!fits_linear_value(it->step, reduced_iv.factor, 0) ||
+		!fits_linear_value((long long)limit + it->step, reduced_iv.factor,
+						   reduced_iv.addend)){
+			continue;
+		}
+
+		bool tests_next = is_name_of(tests_first ? test->arg1 : test->arg2,
+									it->next);
+		// next scales the same way as the basic variable.
+		address_pointer variable = tests_next ? reduced_iv.next :
+												reduced_iv.current;
+		address_pointer scaled = emit_linear_value(bound, reduced_iv.factor,
+													reduced_iv.addend,
+													entry_code, ids, temps);
+		quad_pointer new_test = copy_instruction(test);
+
+		if(tests_first){
+			new_test->arg1 = variable;
+			new_test->arg2 = scaled;
+		}
+		else{
+			new_test->arg1 = scaled;
+			new_test->arg2 = variable;
+		}
+		tests[readers[0]] = new_test;
+		removed[it->phi] = true;
+		removed[it->increment] = true;
+		ret++;
+	}
+
+	// Rewrite the method.
+	unsigned int last_phi = header_block.first;
+
+	for(unsigned int i = header_block.first; i < header_block.last; i++){
+		if(get_inst_type(method[i]) == quad_type::PHI){
+			last_phi = i;
+		}
+	}
+
+	instructions_list code;
+
+	for(unsigned int i = 0; i < method.size(); i++){
+		if(i == entry_block.last - 1 &&
+		entry_last == quad_type::UNCONDITIONAL_JUMP){
+			code.insert(code.end(), entry_code.begin(), entry_code.end());
+		}
+
+		if(!removed[i]){
+			quad_pointer instruction = tests.count(i) > 0 ? tests[i] :
+															method[i];
+			std::vector<address_pointer*> uses = get_inst_uses(instruction);
+			bool replaced = false;
+
+			for(std::vector<address_pointer*>::iterator it = uses.begin();
+			it != uses.end() && !replaced; ++it){
+				replaced = **it != nullptr &&
+						   get_address_type(**it) == address_type::ADDRESS_NAME &&
+						   replacements.count(get_address_name(**it)) > 0;
+			}
+
+			if(replaced){
+				// Other methods may share the quad.
+				instruction = copy_instruction(instruction);
+				uses = get_inst_uses(instruction);
+				for(std::vector<address_pointer*>::iterator it = uses.begin();
+				it != uses.end(); ++it){
+					if(**it != nullptr &&
+					get_address_type(**it) == address_type::ADDRESS_NAME &&
+					replacements.count(get_address_name(**it)) > 0){
+						**it = replacements[get_address_name(**it)];
+					}
+				}
+			}
+			code.push_back(instruction);
+		}
+
+		if(i == entry_block.last - 1 &&
+		entry_last != quad_type::UNCONDITIONAL_JUMP){
+			code.insert(code.end(), entry_code.begin(), entry_code.end());
+		}
+		if(i == last_phi){
+			code.insert(code.end(), phis.begin(), phis.end());
+		}
+		if(steps.count(i) > 0){
+			code.insert(code.end(), steps[i].begin(), steps[i].end());
+		}
+	}
+
+	method = code;
+
+	return ret;
+}
+
+unsigned int reduce_induction_variables(instructions_list& method,
+										ids_info& ids){
+	std::vector<std::string> headers;
+
+	{
+		control_flow_graph cfg(method);
+
+		// {every block into SSA form begins with a label}
+		for(std::vector<natural_loop>::const_iterator it =
+		cfg.get_loops().begin(); it != cfg.get_loops().end(); ++it){
+			headers.push_back(get_label_inst_label(
+									method[cfg.get_block(it->header).first]));
+		}
+	}
+
+	unsigned int ret = 0;
+	unsigned int temps = 0;
+
+	// Inner loops come after the loops that enclose them.
+	for(std::vector<std::string>::reverse_iterator it = headers.rbegin();
+	it != headers.rend(); ++it){
+		ret += reduce_loop(method, *it, ids, temps);
+	}
+
+	// Every new variable is an integer.
+	add_enter_bytes(method, temps*INTEGER_WIDTH);
+
+	return ret;
+}
@@ -0,0 +1,42 @@
+#ifndef INDUCTION_VARIABLES_H_
+#define INDUCTION_VARIABLES_H_
+
+#include "three_address_code.h"
+#include "intermediate_symtable.h"
+
+/* Bibliography adopted:
+ * [1] "Operator Strength Reduction", Keith D. Cooper, L. Taylor Simpson and
+ * 		Christopher A. Vick. ACM TOPLAS, 2001.
+ * */
+
+/* Strength reduction of the induction variables of the natural loops of
+ * method, as those of the code generated for "for i = a, b" statements, where
+ * each access to an array computes its offset as i * width (plus the offset of
+ * the attribute, for arrays into objects).
+ *
+ * A basic induction variable is a PHI of the header of a loop whose value
+ * flows back from the loop increased (or decreased) by a constant. A derived
+ * induction variable is an SSA value computed from another induction variable
+ * by multiplying, adding or subtracting a constant. Each derived variable that
+ * needs a multiplication, and is used by something else than another one of
+ * them, is replaced by a new PHI: its value is computed once before the loop,
+ * and increased by a constant at the point where its basic variable is
+ * increased ([1]).
+ *
+ * Then, if the basic variable is only used to be increased and by the test
+ * that exits the loop, the test is rewritten to compare one of the new
+ * variables (with a positive factor) against the bound scaled the same way,
+ * and the basic variable is removed. Integer arithmetic wraps around, so the
+ * test is rewritten only when the initial value and the bound are constants,
+ * and the scaled values of the new variable (up to one step past the bound)
+ * fit into 32 bits.
+ *
+ * Only loops with a single back edge, entered from a single block that has
+ * the header as its only successor, are modified.
+ *
+ * Returns the number of induction variables reduced or removed.
+ * PRE : {method is the code of a single method, into SSA form} */
+unsigned int reduce_induction_variables(instructions_list& method,
+										ids_info& ids);
+
+#endif // INDUCTION_VARIABLES_H_
@@ -0,0 +1,415 @@
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include "inlining.h"
+#include "control_flow_graph.h"
+#include "ssa.h"
+#include "constants.h"
+
+#ifdef __DEBUG
+	#include <cassert>
+#endif
+
+typedef std::unordered_set<std::string> names_set;
+
+bool is_call_inst(const quad_pointer& instruction){
+	return get_inst_type(instruction) == quad_type::PROCEDURE_CALL ||
+		   get_inst_type(instruction) == quad_type::FUNCTION_CALL;
+}
+
+// Quads of method, without its label and its ENTER_PROCEDURE.
+unsigned int get_body_size(const instructions_list& method){
+	unsigned int ret = 0;
+
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		if(!is_method_label_inst(*it) &&
+		get_inst_type(*it) != quad_type::ENTER_PROCEDURE){
+			ret++;
+		}
+	}
+
+	return ret;
+}
+
+// Names that appear into method.
+names_set get_method_names(const instructions_list& method){
+	names_set ret;
+
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		address_pointer operands[] = {(*it)->arg1, (*it)->arg2, (*it)->result};
+
+		for(unsigned int i = 0; i < 3; i++){
+			if(operands[i] != nullptr &&
+			get_address_type(operands[i]) == address_type::ADDRESS_NAME){
+				ret.insert(get_address_name(operands[i]));
+			}
+		}
+	}
+
+	return ret;
+}
+
+
+/////////////////////////
+// @INLINER
+/////////////////////////
+class inliner {
+public:
+	inliner(instructions_list& code,
+			ids_info& ids,
+			const execution_profile* profile);
+
+	// Inlines calls into every method. Returns the number of calls inlined.
+	unsigned int run();
+
+private:
+	enum class visit_state { NOT_VISITED, ON_STACK, VISITED };
+
+	instructions_list& code;
+	ids_info& ids;
+	std::vector<instructions_list> methods;
+	std::unordered_map<std::string, unsigned int> method_index;
+	std::vector<visit_state> states;
+	// Parameters of each method, "this" first, and whether they are known.
+	std::vector<std::vector<std::string> > params;
+	std::vector<bool> inlinable;
+	// Calls to each method, into the whole program.
+	std::vector<unsigned int> call_sites;
+	// Executions of the calls of the code given, if there is a profile.
+	std::unordered_map<const quad*, unsigned long> call_counts;
+	unsigned long hottest_call;
+	unsigned int inlined;
+
+	// Inlines the calls of method, after visiting the methods it calls.
+	void visit(unsigned int method);
+
+	void inline_calls(unsigned int method);
+
+	/* Index of the method called by call, if it is defined into the code.
+	 * Otherwise, -1. */
+	int get_callee(const quad_pointer& call) const;
+
+	bool should_inline(unsigned int caller,
+						unsigned int callee,
+						const quad_pointer& call) const;
+
+	/* Returns a new name for the copy of name, not used by the caller. Counts
+	 * it into new_names. */
+	address_pointer new_name(const std::string& name,
+							names_set& used,
+							unsigned int& new_names);
+};
+
+inliner::inliner(instructions_list& _code,
+				ids_info& _ids,
+				const execution_profile* profile) :
+code(_code), ids(_ids), hottest_call(0), inlined(0) {
+	methods = split_into_methods(code);
+	states = std::vector<visit_state>(methods.size(),
+										visit_state::NOT_VISITED);
+	params = std::vector<std::vector<std::string> >(methods.size());
+	inlinable = std::vector<bool>(methods.size(), false);
+	call_sites = std::vector<unsigned int>(methods.size(), 0);
+
+	for(unsigned int m = 0; m < methods.size(); m++){
+		if(!methods[m].empty() && is_method_label_inst(methods[m][0])){
+			method_index[get_label_inst_label(methods[m][0])] = m;
+		}
+	}
+
+	for(unsigned int m = 0; m < methods.size(); m++){
+		for(instructions_list::iterator it = methods[m].begin();
+		it != methods[m].end(); ++it){
+			if(is_call_inst(*it) && this->get_callee(*it) != -1){
+				call_sites[this->get_callee(*it)]++;
+			}
+		}
+
+		if(profile != nullptr && !methods[m].empty() &&
+		is_method_label_inst(methods[m][0])){
+			std::string label = get_label_inst_label(methods[m][0]);
+			std::vector<int> positions = get_call_positions(methods[m]);
+
+			for(unsigned int i = 0; i < methods[m].size(); i++){
+				if(positions[i] != -1){
+					unsigned long count = get_call_count(*profile, label,
+														positions[i]);
+
+					call_counts[methods[m][i].get()] = count;
+					hottest_call = std::max(hottest_call, count);
+				}
+			}
+		}
+
+		if(methods[m].empty() || !is_method_label_inst(methods[m][0]) ||
+		get_body_size(methods[m]) == 0){
+			// {code before the first method, or an extern method}
+			continue;
+		}
+
+		std::string method_id = get_label_inst_method_name(methods[m][0]) +
+								"::" +
+								get_label_inst_class_name(methods[m][0]);
+
+		if(!ids.id_exists(method_id)){
+			continue;
+		}
+
+		t_params& list = ids.get_list_params(method_id);
+		names_set param_names(list.begin(), list.end());
+		names_set names = get_method_names(methods[m]);
+		bool declares_objects = false;
+
+		for(names_set::iterator it = names.begin(); it != names.end(); ++it){
+			declares_objects = declares_objects ||
+							   (param_names.find(*it) == param_names.end() &&
+							   ids.id_exists(*it) &&
+							   ids.get_kind(*it) == K_OBJECT);
+		}
+
+		params[m] = std::vector<std::string>(list.begin(), list.end());
+		inlinable[m] = !declares_objects && !params[m].empty();
+	}
+}
+
+unsigned int inliner::run(){
+	for(unsigned int m = 0; m < methods.size(); m++){
+		if(states[m] == visit_state::NOT_VISITED){
+			this->visit(m);
+		}
+	}
+
+	instructions_list* joined = join_methods(methods);
+	code = *joined;
+	delete joined;
+
+	return inlined;
+}
+
+int inliner::get_callee(const quad_pointer& call) const{
+	std::unordered_map<std::string, unsigned int>::const_iterator it =
+					method_index.find(get_procedure_or_function_call_label(call));
+
+	return it != method_index.end() ? (int)it->second : -1;
+}
+
+void inliner::visit(unsigned int method){
+	states[method] = visit_state::ON_STACK;
+
+	for(unsigned int i = 0; i < methods[method].size(); i++){
+		if(is_call_inst(methods[method][i])){
+			int callee = this->get_callee(methods[method][i]);
+
+			if(callee != -1 && states[callee] == visit_state::NOT_VISITED){
+				this->visit(callee);
+			}
+		}
+	}
+
+	this->inline_calls(method);
+	states[method] = visit_state::VISITED;
+}
+
+bool inliner::should_inline(unsigned int caller,
+							unsigned int callee,
+							const quad_pointer& call) const{
+	unsigned int size = get_body_size(methods[callee]);
+	// The parameters and the call go away.
+	unsigned int call_size = params[callee].size() + 1;
+	bool profitable = size <= call_size + INLINE_GROWTH_LIMIT ||
+					  (call_sites[callee] == 1 &&
+					  size <= INLINE_SINGLE_CALL_LIMIT);
+	std::unordered_map<const quad*, unsigned long>::const_iterator count =
+												call_counts.find(call.get());
+
+	if(count != call_counts.end()){
+		if(count->second == 0){
+			// Cold call.
+			profitable = size <= call_size;
+		}
+		else if(count->second*INLINE_HOT_CALL_RATIO >= hottest_call){
+			profitable = profitable ||
+						 size <= call_size + INLINE_HOT_GROWTH_LIMIT;
+		}
+	}
+
+	// A callee still into the stack is part of a recursive cycle.
+	return states[callee] == visit_state::VISITED && inlinable[callee] &&
+		   profitable && methods[caller].size() + size <= INLINE_METHOD_LIMIT;
+}
+
+address_pointer inliner::new_name(const std::string& name,
+								names_set& used,
+								unsigned int& new_names){
+	std::string version;
+	unsigned int counter = 0;
+
+	do{
+		version = name + "@" + std::to_string(++counter);
+	}while(used.find(version) != used.end() || ids.id_exists(version));
+
+	used.insert(version);
+	if(ids.id_exists(name)){
+		ids.register_version(name, version);
+	}
+	new_names++;
+
+	return new_name_address(version);
+}
+
+void inliner::inline_calls(unsigned int method){
+	instructions_list& caller = methods[method];
+	names_set used = get_method_names(caller);
+	unsigned int new_names = 0;
+	unsigned int i = 0;
+
+	while(i < caller.size()){
+		int callee = is_call_inst(caller[i]) ? this->get_callee(caller[i]) : -1;
+		std::vector<unsigned int> positions;
+
+		if(callee == -1 || !this->should_inline(method, callee, caller[i]) ||
+		params[callee].size() != get_call_param_quantity(caller[i]) + 1 ||
+		!find_call_parameters(caller, i, positions)){
+			i++;
+			continue;
+		}
+
+		// Parameters: "this" and objects are replaced by their argument, the
+		// others are copied into a new variable.
+		std::unordered_map<std::string, address_pointer> names;
+		std::vector<quad_pointer> param_copies(positions.size(), nullptr);
+
+		for(unsigned int k = 0; k < positions.size(); k++){
+			const std::string& param = params[callee][k];
+			address_pointer argument = get_param_inst_param(
+														caller[positions[k]]);
+
+			if(k == 0 || (ids.id_exists(param) &&
+			ids.get_kind(param) == K_OBJECT)){
+				names[param] = argument;
+			}
+			else{
+				names[param] = this->new_name(param, used, new_names);
+				param_copies[k] = new_copy(names[param], argument);
+			}
+		}
+
+		// Labels of the callee.
+		std::unordered_map<std::string, address_pointer> labels;
+		const instructions_list& body = methods[callee];
+
+		for(instructions_list::const_iterator it = body.begin();
+		it != body.end(); ++it){
+			if(get_inst_type(*it) == quad_type::LABEL &&
+			!is_method_label_inst(*it)){
+				labels[get_label_inst_label(*it)] = new_label_address(
+											*ids.new_temp(0, T_UNDEFINED));
+			}
+		}
+
+		// Copy of the body.
+		address_pointer result = get_inst_type(caller[i]) ==
+									quad_type::FUNCTION_CALL ?
+									get_function_call_dest(caller[i]) : nullptr;
+		address_pointer end = nullptr;
+		instructions_list copy;
+
+		for(unsigned int j = 0; j < body.size(); j++){
+			if(is_method_label_inst(body[j]) ||
+			get_inst_type(body[j]) == quad_type::ENTER_PROCEDURE){
+				continue;
+			}
+
+			quad_pointer instruction = copy_instruction(body[j]);
+			address_pointer* operands[] = {&instruction->arg1,
+											&instruction->arg2,
+											&instruction->result};
+
+			for(unsigned int k = 0; k < 3; k++){
+				address_pointer& operand = *operands[k];
+
+				if(operand == nullptr){
+					continue;
+				}
+
+				if(get_address_type(operand) == address_type::ADDRESS_NAME){
+					std::string name = get_address_name(operand);
+
+					if(names.find(name) == names.end()){
+						names[name] = this->new_name(name, used, new_names);
+					}
+					operand = names[name];
+				}
+				else if(get_address_type(operand) ==
+				address_type::ADDRESS_LABEL &&
+				labels.find(get_label_address_value(operand)) != labels.end()){
+					operand = labels[get_label_address_value(operand)];
+				}
+			}
+
+			if(get_inst_type(instruction) == quad_type::RETURN){
+				if(result != nullptr && instruction->arg1 != nullptr){
+					copy.push_back(new_copy(result, instruction->arg1));
+				}
+				if(j + 1 < body.size()){
+					if(end == nullptr){
+						end = new_label_address(*ids.new_temp(0, T_UNDEFINED));
+					}
+					copy.push_back(new_unconditional_jump_inst(end));
+				}
+			}
+			else{
+				copy.push_back(instruction);
+			}
+		}
+
+		if(end != nullptr){
+			copy.push_back(new_label_inst(end));
+		}
+
+		// Replace the parameters and the call.
+		instructions_list replaced;
+		unsigned int next = 0;
+		unsigned int k = 0;
+
+		for(unsigned int j = 0; j < caller.size(); j++){
+			if(k < positions.size() && j == positions[k]){
+				if(param_copies[k] != nullptr){
+					replaced.push_back(param_copies[k]);
+				}
+				k++;
+			}
+			else if(j == i){
+				replaced.insert(replaced.end(), copy.begin(), copy.end());
+				// Calls into the copy were already considered, into the callee.
+				next = replaced.size();
+			}
+			else{
+				replaced.push_back(caller[j]);
+			}
+		}
+
+		caller = replaced;
+		i = next;
+		inlined++;
+	}
+
+	// Every scalar type has the same width.
+	add_enter_bytes(caller, new_names*INTEGER_WIDTH);
+}
+
+unsigned int inline_methods(instructions_list& code, ids_info& ids){
+	inliner calls_inliner(code, ids, nullptr);
+
+	return calls_inliner.run();
+}
+
+unsigned int inline_methods_with_profile(instructions_list& code,
+										ids_info& ids,
+										const execution_profile& profile){
+	inliner calls_inliner(code, ids, &profile);
+
+	return calls_inliner.run();
+}
@@ -0,0 +1,60 @@
+#ifndef INLINING_H_
+#define INLINING_H_
+
+#include "three_address_code.h"
+#include "intermediate_symtable.h"
+#include "profile.h"
+
+// A call is replaced by the body of a method with up to this many quads more
+// than the quads of the call (its parameters and the call itself)...
+#define INLINE_GROWTH_LIMIT 8
+// ... or with up to this many quads, if that is the only call to the method.
+#define INLINE_SINGLE_CALL_LIMIT 200
+// No method grows beyond this number of quads by inlining.
+#define INLINE_METHOD_LIMIT 2000
+// With a profile, a call executed at least 1/INLINE_HOT_CALL_RATIO times as
+// often as the most executed call is hot: it is replaced by a method with up
+// to this many quads more than the call.
+#define INLINE_HOT_CALL_RATIO 10
+#define INLINE_HOT_GROWTH_LIMIT 40
+
+/* Replaces calls to small methods, and to methods called from a single place,
+ * by a copy of the body of the method. Into the copy:
+ * 		_ "this" and the parameters that are objects, are replaced by the
+ * 		arguments of the call (objects' references can't be modified),
+ *
+ * 		_ the other parameters are new variables, copied from the arguments
+ * 		where the call computed its parameters,
+ *
+ * 		_ the remaining variables, temporaries and labels are given new names,
+ * 		so each copy has its own,
+ *
+ * 		_ returns become a copy into the result of the call (if any) and a
+ * 		jump to the end of the copy.
+ *
+ * New names are registered into ids, as versions of the originals, and the
+ * ENTER_PROCEDURE of the caller reserves space for them.
+ *
+ * Methods are visited bottom-up on the call graph, so a method is copied
+ * with the calls it makes already inlined. A call is never inlined into a
+ * method that is being visited below it: calls into a recursive cycle are kept,
+ * and inlining always ends.
+ *
+ * Methods without quads besides their label and their ENTER_PROCEDURE are
+ * taken as extern, and are never inlined. Neither are methods that declare
+ * objects, or whose parameters are not registered into ids.
+ *
+ * Returns the number of calls inlined.
+ * PRE : {code is the code of a whole program, out of SSA form} */
+unsigned int inline_methods(instructions_list& code, ids_info& ids);
+
+/* As inline_methods, guided by the executions of each call site given by
+ * profile (of the same code, as generated): hot calls are inlined up to
+ * INLINE_HOT_GROWTH_LIMIT, and calls never executed only if the copy is not
+ * larger than the call. Calls copied by inlining are not into the profile,
+ * and are inlined as without it. */
+unsigned int inline_methods_with_profile(instructions_list& code,
+										ids_info& ids,
+										const execution_profile& profile);
+
+#endif // INLINING_H_
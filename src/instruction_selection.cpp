@@ -0,0 +1,793 @@
+#include "instruction_selection.h"
+
+/////////////////////////
+// @AUXILIARY
+/////////////////////////
+bool is_integer_constant_leaf(const expression_pointer& tree){
+	return tree->op == quad_oper::NONE and
+		   get_address_type(tree->leaf) == address_type::ADDRESS_CONSTANT and
+		   get_constant_address_type(tree->leaf) == value_type::INTEGER;
+}
+
+expression_pointer copy_expression_tree(const expression_pointer& tree){
+	expression_pointer ret = nullptr;
+
+	if(tree != nullptr){
+		ret = expression_pointer(new expression_node(*tree));
+		ret->left = copy_expression_tree(tree->left);
+		ret->right = copy_expression_tree(tree->right);
+	}
+
+	return ret;
+}
+
+/* Is instruction a quad that can be folded into an index tree, as the
+ * definition of name? */
+bool is_foldable_index_quad(const quad_pointer& instruction,
+							const std::string& name,
+							ids_info& ids,
+							const std::unordered_set<std::string>& float_names){
+	if(get_inst_type(instruction) != quad_type::BINARY_ASSIGN or
+	(get_inst_op(instruction) != quad_oper::PLUS and
+	 get_inst_op(instruction) != quad_oper::MINUS and
+	 get_inst_op(instruction) != quad_oper::TIMES)){
+		return false;
+	}
+
+	address_pointer result = get_binary_assign_result(instruction);
+	if(get_address_type(result) != address_type::ADDRESS_NAME or
+	get_address_name(result) != name or not ids.id_exists(name) or
+	ids.get_kind(name) != K_TEMP or float_names.find(name) != float_names.end()){
+		return false;
+	}
+
+	unsigned int names = 0;
+	address_pointer args[] = {get_binary_assign_arg1(instruction),
+							  get_binary_assign_arg2(instruction)};
+	for(unsigned int i = 0; i < 2; i++){
+		if(get_address_type(args[i]) == address_type::ADDRESS_NAME){
+			if(float_names.find(get_address_name(args[i])) !=
+			float_names.end()){
+				return false;
+			}
+			names++;
+		}
+		else if(get_address_type(args[i]) != address_type::ADDRESS_CONSTANT or
+		get_constant_address_type(args[i]) != value_type::INTEGER){
+			return false;
+		}
+	}
+
+	return names <= 1;
+}
+
+bool is_selection_memory(const operand_pointer& operand){
+	return get_operand_addressing(operand) == operand_addressing::MEMORY or
+		   get_operand_addressing(operand) == operand_addressing::RIP_RELATIVE;
+}
+
+bool is_selection_immediate(const operand_pointer& operand){
+	return get_operand_addressing(operand) == operand_addressing::IMMEDIATE;
+}
+
+bool is_selection_register(const operand_pointer& operand){
+	return get_operand_addressing(operand) == operand_addressing::REGISTER;
+}
+
+bool is_selection_zero(const operand_pointer& operand){
+	return is_selection_immediate(operand) and
+		   operand->value.imm.imm_op_type != immediate_op_type::FLOAT and
+		   operand->value.imm.val.ival == 0;
+}
+
+// Is instruction x = y relop z?
+bool is_relational_assign(const quad_pointer& instruction){
+	if(get_inst_type(instruction) != quad_type::BINARY_ASSIGN){
+		return false;
+	}
+
+	switch(get_inst_op(instruction)){
+		case quad_oper::LESS:
+		case quad_oper::LESS_EQUAL:
+		case quad_oper::GREATER:
+		case quad_oper::GREATER_EQUAL:
+		case quad_oper::EQUAL:
+		case quad_oper::DISTINCT:
+			return true;
+
+		default:
+			return false;
+	}
+}
+
+// Index, into candidates, of the cheapest one (the first, among ties).
+unsigned int get_cheapest_candidate(
+						const std::vector<asm_instructions_list>& candidates){
+	unsigned int ret = 0;
+
+	for(unsigned int i = 1; i < candidates.size(); i++){
+		if(get_selection_cost(candidates[i]) <
+		get_selection_cost(candidates[ret])){
+			ret = i;
+		}
+	}
+
+	return ret;
+}
+
+asm_instruction_pointer new_relational_jump_instruction(quad_oper relop,
+													const std::string& label){
+	asm_instruction_pointer ret;
+
+	switch(relop){
+		case quad_oper::LESS:
+			ret = new_jl_instruction(label);
+			break;
+
+		case quad_oper::LESS_EQUAL:
+			ret = new_jle_instruction(label);
+			break;
+
+		case quad_oper::GREATER:
+			ret = new_jg_instruction(label);
+			break;
+
+		case quad_oper::GREATER_EQUAL:
+			ret = new_jge_instruction(label);
+			break;
+
+		case quad_oper::EQUAL:
+			ret = new_je_instruction(label);
+			break;
+
+		default:
+			// {relop == quad_oper::DISTINCT}
+			ret = new_jne_instruction(label);
+	}
+
+	return ret;
+}
+
+asm_instruction_pointer new_relational_set_instruction(quad_oper relop,
+											const operand_pointer& destination){
+	operation op;
+
+	switch(relop){
+		case quad_oper::LESS:
+			op = operation::SETL;
+			break;
+
+		case quad_oper::LESS_EQUAL:
+			op = operation::SETLE;
+			break;
+
+		case quad_oper::GREATER:
+			op = operation::SETG;
+			break;
+
+		case quad_oper::GREATER_EQUAL:
+			op = operation::SETGE;
+			break;
+
+		case quad_oper::EQUAL:
+			op = operation::SETE;
+			break;
+
+		default:
+			// {relop == quad_oper::DISTINCT}
+			op = operation::SETNE;
+	}
+
+	return new_set_instruction(op, destination);
+}
+
+// Relational operator that gives the same result, with its operands swapped.
+quad_oper get_mirrored_relop(quad_oper relop){
+	quad_oper ret = relop;
+
+	switch(relop){
+		case quad_oper::LESS:
+			ret = quad_oper::GREATER;
+			break;
+
+		case quad_oper::LESS_EQUAL:
+			ret = quad_oper::GREATER_EQUAL;
+			break;
+
+		case quad_oper::GREATER:
+			ret = quad_oper::LESS;
+			break;
+
+		case quad_oper::GREATER_EQUAL:
+			ret = quad_oper::LESS_EQUAL;
+			break;
+
+		default:
+			// {relop is EQUAL or DISTINCT}
+			break;
+	}
+
+	return ret;
+}
+
+bool evaluate_integer_relation(quad_oper relop, int y, int z){
+	bool ret;
+
+	switch(relop){
+		case quad_oper::LESS:
+			ret = y < z;
+			break;
+
+		case quad_oper::LESS_EQUAL:
+			ret = y <= z;
+			break;
+
+		case quad_oper::GREATER:
+			ret = y > z;
+			break;
+
+		case quad_oper::GREATER_EQUAL:
+			ret = y >= z;
+			break;
+
+		case quad_oper::EQUAL:
+			ret = y == z;
+			break;
+
+		default:
+			// {relop == quad_oper::DISTINCT}
+			ret = y != z;
+	}
+
+	return ret;
+}
+
+/////////////////////////
+// @INTERFACE
+/////////////////////////
+expression_pointer new_expression_leaf(const address_pointer& leaf){
+	expression_pointer ret = expression_pointer(new expression_node);
+
+	ret->op = quad_oper::NONE;
+	ret->leaf = leaf;
+	ret->left = nullptr;
+	ret->right = nullptr;
+
+	return ret;
+}
+
+expression_pointer new_expression_node(quad_oper op,
+									const expression_pointer& left,
+									const expression_pointer& right){
+	expression_pointer ret = expression_pointer(new expression_node);
+
+	ret->op = op;
+	ret->leaf = nullptr;
+	ret->left = left;
+	ret->right = right;
+
+	return ret;
+}
+
+bool match_address_tile(const expression_pointer& tree, address_tile& tile){
+	address_tile sub;
+	bool ret = false;
+
+	switch(tree->op){
+		case quad_oper::NONE:
+			if(is_integer_constant_leaf(tree)){
+				sub = {nullptr, 1, get_constant_address_integer_value(tree->leaf)};
+				ret = true;
+			}
+			else if(get_address_type(tree->leaf) == address_type::ADDRESS_NAME){
+				sub = {tree->leaf, 1, 0};
+				ret = true;
+			}
+			break;
+
+		case quad_oper::TIMES:{
+			bool right_constant = is_integer_constant_leaf(tree->right);
+			expression_pointer factor = right_constant ? tree->right : tree->left;
+			expression_pointer other = right_constant ? tree->left : tree->right;
+
+			if(is_integer_constant_leaf(factor) and match_address_tile(other, sub)){
+				int k = get_constant_address_integer_value(factor->leaf);
+				int scale = sub.index == nullptr ? 1 : (int) sub.scale * k;
+
+				ret = scale == 1 or scale == 2 or scale == 4 or scale == 8;
+				sub.scale = (unsigned int) scale;
+				sub.displacement *= k;
+			}
+			break;
+		}
+
+		case quad_oper::PLUS:
+		case quad_oper::MINUS:{
+			bool right_constant = is_integer_constant_leaf(tree->right);
+			expression_pointer constant = right_constant ? tree->right : tree->left;
+			expression_pointer other = right_constant ? tree->left : tree->right;
+
+			// c - t negates t: it has no tile.
+			if(is_integer_constant_leaf(constant) and
+			(tree->op == quad_oper::PLUS or right_constant) and
+			match_address_tile(other, sub)){
+				int c = get_constant_address_integer_value(constant->leaf);
+
+				sub.displacement += tree->op == quad_oper::PLUS ? c : -c;
+				ret = true;
+			}
+			break;
+		}
+
+		default:
+			break;
+	}
+
+	if(ret){
+		tile = sub;
+	}
+
+	return ret;
+}
+
+std::unordered_map<unsigned int, expression_pointer> build_index_trees(
+							const instructions_list& method,
+							ids_info& ids,
+							const std::unordered_set<std::string>& float_names,
+							std::unordered_set<unsigned int>& folded){
+	std::unordered_map<unsigned int, expression_pointer> ret;
+	// Positions of the quads that read each name.
+	std::unordered_map<std::string, std::vector<unsigned int> > reads;
+
+	for(unsigned int i = 0; i < method.size(); i++){
+		std::vector<address_pointer*> uses = get_inst_uses(method[i]);
+
+		for(std::vector<address_pointer*>::iterator use = uses.begin();
+		use != uses.end(); ++use){
+			if(**use != nullptr and
+			get_address_type(**use) == address_type::ADDRESS_NAME){
+				reads[get_address_name(**use)].push_back(i);
+			}
+		}
+	}
+
+	for(unsigned int copy = 0; copy < method.size(); copy++){
+		address_pointer index;
+
+		if(get_inst_type(method[copy]) == quad_type::INDEXED_COPY_TO){
+			index = get_indexed_copy_to_index(method[copy]);
+		}
+		else if(get_inst_type(method[copy]) == quad_type::INDEXED_COPY_FROM){
+			index = get_indexed_copy_from_index(method[copy]);
+		}
+		else{
+			continue;
+		}
+
+		expression_pointer tree = new_expression_leaf(index);
+		// The leaf of tree that the next quad folded would replace.
+		expression_pointer *open = &tree;
+		expression_pointer best = nullptr;
+		unsigned int best_first = copy;
+		std::unordered_set<std::string> defined;
+
+		for(unsigned int first = copy; first > 0; first--){
+			const quad_pointer& instruction = method[first - 1];
+
+			if(get_address_type((*open)->leaf) != address_type::ADDRESS_NAME or
+			not is_foldable_index_quad(instruction,
+									get_address_name((*open)->leaf),
+									ids,
+									float_names)){
+				break;
+			}
+			defined.insert(get_address_name((*open)->leaf));
+
+			expression_pointer left = new_expression_leaf(
+									get_binary_assign_arg1(instruction));
+			expression_pointer right = new_expression_leaf(
+									get_binary_assign_arg2(instruction));
+			*open = new_expression_node(get_inst_op(instruction), left, right);
+			if(get_address_type(left->leaf) == address_type::ADDRESS_NAME){
+				open = &(*open)->left;
+			}
+			else if(get_address_type(right->leaf) == address_type::ADDRESS_NAME){
+				open = &(*open)->right;
+			}
+			else{
+				// {both operands are constants: nothing more to fold}
+				open = nullptr;
+			}
+
+			// The values of the quads folded must not be read out of
+			// [first - 1, copy].
+			bool local = true;
+			for(std::unordered_set<std::string>::iterator name = defined.begin();
+			local and name != defined.end(); ++name){
+				std::vector<unsigned int>& positions = reads[*name];
+
+				for(unsigned int j = 0; local and j < positions.size(); j++){
+					local = positions[j] >= first - 1 and positions[j] <= copy;
+				}
+			}
+
+			address_tile tile;
+			if(local and match_address_tile(tree, tile)){
+				best = copy_expression_tree(tree);
+				best_first = first - 1;
+			}
+
+			if(open == nullptr){
+				break;
+			}
+		}
+
+		if(best != nullptr){
+			ret[copy] = best;
+			for(unsigned int j = best_first; j < copy; j++){
+				folded.insert(j);
+			}
+		}
+	}
+
+	return ret;
+}
+
+unsigned int get_selection_cost(const asm_instructions_list& code){
+	unsigned int ret = 0;
+
+	for(asm_instructions_list::const_iterator it = code.begin();
+	it != code.end(); ++it){
+		const asm_instruction_pointer& inst = *it;
+
+		if(inst->op == operation::LABEL or inst->op == operation::DIRECTIVE){
+			continue;
+		}
+
+		ret++;
+		if(inst->source != nullptr and inst->op != operation::LEA and
+		is_selection_memory(inst->source)){
+			ret++;
+		}
+		if(inst->destination != nullptr and
+		is_selection_memory(inst->destination)){
+			// Read and written, but for mov (only written), and cmp and test
+			// (only read).
+			ret += inst->op == operation::MOV or inst->op == operation::CMP or
+				   inst->op == operation::TEST ? 1 : 2;
+		}
+	}
+
+	return ret;
+}
+
+operand_pointer translate_address_tile(asm_instructions_list& code,
+									register_id base,
+									int base_displacement,
+									const address_tile& tile,
+									const operand_pointer& index,
+									register_id index_register){
+	// PRE
+	#ifdef __DEBUG
+		assert(get_register32(base) != register_id::NONE or
+			   base == register_id::RBP);
+		assert(get_register32(index_register) != register_id::NONE);
+		assert((tile.index == nullptr) == (index == nullptr));
+	#endif
+
+	register_id index_base = register_id::NONE;
+	unsigned int scale = 1;
+
+	if(index != nullptr){
+		// Indexes are 32-bit signed integers: the upper half of the register
+		// must have the sign.
+		index_base = index_register;
+		scale = tile.scale;
+		code.push_back(new_movslq_instruction(index,
+								new_register_operand(index_register)));
+	}
+
+	return new_memory_operand(base_displacement + tile.displacement,
+							base,
+							index_base,
+							scale);
+}
+
+void select_additive_operation(asm_instructions_list& code,
+								quad_oper op,
+								const operand_pointer& x,
+								const operand_pointer& y,
+								const operand_pointer& z,
+								register_id scratch){
+	// PRE
+	#ifdef __DEBUG
+		assert(op == quad_oper::PLUS or op == quad_oper::MINUS);
+	#endif
+
+	data_type ops_type = data_type::L;
+	bool plus = op == quad_oper::PLUS;
+
+	if(is_selection_immediate(y) and is_selection_immediate(z)){
+		unsigned int a = (unsigned int) y->value.imm.val.ival;
+		unsigned int b = (unsigned int) z->value.imm.val.ival;
+
+		code.push_back(new_mov_instruction(
+							new_immediate_integer_operand((int) (plus ? a + b :
+																		a - b)),
+							x,
+							ops_type));
+		return;
+	}
+
+	operand_pointer acc = new_register_operand(scratch);
+	std::vector<asm_instructions_list> candidates(1);
+
+	// Through the scratch register: always valid.
+	candidates[0].push_back(new_mov_instruction(y, acc, ops_type));
+	candidates[0].push_back(plus ? new_add_instruction(z, acc, ops_type) :
+								   new_sub_instruction(z, acc, ops_type));
+	candidates[0].push_back(new_mov_instruction(acc, x, ops_type));
+
+	// In place.
+	if(are_equal_operands(x, y) and
+	not (is_selection_memory(x) and is_selection_memory(z))){
+		asm_instructions_list candidate;
+
+		candidate.push_back(plus ? new_add_instruction(z, x, ops_type) :
+								   new_sub_instruction(z, x, ops_type));
+		candidates.push_back(candidate);
+	}
+	if(plus and are_equal_operands(x, z) and
+	not (is_selection_memory(x) and is_selection_memory(y))){
+		asm_instructions_list candidate;
+
+		candidate.push_back(new_add_instruction(y, x, ops_type));
+		candidates.push_back(candidate);
+	}
+
+	// Into the register of the result.
+	if(is_selection_register(x) and not are_equal_operands(x, z)){
+		asm_instructions_list candidate;
+
+		candidate.push_back(new_mov_instruction(y, x, ops_type));
+		candidate.push_back(plus ? new_add_instruction(z, x, ops_type) :
+								   new_sub_instruction(z, x, ops_type));
+		candidates.push_back(candidate);
+	}
+
+	// As an address: the 32 low-order bits of the sum are the same.
+	if(is_selection_register(x) and is_selection_register(y) and
+	get_register64(y->value.reg) != register_id::NONE){
+		register_id base = get_register64(y->value.reg);
+		asm_instructions_list candidate;
+
+		if(plus and is_selection_register(z) and
+		get_register64(z->value.reg) != register_id::NONE){
+			candidate.push_back(new_scaled_lea_instruction(base,
+												get_register64(z->value.reg),
+												1,
+												x,
+												ops_type));
+		}
+		else if(is_selection_immediate(z)){
+			unsigned int c = (unsigned int) z->value.imm.val.ival;
+
+			candidate.push_back(new_lea_instruction(
+									new_memory_operand((int) (plus ? c : 0u - c),
+														base,
+														register_id::NONE,
+														1),
+									x,
+									ops_type));
+		}
+
+		if(not candidate.empty()){
+			candidates.push_back(candidate);
+		}
+	}
+
+	asm_instructions_list& cheapest = candidates[get_cheapest_candidate(candidates)];
+	code.insert(code.end(), cheapest.begin(), cheapest.end());
+}
+
+std::unordered_set<unsigned int> find_fused_comparisons(
+											const instructions_list& method){
+	std::unordered_map<std::string, unsigned int> uses;
+	std::unordered_set<unsigned int> ret;
+
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		std::vector<address_pointer*> operands = get_inst_uses(*it);
+
+		for(std::vector<address_pointer*>::iterator use = operands.begin();
+		use != operands.end(); ++use){
+			if(**use != nullptr and
+			get_address_type(**use) == address_type::ADDRESS_NAME){
+				uses[get_address_name(**use)]++;
+			}
+		}
+	}
+
+	for(unsigned int i = 0; i + 1 < method.size(); i++){
+		if(not is_relational_assign(method[i]) or
+		get_inst_type(method[i + 1]) != quad_type::CONDITIONAL_JUMP){
+			continue;
+		}
+
+		address_pointer result = get_binary_assign_result(method[i]);
+		address_pointer guard = get_conditional_jmp_guard(method[i + 1]);
+
+		if(get_address_type(guard) == address_type::ADDRESS_NAME and
+		are_equal_address_pointers(result, guard) and
+		uses[get_address_name(result)] == 1){
+			ret.insert(i);
+		}
+	}
+
+	return ret;
+}
+
+bool are_flags_set_for_zero_test(const asm_instructions_list& code,
+								const operand_pointer& x,
+								quad_oper relop){
+	operand_pointer value = x;
+
+	for(asm_instructions_list::const_reverse_iterator it = code.rbegin();
+	it != code.rend(); ++it){
+		const asm_instruction_pointer& inst = *it;
+
+		if(inst->ops_type != data_type::L or inst->destination == nullptr or
+		not are_equal_operands(inst->destination, value)){
+			return false;
+		}
+
+		switch(inst->op){
+			case operation::MOV:
+				// {value holds what the source of inst held}
+				if(is_selection_immediate(inst->source)){
+					return false;
+				}
+				value = inst->source;
+				break;
+
+			case operation::ADD:
+			case operation::SUB:
+				// Their overflow flag isn't the one of cmp $0.
+				return relop == quad_oper::EQUAL or relop == quad_oper::DISTINCT;
+
+			case operation::AND:
+			case operation::XOR:
+				return true;
+
+			default:
+				return false;
+		}
+	}
+
+	return false;
+}
+
+void select_zero_test(asm_instructions_list& code,
+					const operand_pointer& x,
+					quad_oper relop){
+	if(are_flags_set_for_zero_test(code, x, relop)){
+		return;
+	}
+
+	if(is_selection_register(x)){
+		code.push_back(new_test_instruction(x, x, data_type::L));
+	}
+	else{
+		code.push_back(new_cmp_instruction(new_immediate_integer_operand(0),
+											x,
+											data_type::L));
+	}
+}
+
+/* Appends to code the cheapest comparison of y with z, for a jump or a set on
+ * relop (see select_relational_jump), and returns the relation that the flags
+ * hold when y relop z does (relop, or its mirror if the operands are swapped).
+ * PRE : {y and z aren't both immediate} */
+quad_oper select_comparison(asm_instructions_list& code,
+							quad_oper relop,
+							const operand_pointer& y,
+							const operand_pointer& z,
+							register_id scratch){
+	data_type ops_type = data_type::L;
+
+	// Comparisons with 0.
+	if(is_selection_zero(z) or is_selection_zero(y)){
+		quad_oper tested_relop = is_selection_zero(z) ? relop :
+								 get_mirrored_relop(relop);
+
+		select_zero_test(code, is_selection_zero(z) ? y : z, tested_relop);
+		return tested_relop;
+	}
+
+	bool memory_operands = is_selection_memory(y) and is_selection_memory(z);
+	std::vector<asm_instructions_list> candidates;
+	std::vector<quad_oper> tested_relops;
+
+	if(not is_selection_immediate(y) and not memory_operands){
+		asm_instructions_list candidate;
+
+		candidate.push_back(new_cmp_instruction(z, y, ops_type));
+		candidates.push_back(candidate);
+		tested_relops.push_back(relop);
+	}
+	if(not is_selection_immediate(z) and not memory_operands){
+		asm_instructions_list candidate;
+
+		candidate.push_back(new_cmp_instruction(y, z, ops_type));
+		candidates.push_back(candidate);
+		tested_relops.push_back(get_mirrored_relop(relop));
+	}
+
+	asm_instructions_list candidate;
+	operand_pointer acc = new_register_operand(scratch);
+
+	candidate.push_back(new_mov_instruction(y, acc, ops_type));
+	candidate.push_back(new_cmp_instruction(z, acc, ops_type));
+	candidates.push_back(candidate);
+	tested_relops.push_back(relop);
+
+	unsigned int cheapest = get_cheapest_candidate(candidates);
+	code.insert(code.end(), candidates[cheapest].begin(),
+				candidates[cheapest].end());
+
+	return tested_relops[cheapest];
+}
+
+void select_relational_jump(asm_instructions_list& code,
+							quad_oper relop,
+							const operand_pointer& y,
+							const operand_pointer& z,
+							const std::string& label,
+							register_id scratch){
+	if(is_selection_immediate(y) and is_selection_immediate(z)){
+		if(evaluate_integer_relation(relop, y->value.imm.val.ival,
+									z->value.imm.val.ival)){
+			code.push_back(new_jmp_instruction(label));
+		}
+		return;
+	}
+
+	quad_oper tested_relop = select_comparison(code, relop, y, z, scratch);
+	code.push_back(new_relational_jump_instruction(tested_relop, label));
+}
+
+void select_relational_assign(asm_instructions_list& code,
+							quad_oper relop,
+							const operand_pointer& x,
+							const operand_pointer& y,
+							const operand_pointer& z,
+							register_id scratch){
+	// PRE
+	#ifdef __DEBUG
+		assert(get_register8(scratch) != register_id::NONE);
+	#endif
+
+	if(is_selection_immediate(y) and is_selection_immediate(z)){
+		code.push_back(new_mov_instruction(new_immediate_integer_operand(
+									evaluate_integer_relation(relop,
+														y->value.imm.val.ival,
+														z->value.imm.val.ival)),
+								x,
+								data_type::L));
+		return;
+	}
+
+	// The value is computed into x itself, when it is a register.
+	register_id value = is_selection_register(x) and
+						get_register8(x->value.reg) != register_id::NONE ?
+						x->value.reg : scratch;
+	operand_pointer value_register = new_register_operand(value);
+	operand_pointer value_byte = new_register_operand(get_register8(value));
+	quad_oper tested_relop = select_comparison(code, relop, y, z, scratch);
+
+	code.push_back(new_relational_set_instruction(tested_relop, value_byte));
+	code.push_back(new_movzbl_instruction(value_byte, value_register));
+	if(not are_equal_operands(value_register, x)){
+		code.push_back(new_mov_instruction(value_register, x, data_type::L));
+	}
+}
@@ -0,0 +1,200 @@
+#ifndef INSTRUCTION_SELECTION_H_
+#define INSTRUCTION_SELECTION_H_
+
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include "asm_instruction.h"
+#include "three_address_code.h"
+#include "intermediate_symtable.h"
+
+/* Bibliography adopted:
+ * [1] "Modern Compiler Implementation in C", Andrew W. Appel. Cambridge
+ * 		University Press, 1998. Chapter 9: "Instruction selection".
+ *
+ * [2] "Engineering a Compiler", Keith D. Cooper and Linda Torczon. Morgan
+ * 		Kaufmann, 2nd edition, 2012. Section 11.4: "Selection via tree-pattern
+ * 		matching".
+ *
+ * [3] "Intel 64 and IA-32 Architectures Software Developer's Manual, Volume
+ * 		1: Basic Architecture". Section 3.7.5: "Specifying an Offset".
+ *
+ * [4] "Intel 64 and IA-32 Architectures Optimization Reference Manual".
+ * 		Section 3.4.2.2: "Optimizing for Macro-fusion".
+ * */
+
+// Preferred scratch registers of the selection: for values moved between
+// memory operands, and for indices sign-extended into 64 bits. The ones
+// actually used are given by the caller.
+#define SELECTION_VALUE_REGISTER register_id::R8D
+#define SELECTION_INDEX_REGISTER register_id::R9
+
+/* Expression trees, rebuilt from the quads of a basic block: leaves are
+ * operands of the quads (names and constants), and inner nodes the
+ * arithmetic operators that combine them. */
+struct expression_node;
+
+typedef std::shared_ptr<expression_node> expression_pointer;
+
+struct expression_node {
+	quad_oper op; // quad_oper::NONE, for leaves.
+	address_pointer leaf; // Only for leaves.
+	expression_pointer left;
+	expression_pointer right;
+};
+
+expression_pointer new_expression_leaf(const address_pointer& leaf);
+
+expression_pointer new_expression_node(quad_oper op,
+									const expression_pointer& left,
+									const expression_pointer& right);
+
+/* Effective address displacement + index * scale, computed by a single
+ * memory operand ([3]). index is nullptr when there is none. */
+struct address_tile {
+	address_pointer index;
+	unsigned int scale;
+	int displacement;
+};
+
+/* Covers tree with a single address_tile, if it can. Tiles are matched
+ * from the root, taking as much of the tree as they can (maximal munch,
+ * [1]):
+ * 		_ an integer constant c is a displacement c.
+ * 		_ a name n is an index n, with scale 1.
+ * 		_ t * c and c * t multiply the displacement and the scale of the tile
+ * 		of t by c (the scale must remain 1, 2, 4 or 8).
+ * 		_ t + c, c + t and t - c add (subtract) c to the displacement of the
+ * 		tile of t.
+ * Returns false, leaving tile as it was, if there is no such cover. */
+bool match_address_tile(const expression_pointer& tree, address_tile& tile);
+
+/* Rebuilds the trees of the indexes of the indexed copies of method (whose
+ * integer names aren't into float_names). Walking backwards from each
+ * indexed copy, the quads that compute its index are folded into its tree,
+ * taking the longest sequence of quads that immediately precede the copy,
+ * such that:
+ * 		_ each one is a PLUS, MINUS or TIMES of integers, with at most one
+ * 		name as operand, that defines a temporary read by the next one (or
+ * 		by the copy, as its index).
+ *
+ * 		_ the temporaries defined aren't read out of the sequence (nor by
+ * 		other quads of the method).
+ *
+ * 		_ match_address_tile covers the resulting tree.
+ *
+ * Returns the tree of each indexed copy with quads folded, by its position
+ * into method, and adds to folded the positions of those quads: their
+ * values are computed by the addressing of the copy, so they must not be
+ * translated. */
+std::unordered_map<unsigned int, expression_pointer> build_index_trees(
+							const instructions_list& method,
+							ids_info& ids,
+							const std::unordered_set<std::string>& float_names,
+							std::unordered_set<unsigned int>& folded);
+
+/* Cost of code, by the cost model of the selection: a cycle per
+ * instruction, and one more per access to memory (the source of a lea
+ * isn't accessed, while the destination of an arithmetic instruction is
+ * read and written). Labels and directives are free. */
+unsigned int get_selection_cost(const asm_instructions_list& code);
+
+/* Appends to code the instructions needed to address base +
+ * base_displacement + tile, with a single memory operand, that is returned.
+ * index is the operand of tile.index (nullptr if there is none): it is
+ * sign-extended into the scratch register index_register.
+ * PRE : {base and index_register are 64-bit registers} */
+operand_pointer translate_address_tile(asm_instructions_list& code,
+									register_id base,
+									int base_displacement,
+									const address_tile& tile,
+									const operand_pointer& index,
+									register_id index_register);
+
+/* Appends to code the cheapest translation of x = y op z, by
+ * get_selection_cost, being op PLUS or MINUS, among the ones that are
+ * valid for the operands (being s the scratch register scratch):
+ * 		_ mov y,s; op z,s; mov s,x
+ * 		_ op z,x (if x is y), or add y,x (if x is z)
+ * 		_ mov y,x; op z,x (if x is a register other than z)
+ * 		_ lea (y,z),x; lea c(y),x; lea -c(y),x (if x and y are registers,
+ * 		being z a register or the constant c)
+ * Immediate and memory operands are used directly, as long as no
+ * instruction gets two memory operands. When y and z are immediate, the
+ * result is computed at compile time (wrapping around).
+ * PRE : {scratch is a 32-bit register, and x is a register or memory
+ * 		  operand, different from scratch} */
+void select_additive_operation(asm_instructions_list& code,
+								quad_oper op,
+								const operand_pointer& x,
+								const operand_pointer& y,
+								const operand_pointer& z,
+								register_id scratch);
+
+/* Positions of the quads x = y relop z of method that are followed by a
+ * conditional jump on x, being that jump the only quad of method that reads
+ * x. The comparison is only needed by the jump: both are translated together,
+ * into a comparison and a conditional jump, that the processor fuses into a
+ * single operation ([4]), and x is never written. */
+std::unordered_set<unsigned int> find_fused_comparisons(
+											const instructions_list& method);
+
+/* Do the flags, at the end of code, already hold the comparison of x with 0,
+ * as needed by a jump on relop? They do if the last instruction that writes
+ * them is an and or a xor (OF and CF are cleared, as cmp $0 does), or an add
+ * or a sub (only for EQUAL and DISTINCT, whose jumps read just ZF), whose
+ * destination is x, or is copied into x by the movs that follow it. Every
+ * instruction involved must be 32-bit. */
+bool are_flags_set_for_zero_test(const asm_instructions_list& code,
+								const operand_pointer& x,
+								quad_oper relop);
+
+/* Appends to code the comparison of x with 0, for a jump on relop: nothing if
+ * are_flags_set_for_zero_test, test x,x if x is a register (shorter, and
+ * fused with the jump, [4]), or cmp $0,x otherwise.
+ * PRE : {x is a 32-bit register or memory operand} */
+void select_zero_test(asm_instructions_list& code,
+					const operand_pointer& x,
+					quad_oper relop);
+
+/* Appends to code the cheapest translation of if y relop z goto label, for
+ * integers, among:
+ * 		_ cmp z,y; j<relop> label (flags based on y - z)
+ * 		_ cmp y,z; j<mirrored relop> label (flags based on z - y, when y is
+ * 		immediate)
+ * 		_ mov y,s; cmp z,s; j<relop> label (when both are memory, being s
+ * 		the scratch register scratch)
+ * When y and z are immediate, the comparison is done at compile time: it
+ * results in a jmp, or in nothing. Comparisons with 0 are made by
+ * select_zero_test.
+ * PRE : {relop is a relational operator, and scratch a 32-bit register} */
+void select_relational_jump(asm_instructions_list& code,
+							quad_oper relop,
+							const operand_pointer& y,
+							const operand_pointer& z,
+							const std::string& label,
+							register_id scratch);
+
+/* set<cc> destination, for the condition of the jump on relop that
+ * select_relational_jump would append.
+ * PRE : {relop is a relational operator} */
+asm_instruction_pointer new_relational_set_instruction(quad_oper relop,
+											const operand_pointer& destination);
+
+/* Appends to code the translation of x = y relop z, for integers, when it
+ * isn't fused with a jump: the comparison of select_relational_jump,
+ * followed by
+ * 		set<cc> r8; movzbl r8,r (; mov r,x)
+ * being r x itself, if it is a register, or the scratch register scratch
+ * otherwise, and r8 its low byte. When y and z are immediate, the result is
+ * computed at compile time, and moved into x.
+ * PRE : {relop is a relational operator, and scratch a 32-bit register with
+ * 		  an 8-bit register (get_register8)} */
+void select_relational_assign(asm_instructions_list& code,
+							quad_oper relop,
+							const operand_pointer& x,
+							const operand_pointer& y,
+							const operand_pointer& z,
+							register_id scratch);
+
+#endif // INSTRUCTION_SELECTION_H_
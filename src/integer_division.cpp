@@ -0,0 +1,251 @@
+#include <climits>
+#include "integer_division.h"
+
+/////////////////////////
+// @AUXILIARY
+/////////////////////////
+bool is_immediate_integer(const operand_pointer& operand){
+	return get_operand_addressing(operand) == operand_addressing::IMMEDIATE &&
+		   operand->value.imm.imm_op_type == immediate_op_type::INTEGER;
+}
+
+// Returns k if value == 2^k, or -1 if value isn't a power of two.
+int get_power_of_two(unsigned int value){
+	int ret = -1;
+
+	if(value != 0 && (value & (value - 1)) == 0){
+		ret = 0;
+		while(value > 1){
+			value >>= 1;
+			ret++;
+		}
+	}
+
+	return ret;
+}
+
+/* Appends to code the translation of x = y / d (or y % d), being |d| == 2^k,
+ * with k > 0 ([1], 10-1 and 10-2). */
+void translate_power_of_two_division(asm_instructions_list& code,
+									const operand_pointer& x,
+									const operand_pointer& y,
+									int d,
+									int k,
+									bool remainder){
+	data_type ops_type = data_type::L;
+	operand_pointer eax = new_register_operand(register_id::EAX);
+	operand_pointer edx = new_register_operand(register_id::EDX);
+
+	code.push_back(new_mov_instruction(y, eax, ops_type));
+	// %edx = 2^k - 1 if y < 0, 0 otherwise: the bias that makes the shift
+	// truncate toward zero.
+	code.push_back(new_mov_instruction(eax, edx, ops_type));
+	if(k > 1){
+		code.push_back(new_sar_instruction(new_immediate_integer_operand(31),
+											edx,
+											ops_type));
+	}
+	code.push_back(new_shr_instruction(new_immediate_integer_operand(32 - k),
+										edx,
+										ops_type));
+	code.push_back(new_add_instruction(edx, eax, ops_type));
+
+	if(remainder){
+		// y % d == ((y + bias) & (2^k - 1)) - bias, whatever the sign of d.
+		unsigned int mask = (1u << k) - 1;
+		code.push_back(new_and_instruction(
+								new_immediate_integer_operand((int) mask),
+								eax,
+								ops_type));
+		code.push_back(new_sub_instruction(edx, eax, ops_type));
+	}
+	else{
+		code.push_back(new_sar_instruction(new_immediate_integer_operand(k),
+											eax,
+											ops_type));
+		if(d < 0){
+			code.push_back(new_neg_instruction(eax, ops_type));
+		}
+	}
+
+	code.push_back(new_mov_instruction(eax, x, ops_type));
+}
+
+/* Appends to code the translation of x = y / d (or y % d), through the magic
+ * number of d ([1], 10-4 and 10-5).
+ * PRE : {y is a register or memory operand} */
+void translate_magic_division(asm_instructions_list& code,
+							const operand_pointer& x,
+							const operand_pointer& y,
+							int d,
+							bool remainder){
+	// PRE
+	#ifdef __DEBUG
+		assert(!is_immediate_integer(y));
+	#endif
+
+	data_type ops_type = data_type::L;
+	operand_pointer eax = new_register_operand(register_id::EAX);
+	operand_pointer edx = new_register_operand(register_id::EDX);
+	division_magic magic = get_division_magic(d);
+
+	// %edx = high half of magic * y.
+	code.push_back(new_mov_instruction(
+								new_immediate_integer_operand(magic.multiplier),
+								eax,
+								ops_type));
+	code.push_back(new_widening_mul_instruction(y, ops_type, true));
+	// The multiplier is taken as signed: correct it, when its sign isn't the
+	// one of d.
+	if(d > 0 && magic.multiplier < 0){
+		code.push_back(new_add_instruction(y, edx, ops_type));
+	}
+	else if(d < 0 && magic.multiplier > 0){
+		code.push_back(new_sub_instruction(y, edx, ops_type));
+	}
+	if(magic.shift > 0){
+		code.push_back(new_sar_instruction(
+							new_immediate_integer_operand(magic.shift),
+							edx,
+							ops_type));
+	}
+	// Add 1 to negative quotients, to truncate them toward zero.
+	code.push_back(new_mov_instruction(edx, eax, ops_type));
+	code.push_back(new_shr_instruction(new_immediate_integer_operand(31),
+										eax,
+										ops_type));
+	code.push_back(new_add_instruction(eax, edx, ops_type));
+	// {%edx == y / d}
+
+	if(remainder){
+		code.push_back(new_mul_instruction(new_immediate_integer_operand(d),
+											edx,
+											ops_type,
+											true));
+		code.push_back(new_mov_instruction(y, eax, ops_type));
+		code.push_back(new_sub_instruction(edx, eax, ops_type));
+		code.push_back(new_mov_instruction(eax, x, ops_type));
+	}
+	else{
+		code.push_back(new_mov_instruction(edx, x, ops_type));
+	}
+}
+
+/////////////////////////
+// @INTERFACE
+/////////////////////////
+division_magic get_division_magic(int divisor){
+	// PRE
+	#ifdef __DEBUG
+		assert(divisor < -1 || divisor > 1);
+	#endif
+
+	const unsigned int two31 = 0x80000000u;
+	division_magic ret;
+	unsigned int ad = divisor < 0 ? 0u - (unsigned int) divisor :
+									(unsigned int) divisor;
+	unsigned int t = two31 + ((unsigned int) divisor >> 31);
+	// Absolute value of the greatest dividend such that its remainder is
+	// ad - 1.
+	unsigned int anc = t - 1 - t % ad;
+	unsigned int p = 31;
+	// Quotients and remainders of 2^p / anc and 2^p / ad.
+	unsigned int q1 = two31 / anc;
+	unsigned int r1 = two31 - q1*anc;
+	unsigned int q2 = two31 / ad;
+	unsigned int r2 = two31 - q2*ad;
+	unsigned int delta;
+
+	do{
+		p++;
+		q1 = 2*q1;
+		r1 = 2*r1;
+		if(r1 >= anc){
+			q1++;
+			r1 -= anc;
+		}
+		q2 = 2*q2;
+		r2 = 2*r2;
+		if(r2 >= ad){
+			q2++;
+			r2 -= ad;
+		}
+		delta = ad - r2;
+	}while(q1 < delta || (q1 == delta && r1 == 0));
+
+	ret.multiplier = divisor < 0 ? (int) (0u - (q2 + 1)) : (int) (q2 + 1);
+	ret.shift = p - 32;
+
+	return ret;
+}
+
+void translate_integer_division(asm_instructions_list& code,
+								const operand_pointer& x,
+								const operand_pointer& y,
+								const operand_pointer& z,
+								bool remainder,
+								register_id divisor_register){
+	data_type ops_type = data_type::L;
+	operand_pointer eax = new_register_operand(register_id::EAX);
+	operand_pointer edx = new_register_operand(register_id::EDX);
+
+	if(is_immediate_integer(z) && z->value.imm.val.ival != 0){
+		int d = z->value.imm.val.ival;
+		unsigned int magnitude = d < 0 ? 0u - (unsigned int) d :
+										 (unsigned int) d;
+
+		if(is_immediate_integer(y) &&
+		not (y->value.imm.val.ival == INT_MIN && d == -1)){
+			int value = y->value.imm.val.ival;
+
+			code.push_back(new_mov_instruction(
+								new_immediate_integer_operand(
+									remainder ? value % d : value / d),
+								x,
+								ops_type));
+		}
+		else if(magnitude == 1){
+			if(remainder){
+				code.push_back(new_mov_instruction(
+										new_immediate_integer_operand(0),
+										x,
+										ops_type));
+			}
+			else{
+				code.push_back(new_mov_instruction(y, eax, ops_type));
+				if(d < 0){
+					// INT_MIN / -1 wraps around to INT_MIN.
+					code.push_back(new_neg_instruction(eax, ops_type));
+				}
+				code.push_back(new_mov_instruction(eax, x, ops_type));
+			}
+		}
+		else if(get_power_of_two(magnitude) > 0){
+			translate_power_of_two_division(code, x, y, d,
+											get_power_of_two(magnitude),
+											remainder);
+		}
+		else{
+			translate_magic_division(code, x, y, d, remainder);
+		}
+	}
+	else{
+		// {z is not an immediate value, or it is 0}
+		operand_pointer divisor = z;
+
+		if(is_immediate_integer(z)){
+			// idiv doesn't take an immediate operand.
+			divisor = new_register_operand(divisor_register);
+			code.push_back(new_mov_instruction(z, divisor, ops_type));
+		}
+
+		code.push_back(new_mov_instruction(y, eax, ops_type));
+		// Sign-extend y into %edx::%eax.
+		code.push_back(new_cltd_instruction());
+		code.push_back(new_div_instruction(divisor, ops_type, true));
+		// The quotient is left into %eax, and the remainder into %edx.
+		code.push_back(new_mov_instruction(remainder ? edx : eax,
+											x,
+											ops_type));
+	}
+}
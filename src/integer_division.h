@@ -0,0 +1,57 @@
+#ifndef INTEGER_DIVISION_H_
+#define INTEGER_DIVISION_H_
+
+#include "asm_instruction.h"
+
+/* Bibliography adopted:
+ * [1] "Hacker's Delight", Henry S. Warren, Jr. Addison-Wesley, 2nd edition,
+ * 		2012. Chapter 10: "Integer division by constants".
+ *
+ * [2] "Division by Invariant Integers using Multiplication", Torbjörn
+ * 		Granlund and Peter L. Montgomery. PLDI 1994.
+ * */
+
+// Multiplier and shift that replace a signed 32-bit division by a constant
+// ([1], 10-4): y / d == (high 32 bits of (magic * y)) >> shift, corrected by
+// the signs of magic, d and the result.
+struct division_magic {
+	int multiplier;
+	unsigned int shift;
+};
+
+/* Returns the magic number of divisor, following the algorithm of [1] (figure
+ * 10-1).
+ * PRE : {divisor is not in {-1, 0, 1}} */
+division_magic get_division_magic(int divisor);
+
+/* Appends to code the translation of x = y / z (x = y % z, if remainder), for
+ * COMPI's 32-bit signed integers, with the semantics of idiv: the quotient is
+ * truncated toward zero, and the remainder has the sign of y.
+ *
+ * When z is an immediate value, idiv is avoided ([1], [2]):
+ * 		_ y / 1, y % 1, y / -1 and y % -1 are just moves (and a neg).
+ * 		_ powers of two (and their negations) are divided by sar, after
+ * 		adding 2^k - 1 to the negative dividends, so the quotient is
+ * 		truncated toward zero. The remainder is taken by and, from the same
+ * 		biased dividend.
+ * 		_ for the rest of the divisors, the quotient is the high half of the
+ * 		product of y and the magic number, shifted and corrected by sign. The
+ * 		remainder is y - quotient * z.
+ * When y is an immediate value too, the result is computed at compile time.
+ *
+ * Otherwise, y is sign-extended into %edx::%eax by cltd, and divided by idiv.
+ * An immediate z (only 0, that is never folded) is moved into the scratch
+ * register divisor_register, first.
+ *
+ * %eax and %edx are always taken as scratch registers: the caller must save
+ * them if they are live.
+ * PRE : {x is a register or memory operand, different from %eax and %edx,
+ * 		  and divisor_register is a 32-bit register other than them} */
+void translate_integer_division(asm_instructions_list& code,
+								const operand_pointer& x,
+								const operand_pointer& y,
+								const operand_pointer& z,
+								bool remainder,
+								register_id divisor_register);
+
+#endif // INTEGER_DIVISION_H_
@@ -0,0 +1,192 @@
+#include "integer_multiplication.h"
+
+// Latency of each multiplication_step_kind, in the order of its declaration.
+const unsigned int multiplication_step_latencies[] = {1,	// LEA
+													1,	// SHL
+													1,	// ADD
+													1,	// SUB
+													1};	// NEG
+
+/////////////////////////
+// @AUXILIARY
+/////////////////////////
+bool is_immediate_factor(const operand_pointer& operand){
+	return get_operand_addressing(operand) == operand_addressing::IMMEDIATE &&
+		   operand->value.imm.imm_op_type == immediate_op_type::INTEGER;
+}
+
+// Value of acc, multiplied by step (being y == 1).
+unsigned int apply_multiplication_step(unsigned int acc,
+									const multiplication_step& step){
+	unsigned int ret = acc;
+
+	switch(step.kind){
+		case multiplication_step_kind::LEA:
+			ret = acc + acc*step.amount;
+			break;
+
+		case multiplication_step_kind::SHL:
+			ret = acc << step.amount;
+			break;
+
+		case multiplication_step_kind::ADD:
+			ret = acc + 1;
+			break;
+
+		case multiplication_step_kind::SUB:
+			ret = acc - 1;
+			break;
+
+		case multiplication_step_kind::NEG:
+			ret = 0u - acc;
+			break;
+	}
+
+	return ret;
+}
+
+/* Depth-first search of the cheapest sequence that takes acc to factor,
+ * extending steps, with latency below best_latency. Updates best and
+ * best_latency with each sequence found. */
+void search_multiplication_steps(unsigned int acc,
+								unsigned int factor,
+								unsigned int latency,
+								std::vector<multiplication_step>& steps,
+								std::vector<multiplication_step>& best,
+								unsigned int& best_latency){
+	if(acc == factor){
+		// {latency < best_latency}
+		best = steps;
+		best_latency = latency;
+		return;
+	}
+
+	std::vector<multiplication_step> candidates;
+	for(unsigned int scale = 2; scale <= 8; scale *= 2){
+		candidates.push_back({multiplication_step_kind::LEA, scale});
+	}
+	for(unsigned int shift = 1; shift < 32; shift++){
+		candidates.push_back({multiplication_step_kind::SHL, shift});
+	}
+	candidates.push_back({multiplication_step_kind::ADD, 0});
+	candidates.push_back({multiplication_step_kind::SUB, 0});
+	candidates.push_back({multiplication_step_kind::NEG, 0});
+
+	for(std::vector<multiplication_step>::iterator it = candidates.begin();
+	it != candidates.end(); ++it){
+		unsigned int step_latency = get_multiplication_step_latency(it->kind);
+
+		if(latency + step_latency < best_latency){
+			steps.push_back(*it);
+			search_multiplication_steps(apply_multiplication_step(acc, *it),
+										factor,
+										latency + step_latency,
+										steps,
+										best,
+										best_latency);
+			steps.pop_back();
+		}
+	}
+}
+
+/////////////////////////
+// @INTERFACE
+/////////////////////////
+unsigned int get_multiplication_step_latency(multiplication_step_kind kind){
+	return multiplication_step_latencies[static_cast<int>(kind)];
+}
+
+bool get_multiplication_steps(int factor,
+							std::vector<multiplication_step>& steps){
+	std::vector<multiplication_step> current;
+	unsigned int best_latency = IMUL_LATENCY;
+
+	steps.clear();
+	search_multiplication_steps(1, (unsigned int) factor, 0, current, steps,
+								best_latency);
+
+	return best_latency < IMUL_LATENCY;
+}
+
+void translate_integer_multiplication(asm_instructions_list& code,
+									const operand_pointer& x,
+									const operand_pointer& y,
+									const operand_pointer& z,
+									register_id acc_register){
+	// PRE
+	#ifdef __DEBUG
+		assert(get_register64(acc_register) != register_id::NONE);
+	#endif
+
+	data_type ops_type = data_type::L;
+	operand_pointer acc = new_register_operand(acc_register);
+	// Multiplication is commutative: keep the immediate value, if any, as z.
+	operand_pointer multiplicand = is_immediate_factor(y) ? z : y;
+	operand_pointer factor = is_immediate_factor(y) ? y : z;
+	std::vector<multiplication_step> steps;
+
+	if(is_immediate_factor(multiplicand)){
+		// {both operands are immediate}
+		unsigned int product = (unsigned int) multiplicand->value.imm.val.ival *
+							   (unsigned int) factor->value.imm.val.ival;
+
+		code.push_back(new_mov_instruction(
+							new_immediate_integer_operand((int) product),
+							x,
+							ops_type));
+	}
+	else if(is_immediate_factor(factor) && factor->value.imm.val.ival == 0){
+		code.push_back(new_mov_instruction(new_immediate_integer_operand(0),
+											x,
+											ops_type));
+	}
+	else if(is_immediate_factor(factor) &&
+	get_multiplication_steps(factor->value.imm.val.ival, steps)){
+		code.push_back(new_mov_instruction(multiplicand, acc, ops_type));
+
+		for(std::vector<multiplication_step>::iterator it = steps.begin();
+		it != steps.end(); ++it){
+			switch(it->kind){
+				case multiplication_step_kind::LEA:
+					// The address is computed with the 64-bit register: its
+					// 32 low-order bits are the same.
+					code.push_back(new_scaled_lea_instruction(
+												get_register64(acc_register),
+												get_register64(acc_register),
+															it->amount,
+															acc,
+															ops_type));
+					break;
+
+				case multiplication_step_kind::SHL:
+					code.push_back(new_shl_instruction(
+										new_immediate_integer_operand(it->amount),
+										acc,
+										ops_type));
+					break;
+
+				case multiplication_step_kind::ADD:
+					code.push_back(new_add_instruction(multiplicand, acc,
+														ops_type));
+					break;
+
+				case multiplication_step_kind::SUB:
+					code.push_back(new_sub_instruction(multiplicand, acc,
+														ops_type));
+					break;
+
+				case multiplication_step_kind::NEG:
+					code.push_back(new_neg_instruction(acc, ops_type));
+					break;
+			}
+		}
+
+		code.push_back(new_mov_instruction(acc, x, ops_type));
+	}
+	else{
+		// imulw y,z (z = z ∗ y, z debe ser un registro)
+		code.push_back(new_mov_instruction(y, acc, ops_type));
+		code.push_back(new_mul_instruction(z, acc, ops_type, true));
+		code.push_back(new_mov_instruction(acc, x, ops_type));
+	}
+}
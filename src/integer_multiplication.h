@@ -0,0 +1,62 @@
+#ifndef INTEGER_MULTIPLICATION_H_
+#define INTEGER_MULTIPLICATION_H_
+
+#include <vector>
+#include "asm_instruction.h"
+
+/* Bibliography adopted:
+ * [1] "Instruction tables: Lists of instruction latencies, throughputs and
+ * 		micro-operation breakdowns for Intel, AMD and VIA CPUs", Agner Fog.
+ * 		Available at https://www.agner.org/optimize/instruction_tables.pdf
+ *
+ * [2] "Hacker's Delight", Henry S. Warren, Jr. Addison-Wesley, 2nd edition,
+ * 		2012. Section 8-4: "Multiplication by constants".
+ * */
+
+// Latency (in cycles) of imull, for 32-bit registers ([1]).
+#define IMUL_LATENCY 3
+
+/* Steps that replace the multiplication of an accumulator (that begins with
+ * the value of y) by a constant ([2]):
+ * 		LEA: acc = acc + acc * amount (amount = 2, 4 or 8), by a lea with
+ * 		scaled index.
+ * 		SHL: acc = acc << amount.
+ * 		ADD, SUB: acc = acc + y, acc = acc - y.
+ * 		NEG: acc = -acc. */
+enum class multiplication_step_kind {
+	LEA,
+	SHL,
+	ADD,
+	SUB,
+	NEG
+};
+
+struct multiplication_step {
+	multiplication_step_kind kind;
+	unsigned int amount;
+};
+
+/* Latency (in cycles) of each multiplication_step_kind ([1]): the lea has
+ * only base and index, so it takes a single cycle. */
+unsigned int get_multiplication_step_latency(multiplication_step_kind kind);
+
+/* Looks for the sequence of steps with the least total latency, that
+ * multiplies by factor (modulo 2^32). Returns true and sets steps if its
+ * latency is below IMUL_LATENCY (steps is empty for factor == 1). */
+bool get_multiplication_steps(int factor,
+							std::vector<multiplication_step>& steps);
+
+/* Appends to code the translation of x = y * z, for COMPI's 32-bit integers
+ * (wrapping around). When y or z is an immediate value, the multiplication
+ * is replaced by the steps of get_multiplication_steps, if any, computed
+ * into the scratch register acc_register. When both are immediate, the
+ * product is computed at compile time. Otherwise, imull is used.
+ * PRE : {acc_register is a 32-bit register, and x is a register or memory
+ * 		  operand, different from acc_register} */
+void translate_integer_multiplication(asm_instructions_list& code,
+									const operand_pointer& x,
+									const operand_pointer& y,
+									const operand_pointer& z,
+									register_id acc_register);
+
+#endif // INTEGER_MULTIPLICATION_H_
@@ -1,3 +1,4 @@
+#include <unordered_set>
 #include "inter_code_gen_visitor.h"
 
 /* TODO: cosas que faltan:
@@ -765,10 +766,22 @@ void inter_code_gen_visitor::visit(node_assignment_statement& node) {
         unsigned int size = this->calculate_size(array->get_type(),
                                         std::string(""));
         
-        inst_list->push_back(new_binary_assign(index,
+        // The offset goes into a new temporal: the index could be a
+        // variable, whose value must not change.
+        t_results offset_pair = this->s_table.new_temp(this->offset);
+
+        #ifdef __DEBUG
+            assert(std::get<0>(offset_pair) == put_results::ID_PUT);
+        #endif
+        address_pointer array_offset = new_name_address(
+                                                *std::get<1>(offset_pair));
+        this->offset += INTEGER_WIDTH;
+
+        inst_list->push_back(new_binary_assign(array_offset,
                                             index, 
                                             new_integer_constant(size), 
                                             quad_oper::TIMES));
+        index = array_offset;
         
         if(location->is_object_field() or is_att_from_act_obj){
             // Get the offset of the array, into the instance.
@@ -914,10 +927,22 @@ void inter_code_gen_visitor::visit(node_location& node) {
         int field_size = this->calculate_size(array->get_type(),
                                                 std::string(""));
         address_pointer address_field_size = new_integer_constant(field_size);            
-        inst_list->push_back(new_binary_assign(index,
+        // The offset goes into a new temporal: the index could be a
+        // variable, whose value must not change.
+        t_results offset_pair = this->s_table.new_temp(this->offset);
+
+        #ifdef __DEBUG
+            assert(std::get<0>(offset_pair) == put_results::ID_PUT);
+        #endif
+        address_pointer array_offset = new_name_address(
+                                                *std::get<1>(offset_pair));
+        this->offset += INTEGER_WIDTH;
+
+        inst_list->push_back(new_binary_assign(array_offset,
 		                                        index, 
                                                 address_field_size, 
                                                 quad_oper::TIMES));
+        index = array_offset;
         reference_list ids = node.get_ids();
 
         // Determine if it is an instance's attribute.
@@ -1121,13 +1146,14 @@ void inter_code_gen_visitor::visit(node_if_statement& node){
 	#ifdef __DEBUG
 			std::cout << "Translating if statement" << std::endl;
 	#endif
-	this->expr_call_appropriate_accept(node.expression);
+	jump_list true_list;
+	jump_list false_list;
+	this->translate_condition(node.expression, true_list, false_list, true);
+	this->backpatch_here(true_list);
 
     t_results label_else_pair =  s_table.new_temp(this->offset);
 	std::string label_else(*std::get<1>(label_else_pair));
-	inst_list->push_back(new_conditional_jump_inst(this->temp,
-													new_label_address(label_else),
-													quad_oper::IFFALSE));
+	this->backpatch(false_list, new_label_address(label_else));
 	// Code for the "if" branch.
 	stm_call_appropriate_accept(node.then_statement);
 	// Unconditional jump to the final part of the translation.
@@ -1150,27 +1176,39 @@ void inter_code_gen_visitor::visit(node_for_statement& node){
 			std::cout << "Translating for statement" << std::endl;
 	#endif
 
+	/* Rotated into a guarded loop, tested at the bottom, so each iteration
+	 * takes a single (backward) jump:
+	 * 		var = from
+	 * 		(BOUND CODE, it returns t1)
+	 * 		if t1 < var goto L2
+	 * 	L1:	(BODY CODE)
+	 * 		var = var + 1
+	 * 		(BOUND CODE, again, unless t1 is invariant)
+	 * 		if var <= t1 goto L1
+	 * 	L2:
+	 * */
 	this->expr_call_appropriate_accept(node.from);
     // The variable node.id is local to the loop.
 	address_pointer var = new_name_address(node.id);
 	inst_list->push_back(new_copy(var, temp));
 
-    t_results label_beg_pair =  s_table.new_temp(this->offset);
-	std::string label_beginning(*std::get<1>(label_beg_pair));
-	inst_list->push_back(new_label_inst(new_label_address(label_beginning)));
-
-	/*inst_list->push_back("LTE x to z");
-	inst_list->push_back("IFFALSE z L2");*/
-
     t_results label_ending_pair =  s_table.new_temp(this->offset);
 	std::string label_ending(*std::get<1>(label_ending_pair));
+	unsigned int bound_first = inst_list->size();
 	this->expr_call_appropriate_accept(node.to);
+	address_pointer bound = this->temp;
+	unsigned int bound_last = inst_list->size();
 	// if temp < var goto label_ending
-	inst_list->push_back(new_relational_jump_inst(this->temp, 
+	inst_list->push_back(new_relational_jump_inst(bound,
                                                     var, 
                                                     quad_oper::LESS,
 						                            new_label_address(label_ending)));
 
+    t_results label_body_pair =  s_table.new_temp(this->offset);
+	std::string label_body(*std::get<1>(label_body_pair));
+	inst_list->push_back(new_label_inst(new_label_address(label_body)));
+	unsigned int body_first = inst_list->size();
+
 	// Body code.
 	stm_call_appropriate_accept(node.body);
 
@@ -1178,9 +1216,17 @@ void inter_code_gen_visitor::visit(node_for_statement& node){
 	address_pointer inc = new_integer_constant(1);
 	inst_list->push_back(new_binary_assign(var, var, inc, quad_oper::PLUS));
 
-	// Return to the beginning
-	inst_list->push_back(new_unconditional_jump_inst(
-											new_label_address(label_beginning)));
+	// The bound is hoisted out of the loop, when it is invariant.
+	if(not this->is_invariant_bound(bound_first, bound_last, body_first)){
+		this->expr_call_appropriate_accept(node.to);
+		bound = this->temp;
+	}
+
+	// if var <= temp goto label_body
+	inst_list->push_back(new_relational_jump_inst(var,
+												bound,
+												quad_oper::LESS_EQUAL,
+												new_label_address(label_body)));
 
 	// Ending.
 	inst_list->push_back(new_label_inst(new_label_address(label_ending)));
@@ -1190,30 +1236,38 @@ void inter_code_gen_visitor::visit(node_while_statement& node) {
 	#ifdef __DEBUG
 		std::cout << "Translating while statement" << std::endl;
 	#endif
-	/*
-	 *  LABEL L1, (EXPRESSION CODE, it returns t1), IFFALSE t1 L2, (BODY CODE),
-	 *  GOTO L1, LABEL L2
+	/* Rotated into a guarded loop, tested at the bottom, so each iteration
+	 * takes a single (backward) jump:
+	 * 		(GUARD, jumping to L2 if it is false)
+	 * 	L1:	(BODY CODE)
+	 * 		(GUARD, jumping to L1 if it is true)
+	 * 	L2:
 	 * */
-    t_results label_beg_pair =  s_table.new_temp(this->offset);
-	std::string label_beginning(*std::get<1>(label_beg_pair));
-	inst_list->push_back(new_label_inst(new_label_address(label_beginning)));
-
-	// Evaluate the guard. Its value is in temp.
-	this->expr_call_appropriate_accept(node.expression);
+	// Evaluate the guard: if it is true, continue with the body.
+	jump_list true_list;
+	jump_list false_list;
+	this->translate_condition(node.expression, true_list, false_list, true);
 
 	// If the guard is false, jump to the end of the code.
     t_results label_end_pair =  s_table.new_temp(this->offset);
 	std::string label_ending(*std::get<1>(label_end_pair));
-	inst_list->push_back(new_conditional_jump_inst(temp,
-										new_label_address(label_ending),
-										quad_oper::IFFALSE));
+	this->backpatch(false_list, new_label_address(label_ending));
+
+    t_results label_body_pair =  s_table.new_temp(this->offset);
+	std::string label_body(*std::get<1>(label_body_pair));
+	inst_list->push_back(new_label_inst(new_label_address(label_body)));
+	this->backpatch(true_list, new_label_address(label_body));
 
 	// Body.
 	stm_call_appropriate_accept(node.body);
 
-	// Return to the beginning.
-	inst_list->push_back(new_unconditional_jump_inst(
-										new_label_address(label_beginning)));
+	// The guard, again: return to the body while it is true.
+	jump_list loop_true_list;
+	jump_list loop_false_list;
+	this->translate_condition(node.expression, loop_true_list,
+							loop_false_list, false);
+	this->backpatch(loop_true_list, new_label_address(label_body));
+	this->backpatch(loop_false_list, new_label_address(label_ending));
 
 	// The end of the loop.
 	inst_list->push_back(new_label_inst(new_label_address(label_ending)));
@@ -1265,10 +1319,6 @@ void inter_code_gen_visitor::visit(node_binary_operation_expr& node) {
 		std::cout << "Translating binary operation" << std::endl;
 	#endif
 
-	// Evaluate the operands.
-	this->expr_call_appropriate_accept(node.left);
-	left_operand = this->temp;
-
 	switch(node.oper){
 		case Oper::OTIMES:
 			oper = quad_oper::TIMES;
@@ -1316,43 +1366,32 @@ void inter_code_gen_visitor::visit(node_binary_operation_expr& node) {
 
         default:{
             // {node.oper == Oper::AND or node.oper = Oper::OR}
-            // This operators have a "short-circuit" semantics.
-            t_results label_pair =  s_table.new_temp(this->offset);
+            // This operators have a "short-circuit" semantics: the value is
+            // computed by jumping code.
+            t_results pair =  s_table.new_temp(this->offset);
 	        #ifdef __DEBUG
-		        assert(std::get<0>(label_pair) == put_results::ID_PUT);
+		        assert(std::get<0>(pair) == put_results::ID_PUT);
 	        #endif
-			
-            bool short_circuit_value;
 
-            switch(node.oper){
-                case Oper::OAND:
-                    short_circuit_value = false;
-                    break;
+            dest = new_name_address(*std::get<1>(pair));
+            inst_list->push_back(new_copy(dest, new_boolean_constant(false)));
 
-                default:
-                    // {node.oper == Oper::OR}
-                    short_circuit_value = true;
-            }
+            jump_list true_list;
+            jump_list false_list;
+            this->translate_logical_operation(node, true_list, false_list, true);
+            this->backpatch_here(true_list);
+            inst_list->push_back(new_copy(dest, new_boolean_constant(true)));
+            this->backpatch_here(false_list);
 
-            // Determine if left_operand is short_circuit_value.
-            inst_list->push_back(
-                new_relational_jump_inst(left_operand,
-                                        new_boolean_constant(short_circuit_value),
-									    quad_oper::EQUAL,
-									    new_label_address(*std::get<1>(label_pair))));
-            // If that is not the case, evaluate the right operand.
-            this->expr_call_appropriate_accept(node.right);
-            inst_list->push_back(new_copy(left_operand, this->temp));
-
-            inst_list->push_back(
-                        new_label_inst(
-                            new_label_address(*std::get<1>(label_pair))));
-            
-            this->temp = left_operand;
+            // Update offset.
+            this->offset += boolean_width;
         }
 	}
 
     if(node.oper != Oper::OAND and node.oper != Oper::OOR){
+        // Evaluate the operands.
+        this->expr_call_appropriate_accept(node.left);
+        left_operand = this->temp;
         this->expr_call_appropriate_accept(node.right);
 	    right_operand = this->temp;
         // New temporal for the result.
@@ -1438,3 +1477,223 @@ void inter_code_gen_visitor::visit(node_parentheses_expr& node) {
 	this->expr_call_appropriate_accept(node.expression);
 }
 
+void inter_code_gen_visitor::translate_condition(expr_pointer e,
+												jump_list& true_list,
+												jump_list& false_list,
+												bool falls_on_true){
+	switch(e->type_of_expression()){
+		case node_expr::binary_operation_expr:{
+			node_binary_operation_expr& node =
+							static_cast<node_binary_operation_expr&>(*e);
+			quad_oper relop;
+
+			switch(node.oper){
+				case Oper::OAND:
+				case Oper::OOR:
+					this->translate_logical_operation(node, true_list,
+													false_list, falls_on_true);
+					return;
+
+				case Oper::OLESS:
+					relop = quad_oper::LESS;
+					break;
+
+				case Oper::OLESS_EQUAL:
+					relop = quad_oper::LESS_EQUAL;
+					break;
+
+				case Oper::OGREATER:
+					relop = quad_oper::GREATER;
+					break;
+
+				case Oper::OGREATER_EQUAL:
+					relop = quad_oper::GREATER_EQUAL;
+					break;
+
+				case Oper::OEQUAL:
+					relop = quad_oper::EQUAL;
+					break;
+
+				case Oper::ODISTINCT:
+					relop = quad_oper::DISTINCT;
+					break;
+
+				default:
+					// {node.oper isn't a boolean operator}
+					#ifdef __DEBUG
+						assert(false);
+					#endif
+					return;
+			}
+
+			this->expr_call_appropriate_accept(node.left);
+			address_pointer left_operand = this->temp;
+			this->expr_call_appropriate_accept(node.right);
+			address_pointer right_operand = this->temp;
+
+			// A single jump, to the outcome that doesn't fall through.
+			if(falls_on_true){
+				inst_list->push_back(new_relational_jump_inst(left_operand,
+												right_operand,
+												get_negated_relop(relop),
+												nullptr));
+				false_list.push_back(inst_list->back());
+			}
+			else{
+				inst_list->push_back(new_relational_jump_inst(left_operand,
+												right_operand,
+												relop,
+												nullptr));
+				true_list.push_back(inst_list->back());
+			}
+			return;
+		}
+
+		case node_expr::negate_expr:
+			this->translate_condition(
+						static_cast<node_negate_expr&>(*e).expression,
+						false_list, true_list, !falls_on_true);
+			return;
+
+		case node_expr::parentheses_expr:
+			this->translate_condition(
+						static_cast<node_parentheses_expr&>(*e).expression,
+						true_list, false_list, falls_on_true);
+			return;
+
+		default:
+			// Locations, literals and method calls: test their value.
+			this->expr_call_appropriate_accept(e);
+			if(falls_on_true){
+				inst_list->push_back(new_conditional_jump_inst(this->temp,
+															nullptr,
+															quad_oper::IFFALSE));
+				false_list.push_back(inst_list->back());
+			}
+			else{
+				inst_list->push_back(new_conditional_jump_inst(this->temp,
+															nullptr,
+															quad_oper::IFTRUE));
+				true_list.push_back(inst_list->back());
+			}
+	}
+}
+
+void inter_code_gen_visitor::translate_logical_operation(
+											node_binary_operation_expr& node,
+											jump_list& true_list,
+											jump_list& false_list,
+											bool falls_on_true){
+	jump_list left_true;
+	jump_list left_false;
+
+	if(node.oper == Oper::OAND){
+		// If the left operand is true, evaluate the right one.
+		this->translate_condition(node.left, left_true, left_false, true);
+		this->backpatch_here(left_true);
+		false_list.insert(false_list.end(), left_false.begin(),
+						left_false.end());
+	}
+	else{
+		// {node.oper == Oper::OOR}
+		// If the left operand is false, evaluate the right one.
+		this->translate_condition(node.left, left_true, left_false, false);
+		this->backpatch_here(left_false);
+		true_list.insert(true_list.end(), left_true.begin(), left_true.end());
+	}
+
+	this->translate_condition(node.right, true_list, false_list,
+							falls_on_true);
+}
+
+void inter_code_gen_visitor::backpatch(const jump_list& list,
+										const address_pointer& label){
+	for(jump_list::const_iterator it = list.begin(); it != list.end(); ++it){
+		switch((*it)->type){
+			case quad_type::UNCONDITIONAL_JUMP:
+				(*it)->arg1 = label;
+				break;
+
+			case quad_type::CONDITIONAL_JUMP:
+				(*it)->arg2 = label;
+				break;
+
+			default:
+				// {(*it)->type == quad_type::RELATIONAL_JUMP}
+				(*it)->result = label;
+		}
+	}
+}
+
+bool inter_code_gen_visitor::is_invariant_bound(unsigned int first,
+												unsigned int last,
+												unsigned int body){
+	std::unordered_set<std::string> read;
+	bool reads_memory = false;
+
+	for(unsigned int i = first; i < last; i++){
+		const quad_pointer& inst = (*inst_list)[i];
+		std::vector<address_pointer*> uses = get_inst_uses(inst);
+
+		switch(get_inst_type(inst)){
+			case quad_type::PARAMETER:
+			case quad_type::PROCEDURE_CALL:
+			case quad_type::FUNCTION_CALL:
+				return false;
+
+			case quad_type::INDEXED_COPY_FROM:
+				reads_memory = true;
+				break;
+
+			default:
+				break;
+		}
+
+		for(std::vector<address_pointer*>::iterator use = uses.begin();
+		use != uses.end(); ++use){
+			if(**use != nullptr and
+			get_address_type(**use) == address_type::ADDRESS_NAME){
+				read.insert(get_address_name(**use));
+			}
+		}
+	}
+
+	for(unsigned int i = body; i < inst_list->size(); i++){
+		const quad_pointer& inst = (*inst_list)[i];
+		address_pointer definition = get_inst_definition(inst);
+
+		switch(get_inst_type(inst)){
+			case quad_type::PARAMETER:
+			case quad_type::PROCEDURE_CALL:
+			case quad_type::FUNCTION_CALL:
+				return false;
+
+			case quad_type::INDEXED_COPY_TO:
+				if(reads_memory){
+					return false;
+				}
+				break;
+
+			default:
+				break;
+		}
+
+		if(definition != nullptr and
+		get_address_type(definition) == address_type::ADDRESS_NAME and
+		read.find(get_address_name(definition)) != read.end()){
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void inter_code_gen_visitor::backpatch_here(const jump_list& list){
+	if(!list.empty()){
+		t_results label_pair =  s_table.new_temp(this->offset);
+		address_pointer label = new_label_address(*std::get<1>(label_pair));
+
+		inst_list->push_back(new_label_inst(label));
+		this->backpatch(list, label);
+	}
+}
@@ -73,6 +73,8 @@ private:
                                 // object's reference, "this".
 	address_pointer temp; // Temporal where the value of the last analyzed
 						   // expression is saved.
+	// Jumps whose target is still unknown.
+	typedef std::vector<quad_pointer> jump_list;
 
 
 	/* PRE : {id_class is an already registered class name and id_instance is 
@@ -121,6 +123,45 @@ private:
 
 	int get_attribute_offset(reference_list ids);
 
+	/* Translates the boolean expression e into jumping code (sections 6.6
+	 * and 6.7 of Dragon book): the value of e is never saved, the code jumps
+	 * to one place or another depending on it. The jumps taken when e is true
+	 * are added to true_list, those taken when it is false to false_list, and
+	 * their targets are set later, through backpatch.
+	 * If falls_on_true, when e is true the code may also reach its end, without
+	 * jumping; otherwise, that happens when e is false. The corresponding list
+	 * must then be backpatched to the instruction that follows the code.
+	 * */
+	void translate_condition(expr_pointer e,
+							jump_list& true_list,
+							jump_list& false_list,
+							bool falls_on_true);
+
+	/* translate_condition, for an expression e1 && e2 or e1 || e2.
+	 * PRE : {node.oper == Oper::OAND or node.oper == Oper::OOR} */
+	void translate_logical_operation(node_binary_operation_expr& node,
+									jump_list& true_list,
+									jump_list& false_list,
+									bool falls_on_true);
+
+	// Sets label as the target of every jump into list.
+	void backpatch(const jump_list& list, const address_pointer& label);
+
+	/* If list isn't empty, adds a new label at the end of the translation,
+	 * and sets it as the target of every jump into list. */
+	void backpatch_here(const jump_list& list);
+
+	/* Can the value of the upper bound of a for loop, computed by the quads
+	 * at positions [first, last) of inst_list, be kept along the loop whose
+	 * body (and increment) was translated from position body on? It can
+	 * when the bound is pure, and the body can't change it: the quads of the
+	 * bound don't call, the body doesn't call nor define any name that they
+	 * read, and it doesn't write into arrays or attributes if they read
+	 * them. */
+	bool is_invariant_bound(unsigned int first,
+							unsigned int last,
+							unsigned int body);
+
 };
 
 #endif
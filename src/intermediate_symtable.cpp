@@ -55,12 +55,39 @@ std::string ids_info::register_var(std::string key
     return internal_key;
 }
 
+void ids_info::register_version(std::string original
+                               , std::string version) {
+    assert(this->id_exists(original));
+
+    if (this->id_exists(version))
+        return;
+
+    entry_info original_info = ((this->info_map).find(original))->second;
+    entry_info information;
+
+    /*  Parameters' versions are ordinary local variables.                   */
+    if (original_info.entry_kind == K_TEMP)
+        information.entry_kind = K_TEMP;
+    else
+        information.entry_kind = K_VAR;
+    information.entry_type = original_info.entry_type;
+    information.is_param = false;
+    information.rep = version;
+    /*  A non-negative offset tells the code generator to assign one.        */
+    information.offset = new int(0);
+
+    (this->info_map).insert(std::pair<std::string, entry_info>(version, information));
+}
+
 id_type ids_info::get_type(std::string key) {
     assert(this->id_exists(key));
     assert((this->get_kind(key) == K_TEMP) || 
            (this->get_kind(key) == K_VAR)  ||
-           (this->get_kind(key) == K_OBJECT));
-    if (this->get_kind(key) == K_TEMP || (this->get_kind(key) == K_VAR)) {
+           (this->get_kind(key) == K_VAR_PARAM)  ||
+           (this->get_kind(key) == K_OBJECT) ||
+           (this->get_kind(key) == K_OBJECT_PARAM));
+    if (this->get_kind(key) == K_TEMP || (this->get_kind(key) == K_VAR) ||
+        (this->get_kind(key) == K_VAR_PARAM)) {
         return ((((this->info_map).find(key))->second).entry_type);
     } else {
         /*  For objects, return T_UNDEFINED; user of the library should then
@@ -179,7 +206,8 @@ id_kind ids_info::get_kind(std::string key) {
 int ids_info::get_offset(std::string key) {
     assert((((this->info_map).find(key))->second).entry_kind == K_VAR
         || (((this->info_map).find(key))->second).entry_kind == K_OBJECT
-        || (((this->info_map).find(key))->second).entry_kind == K_TEMP);
+        || (((this->info_map).find(key))->second).entry_kind == K_TEMP
+        || this->is_parameter(key));
 
     return *((((this->info_map).find(key))->second).offset);
 }
@@ -358,8 +386,10 @@ t_func_results intermediate_symtable::put_func(symtable_element& e
         if (res == symtables_stack::FUNC_ERROR)
             return(t_func_results(FUNC_ERROR, NULL));
 
-        this->func_name = new std::string(key);
         std::string* rep = new std::string((this->information)->register_method(key, local_vars, class_name));
+        /*  Parameters are listed into the method's entry: keep its internal
+            representation.                                                  */
+        this->func_name = new std::string(*rep);
 
         return(t_func_results(FUNC_PUT, rep));
 }
@@ -389,7 +419,7 @@ t_param_results intermediate_symtable::put_var_param(symtable_element& e
             rep = new std::string((this->information)->register_var(key, offset, T_UNDEFINED, true));
         else
             rep = new std::string((this->information)->register_var(key, offset, e.get_type(), true));
-        t_params aux = (this->information)->get_list_params(*(this->func_name));
+        t_params& aux = (this->information)->get_list_params(*(this->func_name));
         aux.push_back(this->get_id_rep(key));
 
         return(t_param_results(PARAM_PUT, rep));
@@ -429,7 +459,7 @@ t_param_results intermediate_symtable::put_obj_param(symtable_element& e
                                                               , owner
                                                               , address
                                                               , true));
-        t_params aux = (this->information)->get_list_params(*(this->func_name));
+        t_params& aux = (this->information)->get_list_params(*(this->func_name));
         aux.push_back(this->get_id_rep(key));
 
         return(t_param_results(PARAM_PUT, rep));
@@ -90,8 +90,17 @@ public:
                   , boolean telling whether its a parameter or not.          */
     std::string register_var(std::string, int, id_type, bool);
 
-    /*  Precondition: the ID has been registered, and it is of kind K_TEMP or 
-        K_VAR.                                                               */
+    /*  Registers a new version of a variable or temporary, as the SSA form
+        does: with the same type, but as a local variable (or temporary) 
+        whose offset is still to be determined. Registering an existing 
+        version has no effect.
+        Parameters: the ID of the original variable (already registered)
+                  , the ID of the new version.                               */
+    void register_version(std::string, std::string);
+
+    /*  Precondition: the ID has been registered, and it is of kind K_TEMP, 
+        K_VAR, K_VAR_PARAM, K_OBJECT or K_OBJECT_PARAM (objects are
+        T_UNDEFINED).                                                        */
     id_type get_type(std::string);
 
     /*  This method is implemented only in case that it is needed in a future
@@ -138,9 +147,10 @@ public:
     /*  Precondition: the ID has been registered.                            */
     id_kind get_kind(std::string);
 
-    /*  Precondition: the ID has been registered, and it is of kind K_VAR or 
-        K_OBJECT.
-        Returns: the id's offset inside its method's body.                   */
+    /*  Precondition: the ID has been registered, and it is of kind K_VAR, 
+        K_OBJECT, K_TEMP or a parameter.
+        Returns: the id's offset inside its method's body (for parameters, 
+        the one set when translating its method).                           */
     int get_offset(std::string);
 
     /*  Precondition: the ID has been registered, and it is of kind K_METHOD.
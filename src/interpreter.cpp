@@ -0,0 +1,811 @@
+#include <climits>
+#include <sstream>
+#include "interpreter.h"
+#include "control_flow_graph.h"
+
+/////////////////////////
+// @VALUES
+/////////////////////////
+ir_value new_integer_value(int value){
+	ir_value ret;
+
+	ret.type = ir_value_type::INTEGER;
+	ret.ival = value;
+
+	return ret;
+}
+
+ir_value new_float_value(float value){
+	ir_value ret;
+
+	ret.type = ir_value_type::FLOAT;
+	ret.fval = value;
+
+	return ret;
+}
+
+ir_value new_boolean_value(bool value){
+	ir_value ret;
+
+	ret.type = ir_value_type::BOOLEAN;
+	ret.bval = value;
+
+	return ret;
+}
+
+ir_value new_string_value(const std::string& value){
+	ir_value ret;
+
+	ret.type = ir_value_type::STRING;
+	ret.sval = value;
+
+	return ret;
+}
+
+ir_value new_reference_value(const std::shared_ptr<ir_storage>& storage){
+	ir_value ret;
+
+	ret.type = ir_value_type::REFERENCE;
+	ret.reference = storage;
+
+	return ret;
+}
+
+std::string print_ir_value(const ir_value& value){
+	std::ostringstream ret;
+
+	switch(value.type){
+		case ir_value_type::INTEGER:
+			ret << value.ival;
+			break;
+
+		case ir_value_type::FLOAT:
+			ret << value.fval;
+			break;
+
+		case ir_value_type::BOOLEAN:
+			ret << (value.bval ? "true" : "false");
+			break;
+
+		case ir_value_type::STRING:
+			ret << value.sval;
+			break;
+
+		case ir_value_type::REFERENCE:
+			ret << "<reference>";
+			break;
+
+		default:
+			// {value.type == ir_value_type::UNDEFINED}
+			ret << "<undefined>";
+			break;
+	}
+
+	return ret.str();
+}
+
+// Integer arithmetic, wrapping around as the generated code does.
+int wrapping_operation(quad_oper op, int x, int y){
+	unsigned int ux = (unsigned int)x;
+	unsigned int uy = (unsigned int)y;
+
+	switch(op){
+		case quad_oper::TIMES:
+			return (int)(ux * uy);
+
+		case quad_oper::PLUS:
+			return (int)(ux + uy);
+
+		case quad_oper::MINUS:
+			return (int)(ux - uy);
+
+		case quad_oper::DIVIDE:
+			// {y != 0}
+			return x == INT_MIN && y == -1 ? INT_MIN : x / y;
+
+		default:
+			// {op == quad_oper::MOD and y != 0}
+			return x == INT_MIN && y == -1 ? 0 : x % y;
+	}
+}
+
+bool is_extern_method(const instructions_list& method){
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		if(!is_method_label_inst(*it) &&
+		get_inst_type(*it) != quad_type::ENTER_PROCEDURE){
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/////////////////////////
+// @HOST FUNCTIONS
+/////////////////////////
+// As the functions of the IO library.
+ir_value host_print_int(const std::vector<ir_value>& arguments,
+						std::istream& in,
+						std::ostream& out){
+	if(!arguments.empty()){
+		out << print_ir_value(arguments[0]);
+	}
+
+	return ir_value();
+}
+
+ir_value host_print_string(const std::vector<ir_value>& arguments,
+							std::istream& in,
+							std::ostream& out){
+	if(!arguments.empty()){
+		out << print_ir_value(arguments[0]);
+	}
+
+	return ir_value();
+}
+
+ir_value host_read_int(const std::vector<ir_value>& arguments,
+						std::istream& in,
+						std::ostream& out){
+	int value = 0;
+
+	if(!(in >> value)){
+		value = 0;
+	}
+
+	return new_integer_value(value);
+}
+
+
+/////////////////////////
+// @INTERPRETER
+/////////////////////////
+ir_interpreter::ir_interpreter(const instructions_list& code, ids_info& _ids) :
+ids(_ids), in(&std::cin), out(&std::cout), step_limit(INTERPRETER_STEP_LIMIT),
+profile(nullptr), executed(0){
+	methods = split_into_methods(code);
+	labels = std::vector<std::unordered_map<std::string, unsigned int> >(
+																methods.size());
+
+	for(unsigned int m = 0; m < methods.size(); m++){
+		call_positions.push_back(get_call_positions(methods[m]));
+		for(unsigned int i = 0; i < methods[m].size(); i++){
+			if(get_inst_type(methods[m][i]) == quad_type::LABEL){
+				labels[m][get_label_inst_label(methods[m][i])] = i;
+			}
+		}
+
+		if(!methods[m].empty() && is_method_label_inst(methods[m][0])){
+			method_index[get_label_inst_label(methods[m][0])] = m;
+		}
+	}
+
+	this->bind_extern("print_int", host_print_int);
+	this->bind_extern("print_string", host_print_string);
+	this->bind_extern("read_int", host_read_int);
+}
+
+void ir_interpreter::set_input(std::istream& _in){
+	in = &_in;
+}
+
+void ir_interpreter::set_output(std::ostream& _out){
+	out = &_out;
+}
+
+void ir_interpreter::set_step_limit(unsigned long limit){
+	step_limit = limit;
+}
+
+void ir_interpreter::set_profile(execution_profile& _profile){
+	profile = &_profile;
+}
+
+void ir_interpreter::bind_extern(const std::string& name,
+								host_function function){
+	externs[name] = function;
+}
+
+const ir_value& ir_interpreter::get_result() const{
+	return result;
+}
+
+unsigned long ir_interpreter::get_executed_quads() const{
+	return executed;
+}
+
+std::string ir_interpreter::run(const std::string& method){
+	frames.clear();
+	result = ir_value();
+	executed = 0;
+	error = "";
+
+	std::unordered_map<std::string, unsigned int>::iterator it =
+													method_index.find(method);
+
+	if(it == method_index.end() || is_extern_method(methods[it->second])){
+		return "Method " + method + " is not defined.";
+	}
+
+	std::vector<ir_value> arguments;
+	arguments.push_back(new_reference_value(
+									std::shared_ptr<ir_storage>(new ir_storage)));
+	this->enter(it->second, arguments, nullptr);
+
+	while(!frames.empty() && error.empty()){
+		frame& current = frames.back();
+
+		if(current.pc >= methods[current.method].size()){
+			// {the method ends without a return}
+			this->do_return(ir_value());
+			continue;
+		}
+
+		if(++executed > step_limit){
+			this->fail("Step limit exceeded.");
+			break;
+		}
+
+		this->execute(methods[current.method][current.pc++]);
+	}
+
+	frames.clear();
+
+	return error;
+}
+
+void ir_interpreter::fail(const std::string& description){
+	if(error.empty()){
+		error = description;
+		if(!frames.empty()){
+			const frame& current = frames.back();
+			const instructions_list& method = methods[current.method];
+
+			error += " At " + get_label_inst_label(method[0]);
+			if(current.pc > 0 && current.pc <= method.size()){
+				error += ": " + print_instruction(method[current.pc - 1]);
+			}
+		}
+	}
+}
+
+void ir_interpreter::enter(unsigned int method,
+							const std::vector<ir_value>& arguments,
+							const address_pointer& result){
+	if(frames.size() >= INTERPRETER_CALL_DEPTH_LIMIT){
+		this->fail("Call depth limit exceeded.");
+		return;
+	}
+
+	const quad_pointer& label = methods[method][0];
+	std::string method_id = get_label_inst_method_name(label) + "::" +
+							get_label_inst_class_name(label);
+	frame callee;
+
+	callee.method = method;
+	callee.pc = 0;
+	callee.result = result;
+	callee.block = get_label_inst_label(label);
+
+	if(ids.id_exists(method_id)){
+		t_params& params = ids.get_list_params(method_id);
+
+		if(params.size() != arguments.size()){
+			this->fail("Call to " + get_label_inst_label(label) + " with " +
+						std::to_string(arguments.size()) + " parameters.");
+			return;
+		}
+
+		unsigned int k = 0;
+		for(t_params::iterator it = params.begin(); it != params.end(); ++it){
+			callee.values[*it] = arguments[k++];
+		}
+	}
+	else if(arguments.size() > 1){
+		this->fail("Parameters of " + get_label_inst_label(label) +
+					" are not registered.");
+		return;
+	}
+
+	if(profile != nullptr){
+		profile->blocks[callee.block][callee.block]++;
+	}
+	frames.push_back(callee);
+}
+
+void ir_interpreter::call(const quad_pointer& call){
+	frame& caller = frames.back();
+	std::string label = get_procedure_or_function_call_label(call);
+	std::string method_id = label.substr(label.rfind('.') + 1) + "::" +
+							label.substr(0, label.rfind('.'));
+	address_pointer dest = get_inst_type(call) == quad_type::FUNCTION_CALL ?
+							get_function_call_dest(call) : nullptr;
+	// The quantity given by procedure calls counts "this", as generated by
+	// inter_code_gen_visitor; the one given by function calls doesn't.
+	unsigned int quantity = ids.id_exists(method_id) ?
+							ids.get_list_params(method_id).size() :
+							get_call_param_quantity(call) + 1;
+
+	if(profile != nullptr){
+		const std::string& method = get_label_inst_label(
+													methods[caller.method][0]);
+
+		profile->calls[method][call_positions[caller.method][caller.pc - 1]]++;
+	}
+
+	if(caller.arguments.size() < quantity){
+		this->fail("Missing parameters of the call.");
+		return;
+	}
+
+	std::vector<ir_value> arguments(caller.arguments.end() - quantity,
+									caller.arguments.end());
+	caller.arguments.resize(caller.arguments.size() - quantity);
+
+	std::unordered_map<std::string, unsigned int>::iterator it =
+													method_index.find(label);
+
+	if(it != method_index.end() && !is_extern_method(methods[it->second])){
+		this->enter(it->second, arguments, dest);
+		return;
+	}
+
+	// {extern method}
+	std::string name = label.substr(label.rfind('.') + 1);
+	std::unordered_map<std::string, host_function>::iterator function =
+															externs.find(name);
+
+	if(function == externs.end()){
+		this->fail("No host function for the extern method " + label + ".");
+		return;
+	}
+
+	arguments.erase(arguments.begin());
+	ir_value value = function->second(arguments, *in, *out);
+
+	if(dest != nullptr){
+		this->write(dest, value);
+	}
+}
+
+void ir_interpreter::do_return(const ir_value& value){
+	address_pointer dest = frames.back().result;
+
+	frames.pop_back();
+	if(frames.empty()){
+		result = value;
+	}
+	else if(dest != nullptr){
+		this->write(dest, value);
+	}
+}
+
+void ir_interpreter::jump(const std::string& label){
+	frame& current = frames.back();
+	std::unordered_map<std::string, unsigned int>::iterator it =
+												labels[current.method].find(label);
+
+	if(it == labels[current.method].end()){
+		this->fail("Jump to an unknown label " + label + ".");
+		return;
+	}
+
+	current.pc = it->second;
+}
+
+std::shared_ptr<ir_storage> ir_interpreter::get_storage(
+											const address_pointer& operand){
+	if(operand == nullptr ||
+	get_address_type(operand) != address_type::ADDRESS_NAME){
+		this->fail("Malformed operand.");
+		return std::shared_ptr<ir_storage>(new ir_storage);
+	}
+
+	frame& current = frames.back();
+	std::string name = get_address_name(operand);
+	std::unordered_map<std::string, ir_value>::iterator value =
+													current.values.find(name);
+
+	if(value != current.values.end() &&
+	value->second.type == ir_value_type::REFERENCE){
+		return value->second.reference;
+	}
+
+	std::shared_ptr<ir_storage>& storage = current.storages[name];
+	if(storage == nullptr){
+		storage = std::shared_ptr<ir_storage>(new ir_storage);
+	}
+
+	return storage;
+}
+
+ir_value ir_interpreter::read(const address_pointer& operand){
+	if(operand == nullptr){
+		this->fail("Missing operand.");
+		return ir_value();
+	}
+
+	switch(get_address_type(operand)){
+		case address_type::ADDRESS_CONSTANT:
+			switch(get_constant_address_type(operand)){
+				case value_type::INTEGER:
+					return new_integer_value(
+								get_constant_address_integer_value(operand));
+
+				case value_type::FLOAT:
+					return new_float_value(
+								get_constant_address_float_value(operand));
+
+				case value_type::BOOLEAN:
+					return new_boolean_value(
+								get_constant_address_boolean_value(operand));
+
+				default:
+					// {get_constant_address_type(operand) == value_type::STRING}
+					return new_string_value(
+								get_constant_address_string_value(operand));
+			}
+
+		case address_type::ADDRESS_NAME:
+			break;
+
+		default:
+			this->fail("Malformed operand.");
+			return ir_value();
+	}
+
+	frame& current = frames.back();
+	std::string name = get_address_name(operand);
+	std::unordered_map<std::string, ir_value>::iterator value =
+													current.values.find(name);
+
+	if(value != current.values.end() &&
+	value->second.type != ir_value_type::UNDEFINED){
+		return value->second;
+	}
+
+	// Objects and arrays are passed by reference.
+	if(current.storages.find(name) != current.storages.end() ||
+	(ids.id_exists(name) && (ids.get_kind(name) == K_OBJECT ||
+							ids.get_kind(name) == K_ARRAY ||
+							ids.get_kind(name) == K_OBJECT_ARRAY))){
+		return new_reference_value(this->get_storage(operand));
+	}
+
+	this->fail("Read of " + name + ", never written.");
+	return ir_value();
+}
+
+void ir_interpreter::write(const address_pointer& operand,
+							const ir_value& value){
+	if(operand == nullptr ||
+	get_address_type(operand) != address_type::ADDRESS_NAME){
+		this->fail("Malformed operand.");
+		return;
+	}
+
+	frames.back().values[get_address_name(operand)] = value;
+}
+
+ir_value ir_interpreter::compute(quad_oper op,
+								const ir_value& x,
+								const ir_value& y){
+	if(x.type != y.type){
+		this->fail("Operands of different types.");
+		return ir_value();
+	}
+
+	switch(op){
+		case quad_oper::TIMES:
+		case quad_oper::DIVIDE:
+		case quad_oper::MOD:
+		case quad_oper::PLUS:
+		case quad_oper::MINUS:
+			if(x.type == ir_value_type::INTEGER){
+				if((op == quad_oper::DIVIDE || op == quad_oper::MOD) &&
+				y.ival == 0){
+					this->fail("Division by zero.");
+					return ir_value();
+				}
+				return new_integer_value(wrapping_operation(op, x.ival, y.ival));
+			}
+			if(x.type == ir_value_type::FLOAT && op != quad_oper::MOD){
+				switch(op){
+					case quad_oper::TIMES:
+						return new_float_value(x.fval * y.fval);
+
+					case quad_oper::DIVIDE:
+						return new_float_value(x.fval / y.fval);
+
+					case quad_oper::PLUS:
+						return new_float_value(x.fval + y.fval);
+
+					default:
+						// {op == quad_oper::MINUS}
+						return new_float_value(x.fval - y.fval);
+				}
+			}
+			break;
+
+		case quad_oper::LESS:
+		case quad_oper::LESS_EQUAL:
+		case quad_oper::GREATER:
+		case quad_oper::GREATER_EQUAL:
+			if(x.type == ir_value_type::INTEGER ||
+			x.type == ir_value_type::FLOAT){
+				bool is_integer = x.type == ir_value_type::INTEGER;
+				int ix = x.ival;
+				int iy = y.ival;
+				float fx = x.fval;
+				float fy = y.fval;
+
+				switch(op){
+					case quad_oper::LESS:
+						return new_boolean_value(is_integer ? ix < iy : fx < fy);
+
+					case quad_oper::LESS_EQUAL:
+						return new_boolean_value(is_integer ? ix <= iy :
+																fx <= fy);
+
+					case quad_oper::GREATER:
+						return new_boolean_value(is_integer ? ix > iy : fx > fy);
+
+					default:
+						// {op == quad_oper::GREATER_EQUAL}
+						return new_boolean_value(is_integer ? ix >= iy :
+																fx >= fy);
+				}
+			}
+			break;
+
+		case quad_oper::EQUAL:
+		case quad_oper::DISTINCT:{
+				bool equal;
+
+				switch(x.type){
+					case ir_value_type::INTEGER:
+						equal = x.ival == y.ival;
+						break;
+
+					case ir_value_type::FLOAT:
+						equal = x.fval == y.fval;
+						break;
+
+					case ir_value_type::BOOLEAN:
+						equal = x.bval == y.bval;
+						break;
+
+					case ir_value_type::STRING:
+						equal = x.sval == y.sval;
+						break;
+
+					case ir_value_type::REFERENCE:
+						equal = x.reference == y.reference;
+						break;
+
+					default:
+						this->fail("Comparison of undefined values.");
+						return ir_value();
+				}
+
+				return new_boolean_value(op == quad_oper::EQUAL ? equal : !equal);
+			}
+
+		case quad_oper::AND:
+		case quad_oper::OR:
+			if(x.type == ir_value_type::BOOLEAN){
+				return new_boolean_value(op == quad_oper::AND ?
+											x.bval && y.bval :
+											x.bval || y.bval);
+			}
+			break;
+
+		default:
+			break;
+	}
+
+	this->fail("Operator not defined for its operands.");
+	return ir_value();
+}
+
+ir_value ir_interpreter::compute(quad_oper op, const ir_value& x){
+	if(op == quad_oper::NEGATIVE && x.type == ir_value_type::INTEGER){
+		return new_integer_value(wrapping_operation(quad_oper::MINUS, 0,
+																	x.ival));
+	}
+	if(op == quad_oper::NEGATIVE && x.type == ir_value_type::FLOAT){
+		return new_float_value(-x.fval);
+	}
+	if(op == quad_oper::NEGATION && x.type == ir_value_type::BOOLEAN){
+		return new_boolean_value(!x.bval);
+	}
+
+	this->fail("Operator not defined for its operand.");
+	return ir_value();
+}
+
+void ir_interpreter::execute(const quad_pointer& instruction){
+	frame& current = frames.back();
+
+	switch(get_inst_type(instruction)){
+		case quad_type::LABEL:
+			if(!is_method_label_inst(instruction)){
+				current.previous_block = current.block;
+				current.block = get_label_inst_label(instruction);
+				if(profile != nullptr){
+					profile->blocks[get_label_inst_label(
+							methods[current.method][0])][current.block]++;
+				}
+			}
+			break;
+
+		case quad_type::ENTER_PROCEDURE:
+			break;
+
+		case quad_type::BINARY_ASSIGN:{
+				ir_value x = this->read(instruction->arg1);
+				ir_value y = this->read(instruction->arg2);
+
+				if(error.empty()){
+					ir_value value = this->compute(get_inst_op(instruction), x, y);
+					this->write(instruction->result, value);
+				}
+			}
+			break;
+
+		case quad_type::UNARY_ASSIGN:
+			if(get_inst_op(instruction) == quad_oper::ADDRESS_OF){
+				this->write(instruction->result, new_reference_value(
+										this->get_storage(instruction->arg1)));
+			}
+			else{
+				ir_value x = this->read(instruction->arg1);
+
+				if(error.empty()){
+					ir_value value = this->compute(get_inst_op(instruction), x);
+					this->write(instruction->result, value);
+				}
+			}
+			break;
+
+		case quad_type::COPY:{
+				ir_value value = this->read(instruction->arg1);
+
+				if(error.empty()){
+					this->write(instruction->result, value);
+				}
+			}
+			break;
+
+		case quad_type::INDEXED_COPY_TO:{
+				ir_value index = this->read(instruction->arg1);
+				ir_value value = this->read(instruction->arg2);
+
+				if(error.empty() && index.type != ir_value_type::INTEGER){
+					this->fail("Index is not an integer.");
+				}
+				if(error.empty()){
+					this->get_storage(instruction->result)->cells[index.ival] =
+																		value;
+				}
+			}
+			break;
+
+		case quad_type::INDEXED_COPY_FROM:{
+				ir_value index = this->read(instruction->arg2);
+
+				if(error.empty() && index.type != ir_value_type::INTEGER){
+					this->fail("Index is not an integer.");
+				}
+				if(!error.empty()){
+					break;
+				}
+
+				std::shared_ptr<ir_storage> storage =
+										this->get_storage(instruction->arg1);
+				std::map<int, ir_value>::iterator cell =
+											storage->cells.find(index.ival);
+
+				if(cell == storage->cells.end()){
+					this->fail("Read of offset " + std::to_string(index.ival) +
+								", never written.");
+				}
+				else{
+					this->write(instruction->result, cell->second);
+				}
+			}
+			break;
+
+		case quad_type::UNCONDITIONAL_JUMP:
+			this->jump(get_unconditional_jmp_label(instruction));
+			break;
+
+		case quad_type::CONDITIONAL_JUMP:{
+				ir_value guard = this->read(instruction->arg1);
+
+				if(error.empty() && guard.type != ir_value_type::BOOLEAN){
+					this->fail("Guard is not a boolean.");
+				}
+				if(error.empty() &&
+				guard.bval == (get_inst_op(instruction) == quad_oper::IFTRUE)){
+					this->jump(get_conditional_jmp_label(instruction));
+				}
+			}
+			break;
+
+		case quad_type::RELATIONAL_JUMP:{
+				ir_value x = this->read(instruction->arg1);
+				ir_value y = this->read(instruction->arg2);
+				ir_value condition;
+
+				if(error.empty()){
+					condition = this->compute(get_inst_op(instruction), x, y);
+				}
+				if(error.empty() && condition.bval){
+					this->jump(get_relational_jmp_label(instruction));
+				}
+			}
+			break;
+
+		case quad_type::PARAMETER:{
+				ir_value value = this->read(get_param_inst_param(instruction));
+
+				if(error.empty()){
+					current.arguments.push_back(value);
+				}
+			}
+			break;
+
+		case quad_type::PROCEDURE_CALL:
+		case quad_type::FUNCTION_CALL:
+			this->call(instruction);
+			break;
+
+		case quad_type::RETURN:{
+				ir_value value;
+
+				if(instruction->arg1 != nullptr){
+					value = this->read(instruction->arg1);
+				}
+				if(error.empty()){
+					this->do_return(value);
+				}
+			}
+			break;
+
+		case quad_type::PHI:{
+				// The PHIs at the beginning of a block take their values at
+				// the same time.
+				const instructions_list& method = methods[current.method];
+				std::vector<ir_value> values;
+				unsigned int first = current.pc - 1;
+				unsigned int last = first;
+
+				for(; last < method.size() &&
+				get_inst_type(method[last]) == quad_type::PHI; last++){
+					address_pointer argument = get_phi_argument(method[last],
+														current.previous_block);
+
+					if(argument == nullptr){
+						this->fail("PHI without a value from " +
+									current.previous_block + ".");
+						return;
+					}
+					values.push_back(this->read(argument));
+				}
+
+				for(unsigned int i = first; i < last && error.empty(); i++){
+					this->write(get_phi_inst_dest(method[i]), values[i - first]);
+				}
+				current.pc = last;
+				executed += last - first - 1;
+			}
+			break;
+
+		default:
+			this->fail("Unknown quad.");
+			break;
+	}
+}
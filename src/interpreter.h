@@ -0,0 +1,181 @@
+#ifndef INTERPRETER_H_
+#define INTERPRETER_H_
+
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "three_address_code.h"
+#include "intermediate_symtable.h"
+#include "profile.h"
+
+// Quads executed by a run before it is stopped, taken as an infinite loop.
+#define INTERPRETER_STEP_LIMIT 100000000
+// Calls that may be active at the same time.
+#define INTERPRETER_CALL_DEPTH_LIMIT 100000
+
+enum class ir_value_type {
+	UNDEFINED,
+	INTEGER,
+	FLOAT,
+	BOOLEAN,
+	STRING,
+	REFERENCE	// To an object or array.
+};
+
+struct ir_storage;
+
+struct ir_value {
+	ir_value_type type = ir_value_type::UNDEFINED;
+	int ival = 0;
+	float fval = 0;
+	bool bval = false;
+	std::string sval;
+	std::shared_ptr<ir_storage> reference;
+};
+
+/* The memory of an object or an array: the value stored at each byte offset
+ * (from the beginning of it) that has been written. */
+struct ir_storage {
+	std::map<int, ir_value> cells;
+};
+
+ir_value new_integer_value(int value);
+
+ir_value new_float_value(float value);
+
+ir_value new_boolean_value(bool value);
+
+ir_value new_string_value(const std::string& value);
+
+ir_value new_reference_value(const std::shared_ptr<ir_storage>& storage);
+
+std::string print_ir_value(const ir_value&);
+
+/* A method implemented by the host, that stands for an extern method. It
+ * receives the arguments of the call, without "this", and the streams of the
+ * interpreter; it returns the result of the call (UNDEFINED for procedures). */
+typedef ir_value (*host_function)(const std::vector<ir_value>& arguments,
+									std::istream& in,
+									std::ostream& out);
+
+/* Executes the IR of a whole program directly, as a reference for the
+ * results of the compiled code (mainly, to check that the optimization
+ * passes keep the behaviour of a program, without assembling it).
+ *
+ * Methods are found by the label that begins them. Methods without quads
+ * besides their label and their ENTER_PROCEDURE, or that are not defined into
+ * the code, are taken as extern: a call to one of them is dispatched, by the
+ * name of the method (without its class), to the host function bound to it.
+ * print_int, print_string and read_int are bound by default, as into the IO
+ * library.
+ *
+ * Each call has its own names. The arguments of a call are the last
+ * parameters of the caller still not taken by another call: as many as the
+ * parameters of the callee registered into ids ("this" first), to which they
+ * are bound, or get_call_param_quantity + 1 if the callee isn't registered. Objects and arrays are storages addressed by
+ * byte offset through indexed copies: the storage of a name is created the
+ * first time it is accessed (or its address taken, or passed as parameter),
+ * and it is passed by reference. Integer arithmetic wraps around, as into
+ * the generated code. PHIs take the value that flows from the block executed
+ * before, so code into SSA form can be run too. If a profile is given, the
+ * executions of labels and call sites are counted into it.
+ *
+ * A run stops, reporting an error, when it reads a name never written, calls
+ * an extern method without a host function, divides an integer by zero,
+ * exceeds INTERPRETER_STEP_LIMIT quads or INTERPRETER_CALL_DEPTH_LIMIT
+ * nested calls, or finds a malformed quad. */
+class ir_interpreter {
+public:
+	// PRE : {code is the code of a whole program}
+	ir_interpreter(const instructions_list& code, ids_info& ids);
+
+	void set_input(std::istream& in);
+
+	void set_output(std::ostream& out);
+
+	void set_step_limit(unsigned long limit);
+
+	// Counts the executions of the following runs into profile.
+	void set_profile(execution_profile& profile);
+
+	// Binds calls to the extern method name to function.
+	void bind_extern(const std::string& name, host_function function);
+
+	/* Runs the method that begins with the label method (as "Main.main"),
+	 * with a new object as "this". Returns "" if it returns normally, or a
+	 * description of the error that stopped it. */
+	std::string run(const std::string& method);
+
+	// Value returned by the last run (UNDEFINED if it didn't return one).
+	const ir_value& get_result() const;
+
+	// Quads executed by the last run.
+	unsigned long get_executed_quads() const;
+
+private:
+	// State of a call.
+	struct frame {
+		unsigned int method;
+		unsigned int pc;
+		std::unordered_map<std::string, ir_value> values;
+		std::unordered_map<std::string, std::shared_ptr<ir_storage> > storages;
+		// Parameters of the calls still to be made.
+		std::vector<ir_value> arguments;
+		// Where the caller saves the result (nullptr for procedures).
+		address_pointer result;
+		// Labels that begin the block executed and the one executed before.
+		std::string block;
+		std::string previous_block;
+	};
+
+	ids_info& ids;
+	std::vector<instructions_list> methods;
+	std::unordered_map<std::string, unsigned int> method_index;
+	// Position of each label, by method.
+	std::vector<std::unordered_map<std::string, unsigned int> > labels;
+	// As get_call_positions, by method.
+	std::vector<std::vector<int> > call_positions;
+	std::unordered_map<std::string, host_function> externs;
+	std::istream* in;
+	std::ostream* out;
+	unsigned long step_limit;
+	execution_profile* profile;
+
+	std::vector<frame> frames;
+	ir_value result;
+	unsigned long executed;
+	std::string error;
+
+	// Executes quad, from the current frame. Sets error if it fails.
+	void execute(const quad_pointer& quad);
+
+	// Begins a call to method, binding arguments to its parameters.
+	void enter(unsigned int method,
+				const std::vector<ir_value>& arguments,
+				const address_pointer& result);
+
+	void call(const quad_pointer& call);
+
+	void do_return(const ir_value& value);
+
+	void jump(const std::string& label);
+
+	ir_value read(const address_pointer& operand);
+
+	void write(const address_pointer& operand, const ir_value& value);
+
+	/* Storage of the object or array named by operand, into the frame:
+	 * the one it references, or its own one. */
+	std::shared_ptr<ir_storage> get_storage(const address_pointer& operand);
+
+	ir_value compute(quad_oper op, const ir_value& x, const ir_value& y);
+
+	ir_value compute(quad_oper op, const ir_value& x);
+
+	void fail(const std::string& description);
+};
+
+#endif // INTERPRETER_H_
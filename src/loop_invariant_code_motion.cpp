@@ -0,0 +1,367 @@
+#include <unordered_set>
+#include "loop_invariant_code_motion.h"
+#include "control_flow_graph.h"
+#include "ssa.h"
+
+#ifdef __DEBUG
+	#include <cassert>
+#endif
+
+typedef std::unordered_set<std::string> names_set;
+
+/////////////////////////
+// @INVARIANTS
+/////////////////////////
+// Facts about a loop, needed to decide which of its quads are invariant.
+struct loop_info {
+	std::vector<bool> in_loop; // Indexed by block.
+	names_set defined; // Names defined into the loop.
+	// Does the loop store into memory, call a method, or define a name that
+	// could be accessed through a pointer?
+	bool writes_memory;
+	// Blocks of the loop with a successor out of it.
+	std::vector<unsigned int> exiting;
+};
+
+loop_info get_loop_info(const control_flow_graph& cfg,
+						const natural_loop& loop,
+						const names_set& values){
+	const instructions_list& method = cfg.get_method();
+	loop_info ret;
+
+	ret.in_loop = std::vector<bool>(cfg.size(), false);
+	ret.writes_memory = false;
+	for(std::vector<unsigned int>::const_iterator it = loop.blocks.begin();
+	it != loop.blocks.end(); ++it){
+		ret.in_loop[*it] = true;
+	}
+
+	for(std::vector<unsigned int>::const_iterator it = loop.blocks.begin();
+	it != loop.blocks.end(); ++it){
+		const basic_block& block = cfg.get_block(*it);
+
+		for(unsigned int i = block.first; i < block.last; i++){
+			address_pointer definition = get_inst_definition(method[i]);
+
+			switch(get_inst_type(method[i])){
+				case quad_type::INDEXED_COPY_TO:
+				case quad_type::PROCEDURE_CALL:
+				case quad_type::FUNCTION_CALL:
+					ret.writes_memory = true;
+					break;
+
+				default:
+					break;
+			}
+
+			if(definition != nullptr &&
+			get_address_type(definition) == address_type::ADDRESS_NAME){
+				ret.defined.insert(get_address_name(definition));
+				if(values.find(get_address_name(definition)) == values.end()){
+					ret.writes_memory = true;
+				}
+			}
+		}
+
+		for(std::vector<unsigned int>::const_iterator succ =
+		block.successors.begin(); succ != block.successors.end(); ++succ){
+			if(!ret.in_loop[*succ]){
+				ret.exiting.push_back(*it);
+				break;
+			}
+		}
+	}
+
+	return ret;
+}
+
+/* Is operand, read into the loop, the same on every iteration? invariants
+ * are the names defined by the quads already found invariant. */
+bool is_invariant_operand(const address_pointer& operand,
+						const loop_info& info,
+						const names_set& values,
+						const names_set& invariants){
+	if(operand == nullptr ||
+	get_address_type(operand) != address_type::ADDRESS_NAME){
+		// Constants.
+		return true;
+	}
+
+	const std::string& name = get_address_name(operand);
+
+	if(invariants.find(name) != invariants.end()){
+		return true;
+	}
+	if(info.defined.find(name) != info.defined.end()){
+		return false;
+	}
+	// {name isn't defined into the loop}
+	return values.find(name) != values.end() || !info.writes_memory;
+}
+
+/* Can instruction, from block, be moved out of the loop? */
+bool is_invariant_quad(const quad_pointer& instruction,
+					unsigned int block,
+					const control_flow_graph& cfg,
+					const loop_info& info,
+					const names_set& values,
+					const names_set& invariants){
+	switch(get_inst_type(instruction)){
+		case quad_type::BINARY_ASSIGN:
+		case quad_type::UNARY_ASSIGN:
+		case quad_type::COPY:
+			break;
+
+		case quad_type::INDEXED_COPY_FROM:
+			if(info.writes_memory){
+				return false;
+			}
+			break;
+
+		default:
+			return false;
+	}
+
+	address_pointer definition = get_inst_definition(instruction);
+
+	if(definition == nullptr ||
+	get_address_type(definition) != address_type::ADDRESS_NAME ||
+	values.find(get_address_name(definition)) == values.end()){
+		return false;
+	}
+
+	// The address of a variable never changes.
+	if(get_inst_type(instruction) != quad_type::UNARY_ASSIGN ||
+	get_inst_op(instruction) != quad_oper::ADDRESS_OF){
+		std::vector<address_pointer*> uses = get_inst_uses(instruction);
+
+		for(std::vector<address_pointer*>::iterator it = uses.begin();
+		it != uses.end(); ++it){
+			if(!is_invariant_operand(**it, info, values, invariants)){
+				return false;
+			}
+		}
+	}
+
+	if(may_fail(instruction)){
+		// Don't speculate: the quad must be executed before leaving the loop,
+		// whichever the exit taken.
+		for(std::vector<unsigned int>::const_iterator it = info.exiting.begin();
+		it != info.exiting.end(); ++it){
+			if(!cfg.dominates(block, *it)){
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+
+/////////////////////////
+// @PREHEADER
+/////////////////////////
+/* Returns a copy of jump, that goes to label instead of its target. */
+quad_pointer retarget_jump(const quad_pointer& jump,
+						const address_pointer& label){
+	quad_pointer ret = copy_instruction(jump);
+
+	switch(get_inst_type(jump)){
+		case quad_type::UNCONDITIONAL_JUMP:
+			ret->arg1 = label;
+			break;
+
+		case quad_type::CONDITIONAL_JUMP:
+			ret->arg2 = label;
+			break;
+
+		default:
+			// {jump is a RELATIONAL_JUMP}
+			ret->result = label;
+			break;
+	}
+
+	return ret;
+}
+
+// Returns the label to which jump goes, or "" if it isn't a jump.
+std::string get_jump_label(const quad_pointer& jump){
+	switch(get_inst_type(jump)){
+		case quad_type::UNCONDITIONAL_JUMP:
+			return get_unconditional_jmp_label(jump);
+
+		case quad_type::CONDITIONAL_JUMP:
+			return get_conditional_jmp_label(jump);
+
+		case quad_type::RELATIONAL_JUMP:
+			return get_relational_jmp_label(jump);
+
+		default:
+			return "";
+	}
+}
+
+/* Hoists the invariants of the loop whose header begins with header_label.
+ * Returns the number of quads moved. */
+unsigned int hoist_loop(instructions_list& method,
+						const std::string& header_label,
+						ids_info& ids){
+	control_flow_graph cfg(method);
+	int header = cfg.get_label_block(header_label);
+	const natural_loop* loop = nullptr;
+
+	for(std::vector<natural_loop>::const_iterator it = cfg.get_loops().begin();
+	it != cfg.get_loops().end(); ++it){
+		if((int)it->header == header){
+			loop = &(*it);
+			break;
+		}
+	}
+
+	if(loop == nullptr || header == 0){
+		// {the loop begins at the entry of the method: there is no place
+		// before it}
+		return 0;
+	}
+
+	names_set values = get_ssa_values(method);
+	names_set entry_values = get_entry_values(method);
+	values.insert(entry_values.begin(), entry_values.end());
+
+	loop_info info = get_loop_info(cfg, *loop, values);
+	const basic_block& header_block = cfg.get_block(header);
+	int entry = UNDEFINED_BLOCK;
+
+	for(std::vector<unsigned int>::const_iterator it =
+	header_block.predecessors.begin(); it != header_block.predecessors.end();
+	++it){
+		if(!info.in_loop[*it]){
+			if(entry != UNDEFINED_BLOCK){
+				// More than one entry.
+				return 0;
+			}
+			entry = *it;
+		}
+	}
+
+	if(entry == UNDEFINED_BLOCK){
+		return 0;
+	}
+
+	// Invariant quads, in an order that respects their dependences.
+	std::vector<unsigned int> hoisted;
+	std::vector<bool> moved(method.size(), false);
+	names_set invariants;
+	bool changed = true;
+
+	while(changed){
+		changed = false;
+		for(std::vector<unsigned int>::const_iterator b = loop->blocks.begin();
+		b != loop->blocks.end(); ++b){
+			const basic_block& block = cfg.get_block(*b);
+
+			for(unsigned int i = block.first; i < block.last; i++){
+				if(!moved[i] && is_invariant_quad(method[i], *b, cfg, info,
+												values, invariants)){
+					moved[i] = true;
+					hoisted.push_back(i);
+					invariants.insert(get_address_name(
+											get_inst_definition(method[i])));
+					changed = true;
+				}
+			}
+		}
+	}
+
+	if(hoisted.empty()){
+		return 0;
+	}
+
+	address_pointer preheader = new_label_address(
+											*ids.new_temp(0, T_UNDEFINED));
+	const basic_block& entry_block = cfg.get_block(entry);
+	std::string entry_label = get_label_inst_label(method[entry_block.first]);
+	instructions_list code;
+
+	for(unsigned int b = 0; b < cfg.size(); b++){
+		const basic_block& block = cfg.get_block(b);
+
+		if((int)b == header){
+			code.push_back(new_label_inst(preheader));
+			for(std::vector<unsigned int>::iterator it = hoisted.begin();
+			it != hoisted.end(); ++it){
+				code.push_back(method[*it]);
+			}
+		}
+
+		for(unsigned int i = block.first; i < block.last; i++){
+			if(moved[i]){
+				continue;
+			}
+
+			quad_pointer instruction = method[i];
+
+			if((int)b == entry && i == block.last - 1 &&
+			get_jump_label(instruction) == header_label){
+				instruction = retarget_jump(instruction, preheader);
+			}
+			else if((int)b == header &&
+			get_inst_type(instruction) == quad_type::PHI){
+				instruction = copy_instruction(instruction);
+				std::vector<phi_argument>& args =
+											get_phi_arguments(instruction);
+				for(std::vector<phi_argument>::iterator it = args.begin();
+				it != args.end(); ++it){
+					if(get_label_address_value(it->label) == entry_label){
+						it->label = preheader;
+					}
+				}
+			}
+			code.push_back(instruction);
+		}
+
+		// A block of the loop that falls through into the header, must now
+		// jump over the preheader.
+		quad_type last_type = get_inst_type(method[block.last - 1]);
+
+		if(info.in_loop[b] && (int)b + 1 == header &&
+		last_type != quad_type::UNCONDITIONAL_JUMP &&
+		last_type != quad_type::RETURN){
+			code.push_back(new_unconditional_jump_inst(
+											new_label_address(header_label)));
+		}
+	}
+
+	method = code;
+
+	return hoisted.size();
+}
+
+unsigned int hoist_loop_invariants(instructions_list& method, ids_info& ids){
+	std::vector<std::string> headers;
+
+	{
+		control_flow_graph cfg(method);
+
+		// {every block into SSA form begins with a label}
+		for(std::vector<natural_loop>::const_iterator it =
+		cfg.get_loops().begin(); it != cfg.get_loops().end(); ++it){
+			const quad_pointer& label = method[cfg.get_block(it->header).first];
+
+			#ifdef __DEBUG
+				assert(get_inst_type(label) == quad_type::LABEL);
+			#endif
+			headers.push_back(get_label_inst_label(label));
+		}
+	}
+
+	unsigned int ret = 0;
+
+	// Inner loops come after the loops that enclose them.
+	for(std::vector<std::string>::reverse_iterator it = headers.rbegin();
+	it != headers.rend(); ++it){
+		ret += hoist_loop(method, *it, ids);
+	}
+
+	return ret;
+}
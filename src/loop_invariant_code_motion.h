@@ -0,0 +1,28 @@
+#ifndef LOOP_INVARIANT_CODE_MOTION_H_
+#define LOOP_INVARIANT_CODE_MOTION_H_
+
+#include "three_address_code.h"
+#include "intermediate_symtable.h"
+
+/* Moves the quads of each natural loop of method that compute the same value
+ * on every iteration, to a preheader: a new block, with a new label, that
+ * precedes the header of the loop and receives every edge that enters the
+ * loop. Loops are visited from the innermost ones, so invariants of nested
+ * loops can leave every loop that doesn't modify their operands.
+ *
+ * A quad is invariant when it is an assignment, a copy or a load (indexed
+ * copy from), that defines an SSA value, and its operands are constants or
+ * values defined out of the loop (or by other invariant quads). Loads, and
+ * reads of variables that could be accessed through pointers, are invariant
+ * only if the loop has no stores, calls or assignments to such variables.
+ *
+ * Quads that could fail at run time (loads, and divisions by something that
+ * is not a constant different from 0 and -1) are moved only if they are
+ * executed at every iteration that exits the loop: nothing is speculated.
+ * Loops entered from more than one block outside of them are not modified.
+ *
+ * Returns the number of quads moved.
+ * PRE : {method is the code of a single method, into SSA form} */
+unsigned int hoist_loop_invariants(instructions_list& method, ids_info& ids);
+
+#endif // LOOP_INVARIANT_CODE_MOTION_H_
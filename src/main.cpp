@@ -1,7 +1,9 @@
 /*  Compile a COMPI file, up to certain stage of compilation.
 
 Usage:
-  main.cpp [-o <output>] [-target <stage>]
+  main.cpp [-o <output>] [-target <stage>] [-run] [-dce] [-O<level>]
+           [-passes <names>] [-stats] [-fprofile-generate[=<file>]]
+           [-fprofile-use=<file>]
   main.cpp
 
 Options:
@@ -11,6 +13,37 @@ Options:
                         semantics: semantic analysis stage.
                         intercode: intermediate code generation stage.
                         assembly: assembly code generation stage.
+                        cfg: intermediate code generation, and dump of the
+                             control-flow graph of each method (Graphviz's
+                             DOT format), into OUTPUT only if -o is given.
+  -run              Instead of generating assembly code, execute the
+                        intermediate code (after the optimization passes) with
+                        the IR interpreter, from Main.main.
+  -dce              Eliminate dead code from the intermediate code: the same
+                        as -passes dce (added to the passes named).
+  -O<level>         Optimization level: 0 (default, no optimization), 1 or 2.
+                        From level 1, the integer locals and temporaries are
+                        kept into registers, when possible, and instructions
+                        are selected by cost, with the indexes of arrays
+                        computed by their addressing.
+  -passes <names>   Run only the optimization passes named, separated by
+                        commas (see get_optimization_passes). Given more
+                        than once, the passes named are added.
+  -stats            Report, for each optimization pass, the instructions
+                        changed and the time taken, and the rewritings made
+                        by each rule of the peephole pass.
+  -fprofile-generate[=<file>]
+                    Execute the intermediate code as generated (before the
+                        optimization passes) with the IR interpreter, at
+                        compile time, counting the executions of its blocks
+                        and calls, and write them to FILE (compi.profile by
+                        default). The program reads its input from the
+                        compiler's STDIN: the profile is that of this
+                        interpreted run. The compilation goes on after it,
+                        up to the target stage.
+  -fprofile-use=<file>
+                    Guide the optimization passes with the profile written
+                        by -fprofile-generate to FILE.
 */
 
 
@@ -24,6 +57,11 @@ Options:
 #include "semantic_analysis.h"
 #include "inter_code_gen_visitor.h"
 #include "asm_code_generator.h"
+#include "control_flow_graph.h"
+#include "pass_manager.h"
+#include "peephole.h"
+#include "interpreter.h"
+#include "profile.h"
 
 extern program_pointer ast;
 extern int yyparse();
@@ -34,9 +72,13 @@ enum target{
     , SEMANTICS = 2
     , INTERCODE = 3
     , ASSEMBLY = 4
+    , CFG = 5
+    , RUN = 6
 };
 
-void parseArguments(char**, char**, FILE*&, FILE*&, enum target&, bool&);
+void parseArguments(char**, char**, FILE*&, FILE*&, enum target&, bool&,
+                    unsigned int&, std::string&, bool&, std::string&,
+                    std::string&);
 bool endsWith(std::string const&, std::string const&);
 
 
@@ -47,7 +89,16 @@ int main(int argc, const char* argv[]) {
         std::cout << "Usage: " << argv[0] << " [OPTIONS] FILE" << std::endl;
         std::cout << std::endl << "OPTIONS:" << std::endl;
         std::cout << "  -o OUTPUT      Renames the executable file to OUTPUT." << std::endl;
-        std::cout << "  -target STAGE  STAGE is either \"parse\", \"semantics\", \"intercode\", or \"assembly\"." << std::endl;
+        std::cout << "  -target STAGE  STAGE is either \"parse\", \"semantics\", \"intercode\", \"assembly\", or \"cfg\"." << std::endl;
+        std::cout << "  -run           Executes the intermediate code, instead of generating assembly." << std::endl;
+        std::cout << "  -dce           Eliminates dead code: the same as -passes dce." << std::endl;
+        std::cout << "  -O0, -O1, -O2  Optimization level (by default, -O0)." << std::endl;
+        std::cout << "  -passes NAMES  Runs only the optimization passes NAMES, separated by commas." << std::endl;
+        std::cout << "  -stats         Prints the changes and time of each optimization pass, and the hits of each peephole rule." << std::endl;
+        std::cout << "  -fprofile-generate[=FILE]  Executes the intermediate code with the IR interpreter, at compile time, writing its profile to FILE." << std::endl;
+        std::cout << "                             The program reads its input from the compiler's STDIN: the profile is that of this interpreted run." << std::endl;
+        std::cout << "                             The compilation goes on after it, up to the target stage." << std::endl;
+        std::cout << "  -fprofile-use=FILE         Guides the optimization passes with the profile into FILE." << std::endl;
         std::cout << "  -debug         Prints debugging information." << std::endl;
         exit(EXIT_SUCCESS);
     }
@@ -58,7 +109,31 @@ int main(int argc, const char* argv[]) {
     FILE* output_file = NULL;
     enum target stage;
     bool debugging;
-    parseArguments((char**)argv, (char**)argv + argc, input_file, output_file, stage, debugging);
+    unsigned int optimization_level;
+    std::string pass_names;
+    bool statistics;
+    std::string profile_generate;
+    std::string profile_use;
+    execution_profile profile;
+    parseArguments((char**)argv, (char**)argv + argc, input_file, output_file, stage, debugging,
+                   optimization_level, pass_names, statistics, profile_generate, profile_use);
+
+    pass_manager passes(optimization_level);
+    if (!pass_names.empty() && !passes.select_passes(pass_names)) {
+        std::cout << "Unknown optimization pass (" << pass_names << ")." << std::endl;
+        exit(EXIT_SUCCESS);
+    }
+    if (debugging) {
+        passes.set_verification(true);
+    }
+    if (!profile_use.empty()) {
+        std::ifstream profile_file(profile_use);
+        if (!profile_file || !read_profile(profile_file, profile)) {
+            std::cout << "Unreadable profile (" << profile_use << ")." << std::endl;
+            exit(EXIT_SUCCESS);
+        }
+        passes.set_profile(&profile);
+    }
 
     if (debugging) {
         #define __DEBUG
@@ -89,6 +164,23 @@ int main(int argc, const char* argv[]) {
 
 			ir_inst_list =  ir_c_gen_v.get_inst_list();
 			sym_table = ir_c_gen_v.get_ids_info();
+
+			if(!profile_generate.empty()){
+				// Training run, over the IR as it will be given to the passes
+				// by -fprofile-use.
+				ir_interpreter interpreter(*ir_inst_list, *sym_table);
+				interpreter.set_profile(profile);
+				std::string error = interpreter.run("Main.main");
+				std::ofstream profile_file(profile_generate);
+				profile_file << print_profile(profile);
+				if(!error.empty()){
+					std::cout << std::endl << "EXECUTION FAILED: " << error << std::endl;
+					exit(EXIT_FAILURE);
+				}
+				std::cout << std::endl << "PROFILE WRITTEN TO " << profile_generate << "." << std::endl;
+			}
+
+			passes.run_ir_passes(*ir_inst_list, *sym_table);
 		}
     	else{
 			// {not sem_analysis_v.is_analysis_successful()}
@@ -96,12 +188,31 @@ int main(int argc, const char* argv[]) {
     	}
     } else exit(EXIT_SUCCESS);
 
-    if(stage == ASSEMBLY) {
+    if(stage == CFG) {
+        // Control-flow graph of each method, in Graphviz's DOT format.
+        std::string dot = print_cfg_dot(*ir_inst_list);
+        std::cout << dot;
+        if (output_file) {
+            fprintf(output_file, "%s", dot.c_str());
+        }
+    } else if(stage == RUN) {
+        // Execution of the IR, reading from STDIN and writing to STDOUT.
+        ir_interpreter interpreter(*ir_inst_list, *sym_table);
+        std::string error = interpreter.run("Main.main");
+        if (!error.empty()) {
+            std::cout << std::endl << "EXECUTION FAILED: " << error << std::endl;
+            exit(EXIT_FAILURE);
+        }
+    } else if(stage == ASSEMBLY) {
     	// Generation of ASM code.
 		asm_code_generator asm_c_gen(ir_inst_list, sym_table);
+		asm_c_gen.set_register_allocation(optimization_level >= 1,
+										profile_use.empty() ? nullptr : &profile);
+		asm_c_gen.set_instruction_selection(optimization_level >= 1);
 		// TODO: es realmente necesario disponer de un método al que llamar
 		// para realizar la traducción?
 		asm_c_gen.translate_ir();
+		passes.run_asm_passes(*asm_c_gen.get_translation());
 		asm_c_gen.print_translation_intel_syntax();
         if (output_file) {
             asm_instructions_list* assembly_code = asm_c_gen.get_translation();
@@ -114,6 +225,11 @@ int main(int argc, const char* argv[]) {
 
     } else exit(EXIT_SUCCESS);
 
+    if (statistics) {
+        std::cout << std::endl << print_pass_statistics(passes.get_statistics());
+        std::cout << get_peephole_optimizer().print_hits();
+    }
+
     std::cout << std::endl << "COMPILATION FINISHED SUCCESFULLY." << std::endl;
 
     return 0;
@@ -124,11 +240,18 @@ void parseArguments(char** beginIt
                   , FILE*& input_file
                   , FILE*& output_file
                   , enum target& stage
-                  , bool& debugging) {
+                  , bool& debugging
+                  , unsigned int& optimization_level
+                  , std::string& pass_names
+                  , bool& statistics
+                  , std::string& profile_generate
+                  , std::string& profile_use) {
     char** itr = beginIt;
     itr++; // First argument is program name
 
     debugging = false;
+    optimization_level = MIN_OPTIMIZATION_LEVEL;
+    statistics = false;
 
     bool input_file_done = false;
     bool output_file_done = false;
@@ -165,13 +288,57 @@ void parseArguments(char** beginIt
                     stage = INTERCODE;
                 } else if (std::string("assembly").compare(*itr) == 0) {
                     stage = ASSEMBLY;
+                } else if (std::string("cfg").compare(*itr) == 0) {
+                    stage = CFG;
                 } else {
                     std::cout << "Invalid target stage." << std::endl;
-                    std::cout << "Options are: \"parse\", \"semantics\", \"intercode\", or \"assembly\"." << std::endl;
+                    std::cout << "Options are: \"parse\", \"semantics\", \"intercode\", \"assembly\", or \"cfg\"." << std::endl;
                     exit(EXIT_SUCCESS);
                 }
             }
             stage_done = true;
+        } else if (std::string("-run").compare(*itr) == 0) {
+            if(stage_done) {
+                std::cout << "Target stage specified twice." << std::endl;
+                exit(EXIT_SUCCESS);
+            }
+            stage = RUN;
+            stage_done = true;
+        } else if (std::string("-dce").compare(*itr) == 0) {
+            pass_names += pass_names.empty() ? "dce" : ",dce";
+        } else if (std::string(*itr).compare(0, 2, "-O") == 0) {
+            std::string level = std::string(*itr).substr(2);
+            if (level.size() != 1 || level[0] < '0' + MIN_OPTIMIZATION_LEVEL
+            || level[0] > '0' + MAX_OPTIMIZATION_LEVEL) {
+                std::cout << "Invalid optimization level." << std::endl;
+                exit(EXIT_SUCCESS);
+            }
+            optimization_level = level[0] - '0';
+        } else if (std::string("-passes").compare(*itr) == 0) {
+            if(++itr == endIt) {
+                std::cout << "Missing mandatory argument for -passes option." << std::endl;
+                exit(EXIT_SUCCESS);
+            }
+            pass_names += pass_names.empty() ? "" : ",";
+            pass_names += std::string(*itr);
+        } else if (std::string("-stats").compare(*itr) == 0) {
+            statistics = true;
+        } else if (std::string(*itr).compare(0, 18, "-fprofile-generate") == 0) {
+            std::string option = std::string(*itr);
+            if (option == "-fprofile-generate") {
+                profile_generate = DEFAULT_PROFILE_FILE;
+            } else if (option[18] == '=' && option.size() > 19) {
+                profile_generate = option.substr(19);
+            } else {
+                std::cout << "Invalid option." << std::endl;
+                exit(EXIT_SUCCESS);
+            }
+        } else if (std::string(*itr).compare(0, 14, "-fprofile-use=") == 0) {
+            profile_use = std::string(*itr).substr(14);
+            if (profile_use.empty()) {
+                std::cout << "Missing file for -fprofile-use option." << std::endl;
+                exit(EXIT_SUCCESS);
+            }
         } else if (std::string("-debug").compare(*itr) == 0) {
             debugging = true;
             #define __DEBUG
@@ -203,11 +370,13 @@ void parseArguments(char** beginIt
         exit(EXIT_SUCCESS);
     }
 
-    if(!output_file_done) 
-        output_file = fopen("a.out", "w");
-
     if (!stage_done) 
         stage = ASSEMBLY;
+
+    // Only the assembly code is written into a.out, if -o is not given:
+    // the other stages don't truncate it.
+    if(!output_file_done && stage == ASSEMBLY) 
+        output_file = fopen("a.out", "w");
 }
 
 bool endsWith(std::string const& fullString, std::string const& ending) {
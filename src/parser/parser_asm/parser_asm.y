@@ -36,12 +36,14 @@ asm_instructions_list *asm_code; // Pointer to the instructions' list.
 %token <label_id> LABEL_ID LABEL
 %token <op> OPERATION
 %token <token> ADDL IMULL IDIVL SUBL NEGL SARL NOTL SHRL MOVL JMP JE JNE JL JLE 
-               JG JGE CALL LEAVE RET CMPL ENTER PUSHQ LEAL
+               JG JGE CALL LEAVE RET CMPL ENTER PUSHQ LEAL ANDL CLTD
+               SHLL MOVSS ADDSS SUBSS MULSS DIVSS UCOMISS CVTSI2SSL JA JAE JP
+               RIP MOVSLQ XORL TESTL MOVZBL SETE SETNE SETL SETLE SETG SETGE
 
 %type <asm_inst_list> inst_list
 %type <instruction> instruction arithmetic logic data_transfer control_transfer
-                    data_comparison misc
-%type <arg> source destination register memory immediate
+                    data_comparison misc sse
+%type <arg> source destination register memory immediate sse_source
 %type <l_int> int_operand
 
 %start inst_list
@@ -70,6 +72,8 @@ instruction
     
     | misc             {$$ = $1;}
     
+    | sse                       {$$ = $1;}
+    
 // TODO: no haria falta mantener ',' a estas alturas...
 // TODO: podriamos definir una categoria sintactico "origen" y "destino",
 // que abstraiga el tipo posible de operandos...
@@ -89,6 +93,11 @@ arithmetic
                                                         data_type::L,
                                                         true));}
                                     
+    | IMULL source                   {$$ = new asm_instruction_pointer(
+                                    new_widening_mul_instruction(*$2, 
+                                                        data_type::L,
+                                                        true));}
+                                    
     | IDIVL source                   {$$ = new asm_instruction_pointer(
                                     new_div_instruction(*$2, 
                                                         data_type::L,
@@ -96,6 +105,9 @@ arithmetic
                                     
     | NEGL destination               {$$ = new asm_instruction_pointer(
                                     new_neg_instruction(*$2, data_type::L));}
+                                    
+    | SARL immediate ',' destination  {$$ = new asm_instruction_pointer(
+                                    new_sar_instruction(*$2, *$4, data_type::L));}
 
 logic
     : NOTL destination                {$$ = new asm_instruction_pointer(
@@ -104,6 +116,15 @@ logic
     | SHRL immediate ',' destination  {$$ = new asm_instruction_pointer(
                                     new_shr_instruction(*$2, *$4, data_type::L));}
                                     
+    | SHLL immediate ',' destination  {$$ = new asm_instruction_pointer(
+                                    new_shl_instruction(*$2, *$4, data_type::L));}
+                                    
+    | ANDL source ',' destination  {$$ = new asm_instruction_pointer(
+                                    new_and_instruction(*$2, *$4, data_type::L));}
+
+    | XORL source ',' destination  {$$ = new asm_instruction_pointer(
+                                    new_xor_instruction(*$2, *$4, data_type::L));}
+                                    
 data_transfer
     : MOVL source ',' destination    {$$ = new asm_instruction_pointer(
                                     new_mov_instruction(*$2, *$4, data_type::L));}
@@ -111,8 +132,17 @@ data_transfer
     | LEAL source ',' destination    {$$ = new asm_instruction_pointer(
                                     new_lea_instruction(*$2, *$4, data_type::L));}
     
+    | MOVSLQ source ',' register     {$$ = new asm_instruction_pointer(
+                                    new_movslq_instruction(*$2, *$4));}
+    
     | PUSHQ source                  {$$ = new asm_instruction_pointer(
                                     new_pushq_instruction(*$2, data_type::L));}
+    
+    | CLTD                          {$$ = new asm_instruction_pointer(
+                                    new_cltd_instruction());}
+
+    | MOVZBL source ',' register     {$$ = new asm_instruction_pointer(
+                                    new_movzbl_instruction(*$2, *$4));}
 
 // TODO: nos haran falta las versions de estas instrucciones en donde el lugar
 // al que saltar se especifica mediante un registro?
@@ -138,6 +168,15 @@ control_transfer
     | JGE LABEL_ID                  {$$ = new asm_instruction_pointer(
                                     new_jge_instruction(*$2));}
     
+    | JA LABEL_ID                   {$$ = new asm_instruction_pointer(
+                                    new_ja_instruction(*$2));}
+    
+    | JAE LABEL_ID                  {$$ = new asm_instruction_pointer(
+                                    new_jae_instruction(*$2));}
+    
+    | JP LABEL_ID                   {$$ = new asm_instruction_pointer(
+                                    new_jp_instruction(*$2));}
+    
     | CALL LABEL_ID                  {$$ = new asm_instruction_pointer(
                                     new_call_instruction(*$2));}
     
@@ -150,7 +189,52 @@ control_transfer
 data_comparison
     : CMPL source ',' source         {$$ = new asm_instruction_pointer(
                                     new_cmp_instruction(*$2, *$4, data_type::L));}
+
+    | TESTL source ',' source        {$$ = new asm_instruction_pointer(
+                                    new_test_instruction(*$2, *$4, data_type::L));}
+
+    | SETE register                 {$$ = new asm_instruction_pointer(
+                                    new_set_instruction(operation::SETE, *$2));}
+
+    | SETNE register                {$$ = new asm_instruction_pointer(
+                                    new_set_instruction(operation::SETNE, *$2));}
+
+    | SETL register                 {$$ = new asm_instruction_pointer(
+                                    new_set_instruction(operation::SETL, *$2));}
+
+    | SETLE register                {$$ = new asm_instruction_pointer(
+                                    new_set_instruction(operation::SETLE, *$2));}
+
+    | SETG register                 {$$ = new asm_instruction_pointer(
+                                    new_set_instruction(operation::SETG, *$2));}
+
+    | SETGE register                {$$ = new asm_instruction_pointer(
+                                    new_set_instruction(operation::SETGE, *$2));}
                                     
+// Scalar single-precision floats: registers are %xmm.
+sse
+    : MOVSS sse_source ',' destination  {$$ = new asm_instruction_pointer(
+                                    new_movss_instruction(*$2, *$4));}
+    
+    | ADDSS sse_source ',' register     {$$ = new asm_instruction_pointer(
+                                    new_addss_instruction(*$2, *$4));}
+    
+    | SUBSS sse_source ',' register     {$$ = new asm_instruction_pointer(
+                                    new_subss_instruction(*$2, *$4));}
+    
+    | MULSS sse_source ',' register     {$$ = new asm_instruction_pointer(
+                                    new_mulss_instruction(*$2, *$4));}
+    
+    | DIVSS sse_source ',' register     {$$ = new asm_instruction_pointer(
+                                    new_divss_instruction(*$2, *$4));}
+    
+    | UCOMISS sse_source ',' register   {$$ = new asm_instruction_pointer(
+                                    new_ucomiss_instruction(*$2, *$4));}
+    
+    | CVTSI2SSL destination ',' register {$$ = new asm_instruction_pointer(
+                                    new_cvtsi2ss_instruction(*$2, *$4,
+                                                            data_type::L));}
+
 misc
     : ENTER immediate ',' immediate {$$ = new asm_instruction_pointer(
                                     new_enter_instruction(*$2, *$4));}
@@ -167,6 +251,12 @@ destination
     : memory                    {$$ = $1;}
     | register                  {$$ = $1;}
 
+sse_source
+    : memory                    {$$ = $1;}
+    | register                  {$$ = $1;}
+    | LABEL_ID '(' '%' RIP ')'  {$$ = new operand_pointer(
+                                        new_rip_relative_operand(*$1));}
+
 register
     : '%' REGISTER             {$$ = new operand_pointer(
                                         new_register_operand($2));}
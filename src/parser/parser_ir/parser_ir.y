@@ -110,6 +110,12 @@ binary_assign
                                                         *$3, 
                                                         *$5, 
                                                     quad_oper::MOD));}
+
+    | name '=' address relop address            {$$ = new quad_pointer(
+                                                        new_binary_assign(address_pointer(new_name_address(*$1)), 
+                                                        *$3, 
+                                                        *$5, 
+                                                        $4));}
     ;
     
 unary_assign
@@ -0,0 +1,421 @@
+#include <iostream>
+#include <cstdlib>
+#include <chrono>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include "pass_manager.h"
+#include "control_flow_graph.h"
+#include "ssa.h"
+#include "constant_propagation.h"
+#include "dead_code_elimination.h"
+#include "value_numbering.h"
+#include "copy_propagation.h"
+#include "loop_invariant_code_motion.h"
+#include "induction_variables.h"
+#include "inlining.h"
+#include "tail_calls.h"
+#include "asm_code_generator.h"
+#include "peephole.h"
+#include "block_placement.h"
+
+typedef std::unordered_set<std::string> names_set;
+typedef std::chrono::steady_clock pass_clock;
+
+/////////////////////////
+// @PASSES
+/////////////////////////
+// Adapters to the signature of optimization_pass::run_ir.
+unsigned int run_fold_constants(instructions_list& method, ids_info& ids){
+	return fold_constants(method);
+}
+
+unsigned int run_propagate_constants(instructions_list& method, ids_info& ids){
+	return propagate_constants(method);
+}
+
+unsigned int run_number_values(instructions_list& method, ids_info& ids){
+	return number_values(method);
+}
+
+unsigned int run_propagate_copies(instructions_list& method, ids_info& ids){
+	return propagate_copies(method);
+}
+
+unsigned int run_remove_dead_quads(instructions_list& method, ids_info& ids){
+	return remove_dead_quads(method);
+}
+
+unsigned int run_coalesce_temporaries(instructions_list& method,
+									ids_info& ids){
+	return coalesce_temporaries(method);
+}
+
+unsigned int run_eliminate_dead_code(instructions_list& method, ids_info& ids){
+	return eliminate_dead_code(method);
+}
+
+// Adapter to the signature of optimization_pass::run_asm.
+unsigned int run_peephole_rules(asm_instructions_list& code){
+	return get_peephole_optimizer().run(code);
+}
+
+const std::vector<optimization_pass>& get_optimization_passes(){
+	static const std::vector<optimization_pass> passes = {
+		{"inline", pass_kind::PROGRAM, 2, inline_methods, nullptr,
+		inline_methods_with_profile},
+		{"tail-recursion", pass_kind::METHOD, 1, eliminate_tail_recursion,
+		nullptr},
+		{"fold", pass_kind::METHOD, 1, run_fold_constants, nullptr},
+		{"sccp", pass_kind::SSA_METHOD, 1, run_propagate_constants, nullptr},
+		{"gvn", pass_kind::SSA_METHOD, 2, run_number_values, nullptr},
+		{"copy-propagation", pass_kind::SSA_METHOD, 1, run_propagate_copies,
+		nullptr},
+		{"licm", pass_kind::SSA_METHOD, 2, hoist_loop_invariants, nullptr},
+		{"strength-reduction", pass_kind::SSA_METHOD, 2,
+		reduce_induction_variables, nullptr},
+		{"dead-quads", pass_kind::SSA_METHOD, 1, run_remove_dead_quads,
+		nullptr},
+		{"coalesce", pass_kind::METHOD, 2, run_coalesce_temporaries, nullptr},
+		{"dce", pass_kind::METHOD, 1, run_eliminate_dead_code, nullptr},
+		{"block-placement", pass_kind::METHOD, 2, place_blocks, nullptr,
+		place_blocks_with_profile},
+		{"asm-jumps", pass_kind::ASSEMBLY, 1, nullptr,
+		remove_asm_jumps_to_next},
+		{"peephole", pass_kind::ASSEMBLY, 1, nullptr, run_peephole_rules}
+	};
+
+	return passes;
+}
+
+
+/////////////////////////
+// @VERIFIER
+/////////////////////////
+// Label to which jump goes, or nullptr if it isn't a jump.
+address_pointer get_jump_target_if_any(const quad_pointer& jump){
+	switch(get_inst_type(jump)){
+		case quad_type::UNCONDITIONAL_JUMP:
+			return jump->arg1;
+
+		case quad_type::CONDITIONAL_JUMP:
+			return jump->arg2;
+
+		case quad_type::RELATIONAL_JUMP:
+			return jump->result;
+
+		default:
+			return nullptr;
+	}
+}
+
+// Does instruction have every operand that its type requires?
+bool has_required_operands(const quad_pointer& instruction){
+	switch(get_inst_type(instruction)){
+		case quad_type::BINARY_ASSIGN:
+		case quad_type::INDEXED_COPY_TO:
+		case quad_type::INDEXED_COPY_FROM:
+		case quad_type::RELATIONAL_JUMP:
+		case quad_type::FUNCTION_CALL:
+			return instruction->arg1 != nullptr &&
+				   instruction->arg2 != nullptr &&
+				   instruction->result != nullptr;
+
+		case quad_type::UNARY_ASSIGN:
+		case quad_type::COPY:
+			return instruction->arg1 != nullptr &&
+				   instruction->result != nullptr;
+
+		case quad_type::CONDITIONAL_JUMP:
+		case quad_type::PROCEDURE_CALL:
+			return instruction->arg1 != nullptr &&
+				   instruction->arg2 != nullptr;
+
+		case quad_type::PHI:
+			return instruction->result != nullptr;
+
+		case quad_type::RETURN:
+			return true;
+
+		default:
+			// {UNCONDITIONAL_JUMP, PARAMETER, LABEL or ENTER_PROCEDURE}
+			return instruction->arg1 != nullptr;
+	}
+}
+
+std::string verify_ir(const instructions_list& code, bool ssa){
+	std::vector<instructions_list> methods = split_into_methods(code);
+	names_set labels;
+
+	for(std::vector<instructions_list>::const_iterator method =
+	methods.begin(); method != methods.end(); ++method){
+		names_set method_labels;
+		names_set phi_definitions;
+		std::unordered_map<std::string, unsigned int> definitions;
+
+		for(unsigned int i = 0; i < method->size(); i++){
+			const quad_pointer& instruction = (*method)[i];
+			std::string position = std::to_string(i) + " of " +
+									(is_method_label_inst((*method)[0]) ?
+									get_label_inst_label((*method)[0]) :
+									std::string("the program"));
+
+			if(!has_required_operands(instruction)){
+				return "missing operands at quad " + position;
+			}
+
+			if(get_inst_type(instruction) == quad_type::LABEL){
+				std::string label = get_label_inst_label(instruction);
+
+				if(!labels.insert(label).second){
+					return "label " + label + " defined twice, at quad " +
+							position;
+				}
+				method_labels.insert(label);
+			}
+			else if(get_inst_type(instruction) == quad_type::PHI){
+				if(!ssa){
+					return "PHI out of SSA form, at quad " + position;
+				}
+				if(i == 0 ||
+				(get_inst_type((*method)[i - 1]) != quad_type::LABEL &&
+				get_inst_type((*method)[i - 1]) != quad_type::PHI)){
+					return "PHI not at the beginning of its block, at quad " +
+							position;
+				}
+				phi_definitions.insert(get_address_name(instruction->result));
+			}
+
+			address_pointer definition = get_inst_definition(instruction);
+
+			if(definition != nullptr &&
+			get_address_type(definition) == address_type::ADDRESS_NAME){
+				definitions[get_address_name(definition)]++;
+			}
+		}
+
+		for(unsigned int i = 0; i < method->size(); i++){
+			address_pointer target = get_jump_target_if_any((*method)[i]);
+
+			if(target != nullptr &&
+			method_labels.find(get_label_address_value(target)) ==
+			method_labels.end()){
+				return "jump to " + get_label_address_value(target) +
+						", not a label of its method";
+			}
+		}
+
+		for(names_set::const_iterator it = phi_definitions.begin();
+		it != phi_definitions.end(); ++it){
+			if(definitions[*it] > 1){
+				return *it + " is defined by a PHI, and elsewhere";
+			}
+		}
+	}
+
+	return "";
+}
+
+
+/////////////////////////
+// @PASS MANAGER
+/////////////////////////
+pass_manager::pass_manager(unsigned int level) : profile(nullptr){
+	const std::vector<optimization_pass>& passes = get_optimization_passes();
+
+	for(std::vector<optimization_pass>::const_iterator it = passes.begin();
+	it != passes.end(); ++it){
+		selected.push_back(it->level <= level);
+	}
+
+	#ifdef __DEBUG
+		verification = true;
+	#else
+		verification = false;
+	#endif
+}
+
+bool pass_manager::select_passes(const std::string& names){
+	const std::vector<optimization_pass>& passes = get_optimization_passes();
+	std::istringstream list(names);
+	std::string name;
+
+	selected = std::vector<bool>(passes.size(), false);
+	while(std::getline(list, name, ',')){
+		bool found = false;
+
+		for(unsigned int p = 0; p < passes.size(); p++){
+			if(passes[p].name == name){
+				selected[p] = true;
+				found = true;
+			}
+		}
+
+		if(!found){
+			selected = std::vector<bool>(passes.size(), false);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void pass_manager::set_verification(bool verify){
+	verification = verify;
+}
+
+void pass_manager::set_profile(const execution_profile* _profile){
+	profile = _profile;
+}
+
+const std::vector<pass_statistics>& pass_manager::get_statistics() const{
+	return statistics;
+}
+
+void pass_manager::record(const std::string& pass,
+						unsigned int changes,
+						double milliseconds){
+	for(std::vector<pass_statistics>::iterator it = statistics.begin();
+	it != statistics.end(); ++it){
+		if(it->pass == pass){
+			it->changes += changes;
+			it->milliseconds += milliseconds;
+			return;
+		}
+	}
+
+	statistics.push_back({pass, changes, milliseconds});
+}
+
+void pass_manager::verify(const instructions_list& code,
+						bool ssa,
+						const std::string& pass) const{
+	if(verification){
+		std::string error = verify_ir(code, ssa);
+
+		if(!error.empty()){
+			std::cerr << "Malformed IR after pass " << pass << ": " << error
+					<< "." << std::endl;
+			exit(EXIT_FAILURE);
+		}
+	}
+}
+
+void pass_manager::run_ir_passes(instructions_list& code, ids_info& ids){
+	const std::vector<optimization_pass>& passes = get_optimization_passes();
+	unsigned int p = 0;
+
+	while(p < passes.size()){
+		if(!selected[p] || passes[p].kind == pass_kind::ASSEMBLY){
+			p++;
+		}
+		else if(passes[p].kind == pass_kind::PROGRAM){
+			pass_clock::time_point start = pass_clock::now();
+			unsigned int changes = profile != nullptr &&
+								passes[p].run_profiled_ir != nullptr ?
+								passes[p].run_profiled_ir(code, ids, *profile) :
+								passes[p].run_ir(code, ids);
+			std::chrono::duration<double, std::milli> time = pass_clock::now() -
+																start;
+
+			this->record(passes[p].name, changes, time.count());
+			this->verify(code, false, passes[p].name);
+			p++;
+		}
+		else{
+			// The following passes over methods run one method at a time.
+			std::vector<unsigned int> group;
+
+			while(p < passes.size() && (!selected[p] ||
+			passes[p].kind == pass_kind::METHOD ||
+			passes[p].kind == pass_kind::SSA_METHOD)){
+				if(selected[p]){
+					group.push_back(p);
+				}
+				p++;
+			}
+
+			std::vector<instructions_list> methods = split_into_methods(code);
+
+			for(std::vector<instructions_list>::iterator method =
+			methods.begin(); method != methods.end(); ++method){
+				if(method->empty() || !is_method_label_inst((*method)[0])){
+					continue;
+				}
+
+				bool ssa = false;
+
+				for(unsigned int g = 0; g <= group.size(); g++){
+					bool needs_ssa = g < group.size() &&
+									passes[group[g]].kind ==
+									pass_kind::SSA_METHOD;
+					pass_clock::time_point start = pass_clock::now();
+
+					if(needs_ssa && !ssa){
+						build_ssa(*method, ids);
+						ssa = true;
+						std::chrono::duration<double, std::milli> time =
+													pass_clock::now() - start;
+						this->record("build-ssa", 0, time.count());
+						this->verify(*method, true, "build-ssa");
+					}
+					else if(!needs_ssa && ssa){
+						destroy_ssa(*method, ids);
+						ssa = false;
+						std::chrono::duration<double, std::milli> time =
+													pass_clock::now() - start;
+						this->record("destroy-ssa", 0, time.count());
+						this->verify(*method, false, "destroy-ssa");
+					}
+
+					if(g < group.size()){
+						const optimization_pass& pass = passes[group[g]];
+
+						start = pass_clock::now();
+						unsigned int changes = profile != nullptr &&
+											pass.run_profiled_ir != nullptr ?
+											pass.run_profiled_ir(*method, ids,
+																*profile) :
+											pass.run_ir(*method, ids);
+						std::chrono::duration<double, std::milli> time =
+													pass_clock::now() - start;
+						this->record(pass.name, changes, time.count());
+						this->verify(*method, ssa, pass.name);
+					}
+				}
+			}
+
+			instructions_list* joined = join_methods(methods);
+			code = *joined;
+			delete joined;
+		}
+	}
+}
+
+void pass_manager::run_asm_passes(asm_instructions_list& code){
+	const std::vector<optimization_pass>& passes = get_optimization_passes();
+
+	for(unsigned int p = 0; p < passes.size(); p++){
+		if(selected[p] && passes[p].kind == pass_kind::ASSEMBLY){
+			pass_clock::time_point start = pass_clock::now();
+			unsigned int changes = passes[p].run_asm(code);
+			std::chrono::duration<double, std::milli> time = pass_clock::now() -
+																start;
+
+			this->record(passes[p].name, changes, time.count());
+		}
+	}
+}
+
+std::string print_pass_statistics(
+								const std::vector<pass_statistics>& statistics){
+	std::ostringstream ret;
+
+	for(std::vector<pass_statistics>::const_iterator it = statistics.begin();
+	it != statistics.end(); ++it){
+		ret << it->pass << ": " << it->changes << " instructions changed, "
+			<< it->milliseconds << " ms." << std::endl;
+	}
+
+	return ret.str();
+}
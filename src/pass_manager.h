@@ -0,0 +1,129 @@
+#ifndef PASS_MANAGER_H_
+#define PASS_MANAGER_H_
+
+#include <string>
+#include <vector>
+#include "three_address_code.h"
+#include "intermediate_symtable.h"
+#include "asm_instruction.h"
+#include "profile.h"
+
+// Lowest and highest optimization levels (-O0 and -O2).
+#define MIN_OPTIMIZATION_LEVEL 0
+#define MAX_OPTIMIZATION_LEVEL 2
+
+// Code over which a pass works.
+enum class pass_kind {
+	PROGRAM,		// The whole program, out of SSA form.
+	METHOD,			// Each method, out of SSA form.
+	SSA_METHOD,		// Each method, into SSA form.
+	ASSEMBLY		// The asm translation of the whole program.
+};
+
+/* An optimization pass. Only the functions that correspond to its kind are
+ * defined; they return the number of instructions changed (modified, moved,
+ * added or removed, as each pass counts them). Passes guided by a profile
+ * define run_profiled_ir too, used instead of run_ir when there is one. */
+struct optimization_pass {
+	std::string name;
+	pass_kind kind;
+	unsigned int level; // Lowest optimization level that runs the pass.
+	unsigned int (*run_ir)(instructions_list& code, ids_info& ids);
+	unsigned int (*run_asm)(asm_instructions_list& code);
+	unsigned int (*run_profiled_ir)(instructions_list& code,
+									ids_info& ids,
+									const execution_profile& profile);
+};
+
+// What a pass did, along the whole program.
+struct pass_statistics {
+	std::string pass;
+	unsigned int changes;
+	double milliseconds;
+};
+
+/* Returns every pass, in the order in which they run:
+ * 		_ inline (-O2): inlining of small methods, and of methods called once
+ * 		(or called from hot call sites, with a profile).
+ * 		_ tail-recursion (-O1): self tail calls into loops.
+ * 		_ fold (-O1): folding of quads with constant operands.
+ * 		_ sccp (-O1): sparse conditional constant propagation.
+ * 		_ gvn (-O2): dominator-based value numbering.
+ * 		_ copy-propagation (-O1).
+ * 		_ licm (-O2): loop-invariant code motion.
+ * 		_ strength-reduction (-O2): of induction variables.
+ * 		_ dead-quads (-O1): removal of quads without effect, into SSA form.
+ * 		_ coalesce (-O2): of temporaries into the variables they are copied to.
+ * 		_ dce (-O1): removal of unreachable and dead code.
+ * 		_ block-placement (-O2): of basic blocks, so likely branches fall
+ * 		through (by the branches taken, with a profile).
+ * 		_ asm-jumps (-O1): removal of jmp to the next instruction.
+ * 		_ peephole (-O1): rewriting of short sequences of asm instructions,
+ * 		by the rules of get_peephole_rules (each rewriting counts as a
+ * 		change).
+ * */
+const std::vector<optimization_pass>& get_optimization_passes();
+
+/* Returns "" if code is well formed, or a description of the first problem
+ * found otherwise:
+ * 		_ every quad has the operands that its type requires,
+ *
+ * 		_ every jump goes to a label of its own method, and no label is
+ * 		defined twice,
+ *
+ * 		_ if ssa, every name is defined at most once into each method, and
+ * 		PHIs only follow a label or other PHI. Otherwise, there are no PHIs.
+ * */
+std::string verify_ir(const instructions_list& code, bool ssa);
+
+/* Runs the optimization passes selected, in the order of
+ * get_optimization_passes, keeping the time each one takes and the
+ * instructions it changes. Consecutive passes over the SSA form share the
+ * construction and destruction of the form for each method (reported as
+ * passes "build-ssa" and "destroy-ssa").
+ * If verification is enabled (as it is by default, when compiling with
+ * __DEBUG), the IR is verified after each pass, and compilation stops when
+ * a pass leaves it malformed. */
+class pass_manager {
+public:
+	// Selects the passes of level or of a lower one.
+	pass_manager(unsigned int level);
+
+	/* Selects only the passes named into names, separated by commas.
+	 * Returns false, selecting nothing, if a name is unknown. */
+	bool select_passes(const std::string& names);
+
+	void set_verification(bool verify);
+
+	/* Guides the passes with profile, of the code that will be given to
+	 * run_ir_passes (nullptr, to stop using one). */
+	void set_profile(const execution_profile* profile);
+
+	// Runs the passes over the IR of code, a whole program.
+	void run_ir_passes(instructions_list& code, ids_info& ids);
+
+	// Runs the passes over the asm translation of a whole program.
+	void run_asm_passes(asm_instructions_list& code);
+
+	const std::vector<pass_statistics>& get_statistics() const;
+
+private:
+	std::vector<bool> selected; // Indexed as get_optimization_passes.
+	bool verification;
+	const execution_profile* profile;
+	std::vector<pass_statistics> statistics;
+
+	void record(const std::string& pass,
+				unsigned int changes,
+				double milliseconds);
+
+	// Stops the compilation if code is malformed after pass.
+	void verify(const instructions_list& code,
+				bool ssa,
+				const std::string& pass) const;
+};
+
+// Returns a line per pass, with its statistics.
+std::string print_pass_statistics(const std::vector<pass_statistics>&);
+
+#endif // PASS_MANAGER_H_
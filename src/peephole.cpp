@@ -0,0 +1,521 @@
+#include <sstream>
+#include "peephole.h"
+
+/////////////////////////
+// @AUXILIARY
+/////////////////////////
+std::string trim_peephole_text(const std::string& text){
+	std::string::size_type first = text.find_first_not_of(" \t");
+	std::string::size_type last = text.find_last_not_of(" \t");
+
+	return first == std::string::npos ? std::string("") :
+										 text.substr(first, last - first + 1);
+}
+
+// Splits text at each separator, trimming the pieces.
+std::vector<std::string> split_peephole_text(const std::string& text,
+											char separator){
+	std::vector<std::string> ret;
+	std::string piece;
+	std::istringstream stream(text);
+
+	while(std::getline(stream, piece, separator)){
+		ret.push_back(trim_peephole_text(piece));
+	}
+
+	return ret;
+}
+
+/* Translates the mnemonic of a rule into op (and ops_type, unless any_type).
+ * Returns false if it is unknown. */
+bool parse_peephole_mnemonic(const std::string& mnemonic,
+							operation& op,
+							data_type& ops_type,
+							bool& any_type){
+	static const std::unordered_map<std::string, operation> mnemonics = {
+		{"mov", operation::MOV},
+		{"add", operation::ADD},
+		{"sub", operation::SUB},
+		{"and", operation::AND},
+		{"xor", operation::XOR},
+		{"cmp", operation::CMP},
+		{"lea", operation::LEA},
+		{"jmp", operation::JMP},
+		{"cltd", operation::CLTD}
+	};
+	static const std::unordered_map<char, data_type> suffixes = {
+		{'b', data_type::B},
+		{'w', data_type::W},
+		{'l', data_type::L},
+		{'q', data_type::Q}
+	};
+
+	std::unordered_map<std::string, operation>::const_iterator it =
+												mnemonics.find(mnemonic);
+	if(it != mnemonics.end()){
+		op = it->second;
+		ops_type = data_type::NONE;
+		any_type = true;
+		return true;
+	}
+
+	if(mnemonic.empty() or
+	suffixes.find(mnemonic.back()) == suffixes.end()){
+		return false;
+	}
+
+	it = mnemonics.find(mnemonic.substr(0, mnemonic.size() - 1));
+	if(it == mnemonics.end()){
+		return false;
+	}
+	op = it->second;
+	ops_type = suffixes.at(mnemonic.back());
+	any_type = false;
+
+	return true;
+}
+
+// Register that contains reg, or reg itself if there is none (e.g.: %rdx,
+// for %edx).
+register_id get_peephole_register_family(register_id reg){
+	register_id ret = get_register64(reg);
+
+	return ret == register_id::NONE ? reg : ret;
+}
+
+// Does operand read reg (or a register that overlaps it)?
+bool peephole_operand_reads(const operand_pointer& operand,
+							const operand_pointer& reg){
+	register_id family = get_peephole_register_family(reg->value.reg);
+	bool ret = false;
+
+	switch(get_operand_addressing(operand)){
+		case operand_addressing::REGISTER:
+			ret = get_peephole_register_family(operand->value.reg) == family;
+			break;
+
+		case operand_addressing::MEMORY:
+			ret = (operand->value.mem.base != register_id::NONE and
+				   get_peephole_register_family(operand->value.mem.base) ==
+				   family) or
+				  (operand->value.mem.index != register_id::NONE and
+				   get_peephole_register_family(operand->value.mem.index) ==
+				   family);
+			break;
+
+		default:
+			break;
+	}
+
+	return ret;
+}
+
+bool is_peephole_flags_reader(operation op){
+	return op == operation::JE or op == operation::JNE or op == operation::JL or
+		   op == operation::JLE or op == operation::JG or
+		   op == operation::JGE or op == operation::JA or
+		   op == operation::JAE or op == operation::JP or
+		   (op >= operation::SETE and op <= operation::SETNP);
+}
+
+/* Are the flags written, from next on into code, before being read? Every
+ * other path is taken as a read: labels and jumps (the flags could be read
+ * at the target), and the end of the code. */
+bool are_peephole_flags_dead(const asm_instructions_list& code,
+							unsigned int next){
+	for(unsigned int i = next; i < code.size(); i++){
+		switch(code[i]->op){
+			case operation::ADD:
+			case operation::SUB:
+			case operation::AND:
+			case operation::XOR:
+			case operation::OR:
+			case operation::CMP:
+			case operation::TEST:
+			case operation::NEG:
+			case operation::IMUL:
+			case operation::MUL:
+			case operation::IDIV:
+			case operation::DIV:
+			case operation::UCOMISS:
+			case operation::CALL:
+			case operation::RET:
+				return true;
+
+			case operation::LABEL:
+			case operation::JMP:
+			case operation::DIRECTIVE:
+			case operation::ENTER:
+				return false;
+
+			default:
+				// The rest don't write the flags (or, as shifts by 0, could
+				// leave them as they are).
+				if(is_peephole_flags_reader(code[i]->op)){
+					return false;
+				}
+		}
+	}
+
+	return false;
+}
+
+// Conditions of get_peephole_rules.
+bool peephole_round_trip_condition(const peephole_bindings& bindings,
+									const asm_instructions_list& code,
+									unsigned int next){
+	const operand_pointer& x1 = bindings.at("x1");
+	const operand_pointer& x2 = bindings.at("x2");
+
+	// Otherwise, the first mov changes the address of x1.
+	return not (get_operand_addressing(x1) == operand_addressing::MEMORY and
+				get_operand_addressing(x2) == operand_addressing::REGISTER and
+				peephole_operand_reads(x1, x2));
+}
+
+bool peephole_store_reload_condition(const peephole_bindings& bindings,
+									const asm_instructions_list& code,
+									unsigned int next){
+	// Both of the same width.
+	return (get_register64(bindings.at("r1")->value.reg) ==
+			register_id::NONE) ==
+		   (get_register64(bindings.at("r2")->value.reg) == register_id::NONE);
+}
+
+bool peephole_dead_write_condition(const peephole_bindings& bindings,
+									const asm_instructions_list& code,
+									unsigned int next){
+	return not peephole_operand_reads(bindings.at("x2"), bindings.at("r1"));
+}
+
+bool peephole_edx_restore_condition(const peephole_bindings& bindings,
+									const asm_instructions_list& code,
+									unsigned int next){
+	return not peephole_operand_reads(bindings.at("x2"), bindings.at("%edx"));
+}
+
+bool peephole_xor_zero_condition(const peephole_bindings& bindings,
+								const asm_instructions_list& code,
+								unsigned int next){
+	// Only general-purpose 32-bit registers: xorl clears the whole one.
+	return get_register64(bindings.at("r1")->value.reg) != register_id::NONE and
+		   are_peephole_flags_dead(code, next);
+}
+
+/////////////////////////
+// @INTERFACE
+/////////////////////////
+const std::vector<peephole_rule>& get_peephole_rules(){
+	static const std::vector<peephole_rule> rules = {
+		{"jump-to-next", "jmp l1 ; l1:", "l1:", nullptr},
+		{"mov-round-trip", "mov x1 , x2 ; mov x2 , x1", "mov x1 , x2",
+		peephole_round_trip_condition},
+		{"store-reload", "mov r1 , m1 ; mov m1 , r2",
+		"mov r1 , m1 ; mov r1 , r2", peephole_store_reload_condition},
+		{"dead-register-write", "mov x1 , r1 ; mov x2 , r1", "mov x2 , r1",
+		peephole_dead_write_condition},
+		{"edx-restore-before-cltd", "movl x1 , %edx ; movl x2 , %eax ; cltd",
+		"movl x2 , %eax ; cltd", peephole_edx_restore_condition},
+		{"xor-zero", "movl $0 , r1", "xorl r1 , r1",
+		peephole_xor_zero_condition}
+	};
+
+	return rules;
+}
+
+peephole_optimizer::peephole_optimizer(const std::vector<peephole_rule>& rules){
+	for(std::vector<peephole_rule>::const_iterator it = rules.begin();
+	it != rules.end(); ++it){
+		compiled_rule rule;
+
+		rule.name = it->name;
+		rule.pattern = this->compile(it->pattern);
+		rule.replacement = this->compile(it->replacement);
+		rule.condition = it->condition;
+
+		#ifdef __DEBUG
+			assert(not rule.pattern.empty() and
+				   rule.pattern.size() <= PEEPHOLE_WINDOW);
+		#endif
+
+		this->rules.push_back(rule);
+	}
+
+	this->hits = std::vector<unsigned int>(this->rules.size(), 0);
+	this->runs = 0;
+}
+
+std::vector<peephole_optimizer::instruction_pattern>
+peephole_optimizer::compile(const std::string& text) const{
+	std::vector<instruction_pattern> ret;
+	std::vector<std::string> instructions = split_peephole_text(text, ';');
+
+	for(std::vector<std::string>::iterator it = instructions.begin();
+	it != instructions.end(); ++it){
+		instruction_pattern instruction;
+		std::vector<std::string> operands;
+
+		if(it->empty()){
+			// An empty replacement.
+			continue;
+		}
+
+		if(it->back() == ':'){
+			instruction.op = operation::LABEL;
+			instruction.ops_type = data_type::NONE;
+			instruction.any_type = true;
+			operands.push_back(trim_peephole_text(
+											it->substr(0, it->size() - 1)));
+		}
+		else{
+			std::string::size_type space = it->find_first_of(" \t");
+			std::string mnemonic = it->substr(0, space);
+			bool known = parse_peephole_mnemonic(mnemonic, instruction.op,
+												instruction.ops_type,
+												instruction.any_type);
+
+			#ifdef __DEBUG
+				assert(known);
+			#endif
+
+			if(space != std::string::npos){
+				operands = split_peephole_text(it->substr(space), ',');
+			}
+		}
+
+		for(std::vector<std::string>::iterator operand = operands.begin();
+		operand != operands.end(); ++operand){
+			operand_pattern pattern;
+
+			pattern.text = *operand;
+			if((*operand)[0] == '%' or (*operand)[0] == '$'){
+				pattern.kind = '=';
+			}
+			else{
+				// {*operand is a variable}
+				pattern.kind = (*operand)[0];
+
+				#ifdef __DEBUG
+					assert(std::string("rmilx").find(pattern.kind) !=
+						   std::string::npos);
+				#endif
+			}
+			instruction.operands.push_back(pattern);
+		}
+
+		ret.push_back(instruction);
+	}
+
+	return ret;
+}
+
+bool peephole_optimizer::match(const compiled_rule& rule,
+							const asm_instructions_list& code,
+							unsigned int position,
+							peephole_bindings& bindings) const{
+	if(position + rule.pattern.size() > code.size()){
+		return false;
+	}
+
+	// Size of the instructions matched without suffix, by operation.
+	std::unordered_map<int, data_type> sizes;
+
+	for(unsigned int i = 0; i < rule.pattern.size(); i++){
+		const instruction_pattern& pattern = rule.pattern[i];
+		const asm_instruction_pointer& inst = code[position + i];
+
+		if(inst->op != pattern.op){
+			return false;
+		}
+		if(pattern.any_type){
+			std::unordered_map<int, data_type>::iterator size =
+										sizes.find(static_cast<int>(inst->op));
+
+			if(size == sizes.end()){
+				sizes[static_cast<int>(inst->op)] = inst->ops_type;
+			}
+			else if(size->second != inst->ops_type){
+				return false;
+			}
+		}
+		else if(inst->ops_type != pattern.ops_type){
+			return false;
+		}
+
+		// A single operand is the destination.
+		operand_pointer operands[] = {
+			pattern.operands.size() == 2 ? inst->source : nullptr,
+			inst->destination
+		};
+		if((pattern.operands.size() < 2 and inst->source != nullptr) or
+		(pattern.operands.empty() and inst->destination != nullptr)){
+			return false;
+		}
+
+		for(unsigned int j = 0; j < pattern.operands.size(); j++){
+			const operand_pattern& operand = pattern.operands[j];
+			const operand_pointer& actual = operands[2 - pattern.operands.size()
+													 + j];
+
+			if(actual == nullptr){
+				return false;
+			}
+
+			operand_addressing addressing = get_operand_addressing(actual);
+			bool valid;
+
+			switch(operand.kind){
+				case 'r':
+					valid = addressing == operand_addressing::REGISTER;
+					break;
+
+				case 'm':
+					valid = addressing == operand_addressing::MEMORY or
+							addressing == operand_addressing::RIP_RELATIVE;
+					break;
+
+				case 'i':
+					valid = addressing == operand_addressing::IMMEDIATE;
+					break;
+
+				case 'l':
+					valid = addressing == operand_addressing::NONE;
+					break;
+
+				case 'x':
+					valid = addressing == operand_addressing::REGISTER or
+							addressing == operand_addressing::MEMORY or
+							addressing == operand_addressing::RIP_RELATIVE or
+							addressing == operand_addressing::IMMEDIATE;
+					break;
+
+				default:
+					// {operand.kind == '='}
+					valid = addressing != operand_addressing::NONE and
+							addressing != operand_addressing::DIRECTIVE and
+							print_operand_intel_syntax(actual) == operand.text;
+			}
+			if(not valid){
+				return false;
+			}
+
+			peephole_bindings::iterator bound = bindings.find(operand.text);
+			if(bound == bindings.end()){
+				bindings[operand.text] = actual;
+			}
+			else if(get_operand_addressing(bound->second) != addressing or
+			not are_equal_operands(bound->second, actual)){
+				return false;
+			}
+		}
+	}
+
+	return rule.condition == nullptr or
+		   rule.condition(bindings, code, position + rule.pattern.size());
+}
+
+asm_instructions_list peephole_optimizer::rewrite(
+									const compiled_rule& rule,
+									const asm_instructions_list& code,
+									unsigned int position,
+									const peephole_bindings& bindings) const{
+	asm_instructions_list ret;
+
+	for(std::vector<instruction_pattern>::const_iterator it =
+	rule.replacement.begin(); it != rule.replacement.end(); ++it){
+		asm_instruction_pointer inst = asm_instruction_pointer(
+															new asm_instruction);
+
+		inst->op = it->op;
+		inst->ops_type = it->ops_type;
+		inst->is_signed = false;
+		// Size and sign of the instruction of the pattern of the same
+		// operation, if there is one.
+		for(unsigned int i = 0; i < rule.pattern.size(); i++){
+			if(code[position + i]->op == it->op){
+				if(it->any_type){
+					inst->ops_type = code[position + i]->ops_type;
+				}
+				inst->is_signed = code[position + i]->is_signed;
+				break;
+			}
+		}
+
+		if(it->operands.size() == 2){
+			inst->source = bindings.at(it->operands[0].text);
+		}
+		if(not it->operands.empty()){
+			inst->destination = bindings.at(it->operands.back().text);
+		}
+
+		ret.push_back(inst);
+	}
+
+	return ret;
+}
+
+unsigned int peephole_optimizer::run(asm_instructions_list& code){
+	unsigned int ret = 0;
+	unsigned int position = 0;
+
+	this->runs++;
+	while(position < code.size()){
+		bool rewritten = false;
+
+		for(unsigned int r = 0; not rewritten and r < this->rules.size(); r++){
+			peephole_bindings bindings;
+
+			if(this->match(this->rules[r], code, position, bindings)){
+				asm_instructions_list replacement = this->rewrite(
+															this->rules[r],
+															code,
+															position,
+															bindings);
+
+				code.erase(code.begin() + position,
+						code.begin() + position + this->rules[r].pattern.size());
+				code.insert(code.begin() + position, replacement.begin(),
+							replacement.end());
+				this->hits[r]++;
+				ret++;
+				rewritten = true;
+			}
+		}
+
+		if(rewritten){
+			// Windows that end at the replacement could match now.
+			position = position >= PEEPHOLE_WINDOW - 1 ?
+					   position - (PEEPHOLE_WINDOW - 1) : 0;
+		}
+		else{
+			position++;
+		}
+	}
+
+	return ret;
+}
+
+const std::vector<unsigned int>& peephole_optimizer::get_hits() const{
+	return this->hits;
+}
+
+std::string peephole_optimizer::print_hits() const{
+	std::ostringstream ret;
+
+	if(this->runs == 0){
+		return std::string("");
+	}
+
+	for(unsigned int r = 0; r < this->rules.size(); r++){
+		ret << "peephole " << this->rules[r].name << ": " << this->hits[r]
+			<< " hits." << std::endl;
+	}
+
+	return ret.str();
+}
+
+peephole_optimizer& get_peephole_optimizer(){
+	static peephole_optimizer optimizer(get_peephole_rules());
+
+	return optimizer;
+}
@@ -0,0 +1,141 @@
+#ifndef PEEPHOLE_H_
+#define PEEPHOLE_H_
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "asm_instruction.h"
+
+/* Bibliography adopted:
+ * [1] "Peephole optimization", W. M. McKeeman. Communications of the ACM,
+ * 		8(7), 1965.
+ *
+ * [2] "Engineering a Compiler", Keith D. Cooper and Linda Torczon. Morgan
+ * 		Kaufmann, 2nd edition, 2012. Section 11.5: "Peephole optimization".
+ *
+ * [3] "Intel 64 and IA-32 Architectures Optimization Reference Manual".
+ * 		Section 3.5.1.7: "Clearing registers and dependency breaking idioms".
+ * */
+
+// Most instructions that the pattern of a rule can have.
+#define PEEPHOLE_WINDOW 4
+
+// Operands bound to the variables (and literals) of a rule, by their text.
+typedef std::unordered_map<std::string, operand_pointer> peephole_bindings;
+
+/* Condition of a rule, over the operands bound by its pattern, and the
+ * instructions of code that follow the window matched (from next on). */
+typedef bool (*peephole_condition)(const peephole_bindings& bindings,
+									const asm_instructions_list& code,
+									unsigned int next);
+
+/* A rewriting rule: the instructions of pattern, when they are consecutive
+ * into the code and condition holds, are replaced by those of replacement.
+ * Both are written as asm, in AT&T order, with instructions separated by
+ * ';':
+ * 		_ mnemonics: mov, add, sub, and, xor, cmp, lea, jmp, cltd, with or
+ * 		without suffix (b, w, l or q). Without it, the size of the operands
+ * 		isn't checked, but instructions of the same mnemonic must have the
+ * 		same size. Replacements take the size of the instruction of the
+ * 		pattern with the same mnemonic.
+ * 		_ labels, as <operand>:
+ * 		_ operands: variables r<n> (a register), m<n> (memory), i<n>
+ * 		(immediate), l<n> (label) and x<n> (any of the previous ones, but
+ * 		labels), and literals as they are printed (e.g.: %edx, $0). A
+ * 		variable, or literal, that appears more than once must match equal
+ * 		operands, and only those bound by the pattern can be used by the
+ * 		replacement.
+ * An instruction with a single operand takes it as its destination.
+ * condition is nullptr when the rule always applies. */
+struct peephole_rule {
+	std::string name;
+	std::string pattern;
+	std::string replacement;
+	peephole_condition condition;
+};
+
+/* Rules of the peephole pass, in the order in which they are tried ([1],
+ * [2]):
+ * 		_ jump-to-next: jmp l1; l1: => l1:
+ * 		_ mov-round-trip: mov x1,x2; mov x2,x1 => mov x1,x2 (if x2 is not
+ * 		part of the address x1).
+ * 		_ store-reload: mov r1,m1; mov m1,r2 => mov r1,m1; mov r1,r2 (if
+ * 		r1 and r2 have the same width).
+ * 		_ dead-register-write: mov x1,r1; mov x2,r1 => mov x2,r1 (if x2
+ * 		doesn't read r1).
+ * 		_ edx-restore-before-cltd: movl x1,%edx; movl x2,%eax; cltd =>
+ * 		movl x2,%eax; cltd (if x2 doesn't read %edx): the restoration of
+ * 		%edx, after a division, is dead when the next one follows.
+ * 		_ xor-zero: movl $0,r1 => xorl r1,r1 (shorter, and breaks the
+ * 		dependency on r1, [3]), if the flags are written before being read.
+ * */
+const std::vector<peephole_rule>& get_peephole_rules();
+
+/* Rewrites code with a table of rules, compiled once. Windows are tried
+ * from the beginning of the code, and each rule in order; after each
+ * rewriting, the window backs up to the first position whose instructions
+ * could have been changed by it, so rewritings can enable others. Every
+ * rule must make code cheaper (fewer instructions, or accesses to memory),
+ * so the process ends. */
+class peephole_optimizer {
+public:
+	/* PRE : {every rule of rules is well formed, with at most
+	 * 		  PEEPHOLE_WINDOW instructions into its pattern} */
+	peephole_optimizer(const std::vector<peephole_rule>& rules);
+
+	// Returns the number of rewritings made.
+	unsigned int run(asm_instructions_list& code);
+
+	// Rewritings made by each rule, along every run, in the order of rules.
+	const std::vector<unsigned int>& get_hits() const;
+
+	// Returns a line per rule, with its hits ("" if it has never run).
+	std::string print_hits() const;
+
+private:
+	// Operand of a compiled rule: a variable or a literal, by its text.
+	struct operand_pattern {
+		char kind; // 'r', 'm', 'i', 'l', 'x', or '=' for literals.
+		std::string text;
+	};
+
+	struct instruction_pattern {
+		operation op;
+		data_type ops_type;
+		bool any_type; // Without suffix.
+		std::vector<operand_pattern> operands; // Source, destination.
+	};
+
+	struct compiled_rule {
+		std::string name;
+		std::vector<instruction_pattern> pattern;
+		std::vector<instruction_pattern> replacement;
+		peephole_condition condition;
+	};
+
+	std::vector<compiled_rule> rules;
+	std::vector<unsigned int> hits;
+	unsigned int runs;
+
+	std::vector<instruction_pattern> compile(const std::string& text) const;
+
+	/* Matches rule with the instructions of code from position on, adding
+	 * to bindings the operands bound. */
+	bool match(const compiled_rule& rule,
+			const asm_instructions_list& code,
+			unsigned int position,
+			peephole_bindings& bindings) const;
+
+	/* Returns the instructions of the replacement of rule, for bindings and
+	 * the window matched, from position on. */
+	asm_instructions_list rewrite(const compiled_rule& rule,
+								const asm_instructions_list& code,
+								unsigned int position,
+								const peephole_bindings& bindings) const;
+};
+
+/* Peephole optimizer with the rules of get_peephole_rules, shared by every
+ * run of the pass: its hits are those of the whole compilation. */
+peephole_optimizer& get_peephole_optimizer();
+
+#endif // PEEPHOLE_H_
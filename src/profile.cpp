@@ -0,0 +1,119 @@
+#include <sstream>
+#include "profile.h"
+
+bool is_empty_profile(const execution_profile& profile){
+	return profile.blocks.empty() && profile.calls.empty();
+}
+
+unsigned long get_block_count(const execution_profile& profile,
+							const std::string& method,
+							const std::string& label){
+	std::map<std::string, std::map<std::string, unsigned long> >::const_iterator
+											blocks = profile.blocks.find(method);
+
+	if(blocks == profile.blocks.end()){
+		return 0;
+	}
+
+	std::map<std::string, unsigned long>::const_iterator it =
+													blocks->second.find(label);
+
+	return it != blocks->second.end() ? it->second : 0;
+}
+
+unsigned long get_call_count(const execution_profile& profile,
+							const std::string& method,
+							unsigned int call){
+	std::map<std::string, std::map<unsigned int, unsigned long> >::const_iterator
+											calls = profile.calls.find(method);
+
+	if(calls == profile.calls.end()){
+		return 0;
+	}
+
+	std::map<unsigned int, unsigned long>::const_iterator it =
+													calls->second.find(call);
+
+	return it != calls->second.end() ? it->second : 0;
+}
+
+std::vector<int> get_call_positions(const instructions_list& method){
+	std::vector<int> ret(method.size(), -1);
+	int calls = 0;
+
+	for(unsigned int i = 0; i < method.size(); i++){
+		if(get_inst_type(method[i]) == quad_type::PROCEDURE_CALL ||
+		get_inst_type(method[i]) == quad_type::FUNCTION_CALL){
+			ret[i] = calls++;
+		}
+	}
+
+	return ret;
+}
+
+std::string print_profile(const execution_profile& profile){
+	std::ostringstream ret;
+
+	for(std::map<std::string, std::map<std::string, unsigned long> >::
+	const_iterator method = profile.blocks.begin();
+	method != profile.blocks.end(); ++method){
+		for(std::map<std::string, unsigned long>::const_iterator it =
+		method->second.begin(); it != method->second.end(); ++it){
+			ret << "block " << method->first << " " << it->first << " "
+				<< it->second << std::endl;
+		}
+	}
+
+	for(std::map<std::string, std::map<unsigned int, unsigned long> >::
+	const_iterator method = profile.calls.begin();
+	method != profile.calls.end(); ++method){
+		for(std::map<unsigned int, unsigned long>::const_iterator it =
+		method->second.begin(); it != method->second.end(); ++it){
+			ret << "call " << method->first << " " << it->first << " "
+				<< it->second << std::endl;
+		}
+	}
+
+	return ret.str();
+}
+
+bool read_profile(std::istream& in, execution_profile& profile){
+	std::string line;
+
+	profile = execution_profile();
+	while(std::getline(in, line)){
+		std::istringstream fields(line);
+		std::string kind, method, label;
+		unsigned int call;
+		unsigned long count;
+		bool read;
+
+		if(!(fields >> kind)){
+			// {empty line}
+			continue;
+		}
+
+		if(kind == "block"){
+			read = (bool)(fields >> method >> label >> count);
+			if(read){
+				profile.blocks[method][label] = count;
+			}
+		}
+		else if(kind == "call"){
+			read = (bool)(fields >> method >> call >> count);
+			if(read){
+				profile.calls[method][call] = count;
+			}
+		}
+		else{
+			read = false;
+		}
+
+		if(!read || (fields >> label)){
+			profile = execution_profile();
+			return false;
+		}
+	}
+
+	return true;
+}
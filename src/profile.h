@@ -0,0 +1,54 @@
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <iostream>
+#include <map>
+#include <string>
+#include "three_address_code.h"
+
+// File into which -fprofile-generate writes the profile, if none is given.
+#define DEFAULT_PROFILE_FILE "compi.profile"
+
+/* Execution counts of a program, taken from a run of its IR as generated
+ * (before the optimization passes), so they can be matched against the same
+ * IR on a later compilation. Methods are identified by their label.
+ * 		_ blocks: executions of each label of each method. The label of the
+ * 		method itself counts the calls to it.
+ *
+ * 		_ calls: executions of each call site, identified by the position of
+ * 		the call among the calls (PROCEDURE_CALL or FUNCTION_CALL) of its
+ * 		method, from 0.
+ * */
+struct execution_profile {
+	std::map<std::string, std::map<std::string, unsigned long> > blocks;
+	std::map<std::string, std::map<unsigned int, unsigned long> > calls;
+};
+
+bool is_empty_profile(const execution_profile&);
+
+// Returns 0 if the label was never executed.
+unsigned long get_block_count(const execution_profile& profile,
+							const std::string& method,
+							const std::string& label);
+
+// Returns 0 if the call was never executed.
+unsigned long get_call_count(const execution_profile& profile,
+							const std::string& method,
+							unsigned int call);
+
+/* Maps each call of method (the code of a single method, beginning with its
+ * label) to its position among the calls of the method. The remaining quads
+ * are mapped to -1. */
+std::vector<int> get_call_positions(const instructions_list& method);
+
+/* Text form of a profile, a count per line:
+ * 		block <method> <label> <count>
+ * 		call <method> <position> <count>
+ * */
+std::string print_profile(const execution_profile&);
+
+/* Reads into profile the text form given by print_profile. Returns false, with
+ * profile empty, if it is malformed. */
+bool read_profile(std::istream& in, execution_profile& profile);
+
+#endif // PROFILE_H_
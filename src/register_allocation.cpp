@@ -0,0 +1,517 @@
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <unordered_set>
+#include "register_allocation.h"
+#include "control_flow_graph.h"
+#include "ssa.h"
+
+// Registers that can be assigned, in order of preference.
+const register_id caller_saved_registers[] = {register_id::R10D,
+												register_id::R11D};
+const register_id callee_saved_registers[] = {register_id::EBX,
+												register_id::R12D,
+												register_id::R13D,
+												register_id::R14D,
+												register_id::R15D};
+
+/////////////////////////
+// @AUXILIARY
+/////////////////////////
+bool is_caller_saved_register(register_id reg){
+	return reg == register_id::R10D || reg == register_id::R11D;
+}
+
+// 64-bit register that contains the 32-bit callee-saved register reg.
+register_id get_callee_saved_register64(register_id reg){
+	register_id ret = register_id::NONE;
+
+	switch(reg){
+		case register_id::EBX:
+			ret = register_id::RBX;
+			break;
+
+		case register_id::R12D:
+			ret = register_id::R12;
+			break;
+
+		case register_id::R13D:
+			ret = register_id::R13;
+			break;
+
+		case register_id::R14D:
+			ret = register_id::R14;
+			break;
+
+		case register_id::R15D:
+			ret = register_id::R15;
+			break;
+
+		default:
+			#ifdef __DEBUG
+				assert(false);
+			#endif
+			break;
+	}
+
+	return ret;
+}
+
+/* Removes from free, and returns, the first register between preferred and
+ * end that is into free, or register_id::NONE if there is none. */
+register_id take_free_register(std::vector<register_id>& free,
+								const register_id* preferred,
+								const register_id* end){
+	register_id ret = register_id::NONE;
+
+	for(; preferred != end && ret == register_id::NONE; ++preferred){
+		std::vector<register_id>::iterator it = std::find(free.begin(),
+															free.end(),
+															*preferred);
+
+		if(it != free.end()){
+			ret = *it;
+			free.erase(it);
+		}
+	}
+
+	return ret;
+}
+
+bool is_call_quad(const quad_pointer& instruction){
+	return get_inst_type(instruction) == quad_type::PROCEDURE_CALL ||
+		   get_inst_type(instruction) == quad_type::FUNCTION_CALL;
+}
+
+/* Maps each PARAMETER quad of method, whose call is found, to the position
+ * of its call. The remaining quads are mapped to -1. */
+std::vector<int> get_parameter_calls(const instructions_list& method){
+	std::vector<int> ret(method.size(), -1);
+
+	for(unsigned int i = 0; i < method.size(); i++){
+		std::vector<unsigned int> positions;
+
+		if(is_call_quad(method[i]) &&
+		find_call_parameters(method, i, positions)){
+			for(std::vector<unsigned int>::iterator it = positions.begin();
+			it != positions.end(); ++it){
+				ret[*it] = i;
+			}
+		}
+	}
+
+	return ret;
+}
+
+/* Weight of the uses and definitions of each quad of method (see
+ * get_live_intervals). */
+std::vector<double> get_quad_weights(const instructions_list& method,
+									const control_flow_graph& cfg,
+									const execution_profile* profile){
+	std::vector<double> ret(method.size(), 1);
+	std::map<std::string, std::map<std::string, unsigned long> >::
+										const_iterator counts;
+	bool profiled = false;
+
+	if(profile != nullptr && !method.empty() &&
+	get_inst_type(method[0]) == quad_type::LABEL){
+		std::string label = get_label_inst_label(method[0]);
+
+		counts = profile->blocks.find(label);
+		profiled = counts != profile->blocks.end() &&
+				   get_block_count(*profile, label, label) > 0;
+	}
+
+	if(profiled){
+		double count = 0;
+
+		for(unsigned int i = 0; i < method.size(); i++){
+			if(get_inst_type(method[i]) == quad_type::LABEL){
+				std::map<std::string, unsigned long>::const_iterator it =
+							counts->second.find(get_label_inst_label(method[i]));
+
+				// Labels introduced after profiling (e.g.: by the inlining)
+				// keep the count of the nearest label before them.
+				if(it != counts->second.end()){
+					count = it->second;
+				}
+			}
+			ret[i] = count;
+		}
+	}
+	else{
+		// {there is no profile for method}
+		for(unsigned int b = 0; b < cfg.size(); b++){
+			const basic_block& block = cfg.get_block(b);
+			double weight = std::pow(LOOP_USE_WEIGHT,
+									std::min(block.loop_depth,
+											(unsigned int)MAX_WEIGHTED_LOOP_DEPTH));
+
+			for(unsigned int i = block.first; i < block.last; i++){
+				ret[i] = weight;
+			}
+		}
+	}
+
+	return ret;
+}
+
+/////////////////////////
+// @LIVE INTERVALS
+/////////////////////////
+std::vector<std::string> get_register_candidates(const instructions_list& method,
+												ids_info& ids){
+	std::unordered_set<std::string> scalars = get_scalar_variables(method);
+	std::unordered_set<std::string> entry_values = get_entry_values(method);
+	std::unordered_set<std::string> excluded;
+	std::vector<int> parameter_calls = get_parameter_calls(method);
+	std::vector<std::string> ret;
+
+	for(unsigned int i = 0; i < method.size(); i++){
+		if(get_inst_type(method[i]) == quad_type::PARAMETER &&
+		parameter_calls[i] == -1){
+			address_pointer param = get_param_inst_param(method[i]);
+
+			if(get_address_type(param) == address_type::ADDRESS_NAME){
+				excluded.insert(get_address_name(param));
+			}
+		}
+	}
+
+	// Integer parameters used by the method, that are not pointed.
+	if(!method.empty() && is_method_label_inst(method[0])){
+		std::string method_id = get_label_inst_method_name(method[0]) + "::" +
+								get_label_inst_class_name(method[0]);
+
+		if(ids.id_exists(method_id)){
+			const t_params& params = ids.get_list_params(method_id);
+
+			for(t_params::const_iterator it = params.begin(); it != params.end();
+			++it){
+				if((scalars.find(*it) != scalars.end() ||
+				entry_values.find(*it) != entry_values.end()) &&
+				excluded.find(*it) == excluded.end() &&
+				ids.get_kind(*it) == K_VAR_PARAM && ids.get_type(*it) == T_INT){
+					ret.push_back(*it);
+					excluded.insert(*it);
+				}
+			}
+		}
+	}
+
+	// Then, locals and temporaries follow the order of their first
+	// definition.
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		address_pointer definition = get_inst_definition(*it);
+
+		if(definition == nullptr ||
+		get_address_type(definition) != address_type::ADDRESS_NAME){
+			continue;
+		}
+
+		std::string name = get_address_name(definition);
+		if(scalars.find(name) == scalars.end() ||
+		excluded.find(name) != excluded.end() || !ids.id_exists(name)){
+			continue;
+		}
+
+		id_kind kind = ids.get_kind(name);
+		if((kind == K_TEMP || kind == K_VAR) &&
+		(ids.get_type(name) == T_INT || ids.get_type(name) == T_BOOL)){
+			ret.push_back(name);
+			// {name won't be added again}
+			excluded.insert(name);
+		}
+	}
+
+	return ret;
+}
+
+std::vector<live_interval> get_live_intervals(const instructions_list& method,
+											ids_info& ids,
+											const execution_profile* profile){
+	std::vector<std::string> candidates = get_register_candidates(method, ids);
+	std::unordered_map<std::string, unsigned int> candidate;
+	std::vector<int> parameter_calls = get_parameter_calls(method);
+	control_flow_graph cfg(method);
+	std::vector<double> weights = get_quad_weights(method, cfg, profile);
+
+	for(unsigned int v = 0; v < candidates.size(); v++){
+		candidate.insert(std::make_pair(candidates[v], v));
+	}
+
+	// Candidates defined and used by each quad.
+	std::vector<int> definitions(method.size(), -1);
+	std::vector<std::vector<unsigned int> > uses(method.size());
+	for(unsigned int i = 0; i < method.size(); i++){
+		address_pointer definition = get_inst_definition(method[i]);
+
+		if(definition != nullptr &&
+		get_address_type(definition) == address_type::ADDRESS_NAME &&
+		candidate.find(get_address_name(definition)) != candidate.end()){
+			definitions[i] = candidate[get_address_name(definition)];
+		}
+
+		// The parameters of a call are used by the call.
+		unsigned int user = parameter_calls[i] != -1 ? parameter_calls[i] : i;
+		std::vector<address_pointer*> operands = get_inst_uses(method[i]);
+		for(std::vector<address_pointer*>::iterator it = operands.begin();
+		it != operands.end(); ++it){
+			if(**it != nullptr &&
+			get_address_type(**it) == address_type::ADDRESS_NAME &&
+			candidate.find(get_address_name(**it)) != candidate.end()){
+				uses[user].push_back(candidate[get_address_name(**it)]);
+			}
+		}
+	}
+
+	// Backward data-flow analysis of the candidates live at the entry of
+	// each block.
+	std::vector<std::vector<bool> > live_in(cfg.size(),
+										std::vector<bool>(candidates.size(), false));
+	bool changed = true;
+
+	while(changed){
+		changed = false;
+
+		for(int b = cfg.size() - 1; b >= 0; b--){
+			const basic_block& block = cfg.get_block(b);
+			std::vector<bool> live(candidates.size(), false);
+
+			for(std::vector<unsigned int>::const_iterator it =
+			block.successors.begin(); it != block.successors.end(); ++it){
+				for(unsigned int v = 0; v < candidates.size(); v++){
+					live[v] = live[v] || live_in[*it][v];
+				}
+			}
+
+			for(int i = block.last - 1; i >= (int)block.first; i--){
+				if(definitions[i] != -1){
+					live[definitions[i]] = false;
+				}
+
+				for(std::vector<unsigned int>::iterator it = uses[i].begin();
+				it != uses[i].end(); ++it){
+					live[*it] = true;
+				}
+			}
+
+			if(live != live_in[b]){
+				// {live_in only grows}
+				live_in[b] = live;
+				changed = true;
+			}
+		}
+	}
+
+	// Extend the interval of each candidate to every quad where it is live
+	// after, defined or used.
+	std::vector<live_interval> intervals(candidates.size());
+	std::vector<bool> touched(candidates.size(), false);
+	for(unsigned int v = 0; v < candidates.size(); v++){
+		intervals[v].name = candidates[v];
+		intervals[v].start = 0;
+		intervals[v].end = 0;
+		intervals[v].crosses_call = false;
+		intervals[v].defined_at_start = false;
+		intervals[v].weight = 0;
+	}
+
+	for(unsigned int b = 0; b < cfg.size(); b++){
+		const basic_block& block = cfg.get_block(b);
+		std::vector<bool> live(candidates.size(), false);
+
+		for(std::vector<unsigned int>::const_iterator it =
+		block.successors.begin(); it != block.successors.end(); ++it){
+			for(unsigned int v = 0; v < candidates.size(); v++){
+				live[v] = live[v] || live_in[*it][v];
+			}
+		}
+
+		for(int i = block.last - 1; i >= (int)block.first; i--){
+			std::vector<unsigned int> present(uses[i]);
+
+			if(definitions[i] != -1){
+				present.push_back(definitions[i]);
+				intervals[definitions[i]].weight += weights[i];
+			}
+
+			for(std::vector<unsigned int>::iterator it = uses[i].begin();
+			it != uses[i].end(); ++it){
+				intervals[*it].weight += weights[i];
+			}
+
+			for(unsigned int v = 0; v < candidates.size(); v++){
+				if(live[v]){
+					present.push_back(v);
+
+					if(is_call_quad(method[i]) && (int)v != definitions[i]){
+						intervals[v].crosses_call = true;
+					}
+				}
+			}
+
+			for(std::vector<unsigned int>::iterator it = present.begin();
+			it != present.end(); ++it){
+				if(!touched[*it]){
+					touched[*it] = true;
+					intervals[*it].start = i;
+					intervals[*it].end = i;
+				}
+				else{
+					intervals[*it].start = std::min(intervals[*it].start,
+													(unsigned int)i);
+					intervals[*it].end = std::max(intervals[*it].end,
+												(unsigned int)i);
+				}
+			}
+
+			if(definitions[i] != -1){
+				live[definitions[i]] = false;
+			}
+
+			for(std::vector<unsigned int>::iterator it = uses[i].begin();
+			it != uses[i].end(); ++it){
+				live[*it] = true;
+			}
+		}
+	}
+
+	// Parameters are received at the label of the method.
+	for(unsigned int v = 0; v < candidates.size(); v++){
+		if(ids.is_parameter(candidates[v])){
+			intervals[v].end = touched[v] ? intervals[v].end : 0;
+			intervals[v].start = 0;
+			touched[v] = true;
+		}
+	}
+
+	std::vector<live_interval> ret;
+	for(unsigned int v = 0; v < candidates.size(); v++){
+		if(touched[v]){
+			intervals[v].defined_at_start =
+							definitions[intervals[v].start] == (int)v;
+			ret.push_back(intervals[v]);
+		}
+	}
+
+	std::stable_sort(ret.begin(), ret.end(),
+					[](const live_interval& x, const live_interval& y){
+						return x.start < y.start;
+					});
+
+	return ret;
+}
+
+/////////////////////////
+// @LINEAR SCAN
+/////////////////////////
+register_allocation allocate_registers(const instructions_list& method,
+										ids_info& ids,
+										const execution_profile* profile){
+	std::vector<live_interval> intervals = get_live_intervals(method, ids,
+																profile);
+	// Intervals that hold a register, with the register.
+	std::vector<std::pair<unsigned int, register_id> > active;
+	std::vector<register_id> free_registers;
+	register_allocation ret;
+
+	free_registers.insert(free_registers.end(),
+						std::begin(caller_saved_registers),
+						std::end(caller_saved_registers));
+	free_registers.insert(free_registers.end(),
+						std::begin(callee_saved_registers),
+						std::end(callee_saved_registers));
+	ret.spilled = 0;
+
+	for(unsigned int i = 0; i < intervals.size(); i++){
+		// Expire the intervals that ended before this one begins.
+		for(unsigned int a = 0; a < active.size(); ){
+			if(intervals[active[a].first].end < intervals[i].start ||
+			(intervals[active[a].first].end == intervals[i].start &&
+			intervals[i].defined_at_start)){
+				free_registers.push_back(active[a].second);
+				active.erase(active.begin() + a);
+			}
+			else{
+				a++;
+			}
+		}
+
+		register_id chosen = register_id::NONE;
+		if(!intervals[i].crosses_call){
+			chosen = take_free_register(free_registers,
+										caller_saved_registers,
+										std::end(caller_saved_registers));
+		}
+
+		if(chosen == register_id::NONE){
+			chosen = take_free_register(free_registers,
+										callee_saved_registers,
+										std::end(callee_saved_registers));
+		}
+
+		if(chosen != register_id::NONE){
+			active.push_back(std::make_pair(i, chosen));
+			ret.registers[intervals[i].name] = chosen;
+			continue;
+		}
+
+		// {there is no register available for the interval}
+		int victim = -1;
+		for(unsigned int a = 0; a < active.size(); a++){
+			if(intervals[i].crosses_call &&
+			is_caller_saved_register(active[a].second)){
+				continue;
+			}
+
+			if(victim == -1 ||
+			intervals[active[a].first].weight <
+			intervals[active[victim].first].weight){
+				victim = a;
+			}
+		}
+
+		if(victim != -1 &&
+		intervals[active[victim].first].weight < intervals[i].weight){
+			// The register is taken by the heavier interval: the victim is
+			// kept into memory, all along.
+			ret.registers.erase(intervals[active[victim].first].name);
+			ret.registers[intervals[i].name] = active[victim].second;
+			active[victim].first = i;
+		}
+		// {else, intervals[i] is kept into memory}
+		ret.spilled++;
+	}
+
+	for(const register_id* reg = callee_saved_registers;
+	reg != std::end(callee_saved_registers); ++reg){
+		for(std::unordered_map<std::string, register_id>::iterator it =
+		ret.registers.begin(); it != ret.registers.end(); ++it){
+			if(it->second == *reg){
+				ret.callee_saved.push_back(get_callee_saved_register64(*reg));
+				break;
+			}
+		}
+	}
+
+	return ret;
+}
+
+std::string print_register_allocation(const register_allocation& allocation){
+	std::map<std::string, register_id> sorted(allocation.registers.begin(),
+											allocation.registers.end());
+	std::ostringstream ret;
+
+	for(std::map<std::string, register_id>::iterator it = sorted.begin();
+	it != sorted.end(); ++it){
+		ret << it->first << ": "
+			<< print_operand_intel_syntax(new_register_operand(it->second))
+			<< std::endl;
+	}
+
+	ret << "spilled: " << allocation.spilled << std::endl;
+
+	return ret.str();
+}
@@ -0,0 +1,107 @@
+#ifndef REGISTER_ALLOCATION_H_
+#define REGISTER_ALLOCATION_H_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "three_address_code.h"
+#include "intermediate_symtable.h"
+#include "asm_instruction.h"
+#include "profile.h"
+
+/* Bibliography adopted:
+ * [1] "Linear Scan Register Allocation", Massimiliano Poletto and Vivek
+ * 		Sarkar. ACM TOPLAS, vol. 21, no. 5, 1999.
+ *
+ * [2] "System V Application Binary Interface AMD64 Architecture Processor
+ * 		Supplement", available at http://www.x86-64.org/documentation/abi.pdf
+ * */
+
+// Weight of a use or definition into a loop, by level of nesting (when there
+// is no profile of the method).
+#define LOOP_USE_WEIGHT 10
+// Deepest level of nesting taken into account by the weights.
+#define MAX_WEIGHTED_LOOP_DEPTH 6
+
+/* Live interval of a variable of a method: the quads between the first and
+ * the last one at which it is live, defined or used, following the order of
+ * the method ([1]). */
+struct live_interval {
+	std::string name;
+	unsigned int start;
+	unsigned int end;
+	// Is it live across a call? (live after a call that doesn't define it).
+	bool crosses_call;
+	// Is it defined by the quad at start? Then, it can take the register of
+	// an interval that ends there, as the translation of a quad reads its
+	// operands before writing its result.
+	bool defined_at_start;
+	// Estimated cost of keeping it into memory: its uses and definitions,
+	// weighted by the executions of their blocks.
+	double weight;
+};
+
+// Registers assigned to the variables of a method.
+struct register_allocation {
+	// 32-bit register of each variable kept into a register. Variables not
+	// included, are kept into the stack frame.
+	std::unordered_map<std::string, register_id> registers;
+	// 64-bit callee-saved registers used, that the method must preserve ([2]).
+	std::vector<register_id> callee_saved;
+	// Candidates that didn't get a register.
+	unsigned int spilled;
+};
+
+/* Returns the variables of method that can be kept into a register:
+ * integer and boolean locals and temporaries (registered into ids), and the
+ * integer parameters of the method used by it (which are received into
+ * registers), that are not accessed through pointers (see
+ * get_scalar_variables). Names passed as parameters of a call whose PARAMETER
+ * quads can't be found (see find_call_parameters) are excluded, as the
+ * pushes of the parameters are delayed until the call. Parameters come
+ * first, in order, and then the rest, in the order of their first
+ * definition.
+ * PRE : {method is the code of a single method, out of SSA form} */
+std::vector<std::string> get_register_candidates(const instructions_list& method,
+												ids_info& ids);
+
+/* Returns the live intervals of the candidates of method, in increasing order
+ * of their start (see get_register_candidates), from a backward data-flow
+ * analysis of liveness over the control flow graph of method. The parameters
+ * of a call are taken as used by the call, as they are pushed into the stack
+ * there. The parameters of method are live since its label, where they are
+ * received.
+ *
+ * If profile has counts for method, the weight of each use or definition is
+ * the count of the label that begins its block (or of the nearest label
+ * before it). Otherwise, it is LOOP_USE_WEIGHT^d, being d the loop nesting
+ * depth of its block (up to MAX_WEIGHTED_LOOP_DEPTH).
+ * PRE : {method is the code of a single method, out of SSA form} */
+std::vector<live_interval> get_live_intervals(const instructions_list& method,
+											ids_info& ids,
+											const execution_profile* profile);
+
+/* Assigns registers to the candidates of method, by linear scan over their
+ * live intervals ([1]): intervals are visited in increasing order of their
+ * start, releasing the registers of those that ended before (or that end
+ * where an interval defined_at_start begins). Intervals live across a call
+ * only get callee-saved registers (%ebx, %r12d - %r15d), so their values
+ * survive the call ([2]); the others prefer the caller-saved %r10d and
+ * %r11d, which don't need to be preserved. When there is no
+ * register available, the interval with the least weight, among the new one
+ * and the active ones whose register could be taken, is spilled (kept into
+ * the stack frame all along).
+ *
+ * The scratch registers preferred by the translation (%eax, %edx, %r8d,
+ * %r9d, %rdi) and the registers of the parameters are never assigned: the
+ * translation takes %r10d and %r11d as scratch only when no name has them
+ * (see register_tracker).
+ * PRE : {method is the code of a single method, out of SSA form} */
+register_allocation allocate_registers(const instructions_list& method,
+										ids_info& ids,
+										const execution_profile* profile);
+
+// Returns a line per variable of allocation, with its register.
+std::string print_register_allocation(const register_allocation& allocation);
+
+#endif // REGISTER_ALLOCATION_H_
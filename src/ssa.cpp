@@ -0,0 +1,692 @@
+#include <unordered_map>
+#include <unordered_set>
+#include "ssa.h"
+#include "constants.h"
+
+// Variables that can be renamed, numbered by their first definition.
+struct ssa_variables {
+	std::vector<std::string> names;
+	std::unordered_map<std::string, unsigned int> ids;
+};
+
+/////////////////////////
+// @AUXILIARY
+/////////////////////////
+bool is_name_operand(const address_pointer& operand){
+	return operand != nullptr &&
+		   get_address_type(operand) == address_type::ADDRESS_NAME;
+}
+
+/* Returns the index of operand into vars, or -1 if it is not a variable that
+ * can be renamed. */
+int get_ssa_variable(const ssa_variables& vars, const address_pointer& operand){
+	int ret = -1;
+
+	if(is_name_operand(operand)){
+		std::unordered_map<std::string, unsigned int>::const_iterator it =
+									vars.ids.find(get_address_name(operand));
+
+		if(it != vars.ids.end()){
+			ret = it->second;
+		}
+	}
+
+	return ret;
+}
+
+/* Returns the names of method that can be accessed through pointers: arrays,
+ * objects and variables whose address is taken. */
+std::unordered_set<std::string> find_pointed_names(
+											const instructions_list& method){
+	std::unordered_set<std::string> ret;
+
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		switch(get_inst_type(*it)){
+			case quad_type::INDEXED_COPY_TO:
+				ret.insert(get_address_name(get_indexed_copy_to_dest(*it)));
+				break;
+
+			case quad_type::INDEXED_COPY_FROM:
+				ret.insert(get_address_name(get_indexed_copy_from_src(*it)));
+				break;
+
+			case quad_type::UNARY_ASSIGN:
+				if(get_inst_op(*it) == quad_oper::ADDRESS_OF){
+					ret.insert(get_address_name(get_unary_assign_src(*it)));
+				}
+				break;
+
+			default:
+				break;
+		}
+	}
+
+	return ret;
+}
+
+bool is_scalar_name(const std::string& name,
+					const std::unordered_set<std::string>& pointed){
+	return name.find('.') == std::string::npos &&
+		   pointed.find(name) == pointed.end();
+}
+
+ssa_variables find_ssa_variables(const instructions_list& method){
+	std::unordered_set<std::string> pointed = find_pointed_names(method);
+	ssa_variables ret;
+
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		address_pointer definition = get_inst_definition(*it);
+
+		if(is_name_operand(definition)){
+			std::string name = get_address_name(definition);
+
+			if(is_scalar_name(name, pointed) &&
+			ret.ids.find(name) == ret.ids.end()){
+				ret.ids.insert(std::make_pair(name, ret.names.size()));
+				ret.names.push_back(name);
+			}
+		}
+	}
+
+	return ret;
+}
+
+std::unordered_set<std::string> get_scalar_variables(
+											const instructions_list& method){
+	ssa_variables vars = find_ssa_variables(method);
+
+	return std::unordered_set<std::string>(vars.names.begin(),
+											vars.names.end());
+}
+
+std::unordered_set<std::string> get_ssa_values(const instructions_list& method){
+	ssa_variables vars = find_ssa_variables(method);
+	std::vector<unsigned int> definitions(vars.names.size(), 0);
+	std::unordered_set<std::string> ret;
+
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		int var = get_ssa_variable(vars, get_inst_definition(*it));
+
+		if(var != -1){
+			definitions[var]++;
+		}
+	}
+
+	for(unsigned int var = 0; var < vars.names.size(); var++){
+		if(definitions[var] == 1){
+			ret.insert(vars.names[var]);
+		}
+	}
+
+	return ret;
+}
+
+std::unordered_set<std::string> get_entry_values(
+											const instructions_list& method){
+	std::unordered_set<std::string> pointed = find_pointed_names(method);
+	std::unordered_set<std::string> defined;
+	std::unordered_set<std::string> ret;
+
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		address_pointer definition = get_inst_definition(*it);
+
+		if(is_name_operand(definition)){
+			defined.insert(get_address_name(definition));
+		}
+	}
+
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		std::vector<address_pointer*> uses = get_inst_uses(*it);
+
+		for(std::vector<address_pointer*>::iterator u = uses.begin();
+		u != uses.end(); ++u){
+			if(is_name_operand(**u) &&
+			defined.find(get_address_name(**u)) == defined.end() &&
+			is_scalar_name(get_address_name(**u), pointed)){
+				ret.insert(get_address_name(**u));
+			}
+		}
+	}
+
+	return ret;
+}
+
+/* Returns the first unused name of the form name@k, for k > counter, and
+ * registers it as a version of name. */
+address_pointer new_ssa_version(const std::string& name,
+								unsigned int& counter,
+								std::unordered_set<std::string>& used,
+								ids_info& ids){
+	std::string version;
+
+	do{
+		version = name + "@" + std::to_string(++counter);
+	}while(used.find(version) != used.end());
+
+	used.insert(version);
+	ids.register_version(name, version);
+
+	return new_name_address(version);
+}
+
+/* Puts a label at the beginning of every block of method that doesn't begin
+ * with one. */
+void label_every_block(instructions_list& method, ids_info& ids){
+	control_flow_graph cfg(method);
+	instructions_list labeled;
+
+	for(unsigned int b = 0; b < cfg.size(); b++){
+		const basic_block& block = cfg.get_block(b);
+
+		if(get_inst_type(method[block.first]) != quad_type::LABEL){
+			labeled.push_back(new_label_inst(new_label_address(
+										*ids.new_temp(0, T_UNDEFINED))));
+		}
+		labeled.insert(labeled.end(), method.begin() + block.first,
+						method.begin() + block.last);
+	}
+
+	method = labeled;
+}
+
+void add_enter_bytes(instructions_list& method, unsigned int bytes){
+	for(instructions_list::iterator it = method.begin(); it != method.end();
+	++it){
+		if(get_inst_type(*it) == quad_type::ENTER_PROCEDURE){
+			*it = new_enter_procedure(get_enter_inst_bytes(*it) + bytes);
+			break;
+		}
+	}
+}
+
+
+/////////////////////////
+// @CONSTRUCTION
+/////////////////////////
+/* Returns the PHIs of each block of the graph: a variable gets a PHI at each
+ * block of the iterated dominance frontier of its definitions, where it is
+ * live ([1]). The PHIs define and have, as arguments, the variable itself:
+ * they are renamed later. */
+std::vector<std::vector<quad_pointer> > place_phis(
+											const control_flow_graph& cfg,
+											const ssa_variables& vars){
+	const instructions_list& method = cfg.get_method();
+	unsigned int variables = vars.names.size();
+	std::vector<std::vector<bool> > upward_exposed(cfg.size(),
+									std::vector<bool>(variables, false));
+	std::vector<std::vector<bool> > defined(cfg.size(),
+									std::vector<bool>(variables, false));
+	std::vector<std::vector<unsigned int> > definitions(variables);
+
+	for(unsigned int b = 0; b < cfg.size(); b++){
+		const basic_block& block = cfg.get_block(b);
+
+		for(unsigned int i = block.first; i < block.last; i++){
+			std::vector<address_pointer*> uses = get_inst_uses(method[i]);
+
+			for(std::vector<address_pointer*>::iterator u = uses.begin();
+			u != uses.end(); ++u){
+				int var = get_ssa_variable(vars, **u);
+
+				if(var != -1 && !defined[b][var]){
+					upward_exposed[b][var] = true;
+				}
+			}
+
+			int var = get_ssa_variable(vars, get_inst_definition(method[i]));
+			if(var != -1 && !defined[b][var]){
+				defined[b][var] = true;
+				definitions[var].push_back(b);
+			}
+		}
+	}
+
+	// Liveness at the entry of each block, visiting the blocks in postorder
+	// until reaching a fix-point.
+	std::vector<std::vector<bool> > live_in = upward_exposed;
+	const std::vector<unsigned int>& rpo = cfg.get_reverse_postorder();
+	bool changed = true;
+
+	while(changed){
+		changed = false;
+
+		for(std::vector<unsigned int>::const_reverse_iterator it = rpo.rbegin();
+		it != rpo.rend(); ++it){
+			const std::vector<unsigned int>& successors =
+											cfg.get_block(*it).successors;
+
+			for(unsigned int var = 0; var < variables; var++){
+				if(live_in[*it][var] || defined[*it][var]){
+					continue;
+				}
+
+				for(std::vector<unsigned int>::const_iterator s =
+				successors.begin(); s != successors.end(); ++s){
+					if(live_in[*s][var]){
+						live_in[*it][var] = true;
+						changed = true;
+						break;
+					}
+				}
+			}
+		}
+	}
+
+	std::vector<std::vector<quad_pointer> > ret(cfg.size());
+	std::vector<int> has_phi(cfg.size(), -1);
+	std::vector<int> visited(cfg.size(), -1);
+
+	for(unsigned int var = 0; var < variables; var++){
+		std::vector<unsigned int> worklist = definitions[var];
+
+		for(std::vector<unsigned int>::iterator it = worklist.begin();
+		it != worklist.end(); ++it){
+			visited[*it] = var;
+		}
+
+		while(!worklist.empty()){
+			unsigned int block = worklist.back();
+			worklist.pop_back();
+			const std::vector<unsigned int>& frontier =
+												cfg.get_block(block).frontier;
+
+			for(std::vector<unsigned int>::const_iterator f = frontier.begin();
+			f != frontier.end(); ++f){
+				if(has_phi[*f] == (int)var){
+					continue;
+				}
+				has_phi[*f] = var;
+
+				if(live_in[*f][var]){
+					address_pointer name = new_name_address(vars.names[var]);
+					ret[*f].push_back(new_phi_inst(name, name));
+				}
+
+				// The PHI is a new definition of the variable.
+				if(visited[*f] != (int)var){
+					visited[*f] = var;
+					worklist.push_back(*f);
+				}
+			}
+		}
+	}
+
+	return ret;
+}
+
+/* Renames every definition of the variables with a new version, and every use
+ * with the version that reaches it, walking the dominator tree in preorder
+ * ([1]). Fills the arguments of the PHIs. Returns the number of versions
+ * created. */
+unsigned int rename_variables(const control_flow_graph& cfg,
+							const ssa_variables& vars,
+							std::vector<std::vector<quad_pointer> >& phis,
+							ids_info& ids){
+	const instructions_list& method = cfg.get_method();
+	std::unordered_set<std::string> used;
+	std::vector<unsigned int> counters(vars.names.size(), 0);
+	// Versions that reach the actual block. At the entry of the method, the
+	// variable itself.
+	std::vector<std::vector<address_pointer> > reaching(vars.names.size());
+	// Variables whose version has been pushed into reaching, to undo the
+	// pushes when leaving a block.
+	std::vector<unsigned int> pushed;
+	unsigned int versions = 0;
+
+	for(instructions_list::const_iterator it = method.begin();
+	it != method.end(); ++it){
+		std::vector<address_pointer*> uses = get_inst_uses(*it);
+		address_pointer definition = get_inst_definition(*it);
+
+		for(std::vector<address_pointer*>::iterator u = uses.begin();
+		u != uses.end(); ++u){
+			if(is_name_operand(**u)){
+				used.insert(get_address_name(**u));
+			}
+		}
+		if(is_name_operand(definition)){
+			used.insert(get_address_name(definition));
+		}
+	}
+
+	for(unsigned int var = 0; var < vars.names.size(); var++){
+		reaching[var].push_back(new_name_address(vars.names[var]));
+	}
+
+	if(cfg.size() == 0){
+		return versions;
+	}
+
+	// Block, next child to visit and size of pushed when entering the block.
+	struct frame {
+		unsigned int block;
+		unsigned int next;
+		unsigned int pushed;
+	};
+	std::vector<frame> stack;
+	stack.push_back({0, 0, 0});
+
+	while(!stack.empty()){
+		frame& actual = stack.back();
+		const basic_block& block = cfg.get_block(actual.block);
+
+		if(actual.next == 0){
+			// First visit to the block.
+			for(std::vector<quad_pointer>::iterator it = phis[actual.block].begin();
+			it != phis[actual.block].end(); ++it){
+				int var = get_ssa_variable(vars, get_phi_inst_variable(*it));
+
+				(*it)->result = new_ssa_version(vars.names[var], counters[var],
+												used, ids);
+				versions++;
+				reaching[var].push_back((*it)->result);
+				pushed.push_back(var);
+			}
+
+			for(unsigned int i = block.first; i < block.last; i++){
+				const quad_pointer& instruction = method[i];
+				std::vector<address_pointer*> uses = get_inst_uses(instruction);
+
+				for(std::vector<address_pointer*>::iterator u = uses.begin();
+				u != uses.end(); ++u){
+					int var = get_ssa_variable(vars, **u);
+
+					if(var != -1){
+						**u = reaching[var].back();
+					}
+				}
+
+				int var = get_ssa_variable(vars,
+										get_inst_definition(instruction));
+				if(var != -1){
+					instruction->result = new_ssa_version(vars.names[var],
+														counters[var],
+														used, ids);
+					versions++;
+					reaching[var].push_back(instruction->result);
+					pushed.push_back(var);
+				}
+			}
+
+			// Arguments of the PHIs of the successors.
+			address_pointer label = method[block.first]->arg1;
+			for(std::vector<unsigned int>::const_iterator s =
+			block.successors.begin(); s != block.successors.end(); ++s){
+				for(std::vector<quad_pointer>::iterator it = phis[*s].begin();
+				it != phis[*s].end(); ++it){
+					int var = get_ssa_variable(vars, get_phi_inst_variable(*it));
+
+					add_phi_argument(*it, reaching[var].back(), label);
+				}
+			}
+		}
+
+		if(actual.next < block.dominated.size()){
+			unsigned int child = block.dominated[actual.next];
+			actual.next++;
+			// actual could be invalidated by push_back.
+			stack.push_back({child, 0, (unsigned int)pushed.size()});
+		}
+		else{
+			// {every child of the block has been visited}
+			while(pushed.size() > actual.pushed){
+				reaching[pushed.back()].pop_back();
+				pushed.pop_back();
+			}
+			stack.pop_back();
+		}
+	}
+
+	return versions;
+}
+
+void build_ssa(instructions_list& method, ids_info& ids){
+	remove_unreachable_blocks(method);
+	label_every_block(method, ids);
+
+	// Renaming modifies the quads, which could be shared with other lists.
+	for(instructions_list::iterator it = method.begin(); it != method.end();
+	++it){
+		*it = copy_instruction(*it);
+	}
+
+	control_flow_graph cfg(method);
+	ssa_variables vars = find_ssa_variables(method);
+	std::vector<std::vector<quad_pointer> > phis = place_phis(cfg, vars);
+	unsigned int versions = rename_variables(cfg, vars, phis, ids);
+
+	// PHIs go right after the label of their block.
+	instructions_list ssa;
+	for(unsigned int b = 0; b < cfg.size(); b++){
+		const basic_block& block = cfg.get_block(b);
+
+		ssa.push_back(method[block.first]);
+		ssa.insert(ssa.end(), phis[b].begin(), phis[b].end());
+		ssa.insert(ssa.end(), method.begin() + block.first + 1,
+					method.begin() + block.last);
+	}
+
+	method = ssa;
+	// Every scalar type has the same width.
+	add_enter_bytes(method, versions*INTEGER_WIDTH);
+}
+
+
+/////////////////////////
+// @DESTRUCTION
+/////////////////////////
+instructions_list sequentialize_parallel_copy(
+								const std::vector<address_pointer>& dests,
+								const std::vector<address_pointer>& srcs,
+								ids_info& ids,
+								unsigned int& temps){
+	// PRE
+	#ifdef __DEBUG
+		assert(dests.size() == srcs.size());
+	#endif
+
+	instructions_list ret;
+	std::vector<address_pointer> pending_dests;
+	std::vector<address_pointer> pending_srcs;
+	// Number of pending copies that read each name.
+	std::unordered_map<std::string, unsigned int> readers;
+
+	for(unsigned int i = 0; i < dests.size(); i++){
+		if(!are_equal_address_pointers(dests[i], srcs[i])){
+			pending_dests.push_back(dests[i]);
+			pending_srcs.push_back(srcs[i]);
+			if(is_name_operand(srcs[i])){
+				readers[get_address_name(srcs[i])]++;
+			}
+		}
+	}
+
+	while(!pending_dests.empty()){
+		bool emitted = false;
+
+		// A copy can be done once no pending copy reads its destination.
+		unsigned int i = 0;
+		while(i < pending_dests.size()){
+			std::unordered_map<std::string, unsigned int>::iterator r =
+							readers.find(get_address_name(pending_dests[i]));
+
+			if(r == readers.end() || r->second == 0){
+				ret.push_back(new_copy(pending_dests[i], pending_srcs[i]));
+				if(is_name_operand(pending_srcs[i])){
+					readers[get_address_name(pending_srcs[i])]--;
+				}
+				pending_dests.erase(pending_dests.begin() + i);
+				pending_srcs.erase(pending_srcs.begin() + i);
+				emitted = true;
+			}
+			else{
+				// {some pending copy reads pending_dests[i]}
+				i++;
+			}
+		}
+
+		if(!emitted && !pending_dests.empty()){
+			// The pending copies form cycles: save the value of a destination
+			// into a temporary, and read it from there.
+			std::string dest = get_address_name(pending_dests[0]);
+			address_pointer temp = new_name_address(
+										*ids.new_temp(0, T_UNDEFINED));
+			temps++;
+			ret.push_back(new_copy(temp, pending_dests[0]));
+
+			for(std::vector<address_pointer>::iterator it =
+			pending_srcs.begin(); it != pending_srcs.end(); ++it){
+				if(is_name_operand(*it) && get_address_name(*it) == dest){
+					*it = temp;
+				}
+			}
+			readers[dest] = 0;
+		}
+	}
+
+	return ret;
+}
+
+/* Returns the copies that replace the PHIs of block, at the end of its
+ * predecessor pred. */
+instructions_list get_phi_copies(const control_flow_graph& cfg,
+								unsigned int pred,
+								unsigned int block,
+								ids_info& ids,
+								unsigned int& temps){
+	const instructions_list& method = cfg.get_method();
+	const quad_pointer& pred_label = method[cfg.get_block(pred).first];
+	std::vector<address_pointer> dests;
+	std::vector<address_pointer> srcs;
+
+	for(unsigned int i = cfg.get_block(block).first;
+	i < cfg.get_block(block).last; i++){
+		if(get_inst_type(method[i]) == quad_type::PHI){
+			#ifdef __DEBUG
+				assert(get_inst_type(pred_label) == quad_type::LABEL);
+			#endif
+			address_pointer value = get_phi_argument(method[i],
+										get_label_inst_label(pred_label));
+			#ifdef __DEBUG
+				assert(value != nullptr);
+			#endif
+
+			dests.push_back(get_phi_inst_dest(method[i]));
+			srcs.push_back(value);
+		}
+	}
+
+	return sequentialize_parallel_copy(dests, srcs, ids, temps);
+}
+
+bool has_phis(const control_flow_graph& cfg, unsigned int block){
+	const basic_block& b = cfg.get_block(block);
+
+	// PHIs are right after the label of the block.
+	return b.first + 1 < b.last &&
+		   get_inst_type(cfg.get_method()[b.first + 1]) == quad_type::PHI;
+}
+
+/* Returns the index of the block that follows block, if control can fall
+ * through into it, or -1. */
+int get_fall_through(const control_flow_graph& cfg, unsigned int block){
+	const quad_type type = get_inst_type(
+						cfg.get_method()[cfg.get_block(block).last - 1]);
+
+	return block + 1 < cfg.size() &&
+		   type != quad_type::UNCONDITIONAL_JUMP &&
+		   type != quad_type::RETURN ? (int)block + 1 : -1;
+}
+
+void destroy_ssa(instructions_list& method, ids_info& ids){
+	control_flow_graph cfg(method);
+	instructions_list code;
+	// Blocks that split critical edges, waiting for a place where control
+	// doesn't fall through.
+	instructions_list pending;
+	unsigned int temps = 0;
+
+	for(unsigned int b = 0; b < cfg.size(); b++){
+		const basic_block& block = cfg.get_block(b);
+		const quad_pointer& last = method[block.last - 1];
+		quad_type last_type = get_inst_type(last);
+		bool ends_with_jump = ends_block(last) && last_type != quad_type::RETURN;
+		int fall_through = get_fall_through(cfg, b);
+
+		for(unsigned int i = block.first;
+		i < (ends_with_jump ? block.last - 1 : block.last); i++){
+			if(get_inst_type(method[i]) != quad_type::PHI){
+				code.push_back(method[i]);
+			}
+		}
+
+		if(last_type == quad_type::UNCONDITIONAL_JUMP){
+			int target = cfg.get_label_block(get_unconditional_jmp_label(last));
+
+			if(target != UNDEFINED_BLOCK && has_phis(cfg, target)){
+				instructions_list copies = get_phi_copies(cfg, b, target, ids,
+															temps);
+				code.insert(code.end(), copies.begin(), copies.end());
+			}
+			code.push_back(last);
+		}
+		else if(ends_with_jump){
+			// {last is a conditional or relational jump}
+			std::string label = last_type == quad_type::CONDITIONAL_JUMP ?
+								get_conditional_jmp_label(last) :
+								get_relational_jmp_label(last);
+			int target = cfg.get_label_block(label);
+
+			if(target != UNDEFINED_BLOCK && has_phis(cfg, target)){
+				// Critical edge: jump to a new block with the copies.
+				address_pointer split = new_label_address(
+											*ids.new_temp(0, T_UNDEFINED));
+				quad_pointer jump = copy_instruction(last);
+
+				if(last_type == quad_type::CONDITIONAL_JUMP){
+					jump->arg2 = split;
+				}
+				else{
+					// {last_type == quad_type::RELATIONAL_JUMP}
+					jump->result = split;
+				}
+				code.push_back(jump);
+
+				instructions_list copies = get_phi_copies(cfg, b, target, ids,
+															temps);
+				pending.push_back(new_label_inst(split));
+				pending.insert(pending.end(), copies.begin(), copies.end());
+				pending.push_back(new_unconditional_jump_inst(
+											new_label_address(label)));
+			}
+			else{
+				code.push_back(last);
+			}
+		}
+
+		// The copies for the fall-through edge are placed right after the
+		// block (even after a conditional jump, where they form a new block
+		// reached only from this one).
+		if(fall_through != -1 && has_phis(cfg, fall_through)){
+			instructions_list copies = get_phi_copies(cfg, b, fall_through, ids,
+														temps);
+			code.insert(code.end(), copies.begin(), copies.end());
+		}
+
+		if(!pending.empty() && fall_through == -1){
+			code.insert(code.end(), pending.begin(), pending.end());
+			pending.clear();
+		}
+	}
+	code.insert(code.end(), pending.begin(), pending.end());
+
+	method = code;
+	remove_unreferenced_labels(method);
+	// Every scalar type has the same width.
+	add_enter_bytes(method, temps*INTEGER_WIDTH);
+}
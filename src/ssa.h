@@ -0,0 +1,82 @@
+#ifndef SSA_H_
+#define SSA_H_
+
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include "three_address_code.h"
+#include "control_flow_graph.h"
+#include "intermediate_symtable.h"
+
+/* Bibliography adopted:
+ * [1] "Efficiently Computing Static Single Assignment Form and the Control
+ * 		Dependence Graph", Ron Cytron, Jeanne Ferrante, Barry K. Rosen, Mark
+ * 		N. Wegman and F. Kenneth Zadeck. ACM TOPLAS, 1991.
+ *
+ * [2] "Revisiting Out-of-SSA Translation for Correctness, Code Quality, and
+ * 		Efficiency", Benoit Boissinot, Alain Darte, Fabrice Rastello, Benoît
+ * 		Dupont de Dinechin and Christophe Guillon. CGO, 2009.
+ * */
+
+/* Static single assignment form of the code of a method.
+ *
+ * Into SSA form, each variable renamed has exactly one definition. Renamed
+ * variables are the scalar ones: names whose address is never taken, that
+ * are not the base of an indexed copy, and that are not attributes of an
+ * object (names that contain a '.'), since those can be accessed through a
+ * pointer. The value of a variable at the entry of the method (e.g.: a
+ * parameter) keeps the original name; every other definition of x defines a
+ * new version x@1, x@2, etc. (the first suffix not used by the method).
+ * Versions are registered into ids_info, and the ENTER_PROCEDURE of the
+ * method is updated to reserve space for them.
+ *
+ * PHIs are placed at the iterated dominance frontier of the definitions of
+ * each variable, only where the variable is live ("pruned" SSA, [1]). They
+ * are put right after the label that begins their block. Every block of a
+ * method into SSA form begins with a label (the label of the method, for the
+ * entry block), that identifies the block into the arguments of the PHIs.
+ * Unreachable blocks are removed when building the SSA form. */
+
+// Converts method into SSA form.
+// PRE : {method is the code of a single method, out of SSA form}
+void build_ssa(instructions_list& method, ids_info& ids);
+
+/* Converts method out of SSA form: each PHI is replaced by copies at the end
+ * of its predecessors, which are parallel copies sequentialized as in [2],
+ * using a new temporary to break each cycle. Edges from a block with two
+ * successors, into a block with PHIs, are split. Labels not referenced by any
+ * jump, are removed. Versions that survive are kept as ordinary variables.
+ * PRE : {method is the code of a single method, into SSA form} */
+void destroy_ssa(instructions_list& method, ids_info& ids);
+
+/* Returns the names defined by method that are renamed into SSA form: their
+ * value can only be read or changed by the quads that name them. */
+std::unordered_set<std::string> get_scalar_variables(
+											const instructions_list& method);
+
+/* Returns the names of method that have a single definition, and whose value
+ * can only change through it (they are not accessed through pointers, as
+ * described above). Into SSA form, these are the values that passes can
+ * propagate and replace freely. */
+std::unordered_set<std::string> get_ssa_values(const instructions_list& method);
+
+/* Returns the names that method uses but never defines, and whose value can't
+ * change through pointers (e.g.: parameters). Their value is the one at the
+ * entry of the method, all along it. */
+std::unordered_set<std::string> get_entry_values(
+											const instructions_list& method);
+
+/* Returns the copies that perform the parallel assignment
+ * dests[0], ..., dests[n-1] := srcs[0], ..., srcs[n-1], one after the other.
+ * New temporaries, if needed, are created through ids, and counted into temps.
+ * PRE : {dests.size() == srcs.size() and every dest is a different name} */
+instructions_list sequentialize_parallel_copy(
+								const std::vector<address_pointer>& dests,
+								const std::vector<address_pointer>& srcs,
+								ids_info& ids,
+								unsigned int& temps);
+
+// Adds bytes to the space reserved by the ENTER_PROCEDURE of method, if any.
+void add_enter_bytes(instructions_list& method, unsigned int bytes);
+
+#endif // SSA_H_
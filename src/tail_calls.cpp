@@ -0,0 +1,137 @@
+#include "tail_calls.h"
+#include "control_flow_graph.h"
+#include "ssa.h"
+#include "constants.h"
+
+/* Can the self call at position call of method, whose parameters are at
+ * positions, be replaced by a jump? */
+bool is_replaceable_self_call(const instructions_list& method,
+							unsigned int call,
+							const std::vector<unsigned int>& positions,
+							const t_params& params,
+							ids_info& ids){
+	if(positions.size() != params.size()){
+		return false;
+	}
+
+	t_params::const_iterator param = params.begin();
+
+	for(unsigned int k = 0; k < positions.size(); k++, ++param){
+		address_pointer argument = get_param_inst_param(method[positions[k]]);
+		bool is_same = get_address_type(argument) ==
+						address_type::ADDRESS_NAME &&
+						get_address_name(argument) == *param;
+
+		// {k == 0 => *param is "this"}
+		if((k == 0 || (ids.id_exists(*param) &&
+		ids.get_kind(*param) == K_OBJECT)) && !is_same){
+			return false;
+		}
+
+		// The argument must still have the value it had when it was passed.
+		if(get_address_type(argument) == address_type::ADDRESS_NAME){
+			for(unsigned int i = positions[k] + 1; i < call; i++){
+				address_pointer definition = get_inst_definition(method[i]);
+
+				if(definition != nullptr &&
+				are_equal_address_pointers(definition, argument)){
+					return false;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+unsigned int eliminate_tail_recursion(instructions_list& method, ids_info& ids){
+	if(method.empty() || !is_method_label_inst(method[0])){
+		return 0;
+	}
+
+	std::string method_label = get_label_inst_label(method[0]);
+	std::string method_id = get_label_inst_method_name(method[0]) + "::" +
+							get_label_inst_class_name(method[0]);
+
+	if(!ids.id_exists(method_id)){
+		return 0;
+	}
+
+	const t_params& params = ids.get_list_params(method_id);
+	address_pointer entry = nullptr;
+	unsigned int temps = 0;
+	unsigned int ret = 0;
+	unsigned int i = 0;
+	std::unordered_map<std::string, unsigned int> labels =
+											get_label_positions(method, 0);
+
+	while(i < method.size()){
+		std::vector<unsigned int> positions;
+
+		if((get_inst_type(method[i]) != quad_type::PROCEDURE_CALL &&
+		get_inst_type(method[i]) != quad_type::FUNCTION_CALL) ||
+		get_procedure_or_function_call_label(method[i]) != method_label ||
+		!is_tail_call(method, i, labels) ||
+		!find_call_parameters(method, i, positions) ||
+		!is_replaceable_self_call(method, i, positions, params, ids)){
+			i++;
+			continue;
+		}
+
+		if(entry == nullptr){
+			entry = new_label_address(*ids.new_temp(0, T_UNDEFINED));
+		}
+
+		// Parallel assignment of the parameters, "this" excepted.
+		std::vector<address_pointer> dests;
+		std::vector<address_pointer> srcs;
+		t_params::const_iterator param = ++params.begin();
+
+		for(unsigned int k = 1; k < positions.size(); k++, ++param){
+			dests.push_back(new_name_address(*param));
+			srcs.push_back(get_param_inst_param(method[positions[k]]));
+		}
+
+		instructions_list copies = sequentialize_parallel_copy(dests, srcs,
+																ids, temps);
+		instructions_list replaced;
+		unsigned int k = 0;
+		unsigned int next = 0;
+
+		for(unsigned int j = 0; j < method.size(); j++){
+			if(k < positions.size() && j == positions[k]){
+				k++;
+			}
+			else if(j == i){
+				replaced.insert(replaced.end(), copies.begin(), copies.end());
+				replaced.push_back(new_unconditional_jump_inst(entry));
+				next = replaced.size();
+			}
+			else{
+				replaced.push_back(method[j]);
+			}
+		}
+
+		method = replaced;
+		labels = get_label_positions(method, 0);
+		i = next;
+		ret++;
+	}
+
+	if(ret > 0){
+		// {entry != nullptr}
+		// Just after the label of the method, and its ENTER_PROCEDURE.
+		unsigned int position = 1;
+
+		if(method.size() > 1 &&
+		get_inst_type(method[1]) == quad_type::ENTER_PROCEDURE){
+			position = 2;
+		}
+		method.insert(method.begin() + position, new_label_inst(entry));
+		remove_unreachable_blocks(method);
+		// Every scalar type has the same width.
+		add_enter_bytes(method, temps*INTEGER_WIDTH);
+	}
+
+	return ret;
+}
@@ -0,0 +1,24 @@
+#ifndef TAIL_CALLS_H_
+#define TAIL_CALLS_H_
+
+#include "three_address_code.h"
+#include "intermediate_symtable.h"
+
+/* Replaces the calls that method makes to itself, in tail position (see
+ * is_tail_call), by a loop: the parameters of the method are assigned the
+ * arguments of the call, as a parallel assignment, and a jump goes back to a
+ * new label, placed just after the ENTER_PROCEDURE of the method.
+ *
+ * Only calls over the same "this", that give every parameter that is an
+ * object the same object it already has, are replaced (objects' references
+ * can't be modified). Other tail calls are left to the code generator, that
+ * can reuse the frame of the caller for them.
+ *
+ * Blocks left unreachable are removed, and the ENTER_PROCEDURE of the method
+ * reserves space for the temporaries that the assignment may need.
+ *
+ * Returns the number of calls replaced.
+ * PRE : {method is the code of a single method, out of SSA form} */
+unsigned int eliminate_tail_recursion(instructions_list& method, ids_info& ids);
+
+#endif // TAIL_CALLS_H_
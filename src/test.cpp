@@ -15,6 +15,26 @@
 #include "./tests/test_asm_instruction.h"
 #include "./tests/test_ir_parser.h"
 #include "./tests/test_asm_parser.h"
+#include "./tests/test_control_flow_graph.h"
+#include "./tests/test_ssa.h"
+#include "./tests/test_constant_propagation.h"
+#include "./tests/test_dead_code_elimination.h"
+#include "./tests/test_value_numbering.h"
+#include "./tests/test_copy_propagation.h"
+#include "./tests/test_loop_invariant_code_motion.h"
+#include "./tests/test_induction_variables.h"
+#include "./tests/test_inlining.h"
+#include "./tests/test_tail_calls.h"
+#include "./tests/test_pass_manager.h"
+#include "./tests/test_interpreter.h"
+#include "./tests/test_profile.h"
+#include "./tests/test_register_allocation.h"
+#include "./tests/test_integer_division.h"
+#include "./tests/test_integer_multiplication.h"
+#include "./tests/test_float_arithmetic.h"
+#include "./tests/test_instruction_selection.h"
+#include "./tests/test_peephole.h"
+#include "./tests/test_block_placement.h"
 
 extern program_pointer ast;
 typedef struct yy_buffer_state * YY_BUFFER_STATE;
@@ -1141,6 +1161,26 @@ int main(int argc, const char* argv[]) {
 	test_asm_instruction();
 	test_ir_parser();
 	test_asm_parser();
+	test_control_flow_graph();
+	test_ssa();
+	test_constant_propagation();
+	test_dead_code_elimination();
+	test_value_numbering();
+	test_copy_propagation();
+	test_loop_invariant_code_motion();
+	test_induction_variables();
+	test_inlining();
+	test_tail_calls();
+	test_pass_manager();
+	test_interpreter();
+	test_profile();
+	test_register_allocation();
+	test_integer_division();
+	test_integer_multiplication();
+	test_float_arithmetic();
+	test_instruction_selection();
+	test_peephole();
+	test_block_placement();
 
 	test_semantics_of_test_cases();
 
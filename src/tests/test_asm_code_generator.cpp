@@ -33,11 +33,13 @@ void set_symbol_table(){
 	std::string method("method");
 	std::string param("param1");
 	s_table->register_class(std::string("class"), t_attributes());
-	s_table->register_method(method, 0, std::string("class"));
+	std::string method_key = s_table->register_method(method,
+														0,
+														std::string("class"));
 
 	// "method" has an integer parameter.
-	s_table->get_list_params(method).push_back(param);
-	s_table->register_var(param, -4, T_INT, true);
+	s_table->get_list_params(method_key).push_back(
+						s_table->register_var(param, -4, T_INT, true));
 
 	// Register information about an instance "obj".
 	s_table->register_obj(std::string("obj"),
@@ -49,6 +51,28 @@ void set_symbol_table(){
 	s_table->register_var(std::string("obj.att1"), 0, id_type::T_INT, false);
 }
 
+/* Do the instructions that follow the label of the method set up a frame of
+ * frame_size bytes? They are removed, so the rest of translation can be
+ * compared with code parsed (that has no 64-bit movq nor subq). */
+bool is_frame_prologue(asm_instructions_list& translation,
+						int frame_size){
+	operand_pointer rbp = new_register_operand(register_id::RBP);
+	operand_pointer rsp = new_register_operand(register_id::RSP);
+	bool ret = translation.size() >= 4 &&
+			is_pushq_instruction(translation[1], rbp, data_type::Q) &&
+			is_mov_instruction(translation[2], rsp, rbp, data_type::Q) &&
+			is_sub_instruction(translation[3],
+								new_immediate_integer_operand(frame_size),
+								rsp,
+								data_type::Q);
+
+	if(ret){
+		translation.erase(translation.begin() + 1, translation.begin() + 4);
+	}
+
+	return ret;
+}
+
 void test_binary_assign(){
 	std::cout << "1) Translation of binary assign: ";
 
@@ -58,7 +82,7 @@ void test_binary_assign(){
 
 	// x = 2 + 1
 	translate_ir_code(std::string("class.method:"
-									"x = 2 + 1"));
+									"x@0 = 2 + 1"));
 
 	asm_code_generator g(ir_code, s_table);
 	g.translate_ir();
@@ -80,7 +104,7 @@ void test_binary_assign(){
 	////////////////////////
 	// x = y - z
 	translate_ir_code(std::string("class.method:"
-									"x = 2 - 1"));
+									"x@0 = 2 - 1"));
 
 	g = asm_code_generator(ir_code, s_table);
 	g.translate_ir();
@@ -101,17 +125,16 @@ void test_binary_assign(){
 	////////////////////////
 	// x = y * z
 	translate_ir_code(std::string("class.method:"
-									"x = 2 * 1"));
+									"x@0 = 2 * 1"));
 
 	g = asm_code_generator(ir_code, s_table);
 	g.translate_ir();
 
 	translation = g.get_translation();
 
+	// Multiplications by constants are computed at compile time.
 	asm_program_text = "class.method:"
-						"movl $2, %r8d\n"
-						"imull $1, %r8d\n"
-						"movl %r8d, -4(%rbp)";
+						"movl $2, -4(%rbp)\n";
 
 	translate_asm_code(asm_program_text);
 
@@ -122,22 +145,16 @@ void test_binary_assign(){
 	////////////////////////
 	// x = y / z
 	translate_ir_code(std::string("class.method:"
-									"x = 2 / 1"));
+									"x@0 = 2 / 1"));
 
 	g = asm_code_generator(ir_code, s_table);
 	g.translate_ir();
 
 	translation = g.get_translation();
 
+	// Divisions by constants are computed at compile time.
 	asm_program_text = 	"class.method:"
-						"movl %edx, %r8d\n"
-						"movl %eax, %r9d\n"
-						"movl $2, %eax\n"
-						"movl $0, %edx\n"
-						"idivl $1\n"
-						"movl %eax, -4(%rbp)\n"
-						"movl %r8d, %edx\n"
-						"movl %r9d, %eax\n";
+						"movl $2, -4(%rbp)\n";
 
 	translate_asm_code(asm_program_text);
 
@@ -148,7 +165,7 @@ void test_binary_assign(){
 	////////////////////////
 	// x = y % z
 	translate_ir_code(std::string("class.method:"
-									"x = 2 % 1"));
+									"x@0 = 2 % 1"));
 
 	g = asm_code_generator(ir_code, s_table);
 	g.translate_ir();
@@ -156,14 +173,30 @@ void test_binary_assign(){
 	translation = g.get_translation();
 
 	asm_program_text = 	"class.method:"
-						"movl %edx, %r8d\n"
-						"movl %eax, %r9d\n"
-						"movl $2, %eax\n"
-						"movl $0, %edx\n"
-						"idivl $1\n"
-						"movl %edx, -4(%rbp)\n"
-						"movl %r8d, %edx\n"
-						"movl %r9d, %eax\n";
+						"movl $0, -4(%rbp)\n";
+
+	translate_asm_code(asm_program_text);
+
+	assert(are_equal_instructions_list(*translation, *asm_code));
+
+	////////////////////////
+	// LESS
+	////////////////////////
+	// x = y < z
+	translate_ir_code(std::string("class.method:"
+									"x@0 = 2 < 1"));
+
+	g = asm_code_generator(ir_code, s_table);
+	g.translate_ir();
+
+	translation = g.get_translation();
+
+	asm_program_text = 	"class.method:"
+						"movl $2, %r8d\n"
+						"cmpl $1, %r8d\n"
+						"setl %r8b\n"
+						"movzbl %r8b, %r8d\n"
+						"movl %r8d, -4(%rbp)";
 
 	translate_asm_code(asm_program_text);
 
@@ -181,7 +214,7 @@ void test_unary_assign(){
 
 	// x = - 1
 	translate_ir_code(std::string("class.method:"
-									"x = - 1"));
+									"x@0 = - 1"));
 
 	asm_code_generator g(ir_code, s_table);
 	g.translate_ir();
@@ -203,7 +236,7 @@ void test_unary_assign(){
 
 	// x = not y
 	translate_ir_code(std::string("class.method:"
-									"x = not true"));
+									"x@0 = not true"));
 
 	g = asm_code_generator(ir_code, s_table);
 	g.translate_ir();
@@ -212,7 +245,7 @@ void test_unary_assign(){
 
 	asm_program_text = "class.method:"
 						"movl $1, %r8d\n"
-						"notl %r8d\n"
+						"xorl $1, %r8d\n"
 						"movl %r8d, -4(%rbp)\n";
 
 	translate_asm_code(asm_program_text);
@@ -231,7 +264,7 @@ void test_copy(){
 
 	// x = y
 	translate_ir_code(std::string("class.method:"
-									"x = 1"));
+									"x@0 = 1"));
 	asm_code_generator g(ir_code, s_table);
 	g.translate_ir();
 
@@ -284,10 +317,9 @@ void test_jmp(){
 
 	translation = g.get_translation();
 
+	// Constant guards are decided at compile time.
 	asm_program_text = "class.method:"
-						"movl $1 , %r8d\n"
-						"cmpl $1 , %r8d\n"
-						"je L";
+						"jmp L";
 
 	translate_asm_code(asm_program_text);
 
@@ -304,10 +336,7 @@ void test_jmp(){
 
 	translation = g.get_translation();
 
-	asm_program_text = "class.method:"
-						"movl $1 , %r8d\n"
-						"cmpl $1 , %r8d\n"
-						"jne L";
+	asm_program_text = "class.method:";
 
 	translate_asm_code(asm_program_text);
 
@@ -446,7 +475,7 @@ void test_parameter_and_call(){
 								"param 6"
 								"param 7"
 								"param 8"
-								"y = call x,8"));
+								"y@0 = call x,8"));
 
 	g = asm_code_generator(ir_code, s_table);
 	g.translate_ir();
@@ -478,17 +507,25 @@ void test_enter(){
 
 	// enter x
 	translate_ir_code(std::string("class.method:\n"
-								"enter 4"));
+								"enter 4\n"
+								"param param1@0\n"
+								"call class.method, 1"));
 
 	asm_code_generator g(ir_code, s_table);
 	g.translate_ir();
 
 	asm_instructions_list *translation = g.get_translation();
 
-	// 0 levels of nesting.
+	// The frame holds param1, aligned to 16 bytes.
+	assert(is_frame_prologue(*translation, 16));
+
+	// The call, the last instruction of the method, becomes a jump.
 	std::string asm_program_text = "class.method:"
-									"enter $8, $0\n"
-									"movl %rdi, -4(%rbp)";
+									"movl %edi, -8(%rbp)\n"
+									"movl -8(%rbp), %rdi\n"
+									"movl $0, %rax\n"
+									"leave\n"
+									"jmp class.method";
 
 	translate_asm_code(asm_program_text);
 
@@ -509,9 +546,9 @@ void test_return(){
 
 	asm_instructions_list *translation = g.get_translation();
 
+	// Without enter, there is no frame to leave.
 	std::string asm_program_text = "class.method:"
 									"movl $1, %rax\n"
-									"leave\n"
 									"ret";
 
 	translate_asm_code(asm_program_text);
@@ -525,26 +562,31 @@ void test_objects_and_arrays(){
 	std::cout << "8) Translation of objects and arrays: ";
 
 	// Object creation.
-	// TODO: los offsets tendrían que ser negativos.
 	translate_ir_code(std::string("class.method:"
-									"obj[0] = 0\n"
-									"obj[4] = 0\n"
-									"obj = &obj.att1\n"
-									"param1 = obj[0]"));
+									"enter 8\n"
+									"obj@0[0] = 0\n"
+									"obj@0[4] = 0\n"
+									"obj@0 = &obj.att1@0\n"
+									"param1@0 = obj@0[0]"));
 
 	asm_code_generator g(ir_code, s_table);
 	g.translate_ir();
 
 	asm_instructions_list *translation = g.get_translation();
 
+	assert(is_frame_prologue(*translation, 32));
+
 	std::string asm_program_text = "class.method:\n"
-									"movl 8(%rbp) , %rdi\n"
+									"movl %edi, -8(%rbp)\n"
+									"movl -12(%rbp) , %rdi\n"
 									"movl $0 , 0(%rdi)\n"
-									"movl 8(%rbp) , %rdi\n"
+									"movl -12(%rbp) , %rdi\n"
 									"movl $0 , 4(%rdi)\n"
-									"leal 0(%rbp) , 8(%rbp)\n"
-									"movl 8(%rbp) , %rdi\n"
-									"movl 0(%rdi) , -4(%rbp)\n";
+									"leal -16(%rbp) , %r8d\n"
+									"movl %r8d , -12(%rbp)\n"
+									"movl -12(%rbp) , %rdi\n"
+									"movl 0(%rdi) , %r8d\n"
+									"movl %r8d , -8(%rbp)\n";
 
 	translate_asm_code(asm_program_text);
 
@@ -556,10 +598,10 @@ void test_objects_and_arrays(){
 void test_asm_code_generator(){
 	std::cout << "\nTesting assembly code generation:" << std::endl;
 	set_symbol_table();
-	/*test_binary_assign();
+	test_binary_assign();
 	test_unary_assign();
 	test_copy();
-	test_jmp();*/
+	test_jmp();
 	test_parameter_and_call();
 	test_enter();
 	test_return();
@@ -35,7 +35,31 @@ void test_print_intel_syntax(){
 	inst = new_neg_instruction(reg_rdi, data_type::L);
 	assert(print_intel_syntax(inst) == std::string("\tnegl %rdi\n"));
 
-	// TODO: sar y shr?
+	// sar, shr and shl
+	// sarl $1 , %rdi
+	inst = new_sar_instruction(imm_1, reg_rdi, data_type::L);
+	assert(print_intel_syntax(inst) == std::string("\tsarl $1 , %rdi\n"));
+	inst = new_shr_instruction(imm_1, reg_rdi, data_type::L);
+	assert(print_intel_syntax(inst) == std::string("\tshrl $1 , %rdi\n"));
+	inst = new_shl_instruction(imm_1, reg_rdi, data_type::L);
+	assert(print_intel_syntax(inst) == std::string("\tshll $1 , %rdi\n"));
+
+	// lea with scaled index
+	// leal 0(%r8, %r8, 4) , %r8d
+	inst = new_scaled_lea_instruction(register_id::R8, register_id::R8, 4,
+								new_register_operand(register_id::R8D),
+								data_type::L);
+	assert(print_intel_syntax(inst) ==
+			std::string("\tleal 0(%r8, %r8, 4) , %r8d\n"));
+
+	// and, cltd and the one-operand imul
+	inst = new_and_instruction(imm_1, reg_rdi, data_type::L);
+	assert(print_intel_syntax(inst) == std::string("\tandl $1 , %rdi\n"));
+	inst = new_xor_instruction(reg_rdi, reg_rdi, data_type::L);
+	assert(print_intel_syntax(inst) == std::string("\txorl %rdi , %rdi\n"));
+	assert(print_intel_syntax(new_cltd_instruction()) == std::string("\tcltd\n"));
+	inst = new_widening_mul_instruction(reg_rdi, data_type::L, true);
+	assert(print_intel_syntax(inst) == std::string("\timull %rdi\n"));
 
 	// not
 	// notq %rdi
@@ -47,6 +71,13 @@ void test_print_intel_syntax(){
 	inst = new_mov_instruction(mem_0, reg_rdi, data_type::W);
 	assert(print_intel_syntax(inst) == std::string("\tmovw 1(%rbp, 0, 1) , %rdi\n"));
 
+	// movslq
+	// movslq 1(%rbp, 0, 1) , %r9
+	inst = new_movslq_instruction(mem_0, new_register_operand(register_id::R9));
+	assert(print_intel_syntax(inst) == std::string("\tmovslq 1(%rbp, 0, 1) , %r9\n"));
+	assert(get_register64(register_id::R10D) == register_id::R10);
+	assert(get_register64(register_id::RBP) == register_id::NONE);
+
 	// jmp
 	// jmp .label
 	std::string label("label");
@@ -112,6 +112,23 @@ void test_data_transfer_inst_translation(){
 			new_register_operand(register_id::R10),
 			data_type::L));
 
+	// MOVSLQ
+	translate_asm_code(std::string("movslq %r10d, %r9"));
+
+	assert(asm_code->size() == 1);
+	assert(is_movslq_instruction((*asm_code)[0],
+			new_register_operand(register_id::R10D),
+			new_register_operand(register_id::R9)));
+
+	// XORL
+	translate_asm_code(std::string("xorl %r10d, %r10d"));
+
+	assert(asm_code->size() == 1);
+	assert(is_xor_instruction((*asm_code)[0],
+			new_register_operand(register_id::R10D),
+			new_register_operand(register_id::R10D),
+			data_type::L));
+
 	std::cout << "OK. " << std::endl;
 }
 
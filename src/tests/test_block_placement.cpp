@@ -0,0 +1,302 @@
+#include "test_block_placement.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+// Weight of the edge from source to target, or -1 if there is none.
+double get_layout_edge_weight(const std::vector<layout_edge>& edges,
+							unsigned int source,
+							unsigned int target){
+	for(std::vector<layout_edge>::const_iterator it = edges.begin();
+	it != edges.end(); ++it){
+		if(it->source == source and it->target == target){
+			return it->weight;
+		}
+	}
+
+	return -1;
+}
+
+// Does the edge from source to target weigh weight (up to rounding)?
+bool has_layout_edge_weight(const std::vector<layout_edge>& edges,
+							unsigned int source,
+							unsigned int target,
+							double weight){
+	return std::fabs(get_layout_edge_weight(edges, source, target) - weight) <
+		   1e-9;
+}
+
+void test_static_edge_weights(){
+	std::cout << "1) Edges weighted by static heuristics: ";
+
+	translate_ir_code(std::string("C.m:\n"
+								"enter 0\n"
+								"L1:\n"
+								"if i@0 >= 10 goto L2\n"
+								"if i@0 == 5 goto L3\n"
+								"i@0 = i@0 + 1\n"
+								"goto L1\n"
+								"L3:\n"
+								"return 1\n"
+								"L2:\n"
+								"return 0"));
+
+	instructions_list method = *ir_code;
+	control_flow_graph cfg(method);
+	std::vector<layout_edge> edges = estimate_edge_weights(cfg);
+
+	// Blocks: 0 (C.m), 1 (L1), 2 (i == 5), 3 (i + 1), 4 (L3), 5 (L2).
+	assert(cfg.size() == 6);
+	assert(has_layout_edge_weight(edges, 0, 1, 1));
+	// Exits of the loop.
+	assert(has_layout_edge_weight(edges, 1, 2, 10 * LOOP_BRANCH_PROBABILITY));
+	assert(has_layout_edge_weight(edges, 1, 5,
+								10 * (1 - LOOP_BRANCH_PROBABILITY)));
+	assert(has_layout_edge_weight(edges, 2, 3, 10 * LOOP_BRANCH_PROBABILITY));
+	// Back edge.
+	assert(has_layout_edge_weight(edges, 3, 1, 10));
+	assert(get_layout_edge_weight(edges, 4, 5) == -1);
+
+	// Out of loops, the successor that doesn't return is preferred.
+	translate_ir_code(std::string("C.m:\n"
+								"enter 0\n"
+								"if x@0 > 0 goto L1\n"
+								"return 0\n"
+								"L1:\n"
+								"x@0 = x@0 - 1\n"
+								"L2:\n"
+								"return x@0"));
+	method = *ir_code;
+	control_flow_graph branch(method);
+	edges = estimate_edge_weights(branch);
+	assert(has_layout_edge_weight(edges, 0, 2, RETURN_BRANCH_PROBABILITY));
+	assert(has_layout_edge_weight(edges, 0, 1,
+								1 - RETURN_BRANCH_PROBABILITY));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_loop_layout(){
+	std::cout << "2) Layout of loops: ";
+
+	ids_info ids;
+	// while(i < 10){ i = i + 1 } return i, with the test at the top.
+	translate_ir_code(std::string("C.m:\n"
+								"enter 0\n"
+								"L1:\n"
+								"if i@0 >= 10 goto L2\n"
+								"i@0 = i@0 + 1\n"
+								"goto L1\n"
+								"L2:\n"
+								"return i@0"));
+
+	instructions_list method = *ir_code;
+
+	// The body falls into the test, that jumps back while it holds.
+	assert(place_blocks(method, ids) == 6);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 0\n"
+			"goto L1\n"
+			"@t0:\n"
+			"i@0 = i@0 + 1\n"
+			"L1:\n"
+			"if i@0 < 10 goto @t0\n"
+			"L2:\n"
+			"return i@0\n");
+	// The layout is stable.
+	assert(place_blocks(method, ids) == 0);
+
+	// A loop already rotated (guarded and tested at the bottom) is kept.
+	translate_ir_code(std::string("C.m:\n"
+								"enter 0\n"
+								"if i@0 >= 10 goto L2\n"
+								"L1:\n"
+								"i@0 = i@0 + 1\n"
+								"if i@0 < 10 goto L1\n"
+								"L2:\n"
+								"return i@0"));
+	method = *ir_code;
+	assert(place_blocks(method, ids) == 0);
+	assert(print_instructions_list(method) ==
+			print_instructions_list(*ir_code));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_cold_blocks(){
+	std::cout << "3) Cold blocks out of the way: ";
+
+	ids_info ids;
+	// The successor that doesn't return falls through, inverting the jump,
+	// and a procedure that falls off its end keeps its last block.
+	translate_ir_code(std::string("C.m:\n"
+								"enter 0\n"
+								"ifFalse b@0 goto L1\n"
+								"return 0\n"
+								"L1:\n"
+								"x@0 = 1\n"
+								"goto L2\n"
+								"L3:\n"
+								"x@0 = 2\n"
+								"L2:\n"
+								"param x@0\n"
+								"call C.p , 1"));
+
+	instructions_list method = *ir_code;
+
+	assert(place_blocks(method, ids) == 4);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 0\n"
+			"ifTrue b@0 goto @t0\n"
+			"L1:\n"
+			"x@0 = 1\n"
+			"goto L2\n"
+			"@t0:\n"
+			"return 0\n"
+			"L3:\n"
+			"x@0 = 2\n"
+			"L2:\n"
+			"param x@0\n"
+			"call C.p, 1\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_profiled_layout(){
+	std::cout << "4) Layout guided by a profile: ";
+
+	ids_info ids;
+	const std::string program("C.m:\n"
+							"enter 0\n"
+							"if x@0 > 0 goto L1\n"
+							"x@0 = 0 - x@0\n"
+							"goto L2\n"
+							"L1:\n"
+							"x@0 = x@0 + 1\n"
+							"L2:\n"
+							"return x@0");
+	execution_profile profile;
+
+	translate_ir_code(program);
+	instructions_list method = *ir_code;
+	control_flow_graph cfg(method);
+
+	// x > 0 on 90 of 100 calls.
+	profile.blocks["C.m"]["C.m"] = 100;
+	profile.blocks["C.m"]["L1"] = 90;
+	profile.blocks["C.m"]["L2"] = 100;
+	std::vector<layout_edge> edges = get_profiled_edge_weights(cfg, profile,
+																"C.m");
+	assert(has_layout_edge_weight(edges, 0, 2, 90));
+	assert(has_layout_edge_weight(edges, 0, 1, 10));
+	assert(has_layout_edge_weight(edges, 1, 3, 10));
+	assert(has_layout_edge_weight(edges, 2, 3, 90));
+
+	// Without the profile, the order is kept.
+	assert(place_blocks(method, ids) == 0);
+
+	assert(place_blocks_with_profile(method, ids, profile) == 3);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 0\n"
+			"if x@0 <= 0 goto @t0\n"
+			"L1:\n"
+			"x@0 = x@0 + 1\n"
+			"L2:\n"
+			"return x@0\n"
+			"@t0:\n"
+			"x@0 = 0 - x@0\n"
+			"goto L2\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_block_placement_pass(){
+	std::cout << "5) Block placement into the pass manager: ";
+
+	ids_info ids;
+	translate_ir_code(std::string("C.m:\n"
+								"enter 0\n"
+								"L1:\n"
+								"if i@0 >= 10 goto L2\n"
+								"i@0 = i@0 + 1\n"
+								"goto L1\n"
+								"L2:\n"
+								"return i@0\n"
+								"C.n:\n"
+								"enter 0\n"
+								"return 0"));
+
+	instructions_list code = *ir_code;
+	pass_manager manager(0);
+
+	assert(manager.select_passes(std::string("block-placement")));
+	manager.set_verification(true);
+	manager.run_ir_passes(code, ids);
+	assert(manager.get_statistics().size() == 1);
+	assert(manager.get_statistics()[0].pass == "block-placement");
+	assert(manager.get_statistics()[0].changes == 6);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_placed_blocks_translation(){
+	std::cout << "6) Translation of placed blocks: ";
+
+	ids_info ids;
+	ids.register_class(std::string("C"), t_attributes());
+	ids.register_method(std::string("m"), 0, std::string("C"));
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("j"), 4, T_INT, false);
+	translate_ir_code(std::string("C.m:\n"
+								"enter 0\n"
+								"i@0 = 0\n"
+								"L1:\n"
+								"j@0 = i@0 + 1\n"
+								"if j@0 >= 10 goto L2\n"
+								"i@0 = j@0\n"
+								"goto L1\n"
+								"L2:\n"
+								"return j@0"));
+
+	instructions_list method = *ir_code;
+
+	// The body, that reads j, is placed before the test that writes it.
+	assert(place_blocks(method, ids) == 6);
+	assert(print_instructions_list(method).find("i@0 = j@0\n"
+												"L1:\n"
+												"j@0 = i@0 + 1\n") !=
+			std::string::npos);
+
+	asm_code_generator generator(&method, &ids);
+	generator.translate_ir();
+	asm_instructions_list& code = *generator.get_translation();
+	std::string text;
+
+	for(asm_instructions_list::iterator it = code.begin(); it != code.end();
+	++it){
+		text += print_intel_syntax(*it);
+	}
+
+	// j is read from the slot into the frame where it is written, not from
+	// the offset it had before the translation.
+	assert(text.find("\tmovl -12(%rbp, 0, 1) , -8(%rbp, 0, 1)\n") !=
+		   std::string::npos);
+	assert(text.find("\tmovl %r8d , -12(%rbp, 0, 1)\n") != std::string::npos);
+	assert(text.find("4(%rbp") == std::string::npos);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_block_placement(){
+	std::cout << "\nTesting block placement:" << std::endl;
+
+	test_static_edge_weights();
+	test_loop_layout();
+	test_cold_blocks();
+	test_profiled_layout();
+	test_block_placement_pass();
+	test_placed_blocks_translation();
+}
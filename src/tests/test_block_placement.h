@@ -0,0 +1,13 @@
+#ifndef TEST_BLOCK_PLACEMENT_H
+#define TEST_BLOCK_PLACEMENT_H
+
+#include <iostream>
+#include <cassert>
+#include <cmath>
+#include "../block_placement.h"
+#include "../pass_manager.h"
+#include "../asm_code_generator.h"
+
+void test_block_placement();
+
+#endif
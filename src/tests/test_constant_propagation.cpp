@@ -0,0 +1,170 @@
+#include "test_constant_propagation.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+void test_folding(){
+	std::cout << "1) Folding of operations: ";
+
+	assert(are_equal_address_pointers(
+			fold_binary_operation(quad_oper::PLUS, new_integer_constant(1),
+								new_integer_constant(2)),
+			new_integer_constant(3)));
+	// Integer arithmetic wraps around.
+	assert(are_equal_address_pointers(
+			fold_binary_operation(quad_oper::PLUS, new_integer_constant(INT_MAX),
+								new_integer_constant(1)),
+			new_integer_constant(INT_MIN)));
+	assert(are_equal_address_pointers(
+			fold_binary_operation(quad_oper::LESS, new_integer_constant(1),
+								new_integer_constant(2)),
+			new_boolean_constant(true)));
+	assert(are_equal_address_pointers(
+			fold_binary_operation(quad_oper::OR, new_boolean_constant(false),
+								new_boolean_constant(true)),
+			new_boolean_constant(true)));
+	assert(are_equal_address_pointers(
+			fold_binary_operation(quad_oper::TIMES, new_float_constant(1.5),
+								new_float_constant(2)),
+			new_float_constant(3)));
+	assert(are_equal_address_pointers(
+			fold_unary_operation(quad_oper::NEGATIVE, new_integer_constant(10)),
+			new_integer_constant(-10)));
+	assert(are_equal_address_pointers(
+			fold_unary_operation(quad_oper::NEGATION, new_boolean_constant(true)),
+			new_boolean_constant(false)));
+
+	// Operations that fail at run time, or that are not constant.
+	assert(fold_binary_operation(quad_oper::DIVIDE, new_integer_constant(1),
+								new_integer_constant(0)) == nullptr);
+	assert(fold_binary_operation(quad_oper::MOD, new_integer_constant(1),
+								new_integer_constant(0)) == nullptr);
+	assert(fold_binary_operation(quad_oper::DIVIDE,
+								new_integer_constant(INT_MIN),
+								new_integer_constant(-1)) == nullptr);
+	assert(fold_binary_operation(quad_oper::PLUS, new_integer_constant(1),
+								new_float_constant(2)) == nullptr);
+	assert(fold_binary_operation(quad_oper::PLUS, new_name_address("x"),
+								new_integer_constant(2)) == nullptr);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_fold_constants(){
+	std::cout << "2) Local constant folding: ";
+
+	translate_ir_code(std::string("C.m:\n"
+								"x = 1 + 2\n"
+								"y = - 10\n"
+								"z = x + 1\n"
+								"if 1 < 2 goto L1\n"
+								"ifFalse true goto L2\n"
+								"L1:\n"
+								"return z\n"
+								"L2:\n"
+								"return y"));
+
+	instructions_list code = *ir_code;
+
+	assert(fold_constants(code) == 4);
+	// z = x + 1 needs propagation.
+	assert(print_instructions_list(code) ==
+			"C.m:\n"
+			"x = 3\n"
+			"y = -10\n"
+			"z = x + 1\n"
+			"goto L1\n"
+			"L1:\n"
+			"return z\n"
+			"L2:\n"
+			"return y\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_sccp_loop(){
+	std::cout << "3) Propagation through PHIs: ";
+
+	// i = 1; while(n > 0){ j = i * 1; i = j; n = n - 1 } return i
+	ids_info ids;
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("j"), 4, T_INT, false);
+	ids.register_var(std::string("n"), 0, T_INT, true);
+	translate_ir_code(std::string("C.m:\n"
+								"enter 8\n"
+								"i@0 = 1\n"
+								"L1:\n"
+								"if n@0 <= 0 goto L2\n"
+								"j@0 = i@0 * 1\n"
+								"i@0 = j@0\n"
+								"n@0 = n@0 - 1\n"
+								"goto L1\n"
+								"L2:\n"
+								"return i@0"));
+
+	instructions_list method = *ir_code;
+	build_ssa(method, ids);
+	assert(propagate_constants(method) > 0);
+
+	// The PHI of i is removed: only the one of n remains.
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 32\n"
+			"i@0@1 = 1\n"
+			"L1:\n"
+			"n@0@1 = phi(C.m: n@0, @t0: n@0@2)\n"
+			"if n@0@1 <= 0 goto L2\n"
+			"@t0:\n"
+			"j@0@1 = 1\n"
+			"i@0@3 = 1\n"
+			"n@0@2 = n@0@1 - 1\n"
+			"goto L1\n"
+			"L2:\n"
+			"return 1\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_sccp_branches(){
+	std::cout << "4) Elimination of branches never taken: ";
+
+	ids_info ids;
+	ids.register_var(std::string("c"), 0, T_INT, false);
+	ids.register_var(std::string("x"), 4, T_INT, false);
+	translate_ir_code(std::string("C.m:\n"
+								"enter 8\n"
+								"c@0 = 3\n"
+								"if c@0 > 5 goto L1\n"
+								"x@0 = 1\n"
+								"goto L2\n"
+								"L1:\n"
+								"x@0 = 2\n"
+								"L2:\n"
+								"return x@0"));
+
+	instructions_list method = *ir_code;
+	build_ssa(method, ids);
+	propagate_constants(method);
+
+	// Only the edge from the fall-through flows into the PHI of x.
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 24\n"
+			"c@0@1 = 3\n"
+			"@t0:\n"
+			"x@0@1 = 1\n"
+			"goto L2\n"
+			"L2:\n"
+			"return 1\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_constant_propagation(){
+	std::cout << "\nTesting constant propagation:" << std::endl;
+
+	test_folding();
+	test_fold_constants();
+	test_sccp_loop();
+	test_sccp_branches();
+}
@@ -0,0 +1,12 @@
+#ifndef TEST_CONSTANT_PROPAGATION_H
+#define TEST_CONSTANT_PROPAGATION_H
+
+#include <iostream>
+#include <cassert>
+#include <climits>
+#include "../constant_propagation.h"
+#include "../ssa.h"
+
+void test_constant_propagation();
+
+#endif
@@ -0,0 +1,211 @@
+#include <chrono>
+#include "test_control_flow_graph.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+void test_basic_blocks(){
+	std::cout << "1) Basic blocks and edges: ";
+
+	// if x < y then z = 1 else z = 2; return z
+	translate_ir_code(std::string("C.m:\n"
+								"enter 4\n"
+								"if x < y goto L1\n"
+								"z = 2\n"
+								"goto L2\n"
+								"L1:\n"
+								"z = 1\n"
+								"L2:\n"
+								"return z\n"
+								"z = 3"));
+
+	control_flow_graph cfg(*ir_code);
+	assert(cfg.size() == 5);
+
+	// B0: C.m, enter, if.
+	assert(cfg.get_block(0).first == 0 && cfg.get_block(0).last == 3);
+	assert(cfg.get_block(0).successors.size() == 2);
+	// B1: z = 2; goto L2.
+	assert(cfg.get_block(1).successors.size() == 1);
+	assert(cfg.get_block(1).successors[0] == 3);
+	// B2: L1, z = 1 (falls through into L2).
+	assert(cfg.get_label_block(std::string("L1")) == 2);
+	assert(cfg.get_block(2).successors.size() == 1);
+	assert(cfg.get_block(2).successors[0] == 3);
+	// B3: L2, return z.
+	assert(cfg.get_block(3).predecessors.size() == 2);
+	assert(cfg.get_block(3).successors.empty());
+	// B4: unreachable.
+	assert(!cfg.is_reachable(4));
+	assert(cfg.get_block(4).predecessors.empty());
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_dominators(){
+	std::cout << "2) Dominator tree: ";
+
+	translate_ir_code(std::string("C.m:\n"
+								"if x < y goto L1\n"
+								"z = 2\n"
+								"goto L2\n"
+								"L1:\n"
+								"z = 1\n"
+								"L2:\n"
+								"return z"));
+
+	control_flow_graph cfg(*ir_code);
+	assert(cfg.size() == 4);
+	assert(cfg.get_block(0).idom == UNDEFINED_BLOCK);
+	assert(cfg.get_block(1).idom == 0);
+	assert(cfg.get_block(2).idom == 0);
+	// The join point is dominated by the entry, but not by the branches.
+	assert(cfg.get_block(3).idom == 0);
+	assert(cfg.dominates(0, 3));
+	assert(!cfg.dominates(1, 3));
+	assert(!cfg.dominates(2, 3));
+	assert(cfg.dominates(3, 3));
+	assert(cfg.get_block(0).dominated.size() == 3);
+	// Dominance frontiers.
+	assert(cfg.get_block(0).frontier.empty());
+	assert(cfg.get_block(1).frontier == std::vector<unsigned int>({3}));
+	assert(cfg.get_block(2).frontier == std::vector<unsigned int>({3}));
+	assert(cfg.get_block(3).frontier.empty());
+	assert(cfg.get_reverse_postorder().size() == 4);
+	assert(cfg.get_reverse_postorder()[0] == 0);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_natural_loops(){
+	std::cout << "3) Natural loops: ";
+
+	// while(i < n){ j = 0; while(j < n){ j = j + 1 } i = i + 1 }
+	translate_ir_code(std::string("C.m:\n"
+								"i = 0\n"
+								"L1:\n"
+								"if i >= n goto L2\n"
+								"j = 0\n"
+								"L3:\n"
+								"if j >= n goto L4\n"
+								"j = j + 1\n"
+								"goto L3\n"
+								"L4:\n"
+								"i = i + 1\n"
+								"goto L1\n"
+								"L2:\n"
+								"return"));
+
+	control_flow_graph cfg(*ir_code);
+	// B0: C.m, i = 0 | B1: L1, if | B2: j = 0 | B3: L3, if | B4: j = j + 1,
+	// goto | B5: L4, i = i + 1, goto | B6: L2, return
+	assert(cfg.size() == 7);
+
+	const std::vector<natural_loop>& loops = cfg.get_loops();
+	assert(loops.size() == 2);
+
+	const natural_loop& outer = loops[0];
+	assert(outer.header == 1);
+	assert(outer.latches.size() == 1 && outer.latches[0] == 5);
+	assert(outer.blocks == std::vector<unsigned int>({1, 2, 3, 4, 5}));
+	assert(outer.parent == -1);
+	assert(outer.depth == 1);
+
+	const natural_loop& inner = loops[1];
+	assert(inner.header == 3);
+	assert(inner.blocks == std::vector<unsigned int>({3, 4}));
+	assert(inner.parent == 0);
+	assert(inner.depth == 2);
+
+	assert(cfg.get_block(0).loop_depth == 0);
+	assert(cfg.get_block(2).loop_depth == 1);
+	assert(cfg.get_block(4).loop_depth == 2);
+	assert(cfg.get_block(4).loop == 1);
+	assert(cfg.get_block(6).loop == -1);
+	// The header of the inner loop is into its own frontier, and into the
+	// frontier of the outer loop's header.
+	assert(cfg.get_block(4).frontier == std::vector<unsigned int>({3}));
+	assert(cfg.get_block(3).frontier == std::vector<unsigned int>({3, 1}) ||
+			cfg.get_block(3).frontier == std::vector<unsigned int>({1, 3}));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_dot_output(){
+	std::cout << "4) DOT output: ";
+
+	translate_ir_code(std::string("C.m:\n"
+								"L1:\n"
+								"if i >= n goto L2\n"
+								"i = i + 1\n"
+								"goto L1\n"
+								"L2:\n"
+								"return i\n"
+								"C.n:\n"
+								"return"));
+
+	std::vector<instructions_list> methods = split_into_methods(*ir_code);
+	assert(methods.size() == 2);
+	assert(are_equal_instructions_list(*join_methods(methods), *ir_code));
+
+	std::string dot = print_cfg_dot(*ir_code);
+	assert(dot.find("digraph cfg {") == 0);
+	assert(dot.find("subgraph \"cluster_C.m\"") != std::string::npos);
+	assert(dot.find("subgraph \"cluster_C.n\"") != std::string::npos);
+	assert(dot.find("\"C.m.B1\" -> \"C.m.B3\";") != std::string::npos);
+	// Back edge.
+	assert(dot.find("\"C.m.B2\" -> \"C.m.B1\" [style=dashed];") !=
+			std::string::npos);
+	assert(dot.find("i = i + 1\\l") != std::string::npos);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_large_method(){
+	std::cout << "5) Large methods: ";
+
+	// A method with a long sequence of if-then-else, inside a loop.
+	const unsigned int conditionals = 50000;
+	instructions_list method;
+	address_pointer x = new_name_address(std::string("x"));
+	address_pointer loop = new_label_address(std::string("loop"));
+
+	method.push_back(new_label_inst(new_method_label_address(std::string("m"),
+															std::string("C"))));
+	method.push_back(new_label_inst(loop));
+	for(unsigned int i = 0; i < conditionals; i++){
+		address_pointer l_else = new_label_address("else" + std::to_string(i));
+		address_pointer l_end = new_label_address("end" + std::to_string(i));
+
+		method.push_back(new_conditional_jump_inst(x, l_else, quad_oper::IFFALSE));
+		method.push_back(new_copy(x, new_integer_constant(1)));
+		method.push_back(new_unconditional_jump_inst(l_end));
+		method.push_back(new_label_inst(l_else));
+		method.push_back(new_copy(x, new_integer_constant(0)));
+		method.push_back(new_label_inst(l_end));
+	}
+	method.push_back(new_conditional_jump_inst(x, loop, quad_oper::IFTRUE));
+	method.push_back(new_return_inst(nullptr));
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	control_flow_graph cfg(method);
+	std::chrono::duration<double, std::milli> time =
+									std::chrono::steady_clock::now() - start;
+
+	assert(cfg.size() == 2 + 3*conditionals + 1);
+	assert(cfg.get_loops().size() == 1);
+	assert(cfg.get_loops()[0].blocks.size() == 3*conditionals + 1);
+	assert(cfg.dominates(1, cfg.size() - 1));
+
+	std::cout << method.size() << " quads, " << time.count() << " ms. ";
+	std::cout << "OK. " << std::endl;
+}
+
+void test_control_flow_graph(){
+	std::cout << "\nTesting control-flow graph construction:" << std::endl;
+	test_basic_blocks();
+	test_dominators();
+	test_natural_loops();
+	test_dot_output();
+	test_large_method();
+}
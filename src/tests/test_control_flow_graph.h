@@ -0,0 +1,10 @@
+#ifndef TEST_CONTROL_FLOW_GRAPH_H
+#define TEST_CONTROL_FLOW_GRAPH_H
+
+#include <iostream>
+#include <cassert>
+#include "../control_flow_graph.h"
+
+void test_control_flow_graph();
+
+#endif
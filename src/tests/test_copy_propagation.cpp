@@ -0,0 +1,122 @@
+#include "test_copy_propagation.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+void test_available_copies(){
+	std::cout << "1) Propagation of available copies: ";
+
+	translate_ir_code(std::string("C.m:\n"
+								"x@0 = a@0\n"
+								"y@0 = 5\n"
+								"ifFalse c@0 goto L1\n"
+								"z@0 = x@0 + y@0\n"
+								"goto L2\n"
+								"L1:\n"
+								"x@0 = 1\n"
+								"L2:\n"
+								"w@0 = x@0 + y@0\n"
+								"L3:\n"
+								"if y@0 > w@0 goto L4\n"
+								"w@0 = w@0 + y@0\n"
+								"y@0 = w@0\n"
+								"goto L3\n"
+								"L4:\n"
+								"return w@0"));
+
+	instructions_list method = *ir_code;
+	std::string original = print_instructions_list(*ir_code);
+
+	// x@0 has different values at L2, and y@0 is modified into the loop.
+	assert(propagate_copies(method) == 3);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"x@0 = a@0\n"
+			"y@0 = 5\n"
+			"ifFalse c@0 goto L1\n"
+			"z@0 = a@0 + 5\n"
+			"goto L2\n"
+			"L1:\n"
+			"x@0 = 1\n"
+			"L2:\n"
+			"w@0 = x@0 + 5\n"
+			"L3:\n"
+			"if y@0 > w@0 goto L4\n"
+			"w@0 = w@0 + y@0\n"
+			"y@0 = w@0\n"
+			"goto L3\n"
+			"L4:\n"
+			"return w@0\n");
+	// The original code is not modified.
+	assert(print_instructions_list(*ir_code) == original);
+
+	// Only z@0 is dead: the copies still reach uses that were not replaced.
+	assert(remove_dead_quads(method) == 1);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_temporaries_coalescing(){
+	std::cout << "2) Coalescing of temporaries: ";
+
+	translate_ir_code(std::string("C.m:\n"
+								"@t0 = a@0 + b@0\n"
+								"x@0 = @t0\n"
+								"@t1 = x@0 * 2\n"
+								"@t2 = @t1\n"
+								"y@0 = @t2\n"
+								"@t3 = y@0 + 1\n"
+								"y@0 = 3\n"
+								"x@0 = @t3\n"
+								"@t4 = a@0 + 1\n"
+								"q@0 = q@0 + 1\n"
+								"q@0 = @t4\n"
+								"@t5 = a@0 + 2\n"
+								"call C.f , 0\n"
+								"o@0.f@0 = @t5\n"
+								"@t6 = call C.g , 0\n"
+								"r@0 = @t6\n"
+								"return r@0"));
+
+	instructions_list method = *ir_code;
+	ids_info ids;
+	unsigned int asm_instructions = 0;
+	for(instructions_list::iterator it = method.begin(); it != method.end();
+	++it){
+		asm_instructions += count_asm_instructions(*it, ids);
+	}
+
+	// q@0 is modified before receiving @t4, and the call could read o@0.f@0.
+	assert(coalesce_temporaries(method) == 5);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"x@0 = a@0 + b@0\n"
+			"y@0 = x@0 * 2\n"
+			"x@0 = y@0 + 1\n"
+			"y@0 = 3\n"
+			"@t4 = a@0 + 1\n"
+			"q@0 = q@0 + 1\n"
+			"q@0 = @t4\n"
+			"@t5 = a@0 + 2\n"
+			"call C.f, 0\n"
+			"o@0.f@0 = @t5\n"
+			"r@0 = call C.g, 0\n"
+			"return r@0\n");
+
+	// Each copy removed is a mov less.
+	unsigned int coalesced_instructions = 0;
+	for(instructions_list::iterator it = method.begin(); it != method.end();
+	++it){
+		coalesced_instructions += count_asm_instructions(*it, ids);
+	}
+	assert(asm_instructions - coalesced_instructions == 5);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_copy_propagation(){
+	std::cout << "\nTesting copy propagation:" << std::endl;
+
+	test_available_copies();
+	test_temporaries_coalescing();
+}
@@ -0,0 +1,12 @@
+#ifndef TEST_COPY_PROPAGATION_H
+#define TEST_COPY_PROPAGATION_H
+
+#include <iostream>
+#include <cassert>
+#include "../copy_propagation.h"
+#include "../dead_code_elimination.h"
+#include "../asm_code_generator.h"
+
+void test_copy_propagation();
+
+#endif
@@ -0,0 +1,131 @@
+#include "test_dead_code_elimination.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+void test_dead_quads(){
+	std::cout << "1) Removal of dead quads: ";
+
+	translate_ir_code(std::string("C.m:\n"
+								"enter 24\n"
+								"@t0 = a@0 + 1\n"
+								"@t1 = @t0 * 2\n"
+								"@t2 = a@0 / b@0\n"
+								"@t3 = a@0 / 2\n"
+								"@t4 = call C.f , 0\n"
+								"x@0 = 1\n"
+								"L1:\n"
+								"if x@0 > 10 goto L2\n"
+								"y@0 = x@0 * 3\n"
+								"x@0 = x@0 + 1\n"
+								"goto L1\n"
+								"L2:\n"
+								"return x@0"));
+
+	instructions_list method = *ir_code;
+
+	// The chain of temporaries, and y, are dead. The division that could fail
+	// and the call are kept.
+	assert(remove_dead_quads(method) == 4);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 24\n"
+			"@t2 = a@0 / b@0\n"
+			"@t4 = call C.f, 0\n"
+			"x@0 = 1\n"
+			"L1:\n"
+			"if x@0 > 10 goto L2\n"
+			"x@0 = x@0 + 1\n"
+			"goto L1\n"
+			"L2:\n"
+			"return x@0\n");
+
+	// Stores into arrays and objects are never dead.
+	translate_ir_code(std::string("C.m:\n"
+								"a@0[0] = 1\n"
+								"o@0.f@0 = 2\n"
+								"return"));
+	method = *ir_code;
+	assert(remove_dead_quads(method) == 0);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_dead_control_flow(){
+	std::cout << "2) Removal of unreachable blocks and unused labels: ";
+
+	// while(x < 10){ x = x + 1; break; x = 2 } return x
+	translate_ir_code(std::string("C.m:\n"
+								"L1:\n"
+								"if x@0 >= 10 goto L3\n"
+								"x@0 = x@0 + 1\n"
+								"goto L3\n"
+								"L2:\n"
+								"x@0 = 2\n"
+								"goto L1\n"
+								"L3:\n"
+								"return x@0\n"
+								"@t0 = x@0 + 1\n"
+								"return @t0"));
+
+	instructions_list method = *ir_code;
+
+	assert(eliminate_dead_code(method) == 7);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"if x@0 >= 10 goto L3\n"
+			"x@0 = x@0 + 1\n"
+			"L3:\n"
+			"return x@0\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_dead_code_report(){
+	std::cout << "3) Savings of each method: ";
+
+	ids_info ids;
+	ids.register_var(std::string("x"), 0, T_INT, false);
+	ids.register_var(std::string("y"), 4, T_INT, false);
+	translate_ir_code(std::string("C.m:\n"
+								"enter 8\n"
+								"x@0 = 1\n"
+								"y@0 = x@0 + 2\n"
+								"return x@0\n"
+								"C.n:\n"
+								"enter 8\n"
+								"return 0"));
+
+	instructions_list code = *ir_code;
+	std::vector<dead_code_report> reports = eliminate_dead_code(code, ids);
+
+	assert(reports.size() == 2);
+	assert(reports[0].method == "C.m");
+	assert(reports[0].quads == 1);
+	// mov, add and mov, for y@0 = x@0 + 2.
+	assert(reports[0].asm_instructions == 3);
+	assert(reports[1].method == "C.n");
+	assert(reports[1].quads == 0);
+	assert(reports[1].asm_instructions == 0);
+	assert(print_instructions_list(code) ==
+			"C.m:\n"
+			"enter 8\n"
+			"x@0 = 1\n"
+			"return x@0\n"
+			"C.n:\n"
+			"enter 8\n"
+			"return 0\n");
+	assert(print_dead_code_report(reports).find("C.n: 0 quads, 0 asm "
+												"instructions saved.") !=
+			std::string::npos);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_dead_code_elimination(){
+	std::cout << "\nTesting dead code elimination:" << std::endl;
+
+	test_dead_quads();
+	test_dead_control_flow();
+	test_dead_code_report();
+}
@@ -0,0 +1,10 @@
+#ifndef TEST_DEAD_CODE_ELIMINATION_H
+#define TEST_DEAD_CODE_ELIMINATION_H
+
+#include <iostream>
+#include <cassert>
+#include "../dead_code_elimination.h"
+
+void test_dead_code_elimination();
+
+#endif
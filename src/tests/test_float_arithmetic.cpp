@@ -0,0 +1,426 @@
+#include <cmath>
+#include <map>
+#include "test_float_arithmetic.h"
+#include "../asm_code_generator.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+/* Runs the comparison code of translate_float_relational_jump (or of
+ * translate_float_relational_assign), with the floats of memory (by offset
+ * from %rbp) and pool, and returns the label of the jump taken, or "" if none
+ * is taken. Integers moved into memory are kept there as floats. */
+std::string float_jump_test_run(const asm_instructions_list& code,
+								const std::map<std::string, float>& pool,
+								std::map<int, float>& memory){
+	std::map<register_id, float> registers;
+	std::map<register_id, int> integers;
+	bool zf = false, pf = false, cf = false;
+
+	for(asm_instructions_list::const_iterator it = code.begin();
+	it != code.end(); ++it){
+		const asm_instruction_pointer& inst = *it;
+		float s = 0;
+
+		if(inst->source != nullptr){
+			switch(get_operand_addressing(inst->source)){
+				case operand_addressing::REGISTER:
+					s = registers[inst->source->value.reg];
+					break;
+
+				case operand_addressing::RIP_RELATIVE:
+					s = pool.at(*inst->source->value.label);
+					break;
+
+				default:
+					s = memory[inst->source->value.mem.offset];
+			}
+		}
+
+		switch(inst->op){
+			case operation::MOVSS:
+				registers[inst->destination->value.reg] = s;
+				break;
+
+			case operation::UCOMISS:{
+				float d = registers[inst->destination->value.reg];
+				bool unordered = std::isnan(d) || std::isnan(s);
+
+				zf = unordered || d == s;
+				pf = unordered;
+				cf = unordered || d < s;
+				break;
+			}
+
+			case operation::JA:
+				if(!cf && !zf){
+					return *inst->destination->value.label;
+				}
+				break;
+
+			case operation::JAE:
+				if(!cf){
+					return *inst->destination->value.label;
+				}
+				break;
+
+			case operation::JE:
+				if(zf){
+					return *inst->destination->value.label;
+				}
+				break;
+
+			case operation::JNE:
+				if(!zf){
+					return *inst->destination->value.label;
+				}
+				break;
+
+			case operation::JP:
+				if(pf){
+					return *inst->destination->value.label;
+				}
+				break;
+
+			case operation::SETA:
+				integers[inst->destination->value.reg] = !cf && !zf;
+				break;
+
+			case operation::SETAE:
+				integers[inst->destination->value.reg] = !cf;
+				break;
+
+			case operation::SETE:
+				integers[inst->destination->value.reg] = zf;
+				break;
+
+			case operation::SETNE:
+				integers[inst->destination->value.reg] = !zf;
+				break;
+
+			case operation::SETP:
+				integers[inst->destination->value.reg] = pf;
+				break;
+
+			case operation::SETNP:
+				integers[inst->destination->value.reg] = !pf;
+				break;
+
+			case operation::AND:
+				integers[inst->destination->value.reg] &=
+											integers[inst->source->value.reg];
+				break;
+
+			case operation::OR:
+				integers[inst->destination->value.reg] |=
+											integers[inst->source->value.reg];
+				break;
+
+			case operation::MOVZBL:
+				integers[inst->destination->value.reg] =
+											integers[inst->source->value.reg];
+				break;
+
+			case operation::MOV:
+				memory[inst->destination->value.mem.offset] =
+											integers[inst->source->value.reg];
+				break;
+
+			case operation::LABEL:
+				break;
+
+			default:
+				assert(false);
+		}
+	}
+
+	return std::string("");
+}
+
+void test_float_names(){
+	std::cout << "1) Inference of the float names: ";
+
+	ids_info ids;
+	std::string method_id = ids.register_method(std::string("m"), 0,
+												std::string("C"));
+	t_params& params = ids.get_list_params(method_id);
+	params.push_back(ids.register_var(std::string("f"), 0, T_FLOAT, true));
+	ids.register_var(std::string("i"), 4, T_INT, false);
+	ids.register_var(std::string("x"), 8, T_FLOAT, false);
+	for(unsigned int i = 0; i < 6; i++){
+		ids.new_temp(12 + 4*i, T_UNDEFINED);
+	}
+
+	// C.g is called before its definition: its result is a float anyway.
+	translate_ir_code("C.m:\n"
+					"enter 36\n"
+					"@t0 = i@0 * 2\n"
+					"@t1 = @t0 + f@0\n"
+					"x@0 = @t1\n"
+					"@t2 = call C.g , 0\n"
+					"@t3 = - @t2\n"
+					"@t4 = i@0 + 1\n"
+					"i@0 = @t4\n"
+					"return @t4\n"
+					"C.g:\n"
+					"enter 0\n"
+					"@t5 = 1.5\n"
+					"return @t5");
+
+	std::unordered_set<std::string> names = get_float_names(*ir_code, ids);
+	assert(names.count("@t0") == 0);
+	assert(names.count("@t1") == 1);
+	assert(names.count("x@0") == 1);
+	assert(names.count("f@0") == 1);
+	assert(names.count("@t2") == 1);
+	assert(names.count("@t3") == 1);
+	assert(names.count("@t4") == 0);
+	assert(names.count("@t5") == 1);
+	assert(names.count("i@0") == 0);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_float_literal_pool(){
+	std::cout << "2) Literal pool: ";
+
+	float_literal_pool pool;
+	assert(pool.empty());
+
+	operand_pointer one = pool.get_operand(1.0f);
+	assert(get_operand_addressing(one) == operand_addressing::RIP_RELATIVE);
+	assert(print_operand_intel_syntax(one) == "LC0(%rip)");
+	// Each value is kept once, but 0.0 and -0.0 are different.
+	assert(*pool.get_operand(1.0f)->value.label == "LC0");
+	assert(*pool.get_operand(0.0f)->value.label == "LC1");
+	assert(*pool.get_operand(-0.0f)->value.label == "LC2");
+
+	asm_instructions_list code;
+	pool.emit(code);
+	assert(code.size() == 8);
+	assert(print_intel_syntax(code[0]) == ".section .rodata\n");
+	assert(print_intel_syntax(code[1]) == ".align 4\n");
+	assert(is_label_instruction(code[2], "LC0"));
+	assert(print_intel_syntax(code[3]) == ".long 1065353216\n");
+	assert(print_intel_syntax(code[7]) == ".long 2147483648\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_float_arithmetic_translation(){
+	std::cout << "3) Arithmetic and widening of integers: ";
+
+	float_literal_pool pool;
+	operand_pointer x = new_memory_operand(-4, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer y = new_memory_operand(-8, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer i = new_register_operand(register_id::R10D);
+	operand_pointer xmm8 = new_register_operand(register_id::XMM8);
+	operand_pointer xmm9 = new_register_operand(register_id::XMM9);
+
+	// x = y + i: i is widened into %xmm9.
+	asm_instructions_list code;
+	translate_float_arithmetic(code, pool, quad_oper::PLUS, x, y, true, i,
+								false);
+	assert(code.size() == 4);
+	assert(is_movss_instruction(code[0], y, xmm8));
+	assert(is_cvtsi2ss_instruction(code[1], i, xmm9, data_type::L));
+	assert(is_addss_instruction(code[2], xmm9, xmm8));
+	assert(is_movss_instruction(code[3], xmm8, x));
+
+	// x = i / 2.5: i is widened into %xmm8, and 2.5 is read from the pool.
+	code.clear();
+	translate_float_arithmetic(code, pool, quad_oper::DIVIDE, x, i, false,
+								new_immediate_float_operand(2.5f), true);
+	assert(code.size() == 3);
+	assert(is_cvtsi2ss_instruction(code[0], i, xmm8, data_type::L));
+	assert(is_divss_instruction(code[1], new_rip_relative_operand("LC0"),
+								xmm8));
+
+	// Integer constants are widened at compile time.
+	code.clear();
+	translate_float_arithmetic(code, pool, quad_oper::MINUS, x, y, true,
+								new_immediate_integer_operand(3), false);
+	assert(is_subss_instruction(code[1], new_rip_relative_operand("LC1"),
+								xmm8));
+	asm_instructions_list literals;
+	pool.emit(literals);
+	assert(print_intel_syntax(literals[5]) == ".long 1077936128\n");
+
+	// Constants are computed at compile time.
+	code.clear();
+	translate_float_arithmetic(code, pool, quad_oper::TIMES, x,
+								new_immediate_float_operand(1.5f), true,
+								new_immediate_integer_operand(3), false);
+	assert(code.size() == 1);
+	assert(is_mov_instruction(code[0], new_immediate_float_operand(4.5f), x,
+								data_type::L));
+	assert(print_intel_syntax(code[0]) ==
+			"\tmovl $1083179008 , -4(%rbp, 0, 1)\n");
+
+	// Negation.
+	code.clear();
+	translate_float_negation(code, pool, x, y, true);
+	assert(code.size() == 3);
+	assert(is_mulss_instruction(code[1], new_rip_relative_operand("LC2"),
+								xmm8));
+	assert(print_intel_syntax(code[1]) == "\tmulss LC2(%rip) , %xmm8\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_float_relational_jumps(){
+	std::cout << "4) Comparisons and relational assigns (and NaN): ";
+
+	const quad_oper relops[] = {quad_oper::LESS, quad_oper::LESS_EQUAL,
+								quad_oper::GREATER, quad_oper::GREATER_EQUAL,
+								quad_oper::EQUAL, quad_oper::DISTINCT};
+	const float values[] = {-1.0f, 0.0f, -0.0f, 2.5f, NAN, INFINITY};
+	operand_pointer y = new_memory_operand(-4, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer z = new_memory_operand(-8, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer x = new_memory_operand(-12, register_id::RBP,
+											register_id::NONE, 1);
+	std::map<std::string, float> no_pool;
+
+	for(unsigned int r = 0; r < 6; r++){
+		float_literal_pool pool;
+		asm_instructions_list code, assign;
+		translate_float_relational_jump(code, pool, relops[r], y, true, z,
+										true, "L", "LU0");
+		// x = y relop z, computed into %r8d (and %r9d, for == and !=).
+		translate_float_relational_assign(assign, pool, relops[r], x, y, true,
+										z, true, register_id::R8D,
+										register_id::R9D);
+
+		for(unsigned int i = 0; i < 6; i++){
+			for(unsigned int j = 0; j < 6; j++){
+				float a = values[i], b = values[j];
+				bool expected;
+
+				switch(relops[r]){
+					case quad_oper::LESS:
+						expected = a < b;
+						break;
+
+					case quad_oper::LESS_EQUAL:
+						expected = a <= b;
+						break;
+
+					case quad_oper::GREATER:
+						expected = a > b;
+						break;
+
+					case quad_oper::GREATER_EQUAL:
+						expected = a >= b;
+						break;
+
+					case quad_oper::EQUAL:
+						expected = a == b;
+						break;
+
+					default:
+						expected = a != b;
+				}
+
+				std::map<int, float> memory;
+				memory[-4] = a;
+				memory[-8] = b;
+				assert((float_jump_test_run(code, no_pool, memory) == "L") ==
+						expected);
+				assert(float_jump_test_run(assign, no_pool, memory) == "" and
+					   memory[-12] == (expected ? 1 : 0));
+			}
+		}
+	}
+
+	// An integer compared with a constant.
+	float_literal_pool pool;
+	asm_instructions_list code;
+	operand_pointer xmm8 = new_register_operand(register_id::XMM8);
+	operand_pointer xmm9 = new_register_operand(register_id::XMM9);
+	translate_float_relational_jump(code, pool, quad_oper::LESS,
+									new_register_operand(register_id::R10D),
+									false, new_immediate_float_operand(0.5f),
+									true, "L", "LU0");
+	assert(code.size() == 4);
+	assert(is_movss_instruction(code[0], new_rip_relative_operand("LC0"),
+								xmm8));
+	assert(is_cvtsi2ss_instruction(code[1],
+								new_register_operand(register_id::R10D),
+								xmm9, data_type::L));
+	assert(is_ucomiss_instruction(code[2], xmm9, xmm8));
+	assert(is_ja_instruction(code[3], "L"));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_float_calls(){
+	std::cout << "5) Float parameters and results: ";
+
+	ids_info ids;
+	std::string method_id = ids.register_method(std::string("h"), 0,
+												std::string("C"));
+	t_params& params = ids.get_list_params(method_id);
+	params.push_back(ids.register_obj(std::string("this"), 0, std::string("C"),
+									std::string(""), true));
+	params.push_back(ids.register_var(std::string("f"), 0, T_FLOAT, true));
+	params.push_back(ids.register_var(std::string("a"), 0, T_INT, true));
+	ids.register_var(std::string("r"), 0, T_FLOAT, false);
+	ids.new_temp(0, T_UNDEFINED);
+
+	translate_ir_code("C.h:\n"
+					"enter 8\n"
+					"r@0 = f@0 * 2.0\n"
+					"param this@0\n"
+					"param r@0\n"
+					"param a@0\n"
+					"@t0 = call C.h , 3\n"
+					"if @t0 < r@0 goto L1\n"
+					"return r@0\n"
+					"L1:\n"
+					"return 0.5");
+
+	asm_code_generator generator(ir_code, &ids);
+	generator.translate_ir();
+	asm_instructions_list& code = *generator.get_translation();
+	std::string text;
+	for(asm_instructions_list::iterator it = code.begin(); it != code.end();
+	++it){
+		text += print_intel_syntax(*it);
+	}
+
+	// f is taken from %xmm0 into the frame, below the integer parameters
+	// (a@0 at -8, this@0 is an object, above %rbp).
+	assert(text.find("movss %xmm0 , -12(%rbp, 0, 1)") != std::string::npos);
+	// r is passed into %xmm0, the call reports a vector register, and the
+	// result is taken from %xmm0, into a new slot.
+	assert(text.find("movss -16(%rbp, 0, 1) , %xmm0\n"
+					"\tmovl -8(%rbp, 0, 1) , %rsi\n"
+					"\tmovl $1 , %rax\n"
+					"\tcall C.h\n"
+					"\tmovss %xmm0 , -20(%rbp, 0, 1)\n") != std::string::npos);
+	assert(text.find("mulss LC0(%rip) , %xmm8") != std::string::npos);
+	assert(text.find("ucomiss") != std::string::npos);
+	assert(text.find("\tja L1\n") != std::string::npos);
+	// Both returns through %xmm0: the constant from the pool.
+	assert(text.find("movss LC1(%rip) , %xmm0") != std::string::npos);
+	assert(text.find("%rax\n\tleave") == std::string::npos);
+	// The pool, at the end: 2.0 and 0.5.
+	assert(text.find(".section .rodata\n.align 4\n LC0\n.long 1073741824\n"
+					" LC1\n.long 1056964608\n") != std::string::npos);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_float_arithmetic(){
+	std::cout << "\nTesting float arithmetic:" << std::endl;
+
+	test_float_names();
+	test_float_literal_pool();
+	test_float_arithmetic_translation();
+	test_float_relational_jumps();
+	test_float_calls();
+}
@@ -0,0 +1,10 @@
+#ifndef TEST_FLOAT_ARITHMETIC_H
+#define TEST_FLOAT_ARITHMETIC_H
+
+#include <iostream>
+#include <cassert>
+#include "../float_arithmetic.h"
+
+void test_float_arithmetic();
+
+#endif
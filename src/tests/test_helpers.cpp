@@ -0,0 +1,33 @@
+#include <algorithm>
+#include "test_helpers.h"
+
+void register_test_method(ids_info& ids,
+						const std::string& method,
+						const std::vector<std::string>& params,
+						const std::vector<std::string>& object_params,
+						const std::vector<std::string>& vars){
+	std::string method_id = ids.register_method(method, 0, std::string("C"));
+	t_params& list = ids.get_list_params(method_id);
+	int offset = 0;
+
+	list.push_back(ids.register_obj(std::string("this"), offset,
+									std::string("C"), std::string(""), true));
+	for(std::vector<std::string>::const_iterator it = params.begin();
+	it != params.end(); ++it){
+		offset += 4;
+		if(std::find(object_params.begin(), object_params.end(), *it) !=
+		object_params.end()){
+			list.push_back(ids.register_obj(*it, offset, std::string("C"),
+											std::string(""), true));
+		}
+		else{
+			list.push_back(ids.register_var(*it, offset, T_INT, true));
+		}
+	}
+
+	for(std::vector<std::string>::const_iterator it = vars.begin();
+	it != vars.end(); ++it){
+		offset += 4;
+		ids.register_var(*it, offset, T_INT, false);
+	}
+}
@@ -0,0 +1,16 @@
+#ifndef TEST_HELPERS_H
+#define TEST_HELPERS_H
+
+#include <string>
+#include <vector>
+#include "../intermediate_symtable.h"
+
+/* Registers method of class C into ids, with "this" and the given parameters
+ * (integers, unless named into object_params), and the integer locals vars. */
+void register_test_method(ids_info& ids,
+						const std::string& method,
+						const std::vector<std::string>& params,
+						const std::vector<std::string>& object_params,
+						const std::vector<std::string>& vars);
+
+#endif
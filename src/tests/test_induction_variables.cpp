@@ -0,0 +1,154 @@
+#include "test_induction_variables.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+void test_array_loop(){
+	std::cout << "1) Indexing into a for loop: ";
+
+	ids_info ids;
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("t"), 4, T_INT, false);
+	ids.register_var(std::string("u"), 8, T_INT, false);
+	ids.register_var(std::string("v"), 12, T_INT, false);
+	ids.register_var(std::string("x"), 16, T_INT, false);
+	// for i = 0, 100 { o.b[i] = a[i] }, with o.b at offset 8.
+	translate_ir_code(std::string("C.m:\n"
+								"enter 20\n"
+								"i@0 = 0\n"
+								"L1:\n"
+								"if 100 < i@0 goto L2\n"
+								"t@0 = i@0 * 4\n"
+								"x@0 = a@0[t@0]\n"
+								"u@0 = i@0 * 4\n"
+								"v@0 = u@0 + 8\n"
+								"o@0[v@0] = x@0\n"
+								"i@0 = i@0 + 1\n"
+								"goto L1\n"
+								"L2:\n"
+								"return x@0"));
+
+	instructions_list method = *ir_code;
+	build_ssa(method, ids);
+
+	/* Both offsets become new variables, increased by 4 on each iteration
+	 * (u@0@1 is only used to compute v@0@1, and goes away). Then, i only
+	 * counts the iterations: the test compares the first offset with the
+	 * bound scaled by 4. */
+	assert(reduce_induction_variables(method, ids) == 3);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 80\n"
+			"i@0@1 = 0\n"
+			"@t1 = i@0@1 * 4\n"
+			"@t4 = i@0@1 * 4\n"
+			"@t5 = @t4 + 8\n"
+			"L1:\n"
+			"x@0@1 = phi(C.m: x@0, @t0: x@0@2)\n"
+			"@t2 = phi(C.m: @t1, @t0: @t3)\n"
+			"@t6 = phi(C.m: @t5, @t0: @t7)\n"
+			"if 400 < @t2 goto L2\n"
+			"@t0:\n"
+			"x@0@2= a@0[@t2]\n"
+			"o@0[@t6] = x@0@2\n"
+			"@t3 = @t2 + 4\n"
+			"@t7 = @t6 + 4\n"
+			"goto L1\n"
+			"L2:\n"
+			"return x@0@1\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_used_variable(){
+	std::cout << "2) Induction variables used out of indexing: ";
+
+	ids_info ids;
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("s"), 4, T_INT, false);
+	ids.register_var(std::string("t"), 8, T_INT, false);
+	ids.register_var(std::string("x"), 12, T_INT, false);
+	translate_ir_code(std::string("C.m:\n"
+								"enter 16\n"
+								"i@0 = k@0\n"
+								"s@0 = 0\n"
+								"L1:\n"
+								"if i@0 >= n@0 goto L2\n"
+								"t@0 = 4 * i@0\n"
+								"x@0 = a@0[t@0]\n"
+								"s@0 = s@0 + x@0\n"
+								"s@0 = s@0 + i@0\n"
+								"i@0 = i@0 + 2\n"
+								"goto L1\n"
+								"L2:\n"
+								"return s@0"));
+
+	instructions_list method = *ir_code;
+	build_ssa(method, ids);
+
+	// The offset is reduced, but i@0 is still needed by the sum.
+	assert(reduce_induction_variables(method, ids) == 1);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 64\n"
+			"i@0@1 = k@0\n"
+			"s@0@1 = 0\n"
+			"@t1 = i@0@1 * 4\n"
+			"L1:\n"
+			"i@0@2 = phi(C.m: i@0@1, @t0: i@0@3)\n"
+			"s@0@2 = phi(C.m: s@0@1, @t0: s@0@4)\n"
+			"@t2 = phi(C.m: @t1, @t0: @t3)\n"
+			"if i@0@2 >= n@0 goto L2\n"
+			"@t0:\n"
+			"x@0@1= a@0[@t2]\n"
+			"s@0@3 = s@0@2 + x@0@1\n"
+			"s@0@4 = s@0@3 + i@0@2\n"
+			"i@0@3 = i@0@2 + 2\n"
+			"@t3 = @t2 + 8\n"
+			"goto L1\n"
+			"L2:\n"
+			"return s@0@2\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_overflowing_test(){
+	std::cout << "3) Exit tests whose scaled bound overflows: ";
+
+	ids_info ids;
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("t"), 4, T_INT, false);
+	ids.register_var(std::string("x"), 8, T_INT, false);
+	translate_ir_code(std::string("C.m:\n"
+								"enter 12\n"
+								"i@0 = 0\n"
+								"L1:\n"
+								"if i@0 >= 600000000 goto L2\n"
+								"t@0 = i@0 * 8\n"
+								"x@0 = a@0[t@0]\n"
+								"i@0 = i@0 + 100000000\n"
+								"goto L1\n"
+								"L2:\n"
+								"return x@0"));
+
+	instructions_list method = *ir_code;
+	build_ssa(method, ids);
+
+	/* 600000000 * 8 doesn't fit into 32 bits: the offset is reduced, but the
+	 * test keeps comparing i, instead of the wrapped 505032704. */
+	assert(reduce_induction_variables(method, ids) == 1);
+	std::string code = print_instructions_list(method);
+	assert(code.find("if i@0@2 >= 600000000 goto L2\n") != std::string::npos);
+	assert(code.find("i@0@3 = i@0@2 + 100000000\n") != std::string::npos);
+	assert(code.find("505032704") == std::string::npos);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_induction_variables(){
+	std::cout << "\nTesting induction variables' strength reduction:" << std::endl;
+
+	test_array_loop();
+	test_used_variable();
+	test_overflowing_test();
+}
@@ -0,0 +1,11 @@
+#ifndef TEST_INDUCTION_VARIABLES_H
+#define TEST_INDUCTION_VARIABLES_H
+
+#include <iostream>
+#include <cassert>
+#include "../induction_variables.h"
+#include "../ssa.h"
+
+void test_induction_variables();
+
+#endif
@@ -0,0 +1,106 @@
+#include "test_inlining.h"
+#include "test_helpers.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+void test_small_methods(){
+	std::cout << "1) Inlining of accessors: ";
+
+	ids_info ids;
+	// this@0, this@1, this@2 and this@3; z@0 and n@0.
+	register_test_method(ids, "get", {}, {}, {});
+	register_test_method(ids, "add", {"z"}, {}, {});
+	register_test_method(ids, "main", {}, {}, {});
+	register_test_method(ids, "rec", {"n"}, {}, {});
+	ids.register_var(std::string("s"), 0, T_INT, false);
+	// @t0, @t1 and @t2.
+	for(unsigned int i = 0; i < 3; i++){
+		ids.new_temp(0, T_INT);
+	}
+	translate_ir_code(std::string("C.get:\n"
+								"enter 4\n"
+								"@t0 = this@0[4]\n"
+								"return @t0\n"
+								"C.add:\n"
+								"enter 4\n"
+								"s@0 = this@1[4]\n"
+								"s@0 = s@0 + z@0\n"
+								"if s@0 < 0 goto L1\n"
+								"return s@0\n"
+								"L1:\n"
+								"return 0\n"
+								"C.main:\n"
+								"enter 8\n"
+								"param this@2\n"
+								"@t1 = call C.get , 0\n"
+								"param this@2\n"
+								"param @t1\n"
+								"@t2 = call C.add , 1\n"
+								"param this@2\n"
+								"param @t2\n"
+								"call C.rec , 1\n"
+								"return @t2\n"
+								"C.rec:\n"
+								"enter 0\n"
+								"param this@3\n"
+								"param n@0\n"
+								"call C.rec , 1\n"
+								"C.ext:\n"
+								"enter 0"));
+
+	instructions_list code = *ir_code;
+
+	/* get and add are inlined into main, and rec once (but not into itself).
+	 * ext has no body: it is extern. */
+	assert(inline_methods(code, ids) == 3);
+	assert(print_instructions_list(code) ==
+			"C.get:\n"
+			"enter 4\n"
+			"@t0= this@0[4]\n"
+			"return @t0\n"
+			"C.add:\n"
+			"enter 4\n"
+			"s@0= this@1[4]\n"
+			"s@0 = s@0 + z@0\n"
+			"if s@0 < 0 goto L1\n"
+			"return s@0\n"
+			"L1:\n"
+			"return 0\n"
+			"C.main:\n"
+			"enter 24\n"
+			"@t0@1= this@2[4]\n"
+			"@t1 = @t0@1\n"
+			"z@0@1 = @t1\n"
+			"s@0@1= this@2[4]\n"
+			"s@0@1 = s@0@1 + z@0@1\n"
+			"if s@0@1 < 0 goto @t3\n"
+			"@t2 = s@0@1\n"
+			"goto @t4\n"
+			"@t3:\n"
+			"@t2 = 0\n"
+			"@t4:\n"
+			"n@0@1 = @t2\n"
+			"param this@2\n"
+			"param n@0@1\n"
+			"call C.rec, 1\n"
+			"return @t2\n"
+			"C.rec:\n"
+			"enter 0\n"
+			"param this@3\n"
+			"param n@0\n"
+			"call C.rec, 1\n"
+			"C.ext:\n"
+			"enter 0\n");
+	// The copies are registered as the originals.
+	assert(ids.id_exists(std::string("z@0@1")) &&
+			ids.get_type(std::string("z@0@1")) == T_INT);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_inlining(){
+	std::cout << "\nTesting inlining:" << std::endl;
+
+	test_small_methods();
+}
@@ -0,0 +1,10 @@
+#ifndef TEST_INLINING_H
+#define TEST_INLINING_H
+
+#include <iostream>
+#include <cassert>
+#include "../inlining.h"
+
+void test_inlining();
+
+#endif
@@ -0,0 +1,414 @@
+#include "test_instruction_selection.h"
+#include "../asm_code_generator.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+void test_address_tiles(){
+	std::cout << "1) Tiles of the addresses: ";
+
+	address_pointer i = new_name_address(std::string("i@0"));
+	expression_pointer leaf = new_expression_leaf(i);
+	expression_pointer four = new_expression_leaf(new_integer_constant(4));
+	expression_pointer three = new_expression_leaf(new_integer_constant(3));
+	expression_pointer eight = new_expression_leaf(new_integer_constant(8));
+	address_tile tile;
+
+	// (i * 4) + 8
+	assert(match_address_tile(new_expression_node(quad_oper::PLUS,
+								new_expression_node(quad_oper::TIMES, leaf,
+													four),
+								eight),
+								tile));
+	assert(tile.index == i and tile.scale == 4 and tile.displacement == 8);
+
+	// 4 * (i - 3): the displacement is scaled too.
+	assert(match_address_tile(new_expression_node(quad_oper::TIMES, four,
+								new_expression_node(quad_oper::MINUS, leaf,
+													three)),
+								tile));
+	assert(tile.index == i and tile.scale == 4 and tile.displacement == -12);
+
+	// A constant.
+	assert(match_address_tile(new_expression_node(quad_oper::TIMES, three,
+												  eight),
+								tile));
+	assert(tile.index == nullptr and tile.displacement == 24);
+
+	// i * 3 and 8 - i have no tile: tile isn't modified.
+	assert(not match_address_tile(new_expression_node(quad_oper::TIMES, leaf,
+													  three),
+								tile));
+	assert(not match_address_tile(new_expression_node(quad_oper::MINUS, eight,
+													  leaf),
+								tile));
+	assert(tile.index == nullptr and tile.displacement == 24);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_index_trees(){
+	std::cout << "2) Trees of the indexes: ";
+
+	ids_info ids;
+	ids.register_method(std::string("m"), 0, std::string("C"));
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("a"), 4, T_INT, false);
+	ids.register_var(std::string("x"), 8, T_INT, false);
+	for(unsigned int j = 0; j < 4; j++){
+		ids.new_temp(12 + 4*j, T_UNDEFINED);
+	}
+
+	// The index of the first copy is folded; @t2 is read after the second
+	// copy (and i@0 * 3 has no tile): only its increment is folded into the
+	// third copy.
+	translate_ir_code("@t0 = i@0 * 4\n"
+					"@t0 = @t0 + 8\n"
+					"x@0 = a@0[@t0]\n"
+					"@t2 = i@0 * 3\n"
+					"a@0[@t2] = x@0\n"
+					"@t3 = @t2 + 1\n"
+					"x@0 = a@0[@t3]");
+
+	std::unordered_set<unsigned int> folded;
+	std::unordered_map<unsigned int, expression_pointer> trees =
+				build_index_trees(*ir_code, ids, std::unordered_set<std::string>(),
+								folded);
+	assert(trees.size() == 2 and trees.count(2) == 1 and trees.count(6) == 1);
+	assert(folded.size() == 3 and folded.count(0) == 1 and
+		   folded.count(1) == 1 and folded.count(5) == 1);
+
+	address_tile tile;
+	assert(match_address_tile(trees[2], tile));
+	assert(get_address_name(tile.index) == "i@0" and tile.scale == 4 and
+		   tile.displacement == 8);
+	assert(match_address_tile(trees[6], tile));
+	assert(get_address_name(tile.index) == "@t2" and tile.scale == 1 and
+		   tile.displacement == 1);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_additive_selection(){
+	std::cout << "3) Selection of additions and subtractions: ";
+
+	operand_pointer x = new_memory_operand(-4, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer y = new_memory_operand(-8, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer r10 = new_register_operand(register_id::R10D);
+	operand_pointer r11 = new_register_operand(register_id::R11D);
+	operand_pointer r8 = new_register_operand(register_id::R8D);
+	operand_pointer one = new_immediate_integer_operand(1);
+	asm_instructions_list code;
+
+	// x = x + 1: in place.
+	select_additive_operation(code, quad_oper::PLUS, x, x, one,
+							SELECTION_VALUE_REGISTER);
+	assert(code.size() == 1);
+	assert(is_add_instruction(code[0], one, x, data_type::L));
+
+	// r11 = r10 - 1, r11 = r10 + r11: by lea, and in place.
+	code.clear();
+	select_additive_operation(code, quad_oper::MINUS, r11, r10, one,
+							SELECTION_VALUE_REGISTER);
+	assert(code.size() == 1);
+	assert(print_intel_syntax(code[0]) == "\tleal -1(%r10, 0, 1) , %r11d\n");
+	code.clear();
+	select_additive_operation(code, quad_oper::PLUS, r11, r10, r11,
+							SELECTION_VALUE_REGISTER);
+	assert(code.size() == 1);
+	assert(is_add_instruction(code[0], r10, r11, data_type::L));
+
+	// r11 = y - r10: into r11.
+	code.clear();
+	select_additive_operation(code, quad_oper::MINUS, r11, y, r10,
+							SELECTION_VALUE_REGISTER);
+	assert(code.size() == 2);
+	assert(is_mov_instruction(code[0], y, r11, data_type::L));
+	assert(is_sub_instruction(code[1], r10, r11, data_type::L));
+
+	// x = y - x: through %r8d.
+	code.clear();
+	select_additive_operation(code, quad_oper::MINUS, x, y, x,
+							SELECTION_VALUE_REGISTER);
+	assert(code.size() == 3);
+	assert(is_mov_instruction(code[0], y, r8, data_type::L));
+	assert(is_sub_instruction(code[1], x, r8, data_type::L));
+	assert(is_mov_instruction(code[2], r8, x, data_type::L));
+
+	// Constants.
+	code.clear();
+	select_additive_operation(code, quad_oper::MINUS, x, one,
+							new_immediate_integer_operand(3),
+							SELECTION_VALUE_REGISTER);
+	assert(code.size() == 1);
+	assert(is_mov_instruction(code[0], new_immediate_integer_operand(-2), x,
+							data_type::L));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_relational_jump_selection(){
+	std::cout << "4) Selection of comparisons: ";
+
+	operand_pointer x = new_memory_operand(-4, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer y = new_memory_operand(-8, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer r8 = new_register_operand(register_id::R8D);
+	operand_pointer two = new_immediate_integer_operand(2);
+	asm_instructions_list code;
+
+	// x < 2: flags based on x - 2.
+	select_relational_jump(code, quad_oper::LESS, x, two, "L",
+						SELECTION_VALUE_REGISTER);
+	assert(code.size() == 2);
+	assert(is_cmp_instruction(code[0], two, x, data_type::L));
+	assert(is_jl_instruction(code[1], "L"));
+
+	// 2 < x: swapped, as x > 2.
+	code.clear();
+	select_relational_jump(code, quad_oper::LESS, two, x, "L",
+						SELECTION_VALUE_REGISTER);
+	assert(code.size() == 2);
+	assert(is_cmp_instruction(code[0], two, x, data_type::L));
+	assert(is_jg_instruction(code[1], "L"));
+
+	// x < y: x is loaded first.
+	code.clear();
+	select_relational_jump(code, quad_oper::LESS, x, y, "L",
+						SELECTION_VALUE_REGISTER);
+	assert(code.size() == 3);
+	assert(is_mov_instruction(code[0], x, r8, data_type::L));
+	assert(is_cmp_instruction(code[1], y, r8, data_type::L));
+
+	// Constants.
+	code.clear();
+	select_relational_jump(code, quad_oper::LESS, two, two, "L",
+						SELECTION_VALUE_REGISTER);
+	assert(code.empty());
+	select_relational_jump(code, quad_oper::LESS_EQUAL, two, two, "L",
+						SELECTION_VALUE_REGISTER);
+	assert(code.size() == 1 and is_jmp_instruction(code[0], "L"));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_selection_translation(){
+	std::cout << "5) Translation with selection: ";
+
+	ids_info ids;
+	ids.register_method(std::string("m"), 0, std::string("C"));
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("a"), 0, T_INT, false);
+	ids.register_var(std::string("x"), 0, T_INT, false);
+	ids.new_temp(0, T_UNDEFINED);
+	ids.new_temp(0, T_UNDEFINED);
+
+	translate_ir_code("C.m:\n"
+					"enter 0\n"
+					"@t0 = i@0 * 4\n"
+					"@t0 = @t0 + 8\n"
+					"x@0 = a@0[@t0]\n"
+					"@t1 = x@0 + 1\n"
+					"x@0 = @t1\n"
+					"if x@0 < 10 goto L1\n"
+					"L1:\n"
+					"return x@0");
+
+	asm_code_generator generator(ir_code, &ids);
+	generator.set_instruction_selection(true);
+	generator.translate_ir();
+	asm_instructions_list& code = *generator.get_translation();
+	std::string text;
+	for(asm_instructions_list::iterator it = code.begin(); it != code.end();
+	++it){
+		text += print_intel_syntax(*it);
+	}
+
+	// The index is computed by the addressing of the copy.
+	assert(text.find("movslq") != std::string::npos);
+	assert(text.find("(%rbp, %r9, 4)") != std::string::npos);
+	assert(text.find("imul") == std::string::npos);
+	assert(text.find("\tleal") == std::string::npos);
+	// The comparison, with the constant as source.
+	assert(text.find("\tcmpl $10 , ") != std::string::npos);
+	assert(text.find("\tjl L1\n") != std::string::npos);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_zero_tests(){
+	std::cout << "6) Comparisons with 0 and reuse of flags: ";
+
+	operand_pointer x = new_memory_operand(-4, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer y = new_memory_operand(-8, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer r8 = new_register_operand(register_id::R8D);
+	operand_pointer zero = new_immediate_integer_operand(0);
+	operand_pointer one = new_immediate_integer_operand(1);
+	asm_instructions_list code;
+
+	// test for registers, and cmp $0 for memory.
+	select_relational_jump(code, quad_oper::LESS, r8, zero, "L",
+						SELECTION_VALUE_REGISTER);
+	assert(code.size() == 2);
+	assert(is_test_instruction(code[0], r8, r8, data_type::L));
+	assert(is_jl_instruction(code[1], "L"));
+	code.clear();
+	select_relational_jump(code, quad_oper::LESS, zero, x, "L",
+						SELECTION_VALUE_REGISTER);
+	assert(code.size() == 2);
+	assert(is_cmp_instruction(code[0], zero, x, data_type::L));
+	assert(is_jg_instruction(code[1], "L"));
+
+	// x = x - y, copied through %r8d: its flags are those of x == 0, but not
+	// those of x < 0 (the overflow flag can be set).
+	code.clear();
+	code.push_back(new_mov_instruction(x, r8, data_type::L));
+	code.push_back(new_sub_instruction(y, r8, data_type::L));
+	code.push_back(new_mov_instruction(r8, x, data_type::L));
+	assert(are_flags_set_for_zero_test(code, x, quad_oper::EQUAL));
+	assert(!are_flags_set_for_zero_test(code, y, quad_oper::EQUAL));
+	assert(!are_flags_set_for_zero_test(code, x, quad_oper::LESS));
+	select_relational_jump(code, quad_oper::DISTINCT, x, zero, "L",
+						SELECTION_VALUE_REGISTER);
+	assert(code.size() == 4);
+	assert(is_jne_instruction(code[3], "L"));
+
+	// and and xor clear the overflow flag.
+	code.clear();
+	code.push_back(new_xor_instruction(one, r8, data_type::L));
+	assert(are_flags_set_for_zero_test(code, r8, quad_oper::LESS));
+	// Not after a label, nor after a value written by other instruction.
+	code.push_back(new_label_instruction(std::string("L")));
+	assert(!are_flags_set_for_zero_test(code, r8, quad_oper::EQUAL));
+	code.clear();
+	code.push_back(new_xor_instruction(one, r8, data_type::L));
+	code.push_back(new_mov_instruction(zero, r8, data_type::L));
+	select_zero_test(code, r8, quad_oper::EQUAL);
+	assert(code.size() == 3);
+	assert(is_test_instruction(code[2], r8, r8, data_type::L));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_fused_comparisons(){
+	std::cout << "7) Comparisons fused with branches: ";
+
+	ids_info ids;
+	ids.register_method(std::string("m"), 0, std::string("C"));
+	ids.register_var(std::string("x"), 0, T_INT, false);
+	ids.register_var(std::string("b"), 4, T_BOOL, false);
+	ids.new_temp(0, T_UNDEFINED);
+	ids.new_temp(0, T_UNDEFINED);
+
+	// @t0 is only read by the jump that follows it, while @t1 is read again.
+	translate_ir_code("C.m:\n"
+					"enter 8\n"
+					"@t0 = x@0 < 10\n"
+					"ifFalse @t0 goto L1\n"
+					"x@0 = x@0 - 1\n"
+					"if x@0 == 0 goto L1\n"
+					"@t1 = x@0 == 5\n"
+					"ifTrue @t1 goto L1\n"
+					"b@0 = @t1\n"
+					"b@0 = not b@0\n"
+					"ifTrue b@0 goto L1\n"
+					"L1:\n"
+					"return x@0");
+
+	std::unordered_set<unsigned int> fused = find_fused_comparisons(*ir_code);
+	assert(fused.size() == 1 and fused.count(2) == 1);
+
+	asm_code_generator generator(ir_code, &ids);
+	generator.set_instruction_selection(true);
+	generator.translate_ir();
+	asm_instructions_list& code = *generator.get_translation();
+	std::string text;
+	for(asm_instructions_list::iterator it = code.begin(); it != code.end();
+	++it){
+		text += print_intel_syntax(*it);
+	}
+
+	// ifFalse x < 10: a single cmp and jge.
+	assert(text.find("\tcmpl $10 , ") != std::string::npos);
+	assert(text.find("\tjge L1\n") != std::string::npos);
+	// x == 0 reuses the flags of the subtraction, and the negation of b
+	// those of its xor: the only cmp $0 tests @t1, into memory.
+	std::string::size_type zero_test = text.find("\tcmpl $0 , ");
+	assert(zero_test != std::string::npos);
+	assert(text.find("\tcmpl $0 , ", zero_test + 1) == std::string::npos);
+	assert(text.find("\txorl $1 , ") != std::string::npos);
+	assert(text.find("\tje L1\n") != std::string::npos);
+	assert(text.find("\tjne L1\n") != std::string::npos);
+	// @t1 is read twice: it is computed.
+	assert(text.find("\tsete %r8b\n") != std::string::npos);
+	assert(text.find("\tmovzbl %r8b , %r8d\n") != std::string::npos);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_relational_assign_selection(){
+	std::cout << "8) Selection of relational assigns: ";
+
+	operand_pointer x = new_memory_operand(-4, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer y = new_memory_operand(-8, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer r8 = new_register_operand(register_id::R8D);
+	operand_pointer r8b = new_register_operand(register_id::R8B);
+	operand_pointer ebx = new_register_operand(register_id::EBX);
+	operand_pointer bl = new_register_operand(register_id::BL);
+	operand_pointer two = new_immediate_integer_operand(2);
+	operand_pointer zero = new_immediate_integer_operand(0);
+	asm_instructions_list code;
+
+	// y = x < 2, through the scratch register.
+	select_relational_assign(code, quad_oper::LESS, y, x, two,
+							SELECTION_VALUE_REGISTER);
+	assert(code.size() == 4);
+	assert(is_cmp_instruction(code[0], two, x, data_type::L));
+	assert(is_set_instruction(code[1], operation::SETL, r8b));
+	assert(is_movzbl_instruction(code[2], r8b, r8));
+	assert(is_mov_instruction(code[3], r8, y, data_type::L));
+
+	// %ebx = 2 <= x: swapped, and computed into %ebx itself.
+	code.clear();
+	select_relational_assign(code, quad_oper::LESS_EQUAL, ebx, two, x,
+							SELECTION_VALUE_REGISTER);
+	assert(code.size() == 3);
+	assert(is_cmp_instruction(code[0], two, x, data_type::L));
+	assert(is_set_instruction(code[1], operation::SETGE, bl));
+	assert(is_movzbl_instruction(code[2], bl, ebx));
+
+	// Comparisons with 0, and constants.
+	code.clear();
+	select_relational_assign(code, quad_oper::DISTINCT, ebx, x, zero,
+							SELECTION_VALUE_REGISTER);
+	assert(code.size() == 3);
+	assert(is_cmp_instruction(code[0], zero, x, data_type::L));
+	assert(is_set_instruction(code[1], operation::SETNE, bl));
+	code.clear();
+	select_relational_assign(code, quad_oper::LESS, x, two, two,
+							SELECTION_VALUE_REGISTER);
+	assert(code.size() == 1);
+	assert(is_mov_instruction(code[0], zero, x, data_type::L));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_instruction_selection(){
+	std::cout << "\nTesting instruction selection:" << std::endl;
+
+	test_address_tiles();
+	test_index_trees();
+	test_additive_selection();
+	test_relational_jump_selection();
+	test_selection_translation();
+	test_zero_tests();
+	test_fused_comparisons();
+	test_relational_assign_selection();
+}
@@ -0,0 +1,10 @@
+#ifndef TEST_INSTRUCTION_SELECTION_H
+#define TEST_INSTRUCTION_SELECTION_H
+
+#include <iostream>
+#include <cassert>
+#include "../instruction_selection.h"
+
+void test_instruction_selection();
+
+#endif
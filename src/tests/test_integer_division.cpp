@@ -0,0 +1,315 @@
+#include <climits>
+#include <map>
+#include "test_integer_division.h"
+
+// Registers and memory (by offset from %rbp) of division_test_run.
+struct division_test_state {
+	std::map<register_id, int> registers;
+	std::map<int, int> memory;
+};
+
+int division_test_read(division_test_state& state, const operand_pointer& op){
+	int ret = 0;
+
+	switch(get_operand_addressing(op)){
+		case operand_addressing::IMMEDIATE:
+			ret = op->value.imm.val.ival;
+			break;
+
+		case operand_addressing::REGISTER:
+			ret = state.registers[op->value.reg];
+			break;
+
+		default:
+			ret = state.memory[op->value.mem.offset];
+	}
+
+	return ret;
+}
+
+void division_test_write(division_test_state& state,
+						const operand_pointer& op,
+						int value){
+	if(get_operand_addressing(op) == operand_addressing::REGISTER){
+		state.registers[op->value.reg] = value;
+	}
+	else{
+		state.memory[op->value.mem.offset] = value;
+	}
+}
+
+/* Runs code, as the processor would: 32-bit arithmetic, wrapping around.
+ * Only the instructions emitted by translate_integer_division are
+ * understood. */
+void division_test_run(const asm_instructions_list& code,
+						division_test_state& state){
+	for(asm_instructions_list::const_iterator it = code.begin();
+	it != code.end(); ++it){
+		const asm_instruction_pointer& inst = *it;
+		unsigned int s = 0, d = 0;
+
+		if(inst->source != nullptr){
+			s = (unsigned int) division_test_read(state, inst->source);
+		}
+		if(inst->destination != nullptr){
+			d = (unsigned int) division_test_read(state, inst->destination);
+		}
+
+		switch(inst->op){
+			case operation::MOV:
+				division_test_write(state, inst->destination, (int) s);
+				break;
+
+			case operation::ADD:
+				division_test_write(state, inst->destination, (int) (d + s));
+				break;
+
+			case operation::SUB:
+				division_test_write(state, inst->destination, (int) (d - s));
+				break;
+
+			case operation::AND:
+				division_test_write(state, inst->destination, (int) (d & s));
+				break;
+
+			case operation::NEG:
+				division_test_write(state, inst->destination, (int) (0u - d));
+				break;
+
+			case operation::SAR:
+				division_test_write(state, inst->destination, (int) d >> s);
+				break;
+
+			case operation::SHR:
+				division_test_write(state, inst->destination, (int) (d >> s));
+				break;
+
+			case operation::IMUL:
+				if(inst->source != nullptr){
+					division_test_write(state, inst->destination,
+										(int) (d * s));
+				}
+				else{
+					// {one-operand form}
+					long long product = (long long) state.registers[register_id::EAX]
+										* (int) d;
+					state.registers[register_id::EAX] = (int) product;
+					state.registers[register_id::EDX] = (int) (product >> 32);
+				}
+				break;
+
+			case operation::CLTD:
+				state.registers[register_id::EDX] =
+							state.registers[register_id::EAX] < 0 ? -1 : 0;
+				break;
+
+			case operation::IDIV:{
+				long long dividend =
+					(long long) ((unsigned long long)
+						(unsigned int) state.registers[register_id::EDX] << 32 |
+						(unsigned int) state.registers[register_id::EAX]);
+
+				state.registers[register_id::EAX] = (int) (dividend / (int) d);
+				state.registers[register_id::EDX] = (int) (dividend % (int) d);
+				break;
+			}
+
+			default:
+				assert(false);
+		}
+	}
+}
+
+// Is there any idiv into code?
+bool has_idiv(const asm_instructions_list& code){
+	bool ret = false;
+
+	for(asm_instructions_list::const_iterator it = code.begin();
+	it != code.end(); ++it){
+		ret = ret || (*it)->op == operation::IDIV;
+	}
+
+	return ret;
+}
+
+/* Translates x = y / d and x = y % d, with y into memory or into a register,
+ * and checks the results of the translation, for many dividends. */
+void check_division_by(int d){
+	const int dividends[] = {0, 1, -1, 2, -2, 3, -3, 5, -5, 6, -6, 7, -7, 9,
+							-9, 99, -99, 100, -100, 641, -641, 12345, -12345,
+							65536, -65536, 1 << 30, -(1 << 30), INT_MAX,
+							INT_MAX - 1, INT_MIN, INT_MIN + 1, 2147483,
+							-2147483, 1000000007, -1000000007};
+	operand_pointer x = new_memory_operand(-4, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer y_operands[] = {new_memory_operand(-8, register_id::RBP,
+														register_id::NONE, 1),
+									new_register_operand(register_id::R10D)};
+
+	for(unsigned int remainder = 0; remainder < 2; remainder++){
+		for(unsigned int j = 0; j < 2; j++){
+			asm_instructions_list code;
+			translate_integer_division(code, x, y_operands[j],
+										new_immediate_integer_operand(d),
+										remainder == 1,
+										register_id::R9D);
+			assert(!has_idiv(code));
+
+			for(unsigned int i = 0; i < sizeof(dividends) / sizeof(int); i++){
+				int y = dividends[i];
+				int expected;
+
+				if(y == INT_MIN && d == -1){
+					// It wraps around.
+					expected = remainder ? 0 : INT_MIN;
+				}
+				else{
+					expected = remainder ? y % d : y / d;
+				}
+
+				division_test_state state;
+				division_test_write(state, y_operands[j], y);
+				division_test_run(code, state);
+				assert(state.memory[-4] == expected);
+				// y is kept.
+				assert(division_test_read(state, y_operands[j]) == y);
+			}
+		}
+	}
+}
+
+void test_division_magic(){
+	std::cout << "1) Magic numbers: ";
+
+	// From the tables of [1] (10-4).
+	division_magic magic = get_division_magic(3);
+	assert(magic.multiplier == 0x55555556 && magic.shift == 0);
+	magic = get_division_magic(5);
+	assert(magic.multiplier == 0x66666667 && magic.shift == 1);
+	magic = get_division_magic(7);
+	assert(magic.multiplier == (int) 0x92492493 && magic.shift == 2);
+	magic = get_division_magic(-5);
+	assert(magic.multiplier == (int) 0x99999999 && magic.shift == 1);
+	magic = get_division_magic(-7);
+	assert(magic.multiplier == 0x6DB6DB6D && magic.shift == 2);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_division_by_constants(){
+	std::cout << "2) Division and modulo by constants: ";
+
+	const int divisors[] = {2, 3, 4, 5, 6, 7, 8, 9, 10, 16, 25, 100, 125, 641,
+							1000, 1 << 30, 1000000007, INT_MAX, -2, -3, -4,
+							-5, -7, -8, -10, -16, -100, -641, -(1 << 30),
+							-INT_MAX, INT_MIN, 1, -1};
+
+	for(unsigned int i = 0; i < sizeof(divisors) / sizeof(int); i++){
+		check_division_by(divisors[i]);
+	}
+
+	// Powers of two: sar, with the sign correction, and and.
+	asm_instructions_list code;
+	operand_pointer x = new_register_operand(register_id::R11D);
+	operand_pointer y = new_register_operand(register_id::R10D);
+	operand_pointer eax = new_register_operand(register_id::EAX);
+	operand_pointer edx = new_register_operand(register_id::EDX);
+	translate_integer_division(code, x, y, new_immediate_integer_operand(8),
+								false,
+								register_id::R9D);
+	assert(code.size() == 7);
+	assert(is_sar_instruction(code[2], new_immediate_integer_operand(31), edx,
+							data_type::L));
+	assert(is_shr_instruction(code[3], new_immediate_integer_operand(29), edx,
+							data_type::L));
+	assert(is_sar_instruction(code[5], new_immediate_integer_operand(3), eax,
+							data_type::L));
+
+	code.clear();
+	translate_integer_division(code, x, y, new_immediate_integer_operand(8),
+								true,
+								register_id::R9D);
+	assert(is_and_instruction(code[5], new_immediate_integer_operand(7), eax,
+							data_type::L));
+
+	// Other divisors: multiplication by the magic number.
+	code.clear();
+	translate_integer_division(code, x, y, new_immediate_integer_operand(7),
+								false,
+								register_id::R9D);
+	assert(is_mov_instruction(code[0],
+							new_immediate_integer_operand((int) 0x92492493),
+							eax,
+							data_type::L));
+	assert(is_widening_mul_instruction(code[1], y, data_type::L, true));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_division_by_variables(){
+	std::cout << "3) Division by variables and folding: ";
+
+	operand_pointer x = new_memory_operand(-4, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer y = new_memory_operand(-8, register_id::RBP,
+											register_id::NONE, 1);
+	operand_pointer z = new_register_operand(register_id::R10D);
+	operand_pointer eax = new_register_operand(register_id::EAX);
+	operand_pointer edx = new_register_operand(register_id::EDX);
+
+	// y is sign-extended by cltd: no save of the registers.
+	asm_instructions_list code;
+	translate_integer_division(code, x, y, z, false, register_id::R9D);
+	assert(code.size() == 4);
+	assert(is_mov_instruction(code[0], y, eax, data_type::L));
+	assert(is_cltd_instruction(code[1]));
+	assert(is_div_instruction(code[2], z, data_type::L, true));
+	assert(is_mov_instruction(code[3], eax, x, data_type::L));
+
+	const int values[][2] = {{7, 2}, {-7, 2}, {7, -2}, {-7, -2}, {0, 5},
+							{INT_MIN, 3}, {INT_MAX, -1}};
+	for(unsigned int remainder = 0; remainder < 2; remainder++){
+		code.clear();
+		translate_integer_division(code, x, y, z, remainder == 1,
+								register_id::R9D);
+
+		for(unsigned int i = 0; i < sizeof(values) / sizeof(values[0]); i++){
+			division_test_state state;
+			state.memory[-8] = values[i][0];
+			state.registers[register_id::R10D] = values[i][1];
+			division_test_run(code, state);
+			assert(state.memory[-4] == (remainder ?
+										values[i][0] % values[i][1] :
+										values[i][0] / values[i][1]));
+		}
+	}
+
+	// Constants are divided at compile time...
+	code.clear();
+	translate_integer_division(code, x, new_immediate_integer_operand(-17),
+								new_immediate_integer_operand(5), true,
+								register_id::R9D);
+	assert(code.size() == 1);
+	assert(is_mov_instruction(code[0], new_immediate_integer_operand(-2), x,
+							data_type::L));
+
+	// ...but not by 0, that is left to idiv.
+	code.clear();
+	translate_integer_division(code, x, y, new_immediate_integer_operand(0),
+								false,
+								register_id::R9D);
+	assert(has_idiv(code));
+	assert(is_mov_instruction(code[0], new_immediate_integer_operand(0),
+							new_register_operand(register_id::R9D),
+							data_type::L));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_integer_division(){
+	std::cout << "\nTesting integer division:" << std::endl;
+
+	test_division_magic();
+	test_division_by_constants();
+	test_division_by_variables();
+}
@@ -0,0 +1,10 @@
+#ifndef TEST_INTEGER_DIVISION_H
+#define TEST_INTEGER_DIVISION_H
+
+#include <iostream>
+#include <cassert>
+#include "../integer_division.h"
+
+void test_integer_division();
+
+#endif
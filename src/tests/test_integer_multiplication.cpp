@@ -0,0 +1,186 @@
+#include <climits>
+#include "test_integer_multiplication.h"
+
+/* Value left into x (%r11d) by code, the translation of x = y * factor,
+ * being y into %r10d: runs the instructions emitted for it, over 32-bit
+ * registers. */
+int multiplication_test_run(const asm_instructions_list& code, int y){
+	unsigned int r8 = 0, x = 0;
+
+	for(asm_instructions_list::const_iterator it = code.begin();
+	it != code.end(); ++it){
+		const asm_instruction_pointer& inst = *it;
+		unsigned int s = 0;
+
+		if(inst->source != nullptr &&
+		get_operand_addressing(inst->source) == operand_addressing::IMMEDIATE){
+			s = (unsigned int) inst->source->value.imm.val.ival;
+		}
+		else if(inst->source != nullptr &&
+		get_operand_addressing(inst->source) == operand_addressing::REGISTER){
+			s = inst->source->value.reg == register_id::R10D ?
+				(unsigned int) y : r8;
+		}
+
+		switch(inst->op){
+			case operation::MOV:
+				if(inst->destination->value.reg == register_id::R8D){
+					r8 = s;
+				}
+				else{
+					x = s;
+				}
+				break;
+
+			case operation::LEA:
+				assert(inst->source->value.mem.base == register_id::R8 &&
+						inst->source->value.mem.index == register_id::R8);
+				r8 = r8 + r8*inst->source->value.mem.scale;
+				break;
+
+			case operation::SHL:
+				r8 <<= s;
+				break;
+
+			case operation::ADD:
+				r8 += s;
+				break;
+
+			case operation::SUB:
+				r8 -= s;
+				break;
+
+			case operation::NEG:
+				r8 = 0u - r8;
+				break;
+
+			case operation::IMUL:
+				r8 *= s;
+				break;
+
+			default:
+				assert(false);
+		}
+	}
+
+	return (int) x;
+}
+
+// Is there any imul into code?
+bool has_imul(const asm_instructions_list& code){
+	bool ret = false;
+
+	for(asm_instructions_list::const_iterator it = code.begin();
+	it != code.end(); ++it){
+		ret = ret || (*it)->op == operation::IMUL;
+	}
+
+	return ret;
+}
+
+void test_multiplication_steps(){
+	std::cout << "1) Steps cheaper than imul: ";
+
+	std::vector<multiplication_step> steps;
+
+	// A lea, or a shift.
+	assert(get_multiplication_steps(9, steps));
+	assert(steps.size() == 1 && steps[0].kind == multiplication_step_kind::LEA &&
+			steps[0].amount == 8);
+	assert(get_multiplication_steps(16, steps));
+	assert(steps.size() == 1 && steps[0].kind == multiplication_step_kind::SHL &&
+			steps[0].amount == 4);
+	assert(get_multiplication_steps(INT_MIN, steps));
+	assert(steps.size() == 1 && steps[0].kind == multiplication_step_kind::SHL &&
+			steps[0].amount == 31);
+
+	// Two of them: 45 = 5 * 9, 40 = 5 * 8, 7 = 8 - 1, -4 = -(4).
+	assert(get_multiplication_steps(45, steps));
+	assert(steps.size() == 2 && steps[0].kind == multiplication_step_kind::LEA &&
+			steps[1].kind == multiplication_step_kind::LEA);
+	assert(get_multiplication_steps(40, steps) && steps.size() == 2);
+	assert(get_multiplication_steps(7, steps));
+	assert(steps.size() == 2 && steps[0].kind == multiplication_step_kind::SHL &&
+			steps[1].kind == multiplication_step_kind::SUB);
+	assert(get_multiplication_steps(-4, steps) && steps.size() == 2);
+
+	// Three steps take as long as imul.
+	assert(!get_multiplication_steps(11, steps));
+	assert(!get_multiplication_steps(1000, steps));
+
+	assert(get_multiplication_steps(1, steps) && steps.empty());
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_multiplication_translation(){
+	std::cout << "2) Translation of products: ";
+
+	operand_pointer x = new_register_operand(register_id::R11D);
+	operand_pointer y = new_register_operand(register_id::R10D);
+	const int values[] = {0, 1, -1, 2, -2, 7, -7, 1000, -1000, 46341, INT_MAX,
+						INT_MIN};
+
+	for(int factor = -300; factor <= 300; factor++){
+		std::vector<multiplication_step> steps;
+		asm_instructions_list code;
+		translate_integer_multiplication(code, x, y,
+										new_immediate_integer_operand(factor),
+										register_id::R8D);
+		assert(has_imul(code) ==
+				(factor != 0 && !get_multiplication_steps(factor, steps)));
+
+		for(unsigned int i = 0; i < sizeof(values) / sizeof(int); i++){
+			assert(multiplication_test_run(code, values[i]) ==
+					(int) ((unsigned int) values[i] * (unsigned int) factor));
+		}
+	}
+
+	// x = 4 * y: the constant may be the first operand.
+	asm_instructions_list code;
+	operand_pointer r8d = new_register_operand(register_id::R8D);
+	translate_integer_multiplication(code, x, new_immediate_integer_operand(4),
+									y,
+									register_id::R8D);
+	assert(code.size() == 3);
+	assert(is_mov_instruction(code[0], y, r8d, data_type::L));
+	assert(is_shl_instruction(code[1], new_immediate_integer_operand(2), r8d,
+							data_type::L));
+	assert(is_mov_instruction(code[2], r8d, x, data_type::L));
+
+	// x = y * 5: lea (%r8, %r8, 4), %r8d.
+	code.clear();
+	translate_integer_multiplication(code, x, y,
+									new_immediate_integer_operand(5),
+									register_id::R8D);
+	assert(is_lea_instruction(code[1],
+							new_memory_operand(0, register_id::R8,
+												register_id::R8, 4),
+							r8d,
+							data_type::L));
+
+	// Constants are multiplied at compile time.
+	code.clear();
+	translate_integer_multiplication(code, x,
+									new_immediate_integer_operand(65536),
+									new_immediate_integer_operand(65537),
+									register_id::R8D);
+	assert(code.size() == 1);
+	assert(is_mov_instruction(code[0], new_immediate_integer_operand(65536), x,
+							data_type::L));
+
+	// Variables.
+	code.clear();
+	translate_integer_multiplication(code, x, y, x, register_id::R8D);
+	assert(code.size() == 3);
+	assert(is_mul_instruction(code[1], x, r8d, data_type::L, true));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_integer_multiplication(){
+	std::cout << "\nTesting integer multiplication:" << std::endl;
+
+	test_multiplication_steps();
+	test_multiplication_translation();
+}
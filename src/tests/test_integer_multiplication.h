@@ -0,0 +1,10 @@
+#ifndef TEST_INTEGER_MULTIPLICATION_H
+#define TEST_INTEGER_MULTIPLICATION_H
+
+#include <iostream>
+#include <cassert>
+#include "../integer_multiplication.h"
+
+void test_integer_multiplication();
+
+#endif
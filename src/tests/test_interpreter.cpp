@@ -0,0 +1,176 @@
+#include <sstream>
+#include "test_interpreter.h"
+#include "test_helpers.h"
+#include "../pass_manager.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+// Sum of the factorials of 0 to 4, with recursive calls.
+const std::string factorials_program("C.fact:\n"
+									"enter 12\n"
+									"if n@0 > 1 goto L1\n"
+									"return 1\n"
+									"L1:\n"
+									"param this@0\n"
+									"@t0 = n@0 - 1\n"
+									"param @t0\n"
+									"@t1 = call C.fact , 1\n"
+									"@t2 = n@0 * @t1\n"
+									"return @t2\n"
+									"C.main:\n"
+									"enter 16\n"
+									"i@0 = 0\n"
+									"s@0 = 0\n"
+									"L2:\n"
+									"if i@0 >= 5 goto L3\n"
+									"param this@1\n"
+									"param i@0\n"
+									"@t3 = call C.fact , 1\n"
+									"s@0 = s@0 + @t3\n"
+									"i@0 = i@0 + 1\n"
+									"goto L2\n"
+									"L3:\n"
+									"return s@0");
+
+void register_factorials_ids(ids_info& ids){
+	// this@0 and n@0; this@1.
+	register_test_method(ids, "fact", {"n"}, {}, {});
+	register_test_method(ids, "main", {}, {}, {});
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("s"), 4, T_INT, false);
+	// @t0 to @t3.
+	for(unsigned int i = 0; i < 4; i++){
+		ids.new_temp(0, T_INT);
+	}
+}
+
+void test_arithmetic_and_calls(){
+	std::cout << "1) Arithmetic, jumps and calls: ";
+
+	ids_info ids;
+	register_factorials_ids(ids);
+	translate_ir_code(factorials_program);
+
+	ir_interpreter interpreter(*ir_code, ids);
+	assert(interpreter.run("C.main") == "");
+	assert(interpreter.get_result().type == ir_value_type::INTEGER);
+	assert(interpreter.get_result().ival == 34);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_objects_and_externs(){
+	std::cout << "2) Objects and extern methods: ";
+
+	ids_info ids;
+	// this@0 and v@0; this@1.
+	register_test_method(ids, "add", {"v"}, {"v"}, {});
+	register_test_method(ids, "main", {}, {}, {});
+	register_test_method(ids, "read_int", {}, {}, {});
+	register_test_method(ids, "print_int", {"y"}, {}, {});
+	translate_ir_code(std::string("C.read_int:\n"
+								"enter 0\n"
+								"C.print_int:\n"
+								"enter 0\n"
+								"C.add:\n"
+								"enter 12\n"
+								"@t1 = v@0[0]\n"
+								"@t2 = v@0[4]\n"
+								"@t3 = @t1 + @t2\n"
+								"v@0[8] = @t3\n"
+								"C.main:\n"
+								"enter 12\n"
+								"param this@1\n"
+								"@t0 = call C.read_int , 0\n"
+								"a[0] = @t0\n"
+								"a[4] = 7\n"
+								"param this@1\n"
+								"param a\n"
+								"call C.add , 1\n"
+								"@t4 = a[8]\n"
+								"param this@1\n"
+								"param @t4\n"
+								"call C.print_int , 1\n"
+								"return @t4"));
+
+	std::istringstream in("5");
+	std::ostringstream out;
+	ir_interpreter interpreter(*ir_code, ids);
+	interpreter.set_input(in);
+	interpreter.set_output(out);
+	// The storage of a, modified by the callee.
+	assert(interpreter.run("C.main") == "");
+	assert(out.str() == "12");
+	assert(interpreter.get_result().ival == 12);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_errors(){
+	std::cout << "3) Errors: ";
+
+	ids_info ids;
+	translate_ir_code(std::string("C.f:\n"
+								"enter 0\n"
+								"x = 0\n"
+								"y = 1 / x\n"
+								"return y\n"
+								"C.g:\n"
+								"enter 0\n"
+								"L1:\n"
+								"goto L1\n"
+								"C.h:\n"
+								"enter 0\n"
+								"y = x + 1\n"
+								"return y\n"
+								"C.k:\n"
+								"enter 0\n"
+								"x = 1\n"
+								"param x\n"
+								"call C.write , 0\n"
+								"return 0"));
+
+	ir_interpreter interpreter(*ir_code, ids);
+	interpreter.set_step_limit(1000);
+	assert(interpreter.run("C.f").find("Division by zero.") == 0);
+	assert(interpreter.run("C.g").find("Step limit exceeded.") == 0);
+	assert(interpreter.get_executed_quads() == 1001);
+	assert(interpreter.run("C.h").find("Read of x, never written.") == 0);
+	assert(interpreter.run("C.k").find("No host function") == 0);
+	assert(interpreter.run("C.m") == "Method C.m is not defined.");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_optimized_code(){
+	std::cout << "4) Same results after the optimization passes: ";
+
+	ids_info ids;
+	register_factorials_ids(ids);
+	translate_ir_code(factorials_program);
+
+	instructions_list code = *ir_code;
+	ir_interpreter original(code, ids);
+	assert(original.run("C.main") == "");
+
+	pass_manager passes(MAX_OPTIMIZATION_LEVEL);
+	passes.run_ir_passes(code, ids);
+
+	ir_interpreter optimized(code, ids);
+	assert(optimized.run("C.main") == "");
+	assert(optimized.get_result().ival == original.get_result().ival);
+	// fact is inlined into the loop.
+	assert(optimized.get_executed_quads() < original.get_executed_quads());
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_interpreter(){
+	std::cout << "\nTesting interpreter:" << std::endl;
+
+	test_arithmetic_and_calls();
+	test_objects_and_externs();
+	test_errors();
+	test_optimized_code();
+}
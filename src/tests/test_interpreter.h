@@ -0,0 +1,10 @@
+#ifndef TEST_INTERPRETER_H
+#define TEST_INTERPRETER_H
+
+#include <iostream>
+#include <cassert>
+#include "../interpreter.h"
+
+void test_interpreter();
+
+#endif
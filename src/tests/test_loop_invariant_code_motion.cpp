@@ -0,0 +1,150 @@
+#include "test_loop_invariant_code_motion.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+void test_while_loop(){
+	std::cout << "1) Invariants of a while loop: ";
+
+	ids_info ids;
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("s"), 4, T_INT, false);
+	ids.register_var(std::string("t"), 8, T_INT, false);
+	ids.register_var(std::string("u"), 12, T_INT, false);
+	ids.register_var(std::string("v"), 16, T_INT, false);
+	ids.register_var(std::string("w"), 20, T_INT, false);
+	ids.register_var(std::string("x"), 24, T_INT, false);
+	translate_ir_code(std::string("C.m:\n"
+								"enter 28\n"
+								"i@0 = 0\n"
+								"s@0 = 0\n"
+								"L1:\n"
+								"if i@0 >= n@0 goto L2\n"
+								"t@0 = a@0 * 4\n"
+								"u@0 = t@0 + 1\n"
+								"v@0 = u@0 + i@0\n"
+								"w@0 = n@0 / d@0\n"
+								"x@0 = b@0[k@0]\n"
+								"s@0 = s@0 + v@0\n"
+								"s@0 = s@0 + w@0\n"
+								"s@0 = s@0 + x@0\n"
+								"i@0 = i@0 + 1\n"
+								"goto L1\n"
+								"L2:\n"
+								"return s@0"));
+
+	instructions_list method = *ir_code;
+	build_ssa(method, ids);
+
+	/* The computations from a@0 leave the loop. The division and the load
+	 * don't: they are not executed when the loop ends at its header. */
+	assert(hoist_loop_invariants(method, ids) == 2);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 80\n"
+			"i@0@1 = 0\n"
+			"s@0@1 = 0\n"
+			"@t1:\n"
+			"t@0@1 = a@0 * 4\n"
+			"u@0@1 = t@0@1 + 1\n"
+			"L1:\n"
+			"i@0@2 = phi(@t1: i@0@1, @t0: i@0@3)\n"
+			"s@0@2 = phi(@t1: s@0@1, @t0: s@0@5)\n"
+			"if i@0@2 >= n@0 goto L2\n"
+			"@t0:\n"
+			"v@0@1 = u@0@1 + i@0@2\n"
+			"w@0@1 = n@0 / d@0\n"
+			"x@0@1= b@0[k@0]\n"
+			"s@0@3 = s@0@2 + v@0@1\n"
+			"s@0@4 = s@0@3 + w@0@1\n"
+			"s@0@5 = s@0@4 + x@0@1\n"
+			"i@0@3 = i@0@2 + 1\n"
+			"goto L1\n"
+			"L2:\n"
+			"return s@0@2\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_loop_memory(){
+	std::cout << "2) Loads and divisions executed on every iteration: ";
+
+	ids_info ids;
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("t"), 4, T_INT, false);
+	ids.register_var(std::string("u"), 8, T_INT, false);
+	ids.register_var(std::string("x"), 12, T_INT, false);
+	translate_ir_code(std::string("C.m:\n"
+								"enter 16\n"
+								"i@0 = 0\n"
+								"L1:\n"
+								"x@0 = b@0[k@0]\n"
+								"t@0 = n@0 / 3\n"
+								"u@0 = n@0 / d@0\n"
+								"i@0 = i@0 + x@0\n"
+								"i@0 = i@0 + t@0\n"
+								"i@0 = i@0 + u@0\n"
+								"if i@0 < n@0 goto L1\n"
+								"return i@0"));
+
+	instructions_list method = *ir_code;
+	build_ssa(method, ids);
+
+	// The loop exits at the end of its only block.
+	assert(hoist_loop_invariants(method, ids) == 3);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 48\n"
+			"i@0@1 = 0\n"
+			"@t1:\n"
+			"x@0@1= b@0[k@0]\n"
+			"t@0@1 = n@0 / 3\n"
+			"u@0@1 = n@0 / d@0\n"
+			"L1:\n"
+			"i@0@2 = phi(@t1: i@0@1, L1: i@0@5)\n"
+			"i@0@3 = i@0@2 + x@0@1\n"
+			"i@0@4 = i@0@3 + t@0@1\n"
+			"i@0@5 = i@0@4 + u@0@1\n"
+			"if i@0@5 < n@0 goto L1\n"
+			"@t0:\n"
+			"return i@0@5\n");
+
+	// A store into the loop keeps the load.
+	translate_ir_code(std::string("C.m:\n"
+								"enter 16\n"
+								"i@0 = 0\n"
+								"L1:\n"
+								"x@0 = b@0[k@0]\n"
+								"t@0 = n@0 / 3\n"
+								"i@0 = i@0 + x@0\n"
+								"b@0[i@0] = t@0\n"
+								"if i@0 < n@0 goto L1\n"
+								"return i@0"));
+	method = *ir_code;
+	build_ssa(method, ids);
+
+	assert(hoist_loop_invariants(method, ids) == 1);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 36\n"
+			"i@0@1 = 0\n"
+			"@t3:\n"
+			"t@0@1 = n@0 / 3\n"
+			"L1:\n"
+			"i@0@2 = phi(@t3: i@0@1, L1: i@0@3)\n"
+			"x@0@1= b@0[k@0]\n"
+			"i@0@3 = i@0@2 + x@0@1\n"
+			"b@0[i@0@3] = t@0@1\n"
+			"if i@0@3 < n@0 goto L1\n"
+			"@t2:\n"
+			"return i@0@3\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_loop_invariant_code_motion(){
+	std::cout << "\nTesting loop-invariant code motion:" << std::endl;
+
+	test_while_loop();
+	test_loop_memory();
+}
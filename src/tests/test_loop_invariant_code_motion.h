@@ -0,0 +1,11 @@
+#ifndef TEST_LOOP_INVARIANT_CODE_MOTION_H
+#define TEST_LOOP_INVARIANT_CODE_MOTION_H
+
+#include <iostream>
+#include <cassert>
+#include "../loop_invariant_code_motion.h"
+#include "../ssa.h"
+
+void test_loop_invariant_code_motion();
+
+#endif
@@ -0,0 +1,174 @@
+#include "test_pass_manager.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+// Statistics of pass, or nullptr if it didn't run.
+const pass_statistics* find_statistics(const pass_manager& manager,
+										const std::string& pass){
+	const std::vector<pass_statistics>& statistics = manager.get_statistics();
+
+	for(std::vector<pass_statistics>::const_iterator it = statistics.begin();
+	it != statistics.end(); ++it){
+		if(it->pass == pass){
+			return &(*it);
+		}
+	}
+
+	return nullptr;
+}
+
+void test_optimization_levels(){
+	std::cout << "1) Optimization levels: ";
+
+	ids_info ids;
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("s"), 4, T_INT, false);
+	ids.register_var(std::string("t"), 8, T_INT, false);
+	std::string program("C.m:\n"
+						"enter 12\n"
+						"i@0 = 0\n"
+						"s@0 = 0\n"
+						"L1:\n"
+						"if i@0 >= 10 goto L2\n"
+						"t@0 = 2 * 4\n"
+						"s@0 = s@0 + t@0\n"
+						"i@0 = i@0 + 1\n"
+						"goto L1\n"
+						"L2:\n"
+						"return s@0");
+	translate_ir_code(program);
+
+	instructions_list code = *ir_code;
+	pass_manager o0(0);
+	o0.set_verification(true);
+	o0.run_ir_passes(code, ids);
+	assert(print_instructions_list(code) == print_instructions_list(*ir_code));
+	assert(o0.get_statistics().empty());
+
+	pass_manager o2(2);
+	o2.set_verification(true);
+	o2.run_ir_passes(code, ids);
+	// The invariant is folded, and then propagated into the loop, whose test
+	// is placed after its body.
+	assert(print_instructions_list(code) ==
+			"C.m:\n"
+			"enter 40\n"
+			"i@0@2 = 0\n"
+			"s@0@2 = 0\n"
+			"goto L1\n"
+			"@t2:\n"
+			"s@0@3 = s@0@2 + 8\n"
+			"i@0@3 = i@0@2 + 1\n"
+			"i@0@2 = i@0@3\n"
+			"s@0@2 = s@0@3\n"
+			"L1:\n"
+			"if i@0@2 < 10 goto @t2\n"
+			"L2:\n"
+			"return s@0@2\n");
+	// Every pass of -O2 runs, in order, and the SSA form is built once.
+	const char* order[] = {"inline", "tail-recursion", "fold", "build-ssa",
+							"sccp", "gvn", "copy-propagation", "licm",
+							"strength-reduction", "dead-quads", "destroy-ssa",
+							"coalesce", "dce", "block-placement"};
+	assert(o2.get_statistics().size() == 14);
+	for(unsigned int i = 0; i < 14; i++){
+		assert(o2.get_statistics()[i].pass == order[i]);
+	}
+	assert(find_statistics(o2, "fold")->changes == 1);
+	assert(find_statistics(o2, "sccp")->changes == 3);
+
+	// -O1 leaves the passes of -O2 out.
+	code = *ir_code;
+	pass_manager o1(1);
+	o1.run_ir_passes(code, ids);
+	assert(find_statistics(o1, "sccp") != nullptr);
+	assert(find_statistics(o1, "gvn") == nullptr);
+	assert(find_statistics(o1, "inline") == nullptr);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_pass_selection(){
+	std::cout << "2) Passes selected by name: ";
+
+	ids_info ids;
+	translate_ir_code(std::string("C.m:\n"
+								"enter 0\n"
+								"goto L1\n"
+								"L1:\n"
+								"x = 2 * 3\n"
+								"return x"));
+
+	instructions_list code = *ir_code;
+	pass_manager manager(0);
+
+	assert(!manager.select_passes(std::string("fold,unrolling")));
+	assert(manager.select_passes(std::string("dce,fold,asm-jumps")));
+	manager.run_ir_passes(code, ids);
+	// The jump to the next quad and its label are removed.
+	assert(print_instructions_list(code) ==
+			"C.m:\n"
+			"enter 0\n"
+			"x = 6\n"
+			"return x\n");
+	assert(manager.get_statistics().size() == 2);
+	assert(find_statistics(manager, "fold")->changes == 1);
+	assert(find_statistics(manager, "dce")->changes == 2);
+
+	asm_instructions_list assembly;
+	assembly.push_back(new_label_instruction(std::string("C.m")));
+	assembly.push_back(new_jmp_instruction(std::string("L1")));
+	assembly.push_back(new_label_instruction(std::string("L1")));
+	assembly.push_back(new_jmp_instruction(std::string("C.m")));
+	manager.run_asm_passes(assembly);
+	assert(assembly.size() == 3);
+	assert(find_statistics(manager, "asm-jumps")->changes == 1);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_ir_verifier(){
+	std::cout << "3) Verification of the IR: ";
+
+	translate_ir_code(std::string("C.m:\n"
+								"enter 0\n"
+								"L1:\n"
+								"goto L1\n"
+								"C.n:\n"
+								"enter 0\n"
+								"goto L2\n"
+								"L2:\n"
+								"return 0"));
+
+	instructions_list code = *ir_code;
+	// x = phi(C.m: y, L1: x), after L1.
+	quad_pointer phi = new_phi_inst(new_name_address(std::string("x")),
+									new_name_address(std::string("x")));
+	add_phi_argument(phi, new_name_address(std::string("y")),
+					new_label_address(std::string("C.m")));
+	add_phi_argument(phi, new_name_address(std::string("x")),
+					new_label_address(std::string("L1")));
+	code.insert(code.begin() + 3, phi);
+
+	assert(verify_ir(code, true) == "");
+	assert(verify_ir(code, false) == "PHI out of SSA form, at quad 3 of C.m");
+
+	// A jump into another method.
+	code[7]->arg1 = new_label_address(std::string("L1"));
+	assert(verify_ir(code, true) == "jump to L1, not a label of its method");
+
+	// A label defined twice.
+	code[8]->arg1 = new_label_address(std::string("L1"));
+	assert(verify_ir(code, true) == "label L1 defined twice, at quad 3 of C.n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_pass_manager(){
+	std::cout << "\nTesting pass manager:" << std::endl;
+
+	test_optimization_levels();
+	test_pass_selection();
+	test_ir_verifier();
+}
@@ -0,0 +1,10 @@
+#ifndef TEST_PASS_MANAGER_H
+#define TEST_PASS_MANAGER_H
+
+#include <iostream>
+#include <cassert>
+#include "../pass_manager.h"
+
+void test_pass_manager();
+
+#endif
@@ -0,0 +1,198 @@
+#include "test_peephole.h"
+#include "../pass_manager.h"
+
+extern asm_instructions_list *asm_code;
+extern void translate_asm_code(std::string program);
+
+std::string print_peephole_test_code(const asm_instructions_list& code){
+	std::string ret;
+
+	for(asm_instructions_list::const_iterator it = code.begin();
+	it != code.end(); ++it){
+		ret += print_intel_syntax(*it);
+	}
+
+	return ret;
+}
+
+// Runs the rules of get_peephole_rules over program, returning the code
+// left.
+std::string peephole_test_run(const std::string& program,
+							peephole_optimizer& optimizer){
+	translate_asm_code(program);
+	asm_instructions_list code = *asm_code;
+	optimizer.run(code);
+
+	return print_peephole_test_code(code);
+}
+
+void test_peephole_rules_language(){
+	std::cout << "1) Rules and their hits: ";
+
+	// andl $-1 is a no-op but for the flags; addl y,x; subl y,x too.
+	std::vector<peephole_rule> rules = {
+		{"and-all-ones", "andl $-1 , x1", "", nullptr},
+		{"add-sub", "add x1 , r1 ; sub x1 , r1", "", nullptr}
+	};
+	peephole_optimizer optimizer(rules);
+	assert(optimizer.print_hits() == "");
+
+	std::string code = peephole_test_run("andl $-1, %r10d\n"
+										"addl -4(%rbp), %r11d\n"
+										"subl -4(%rbp), %r11d\n"
+										"addl -4(%rbp), %r11d\n"
+										"subl -8(%rbp), %r11d\n"
+										"cltd",
+										optimizer);
+	assert(code == "\taddl -4(%rbp, 0, 1) , %r11d\n"
+					"\tsubl -8(%rbp, 0, 1) , %r11d\n"
+					"\tcltd\n");
+	assert(optimizer.get_hits().size() == 2);
+	assert(optimizer.get_hits()[0] == 1 and optimizer.get_hits()[1] == 1);
+
+	// Counts along every run.
+	peephole_test_run("andl $-1, %r10d", optimizer);
+	assert(optimizer.get_hits()[0] == 2);
+	assert(optimizer.print_hits() == "peephole and-all-ones: 2 hits.\n"
+									 "peephole add-sub: 1 hits.\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_peephole_moves(){
+	std::cout << "2) Round trips, reloads and dead writes: ";
+
+	peephole_optimizer optimizer(get_peephole_rules());
+
+	// jmp to the next label.
+	assert(peephole_test_run("jmp L1\n"
+							"L1:\n"
+							"jmp L2\n"
+							"L3:\n",
+							optimizer) ==
+			" L1\n\tjmp L2\n L3\n");
+
+	// A round trip, and a store followed by a reload into another register.
+	assert(peephole_test_run("movl %r10d, -4(%rbp)\n"
+							"movl -4(%rbp), %r10d\n"
+							"movl -4(%rbp), %r11d",
+							optimizer) ==
+			"\tmovl %r10d , -4(%rbp, 0, 1)\n"
+			"\tmovl %r10d , %r11d\n");
+
+	// The first mov changes the address of the second one.
+	std::string kept = "\tmovl 0(%r9, 0, 1) , %r9\n"
+					   "\tmovl %r9 , 0(%r9, 0, 1)\n";
+	assert(peephole_test_run("movl 0(%r9), %r9\n"
+							"movl %r9, 0(%r9)",
+							optimizer) == kept);
+
+	// A register written twice, but read by the second write.
+	assert(peephole_test_run("movl %r8d, %edx\n"
+							"movl $3, %edx\n"
+							"movl %r10d, %r11d\n"
+							"movl 4(%r11), %r11d",
+							optimizer) ==
+			"\tmovl $3 , %edx\n"
+			"\tmovl %r10d , %r11d\n"
+			"\tmovl 4(%r11, 0, 1) , %r11d\n");
+
+	assert(optimizer.get_hits()[0] == 1);
+	assert(optimizer.get_hits()[1] == 1);
+	assert(optimizer.get_hits()[2] == 1);
+	assert(optimizer.get_hits()[3] == 1);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_peephole_divisions_and_zeros(){
+	std::cout << "3) Consecutive divisions and zeros: ";
+
+	peephole_optimizer optimizer(get_peephole_rules());
+
+	// %edx, saved around each division: it is restored once, at the end.
+	assert(peephole_test_run("movl %edx, %r8d\n"
+							"movl -4(%rbp), %eax\n"
+							"cltd\n"
+							"idivl %r10d\n"
+							"movl %eax, %r11d\n"
+							"movl %r8d, %edx\n"
+							"movl %edx, %r8d\n"
+							"movl -8(%rbp), %eax\n"
+							"cltd\n"
+							"idivl %r10d\n"
+							"movl %eax, %r11d\n"
+							"movl %r8d, %edx",
+							optimizer) ==
+			"\tmovl %edx , %r8d\n"
+			"\tmovl -4(%rbp, 0, 1) , %eax\n"
+			"\tcltd\n"
+			"\tidivl %r10d\n"
+			"\tmovl %eax , %r11d\n"
+			"\tmovl -8(%rbp, 0, 1) , %eax\n"
+			"\tcltd\n"
+			"\tidivl %r10d\n"
+			"\tmovl %eax , %r11d\n"
+			"\tmovl %r8d , %edx\n");
+	assert(optimizer.get_hits()[1] == 1);
+	assert(optimizer.get_hits()[4] == 1);
+
+	// Zeros into registers, but for the flags read by a jump.
+	assert(peephole_test_run("movl $0, %r10d\n"
+							"addl $2, %r10d\n"
+							"cmpl $1, %r11d\n"
+							"movl $0, %r11d\n"
+							"jl L1\n"
+							"movl $0, -4(%rbp)\n"
+							"movl $0, %r11d\n"
+							"L1:\n"
+							"movl $0, %r11d\n"
+							"call C.m",
+							optimizer) ==
+			"\txorl %r10d , %r10d\n"
+			"\taddl $2 , %r10d\n"
+			"\tcmpl $1 , %r11d\n"
+			"\tmovl $0 , %r11d\n"
+			"\tjl L1\n"
+			"\tmovl $0 , -4(%rbp, 0, 1)\n"
+			"\tmovl $0 , %r11d\n"
+			" L1\n"
+			"\txorl %r11d , %r11d\n"
+			"\tcall C.m\n");
+	assert(optimizer.get_hits()[5] == 2);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_peephole_pass(){
+	std::cout << "4) Peephole pass: ";
+
+	pass_manager manager(0);
+	assert(manager.select_passes(std::string("peephole")));
+
+	asm_instructions_list code;
+	code.push_back(new_mov_instruction(new_immediate_integer_operand(0),
+									new_register_operand(register_id::R10D),
+									data_type::L));
+	code.push_back(new_leave_instruction());
+	code.push_back(new_ret_instruction());
+	manager.run_asm_passes(code);
+	assert(code.size() == 3);
+	assert(is_xor_instruction(code[0], new_register_operand(register_id::R10D),
+							new_register_operand(register_id::R10D),
+							data_type::L));
+	assert(manager.get_statistics().size() == 1);
+	assert(manager.get_statistics()[0].pass == "peephole");
+	assert(manager.get_statistics()[0].changes == 1);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_peephole(){
+	std::cout << "\nTesting peephole optimization:" << std::endl;
+
+	test_peephole_rules_language();
+	test_peephole_moves();
+	test_peephole_divisions_and_zeros();
+	test_peephole_pass();
+}
@@ -0,0 +1,10 @@
+#ifndef TEST_PEEPHOLE_H
+#define TEST_PEEPHOLE_H
+
+#include <iostream>
+#include <cassert>
+#include "../peephole.h"
+
+void test_peephole();
+
+#endif
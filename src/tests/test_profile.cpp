@@ -0,0 +1,159 @@
+#include <sstream>
+#include "test_profile.h"
+#include "test_helpers.h"
+#include "../interpreter.h"
+#include "../inlining.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+/* C.big has 15 quads, and C.small 4. main calls big 100 times into a loop,
+ * and then once more, and small once. */
+const std::string profiled_program("C.big:\n"
+								"enter 4\n"
+								"x@0 = n@0 + 1\n"
+								"x@0 = x@0 + 1\n"
+								"x@0 = x@0 + 2\n"
+								"x@0 = x@0 + 3\n"
+								"x@0 = x@0 + 4\n"
+								"x@0 = x@0 + 5\n"
+								"x@0 = x@0 + 6\n"
+								"x@0 = x@0 + 7\n"
+								"x@0 = x@0 + 8\n"
+								"x@0 = x@0 + 9\n"
+								"x@0 = x@0 + 10\n"
+								"x@0 = x@0 + 11\n"
+								"x@0 = x@0 + 12\n"
+								"x@0 = x@0 + 13\n"
+								"return x@0\n"
+								"C.small:\n"
+								"enter 4\n"
+								"y@0 = m@0 + 1\n"
+								"y@0 = y@0 + 2\n"
+								"y@0 = y@0 + 3\n"
+								"return y@0\n"
+								"C.main:\n"
+								"enter 12\n"
+								"i@0 = 0\n"
+								"L1:\n"
+								"if i@0 >= 100 goto L2\n"
+								"param this@2\n"
+								"param i@0\n"
+								"a@0 = call C.big , 1\n"
+								"i@0 = i@0 + 1\n"
+								"goto L1\n"
+								"L2:\n"
+								"param this@2\n"
+								"param i@0\n"
+								"a@0 = call C.big , 1\n"
+								"param this@2\n"
+								"param a@0\n"
+								"b@0 = call C.small , 1\n"
+								"return b@0");
+
+void register_profiled_ids(ids_info& ids){
+	// this@0 and n@0; this@1 and m@0.
+	register_test_method(ids, "big", {"n"}, {}, {});
+	register_test_method(ids, "small", {"m"}, {}, {});
+	// this@2.
+	register_test_method(ids, "main", {"unused"}, {}, {});
+	ids.get_list_params(std::string("main::C")).pop_back();
+	ids.register_var(std::string("x"), 0, T_INT, false);
+	ids.register_var(std::string("y"), 0, T_INT, false);
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("a"), 4, T_INT, false);
+	ids.register_var(std::string("b"), 8, T_INT, false);
+}
+
+// Calls left into code.
+unsigned int count_calls(const instructions_list& code){
+	unsigned int ret = 0;
+
+	for(instructions_list::const_iterator it = code.begin(); it != code.end();
+	++it){
+		if(get_inst_type(*it) == quad_type::FUNCTION_CALL ||
+		get_inst_type(*it) == quad_type::PROCEDURE_CALL){
+			ret++;
+		}
+	}
+
+	return ret;
+}
+
+void test_profile_generation(){
+	std::cout << "1) Counts of a run: ";
+
+	ids_info ids;
+	register_profiled_ids(ids);
+	translate_ir_code(profiled_program);
+
+	execution_profile profile;
+	ir_interpreter interpreter(*ir_code, ids);
+	interpreter.set_profile(profile);
+	assert(interpreter.run("C.main") == "");
+	assert(get_block_count(profile, "C.main", "C.main") == 1);
+	assert(get_block_count(profile, "C.main", "L1") == 101);
+	assert(get_block_count(profile, "C.big", "C.big") == 101);
+	assert(get_call_count(profile, "C.main", 0) == 100);
+	assert(get_call_count(profile, "C.main", 1) == 1);
+	assert(get_call_count(profile, "C.main", 2) == 1);
+	assert(get_call_count(profile, "C.big", 0) == 0);
+
+	std::string text = print_profile(profile);
+	std::istringstream in(text);
+	execution_profile read;
+	assert(read_profile(in, read));
+	assert(print_profile(read) == text);
+
+	std::istringstream malformed("call C.main L1 3\n");
+	assert(!read_profile(malformed, read));
+	assert(is_empty_profile(read));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_profile_guided_inlining(){
+	std::cout << "2) Profile-guided inlining: ";
+
+	ids_info ids;
+	register_profiled_ids(ids);
+	translate_ir_code(profiled_program);
+
+	instructions_list code = *ir_code;
+	execution_profile profile;
+	ir_interpreter interpreter(code, ids);
+	interpreter.set_profile(profile);
+	assert(interpreter.run("C.main") == "");
+	int result = interpreter.get_result().ival;
+
+	// Without the profile, only small is inlined.
+	instructions_list static_code = code;
+	assert(inline_methods(static_code, ids) == 1);
+	assert(count_calls(static_code) == 2);
+
+	// With it, big is inlined into the loop too.
+	instructions_list guided = code;
+	assert(inline_methods_with_profile(guided, ids, profile) == 2);
+	// The call after the loop is kept.
+	assert(count_calls(guided) == 1);
+	ir_interpreter guided_interpreter(guided, ids);
+	assert(guided_interpreter.run("C.main") == "");
+	assert(guided_interpreter.get_result().ival == result);
+
+	// A call never executed is inlined only if that doesn't grow the code.
+	std::istringstream in("call C.main 0 100\n"
+						"call C.main 1 0\n"
+						"call C.main 2 0\n");
+	assert(read_profile(in, profile));
+	guided = code;
+	assert(inline_methods_with_profile(guided, ids, profile) == 1);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_profile(){
+	std::cout << "\nTesting profile:" << std::endl;
+
+	test_profile_generation();
+	test_profile_guided_inlining();
+}
@@ -0,0 +1,10 @@
+#ifndef TEST_PROFILE_H
+#define TEST_PROFILE_H
+
+#include <iostream>
+#include <cassert>
+#include "../profile.h"
+
+void test_profile();
+
+#endif
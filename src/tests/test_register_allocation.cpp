@@ -0,0 +1,436 @@
+#include <sstream>
+#include "test_register_allocation.h"
+#include "test_helpers.h"
+#include "../asm_code_generator.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+const live_interval* find_interval(const std::vector<live_interval>& intervals,
+									const std::string& name){
+	const live_interval* ret = nullptr;
+
+	for(unsigned int i = 0; i < intervals.size(); i++){
+		if(intervals[i].name == name){
+			ret = &intervals[i];
+		}
+	}
+
+	return ret;
+}
+
+bool has_register(const register_allocation& allocation,
+				const std::string& name,
+				register_id reg){
+	std::unordered_map<std::string, register_id>::const_iterator it =
+											allocation.registers.find(name);
+
+	return it != allocation.registers.end() && it->second == reg;
+}
+
+// 9 values live at the same time: 2 of them must be kept into memory.
+const std::string pressure_program("C.h:\n"
+									"enter 40\n"
+									"v1@0 = 1\n"
+									"v2@0 = 2\n"
+									"v3@0 = 3\n"
+									"v4@0 = 4\n"
+									"v5@0 = 5\n"
+									"v6@0 = 6\n"
+									"v7@0 = 7\n"
+									"v8@0 = 8\n"
+									"i@0 = 0\n"
+									"L1:\n"
+									"if i@0 >= 10 goto L2\n"
+									"i@0 = i@0 + v8@0\n"
+									"goto L1\n"
+									"L2:\n"
+									"s@0 = v1@0 + v2@0\n"
+									"s@0 = s@0 + v3@0\n"
+									"s@0 = s@0 + v4@0\n"
+									"s@0 = s@0 + v5@0\n"
+									"s@0 = s@0 + v6@0\n"
+									"s@0 = s@0 + v7@0\n"
+									"s@0 = s@0 + v8@0\n"
+									"return s@0");
+
+void register_pressure_ids(ids_info& ids){
+	register_test_method(ids, "h", {}, {},
+						{"v1", "v2", "v3", "v4", "v5", "v6", "v7", "v8", "i",
+						"s"});
+}
+
+void test_live_intervals(){
+	std::cout << "1) Live intervals and assignment: ";
+
+	ids_info ids;
+	register_test_method(ids, "f", {}, {}, {"a", "b", "c"});
+	translate_ir_code("C.f:\n"
+					"enter 12\n"
+					"a@0 = 1\n"
+					"b@0 = a@0 + 2\n"
+					"c@0 = b@0 * a@0\n"
+					"return c@0");
+
+	std::vector<live_interval> intervals = get_live_intervals(*ir_code, ids,
+																nullptr);
+	assert(intervals.size() == 3);
+	assert(intervals[0].name == "a@0" && intervals[0].start == 2 &&
+			intervals[0].end == 4);
+	assert(intervals[1].name == "b@0" && intervals[1].start == 3 &&
+			intervals[1].end == 4);
+	assert(intervals[2].name == "c@0" && intervals[2].start == 4 &&
+			intervals[2].end == 5);
+	assert(!intervals[0].crosses_call && intervals[0].weight == 3);
+
+	// Caller-saved registers first: c takes the register of a, as a and b
+	// are last read by its definition.
+	register_allocation allocation = allocate_registers(*ir_code, ids, nullptr);
+	assert(has_register(allocation, "a@0", register_id::R10D));
+	assert(has_register(allocation, "b@0", register_id::R11D));
+	assert(has_register(allocation, "c@0", register_id::R10D));
+	assert(intervals[2].defined_at_start);
+	assert(allocation.callee_saved.empty());
+	assert(allocation.spilled == 0);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_calls(){
+	std::cout << "2) Values live across calls: ";
+
+	ids_info ids;
+	register_test_method(ids, "g", {}, {}, {"a", "b", "c", "d"});
+	translate_ir_code("C.g:\n"
+					"enter 16\n"
+					"a@0 = 1\n"
+					"b@0 = 2\n"
+					"param this@0\n"
+					"param b@0\n"
+					"c@0 = call C.g , 1\n"
+					"d@0 = a@0 + c@0\n"
+					"return d@0");
+
+	std::vector<live_interval> intervals = get_live_intervals(*ir_code, ids,
+																nullptr);
+	// b is used by the call, that defines c.
+	assert(find_interval(intervals, "a@0")->crosses_call);
+	assert(find_interval(intervals, "b@0")->end == 6);
+	assert(!find_interval(intervals, "b@0")->crosses_call);
+	assert(find_interval(intervals, "c@0")->start == 6);
+	assert(!find_interval(intervals, "c@0")->crosses_call);
+
+	register_allocation allocation = allocate_registers(*ir_code, ids, nullptr);
+	assert(has_register(allocation, "a@0", register_id::EBX));
+	assert(has_register(allocation, "b@0", register_id::R10D));
+	assert(has_register(allocation, "c@0", register_id::R10D));
+	assert(has_register(allocation, "d@0", register_id::R10D));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_spilling(){
+	std::cout << "3) Spilling by weight: ";
+
+	ids_info ids;
+	register_pressure_ids(ids);
+	translate_ir_code(pressure_program);
+
+	// The values used into the loop keep their registers.
+	register_allocation allocation = allocate_registers(*ir_code, ids, nullptr);
+	assert(allocation.spilled == 2);
+	assert(allocation.registers.size() == 8);
+	assert(allocation.registers.find("v1@0") == allocation.registers.end());
+	assert(allocation.registers.find("v2@0") == allocation.registers.end());
+	assert(allocation.registers.find("v8@0") != allocation.registers.end());
+	assert(allocation.registers.find("i@0") != allocation.registers.end());
+	assert(allocation.callee_saved.size() == 5);
+
+	// If the profile says that the loop is never executed, they are the
+	// first ones kept into memory (and s takes the register of v1, last read
+	// by its definition).
+	execution_profile profile;
+	std::istringstream in("block C.h C.h 1\n"
+						"block C.h L1 0\n"
+						"block C.h L2 1\n");
+	assert(read_profile(in, profile));
+	allocation = allocate_registers(*ir_code, ids, &profile);
+	assert(allocation.spilled == 2);
+	assert(allocation.registers.find("v8@0") == allocation.registers.end());
+	assert(allocation.registers.find("i@0") == allocation.registers.end());
+	assert(allocation.registers.find("v2@0") != allocation.registers.end());
+	assert(allocation.registers.at("s@0") == allocation.registers.at("v1@0"));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_candidates(){
+	std::cout << "4) Variables kept into memory: ";
+
+	ids_info ids;
+	std::string method_id = ids.register_method(std::string("k"), 0,
+												std::string("C"));
+	t_params& list = ids.get_list_params(method_id);
+	list.push_back(ids.register_obj(std::string("this"), 0, std::string("C"),
+									std::string(""), true));
+	list.push_back(ids.register_var(std::string("n"), 8, T_INT, true));
+	ids.register_var(std::string("x"), 0, T_INT, false);
+	ids.register_var(std::string("arr"), 4, T_INT, false);
+	ids.register_var(std::string("y"), 12, T_INT, false);
+	ids.register_var(std::string("z"), 16, T_INT, false);
+	ids.register_var(std::string("f"), 20, T_FLOAT, false);
+	translate_ir_code("C.k:\n"
+					"enter 24\n"
+					"x@0 = n@0 + 1\n"
+					"arr@0[0] = x@0\n"
+					"y@0 = arr@0[0]\n"
+					"z@0 = & y@0\n"
+					"f@0 = x@0\n"
+					"n@0 = x@0\n"
+					"return x@0");
+
+	// Arrays, names whose address is taken and floats. The integer
+	// parameter comes first.
+	std::vector<std::string> candidates = get_register_candidates(*ir_code,
+																	ids);
+	assert(candidates.size() == 3);
+	assert(candidates[0] == "n@0");
+	assert(candidates[1] == "x@0");
+	assert(candidates[2] == "z@0");
+
+	std::cout << "OK. " << std::endl;
+}
+
+// Memory operands of the instructions of code.
+unsigned int count_memory_operands(const asm_instructions_list& code){
+	unsigned int ret = 0;
+
+	for(asm_instructions_list::const_iterator it = code.begin();
+	it != code.end(); ++it){
+		if((*it)->source != nullptr &&
+		get_operand_addressing((*it)->source) == operand_addressing::MEMORY){
+			ret++;
+		}
+
+		if((*it)->destination != nullptr &&
+		get_operand_addressing((*it)->destination) ==
+		operand_addressing::MEMORY){
+			ret++;
+		}
+	}
+
+	return ret;
+}
+
+void test_translation(){
+	std::cout << "5) Translation with registers: ";
+
+	ids_info ids;
+	register_pressure_ids(ids);
+	translate_ir_code(pressure_program);
+
+	asm_code_generator in_memory(ir_code, &ids);
+	in_memory.translate_ir();
+	unsigned int before = count_memory_operands(*in_memory.get_translation());
+
+	asm_code_generator in_registers(ir_code, &ids);
+	in_registers.set_register_allocation(true, nullptr);
+	in_registers.translate_ir();
+	asm_instructions_list& code = *in_registers.get_translation();
+
+	// Only v1 and v2, and the saves and restores of the 5 callee-saved
+	// registers are left into memory.
+	assert(count_memory_operands(code) == 4 + 2*5);
+	assert(count_memory_operands(code) < before);
+	// The frame grows with the slots of the callee-saved registers (8 + 40 +
+	// 8*5 bytes, aligned to 16).
+	assert(is_pushq_instruction(code[1],
+								new_register_operand(register_id::RBP),
+								data_type::Q));
+	assert(is_mov_instruction(code[2],
+							new_register_operand(register_id::RSP),
+							new_register_operand(register_id::RBP),
+							data_type::Q));
+	assert(is_sub_instruction(code[3],
+							new_immediate_integer_operand(96),
+							new_register_operand(register_id::RSP),
+							data_type::Q));
+	assert(is_mov_instruction(code[4],
+							new_register_operand(register_id::RBX),
+							new_memory_operand(-96, register_id::RBP,
+												register_id::NONE, 1),
+							data_type::Q));
+	assert(is_ret_instruction(code.back()));
+	assert(is_leave_instruction(code[code.size() - 2]));
+	assert(is_mov_instruction(code[code.size() - 3],
+							new_memory_operand(-64, register_id::RBP,
+												register_id::NONE, 1),
+							new_register_operand(register_id::R15),
+							data_type::Q));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_frameless_leaf(){
+	std::cout << "6) Leaf methods without frame: ";
+
+	ids_info ids;
+	register_test_method(ids, "add", {"a", "b"}, {}, {"t"});
+	translate_ir_code("C.add:\n"
+					"enter 4\n"
+					"t@0 = a@0 + b@0\n"
+					"return t@0");
+
+	asm_code_generator generator(ir_code, &ids);
+	generator.set_register_allocation(true, nullptr);
+	generator.translate_ir();
+	asm_instructions_list& code = *generator.get_translation();
+
+	// Only the parameters are taken into their registers: no prologue, no
+	// leave, and no memory operands.
+	assert(count_memory_operands(code) == 0);
+	assert(is_mov_instruction(code[1],
+							new_register_operand(register_id::EDI),
+							new_register_operand(register_id::R10D),
+							data_type::L));
+	assert(is_mov_instruction(code[2],
+							new_register_operand(register_id::ESI),
+							new_register_operand(register_id::R11D),
+							data_type::L));
+	for(asm_instructions_list::iterator it = code.begin(); it != code.end();
+	++it){
+		assert((*it)->op != operation::PUSHQ);
+		assert(!is_leave_instruction(*it));
+	}
+	assert(is_ret_instruction(code.back()));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_prologue(){
+	std::cout << "7) Prologue of methods with frame: ";
+
+	ids_info ids;
+	register_test_method(ids, "m", {"a", "b"}, {}, {"x"});
+	translate_ir_code("C.m:\n"
+					"enter 4\n"
+					"param this@0\n"
+					"param a@0\n"
+					"x@0 = call C.m , 1\n"
+					"return x@0");
+
+	asm_code_generator generator(ir_code, &ids);
+	generator.translate_ir();
+	asm_instructions_list& code = *generator.get_translation();
+
+	// 8 + 4*2 + 4 bytes, aligned to 16. Only a, used by the method, is taken
+	// into the frame.
+	assert(is_pushq_instruction(code[1],
+								new_register_operand(register_id::RBP),
+								data_type::Q));
+	assert(is_sub_instruction(code[3],
+							new_immediate_integer_operand(32),
+							new_register_operand(register_id::RSP),
+							data_type::Q));
+	assert(is_mov_instruction(code[4],
+							new_register_operand(register_id::EDI),
+							new_memory_operand(-8, register_id::RBP,
+												register_id::NONE, 1),
+							data_type::L));
+	for(asm_instructions_list::iterator it = code.begin(); it != code.end();
+	++it){
+		assert(!is_mov_instruction(*it,
+								new_register_operand(register_id::ESI),
+								new_memory_operand(-12, register_id::RBP,
+													register_id::NONE, 1),
+								data_type::L));
+	}
+	assert(is_leave_instruction(code[code.size() - 2]));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_scratch_registers(){
+	std::cout << "8) Scratch registers: ";
+
+	register_tracker tracker;
+
+	// Preferred registers, when free, with their width.
+	assert(tracker.acquire(register_id::R8D) == register_id::R8D);
+	assert(tracker.acquire(register_id::R8D) == register_id::R9D);
+	assert(tracker.acquire(register_id::RDI) == register_id::RDI);
+	tracker.release_scratch();
+	assert(tracker.is_free(register_id::R8));
+
+	// Live registers are never handed out, until released.
+	tracker.hold(register_id::RDI);
+	tracker.hold(register_id::R8);
+	assert(tracker.is_live(register_id::EDI) and
+		   not tracker.is_free(register_id::R8D));
+	assert(tracker.acquire(register_id::RDI) == register_id::R9);
+	tracker.reserve(register_id::R10);
+	assert(tracker.acquire(register_id::EDI) == register_id::R11D);
+	tracker.release_scratch();
+	tracker.release(register_id::RDI);
+	assert(tracker.acquire(register_id::RDI) == register_id::RDI);
+	tracker.clear();
+	assert(tracker.is_free(register_id::R8) and
+		   tracker.is_free(register_id::RDI));
+
+	ids_info ids;
+	register_test_method(ids, "m", {"a", "b", "c", "d", "e"}, {},
+						{"x", "y", "z"});
+	ids.register_obj(std::string("o"), 24, std::string("C"), std::string("o.f"),
+					false);
+	ids.register_var(std::string("o.f"), 0, T_INT, false);
+	// The copy after the call keeps it out of tail position.
+	translate_ir_code("C.m:\n"
+					"enter 12\n"
+					"param this@0\n"
+					"param a@0\n"
+					"param b@0\n"
+					"param c@0\n"
+					"param d@0\n"
+					"x@0 = o@0[0]\n"
+					"y@0 = x@0 / z@0\n"
+					"param y@0\n"
+					"x@0 = call C.m , 6\n"
+					"y@0 = x@0\n"
+					"return x@0");
+
+	asm_code_generator generator(ir_code, &ids);
+	generator.translate_ir();
+	asm_instructions_list& code = *generator.get_translation();
+
+	std::string text;
+
+	for(asm_instructions_list::iterator it = code.begin(); it != code.end();
+	++it){
+		text += print_intel_syntax(*it);
+	}
+
+	// With 5 parameters pending, the address of o doesn't go through %rdi
+	// (nor %r8), and %edx is saved into %r9d, instead of %r8d.
+	assert(text.find("\tmovl -28(%rbp, 0, 1) , %r9\n"
+					"\tmovl 0(%r9, 0, 1) ,") != std::string::npos);
+	assert(text.find("\tmovl %edx , %r9d\n") != std::string::npos);
+	assert(text.find("\tmovl %r9d , %edx\n") != std::string::npos);
+	assert(text.find(", %rdi\n") == text.rfind(", %rdi\n"));
+	assert(text.find(", %r8\n") == text.rfind(", %r8\n") and
+		   text.find(", %r8d\n") == std::string::npos);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_register_allocation(){
+	std::cout << "\nTesting register allocation:" << std::endl;
+
+	test_live_intervals();
+	test_calls();
+	test_spilling();
+	test_candidates();
+	test_translation();
+	test_frameless_leaf();
+	test_prologue();
+	test_scratch_registers();
+}
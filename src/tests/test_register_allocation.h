@@ -0,0 +1,10 @@
+#ifndef TEST_REGISTER_ALLOCATION_H
+#define TEST_REGISTER_ALLOCATION_H
+
+#include <iostream>
+#include <cassert>
+#include "../register_allocation.h"
+
+void test_register_allocation();
+
+#endif
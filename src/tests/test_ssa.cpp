@@ -0,0 +1,218 @@
+#include "test_ssa.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+void test_ssa_construction(){
+	std::cout << "1) Construction of pruned SSA: ";
+
+	// s = 0; i = 0; while(i < n){ s = s + i; i = i + 1 } return s
+	ids_info ids;
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("s"), 4, T_INT, false);
+	ids.register_var(std::string("n"), 0, T_INT, true);
+	translate_ir_code(std::string("C.m:\n"
+								"enter 8\n"
+								"i@0 = 0\n"
+								"s@0 = 0\n"
+								"L1:\n"
+								"if i@0 >= n@0 goto L2\n"
+								"s@0 = s@0 + i@0\n"
+								"i@0 = i@0 + 1\n"
+								"goto L1\n"
+								"L2:\n"
+								"return s@0\n"
+								"s@0 = 1"));
+
+	instructions_list method = *ir_code;
+	std::string original = print_instructions_list(*ir_code);
+	build_ssa(method, ids);
+
+	// The unreachable block is removed, and the body of the loop gets a
+	// label.
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 32\n"
+			"i@0@1 = 0\n"
+			"s@0@1 = 0\n"
+			"L1:\n"
+			"i@0@2 = phi(C.m: i@0@1, @t0: i@0@3)\n"
+			"s@0@2 = phi(C.m: s@0@1, @t0: s@0@3)\n"
+			"if i@0@2 >= n@0 goto L2\n"
+			"@t0:\n"
+			"s@0@3 = s@0@2 + i@0@2\n"
+			"i@0@3 = i@0@2 + 1\n"
+			"goto L1\n"
+			"L2:\n"
+			"return s@0@2\n");
+	// Versions are local variables, with the type of the original.
+	assert(ids.id_exists(std::string("i@0@3")));
+	assert(ids.get_kind(std::string("i@0@3")) == K_VAR);
+	assert(ids.get_type(std::string("i@0@3")) == T_INT);
+	// The original code is not modified.
+	assert(print_instructions_list(*ir_code) == original);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_ssa_pruning(){
+	std::cout << "2) PHIs only for live variables: ";
+
+	// t is assigned into both branches, but is dead after them; x is not.
+	ids_info ids;
+	ids.register_var(std::string("t"), 0, T_INT, false);
+	ids.register_var(std::string("x"), 4, T_INT, false);
+	translate_ir_code(std::string("C.m:\n"
+								"ifFalse c goto L1\n"
+								"t@0 = 1\n"
+								"x@0 = t@0\n"
+								"goto L2\n"
+								"L1:\n"
+								"t@0 = 2\n"
+								"x@0 = t@0 * 2\n"
+								"a@0[0] = x@0\n"
+								"L2:\n"
+								"return x@0"));
+
+	instructions_list method = *ir_code;
+	build_ssa(method, ids);
+
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"ifFalse c goto L1\n"
+			"@t0:\n"
+			"t@0@1 = 1\n"
+			"x@0@1 = t@0@1\n"
+			"goto L2\n"
+			"L1:\n"
+			"t@0@2 = 2\n"
+			"x@0@2 = t@0@2 * 2\n"
+			"a@0[0] = x@0@2\n"
+			"L2:\n"
+			"x@0@3 = phi(@t0: x@0@1, L1: x@0@2)\n"
+			"return x@0@3\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_parallel_copies(){
+	std::cout << "3) Sequentialization of parallel copies: ";
+
+	ids_info ids;
+	unsigned int temps = 0;
+	address_pointer a = new_name_address(std::string("a"));
+	address_pointer b = new_name_address(std::string("b"));
+	address_pointer c = new_name_address(std::string("c"));
+	address_pointer one = new_integer_constant(1);
+
+	// a, b := b, a (a cycle: needs a temporary).
+	instructions_list copies = sequentialize_parallel_copy({a, b}, {b, a}, ids,
+															temps);
+	assert(temps == 1);
+	assert(print_instructions_list(copies) ==
+			"@t0 = a\n"
+			"a = b\n"
+			"b = @t0\n");
+
+	// c, b, a := b, a, 1 (a chain, and a constant).
+	copies = sequentialize_parallel_copy({c, b, a}, {b, a, one}, ids, temps);
+	assert(temps == 1);
+	assert(print_instructions_list(copies) ==
+			"c = b\n"
+			"b = a\n"
+			"a = 1\n");
+
+	// a, b := a, a
+	copies = sequentialize_parallel_copy({a, b}, {a, a}, ids, temps);
+	assert(print_instructions_list(copies) == "b = a\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_ssa_destruction(){
+	std::cout << "4) Destruction of SSA form: ";
+
+	ids_info ids;
+	ids.register_var(std::string("i"), 0, T_INT, false);
+	ids.register_var(std::string("n"), 0, T_INT, true);
+	// do{ i = i + 1 } while(i < n): the back edge is critical.
+	translate_ir_code(std::string("C.m:\n"
+								"i@0 = 0\n"
+								"L1:\n"
+								"i@0 = i@0 + 1\n"
+								"if i@0 < n@0 goto L1\n"
+								"return i@0"));
+
+	instructions_list method = *ir_code;
+	build_ssa(method, ids);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"i@0@1 = 0\n"
+			"L1:\n"
+			"i@0@2 = phi(C.m: i@0@1, L1: i@0@3)\n"
+			"i@0@3 = i@0@2 + 1\n"
+			"if i@0@3 < n@0 goto L1\n"
+			"@t0:\n"
+			"return i@0@3\n");
+
+	destroy_ssa(method, ids);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"i@0@1 = 0\n"
+			"i@0@2 = i@0@1\n"
+			"L1:\n"
+			"i@0@3 = i@0@2 + 1\n"
+			"if i@0@3 < n@0 goto @t1\n"
+			"return i@0@3\n"
+			"@t1:\n"
+			"i@0@2 = i@0@3\n"
+			"goto L1\n");
+
+	// A swap into a loop.
+	translate_ir_code(std::string("C.m:\n"
+								"enter 0\n"
+								"x@0 = 1\n"
+								"i@0 = 2\n"
+								"L1:\n"
+								"ifFalse c goto L2\n"
+								"t@0 = x@0\n"
+								"x@0 = i@0\n"
+								"i@0 = t@0\n"
+								"goto L1\n"
+								"L2:\n"
+								"return x@0"));
+	ids.register_var(std::string("x"), 0, T_INT, false);
+	ids.register_var(std::string("t"), 0, T_INT, false);
+
+	method = *ir_code;
+	build_ssa(method, ids);
+	destroy_ssa(method, ids);
+
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 28\n"
+			"x@0@1 = 1\n"
+			"i@0@1 = 2\n"
+			"x@0@2 = x@0@1\n"
+			"i@0@2 = i@0@1\n"
+			"L1:\n"
+			"ifFalse c goto L2\n"
+			"t@0@1 = x@0@2\n"
+			"x@0@3 = i@0@2\n"
+			"i@0@3 = t@0@1\n"
+			"x@0@2 = x@0@3\n"
+			"i@0@2 = i@0@3\n"
+			"goto L1\n"
+			"L2:\n"
+			"return x@0@2\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_ssa(){
+	std::cout << "\nTesting SSA form:" << std::endl;
+	test_ssa_construction();
+	test_ssa_pruning();
+	test_parallel_copies();
+	test_ssa_destruction();
+}
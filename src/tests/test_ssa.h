@@ -0,0 +1,10 @@
+#ifndef TEST_SSA_H
+#define TEST_SSA_H
+
+#include <iostream>
+#include <cassert>
+#include "../ssa.h"
+
+void test_ssa();
+
+#endif
@@ -0,0 +1,128 @@
+#include "test_tail_calls.h"
+#include "test_helpers.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+void test_tail_position(){
+	std::cout << "1) Calls in tail position: ";
+
+	translate_ir_code(std::string("C.f:\n"
+								"enter 0\n"
+								"param this\n"
+								"x = call C.f , 0\n"
+								"goto L1\n"
+								"L1:\n"
+								"return x\n"
+								"C.g:\n"
+								"enter 0\n"
+								"param this\n"
+								"x = call C.f , 0\n"
+								"y = x + 1\n"
+								"return y\n"
+								"C.h:\n"
+								"enter 0\n"
+								"param this\n"
+								"call C.g , 0\n"
+								"C.k:\n"
+								"enter 0\n"
+								"param this\n"
+								"call C.g , 0\n"
+								"return 0"));
+
+	instructions_list code = *ir_code;
+
+	assert(get_label_positions(code, 0).size() == 2);
+	assert(get_label_positions(code, 0).at("L1") == 5);
+	assert(is_tail_call(code, 3, get_label_positions(code, 0)));
+	assert(!is_tail_call(code, 10, get_label_positions(code, 7)));
+	// The end of the method.
+	assert(is_tail_call(code, 16, get_label_positions(code, 13)));
+	// A procedure call doesn't give the value returned.
+	assert(!is_tail_call(code, 20, get_label_positions(code, 17)));
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_self_tail_calls(){
+	std::cout << "2) Self tail calls to loops: ";
+
+	ids_info ids;
+	// this@0, n@0 and acc@0; this@1, a@0 and b@0.
+	register_test_method(ids, "fact", {"n", "acc"}, {}, {});
+	register_test_method(ids, "swap", {"a", "b"}, {}, {});
+	// @t0, @t1 and @t2.
+	for(unsigned int i = 0; i < 3; i++){
+		ids.new_temp(0, T_INT);
+	}
+	translate_ir_code(std::string("C.fact:\n"
+								"enter 20\n"
+								"if n@0 > 1 goto L1\n"
+								"return acc@0\n"
+								"L1:\n"
+								"param this@0\n"
+								"@t0 = n@0 - 1\n"
+								"param @t0\n"
+								"@t1 = acc@0 * n@0\n"
+								"param @t1\n"
+								"@t2 = call C.fact , 2\n"
+								"return @t2\n"
+								"C.swap:\n"
+								"enter 8\n"
+								"if a@0 < b@0 goto L2\n"
+								"param this@1\n"
+								"param b@0\n"
+								"param a@0\n"
+								"call C.swap , 2\n"
+								"goto L3\n"
+								"L2:\n"
+								"param this@1\n"
+								"param a@0\n"
+								"param a@0\n"
+								"call C.fact , 2\n"
+								"L3:"));
+
+	std::vector<instructions_list> methods = split_into_methods(*ir_code);
+
+	assert(eliminate_tail_recursion(methods[0], ids) == 1);
+	assert(print_instructions_list(methods[0]) ==
+			"C.fact:\n"
+			"enter 20\n"
+			"@t3:\n"
+			"if n@0 > 1 goto L1\n"
+			"return acc@0\n"
+			"L1:\n"
+			"@t0 = n@0 - 1\n"
+			"@t1 = acc@0 * n@0\n"
+			"n@0 = @t0\n"
+			"acc@0 = @t1\n"
+			"goto @t3\n");
+
+	// The parameters are exchanged through a new temporary. The call to fact
+	// is a tail call, but not a self call.
+	assert(eliminate_tail_recursion(methods[1], ids) == 1);
+	assert(print_instructions_list(methods[1]) ==
+			"C.swap:\n"
+			"enter 12\n"
+			"@t4:\n"
+			"if a@0 < b@0 goto L2\n"
+			"@t5 = a@0\n"
+			"a@0 = b@0\n"
+			"b@0 = @t5\n"
+			"goto @t4\n"
+			"L2:\n"
+			"param this@1\n"
+			"param a@0\n"
+			"param a@0\n"
+			"call C.fact, 2\n"
+			"L3:\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_tail_calls(){
+	std::cout << "\nTesting tail calls:" << std::endl;
+
+	test_tail_position();
+	test_self_tail_calls();
+}
@@ -0,0 +1,11 @@
+#ifndef TEST_TAIL_CALLS_H
+#define TEST_TAIL_CALLS_H
+
+#include <iostream>
+#include <cassert>
+#include "../tail_calls.h"
+#include "../control_flow_graph.h"
+
+void test_tail_calls();
+
+#endif
@@ -0,0 +1,168 @@
+#include "test_value_numbering.h"
+
+extern instructions_list *ir_code;
+extern void translate_ir_code(std::string program);
+
+void test_redundant_expressions(){
+	std::cout << "1) Reuse of expressions computed by dominators: ";
+
+	// Into SSA form already: a@0 and b@0 are parameters.
+	translate_ir_code(std::string("C.m:\n"
+								"enter 24\n"
+								"@t0 = a@0 + b@0\n"
+								"@t1 = b@0 + a@0\n"
+								"x@0 = @t1 * 2\n"
+								"@t2 = x@0\n"
+								"if x@0 > 10 goto L1\n"
+								"L0:\n"
+								"@t3 = a@0 + b@0\n"
+								"return @t3\n"
+								"L1:\n"
+								"@t4 = x@0\n"
+								"@t5 = a@0 - b@0\n"
+								"return @t4\n"
+								"L2:\n"
+								"@t6 = b@0 - a@0\n"
+								"return @t6"));
+
+	// Relational operations, that the IR parser doesn't recognize.
+	(*ir_code)[5] = new_binary_assign(new_name_address("@t2"),
+									new_name_address("x@0"),
+									new_integer_constant(10),
+									quad_oper::GREATER);
+	(*ir_code)[11] = new_binary_assign(new_name_address("@t4"),
+									new_integer_constant(10),
+									new_name_address("x@0"),
+									quad_oper::LESS);
+	instructions_list method = *ir_code;
+	std::string original = print_instructions_list(*ir_code);
+
+	// b@0 - a@0 is not a - b; L2 is not dominated by L1.
+	assert(number_values(method) == 3);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 24\n"
+			"@t0 = a@0 + b@0\n"
+			"@t1 = @t0\n"
+			"x@0 = @t0 * 2\n"
+			"@t2 = x@0 > 10\n"
+			"if x@0 > 10 goto L1\n"
+			"L0:\n"
+			"@t3 = @t0\n"
+			"return @t0\n"
+			"L1:\n"
+			"@t4 = @t2\n"
+			"@t5 = a@0 - b@0\n"
+			"return @t2\n"
+			"L2:\n"
+			"@t6 = b@0 - a@0\n"
+			"return @t6\n");
+	// The original code is not modified.
+	assert(print_instructions_list(*ir_code) == original);
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_redundant_loads_and_phis(){
+	std::cout << "2) Loads and PHIs: ";
+
+	ids_info ids;
+	ids.register_var(std::string("x"), 0, T_INT, false);
+	ids.register_var(std::string("y"), 4, T_INT, false);
+	ids.register_var(std::string("z"), 8, T_INT, false);
+	ids.register_var(std::string("w"), 12, T_INT, false);
+	translate_ir_code(std::string("C.m:\n"
+								"enter 16\n"
+								"x@0 = a@0[i@0]\n"
+								"y@0 = a@0[i@0]\n"
+								"a@0[0] = 1\n"
+								"z@0 = a@0[i@0]\n"
+								"ifFalse c@0 goto L1\n"
+								"x@0 = y@0 + 1\n"
+								"y@0 = 1 + y@0\n"
+								"goto L2\n"
+								"L1:\n"
+								"x@0 = z@0 * 2\n"
+								"y@0 = z@0 * 2\n"
+								"L2:\n"
+								"w@0 = x@0 + y@0\n"
+								"return w@0"));
+
+	instructions_list method = *ir_code;
+	build_ssa(method, ids);
+
+	/* The second load reuses the first one, but not the third: there is a
+	 * store in between. Both PHIs receive the same values from each
+	 * predecessor. */
+	assert(number_values(method) == 4);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 56\n"
+			"x@0@1= a@0[i@0]\n"
+			"y@0@1 = x@0@1\n"
+			"a@0[0] = 1\n"
+			"z@0@1= a@0[i@0]\n"
+			"ifFalse c@0 goto L1\n"
+			"@t0:\n"
+			"x@0@2 = x@0@1 + 1\n"
+			"y@0@2 = x@0@2\n"
+			"goto L2\n"
+			"L1:\n"
+			"x@0@3 = z@0@1 * 2\n"
+			"y@0@3 = x@0@3\n"
+			"L2:\n"
+			"x@0@4 = phi(@t0: x@0@2, L1: x@0@3)\n"
+			"w@0@1 = x@0@4 + x@0@4\n"
+			"return w@0@1\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_copies_into_branches(){
+	std::cout << "3) PHIs of copies made into a branch: ";
+
+	ids_info ids;
+	ids.register_var(std::string("v"), 0, T_INT, false);
+	translate_ir_code(std::string("C.m:\n"
+								"enter 4\n"
+								"v@0 = a@0 * 2\n"
+								"ifFalse c@0 goto L1\n"
+								"v@0 = v@0\n"
+								"goto L2\n"
+								"L1:\n"
+								"param v@0\n"
+								"call C.p, 1\n"
+								"L2:\n"
+								"return v@0"));
+
+	instructions_list method = *ir_code;
+	build_ssa(method, ids);
+
+	/* Both arguments of the PHI have the value number of v@0@1, but v@0@2 is
+	 * only defined when coming from @t0: the PHI is replaced by v@0@1, that
+	 * dominates L2. */
+	assert(number_values(method) == 1);
+	assert(print_instructions_list(method) ==
+			"C.m:\n"
+			"enter 16\n"
+			"v@0@1 = a@0 * 2\n"
+			"ifFalse c@0 goto L1\n"
+			"@t0:\n"
+			"v@0@2 = v@0@1\n"
+			"goto L2\n"
+			"L1:\n"
+			"param v@0@1\n"
+			"call C.p, 1\n"
+			"L2:\n"
+			"return v@0@1\n");
+
+	std::cout << "OK. " << std::endl;
+}
+
+void test_value_numbering(){
+	std::cout << "\nTesting value numbering:" << std::endl;
+
+	test_redundant_expressions();
+	test_redundant_loads_and_phis();
+	test_copies_into_branches();
+}
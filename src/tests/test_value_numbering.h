@@ -0,0 +1,11 @@
+#ifndef TEST_VALUE_NUMBERING_H
+#define TEST_VALUE_NUMBERING_H
+
+#include <iostream>
+#include <cassert>
+#include "../value_numbering.h"
+#include "../ssa.h"
+
+void test_value_numbering();
+
+#endif
@@ -251,6 +251,15 @@ quad_type get_inst_type(const quad_pointer& instruction){
 	return instruction->type;
 }
 
+quad_pointer copy_instruction(const quad_pointer& instruction){
+	if(instruction->type == quad_type::PHI){
+		return quad_pointer(new phi_quad(
+							static_cast<const phi_quad&>(*instruction)));
+	}
+
+	return quad_pointer(new quad(*instruction));
+}
+
 bool are_equal_quad_pointers(const quad_pointer& x, const quad_pointer& y){
 	bool ret = false;
 
@@ -260,6 +269,19 @@ bool are_equal_quad_pointers(const quad_pointer& x, const quad_pointer& y){
 			are_equal_address_pointers(x->arg1, y->arg1) &&
 			are_equal_address_pointers(x->arg2, y->arg2) &&
 			are_equal_address_pointers(x->result, y->result);
+
+		if(ret && x->type == quad_type::PHI){
+			const std::vector<phi_argument>& x_args = get_phi_arguments(x);
+			const std::vector<phi_argument>& y_args = get_phi_arguments(y);
+
+			ret = x_args.size() == y_args.size();
+			for(unsigned int i = 0; ret && i < x_args.size(); i++){
+				ret = are_equal_address_pointers(x_args[i].value,
+												y_args[i].value) &&
+					are_equal_address_pointers(x_args[i].label,
+												y_args[i].label);
+			}
+		}
 	}
 	else{
 		// {x == nullptr}
@@ -317,6 +339,11 @@ std::string print_operand(const address_pointer& operand){
 							get_constant_address_integer_value(operand));
 					break;
 
+				case value_type::STRING:
+					ret = "\"" + get_constant_address_string_value(operand) +
+						"\"";
+					break;
+
 				default:
 					// {operand->value.constant.type == value_type::FLOAT}
 					ret = std::to_string(
@@ -362,6 +389,38 @@ std::string print_binary_assign(const quad_pointer& inst){
 			op = " + ";
 			break;
 
+		case quad_oper::LESS:
+			op = " < ";
+			break;
+
+		case quad_oper::LESS_EQUAL:
+			op = " <= ";
+			break;
+
+		case quad_oper::GREATER:
+			op = " > ";
+			break;
+
+		case quad_oper::GREATER_EQUAL:
+			op = " >= ";
+			break;
+
+		case quad_oper::EQUAL:
+			op = " == ";
+			break;
+
+		case quad_oper::DISTINCT:
+			op = " != ";
+			break;
+
+		case quad_oper::AND:
+			op = " and ";
+			break;
+
+		case quad_oper::OR:
+			op = " or ";
+			break;
+
 		default:
 			// {inst->op == quad_oper::MINUS}
 			#ifdef __DEBUG
@@ -573,6 +632,24 @@ std::string print_enter_inst(const quad_pointer& inst){
 	return "enter " + print_operand(inst->arg1);
 }
 
+/*
+ * PRE : {inst is a phi instruction.}
+ * */
+std::string print_phi_inst(const quad_pointer& inst){
+	std::string ret = print_operand(inst->result) + " = phi(";
+	const std::vector<phi_argument>& args = get_phi_arguments(inst);
+
+	for(std::vector<phi_argument>::const_iterator it = args.begin();
+	it != args.end(); ++it){
+		if(it != args.begin()){
+			ret += ", ";
+		}
+		ret += print_operand(it->label) + ": " + print_operand(it->value);
+	}
+
+	return ret + ")";
+}
+
 std::string print_instruction(const quad_pointer& inst){
 	std::string ret;
 
@@ -629,6 +706,10 @@ std::string print_instruction(const quad_pointer& inst){
 			ret = print_label_inst(inst);
 			break;
 
+		case quad_type::PHI:
+			ret = print_phi_inst(inst);
+			break;
+
 		default:
 			// {inst->type == quad_type::ENTER_PROCEDURE}
 			ret = print_enter_inst(inst);
@@ -686,6 +767,12 @@ bool is_label(const quad_pointer& instruction, const std::string& label){
 	// de un operando...
 }
 
+bool is_method_label_inst(const quad_pointer& instruction){
+	return instruction->type == quad_type::LABEL &&
+		   instruction->arg1->type == address_type::ADDRESS_LABEL &&
+		   instruction->arg1->value.label.class_name != nullptr;
+}
+
 std::string get_label_inst_label(const quad_pointer& instruction){
 	// PRE
 	#ifdef __DEBUG
@@ -1117,6 +1204,118 @@ bool is_procedure_call(const quad_pointer& instruction,
 		   are_equal_address_pointers(instruction->arg2, new_integer_constant(param_quantity));
 }
 
+unsigned int get_call_param_quantity(const quad_pointer& instruction){
+	// PRE
+	#ifdef __DEBUG
+		assert(instruction->type == quad_type::PROCEDURE_CALL or
+				instruction->type == quad_type::FUNCTION_CALL);
+	#endif
+
+	return get_constant_address_integer_value(instruction->arg2);
+}
+
+bool find_call_parameters(const instructions_list& code,
+						unsigned int call,
+						std::vector<unsigned int>& positions){
+	unsigned int count = get_call_param_quantity(code[call]) + 1;
+	// Parameters of inner calls, still to be skipped.
+	unsigned int pending = 0;
+
+	positions.clear();
+	for(int i = (int)call - 1; i >= 0 && positions.size() < count; i--){
+		switch(code[i]->type){
+			case quad_type::PARAMETER:
+				if(pending > 0){
+					pending--;
+				}
+				else{
+					positions.insert(positions.begin(), i);
+				}
+				break;
+
+			case quad_type::PROCEDURE_CALL:
+			case quad_type::FUNCTION_CALL:
+				pending += get_call_param_quantity(code[i]) + 1;
+				break;
+
+			case quad_type::LABEL:
+			case quad_type::UNCONDITIONAL_JUMP:
+			case quad_type::CONDITIONAL_JUMP:
+			case quad_type::RELATIONAL_JUMP:
+			case quad_type::RETURN:
+				return false;
+
+			default:
+				break;
+		}
+	}
+
+	return positions.size() == count;
+}
+
+std::unordered_map<std::string, unsigned int> get_label_positions(
+													const instructions_list& code,
+													unsigned int method){
+	// PRE
+	#ifdef __DEBUG
+		assert(is_method_label_inst(code[method]));
+	#endif
+
+	std::unordered_map<std::string, unsigned int> ret;
+
+	ret[get_label_inst_label(code[method])] = method;
+	for(unsigned int i = method + 1; i < code.size() &&
+	!is_method_label_inst(code[i]); i++){
+		if(code[i]->type == quad_type::LABEL){
+			ret[get_label_inst_label(code[i])] = i;
+		}
+	}
+
+	return ret;
+}
+
+bool is_tail_call(const instructions_list& code,
+				unsigned int call,
+				const std::unordered_map<std::string, unsigned int>& labels){
+	address_pointer result = code[call]->type == quad_type::FUNCTION_CALL ?
+								code[call]->result : nullptr;
+	unsigned int i = call + 1;
+	// Gotos followed, to stop at cycles of jumps.
+	unsigned int jumps = 0;
+
+	while(i < code.size() && !is_method_label_inst(code[i])){
+		switch(code[i]->type){
+			case quad_type::LABEL:
+				i++;
+				break;
+
+			case quad_type::UNCONDITIONAL_JUMP:{
+					std::unordered_map<std::string, unsigned int>::const_iterator
+						target = labels.find(get_unconditional_jmp_label(code[i]));
+
+					if(target == labels.end() || ++jumps > code.size()){
+						return false;
+					}
+					i = target->second;
+				}
+				break;
+
+			case quad_type::RETURN:
+				if(result == nullptr){
+					return code[i]->arg1 == nullptr;
+				}
+				return code[i]->arg1 != nullptr &&
+					   are_equal_address_pointers(code[i]->arg1, result);
+
+			default:
+				return false;
+		}
+	}
+
+	// {the method ends without a return}
+	return result == nullptr;
+}
+
 
 /////////////////////////
 // @CONDITIONAL JUMP
@@ -1235,6 +1434,41 @@ std::string get_relational_jmp_label(const quad_pointer& instruction){
 	return get_label_address_value(instruction->result);
 }
 
+quad_oper get_negated_relop(quad_oper relop){
+	quad_oper ret;
+
+	switch(relop){
+		case quad_oper::LESS:
+			ret = quad_oper::GREATER_EQUAL;
+			break;
+
+		case quad_oper::LESS_EQUAL:
+			ret = quad_oper::GREATER;
+			break;
+
+		case quad_oper::GREATER:
+			ret = quad_oper::LESS_EQUAL;
+			break;
+
+		case quad_oper::GREATER_EQUAL:
+			ret = quad_oper::LESS;
+			break;
+
+		case quad_oper::EQUAL:
+			ret = quad_oper::DISTINCT;
+			break;
+
+		default:
+			// PRE
+			#ifdef __DEBUG
+				assert(relop == quad_oper::DISTINCT);
+			#endif
+			ret = quad_oper::EQUAL;
+	}
+
+	return ret;
+}
+
 
 /////////////////////////
 // RETURN
@@ -1254,3 +1488,199 @@ quad_pointer new_return_inst(const address_pointer& value){
 
 	return instruction;
 }
+
+
+/////////////////////////
+// @PHI
+/////////////////////////
+quad_pointer new_phi_inst(const address_pointer& dest,
+						const address_pointer& variable){
+	quad_pointer instruction = quad_pointer(new phi_quad);
+	instruction->type = quad_type::PHI;
+	instruction->op = quad_oper::NONE;
+	instruction->result = dest;
+	instruction->arg1 = variable;
+
+	return instruction;
+}
+
+address_pointer get_phi_inst_dest(const quad_pointer& instruction){
+	// PRE
+	#ifdef __DEBUG
+		assert(instruction->type == quad_type::PHI);
+	#endif
+
+	return instruction->result;
+}
+
+address_pointer get_phi_inst_variable(const quad_pointer& instruction){
+	// PRE
+	#ifdef __DEBUG
+		assert(instruction->type == quad_type::PHI);
+	#endif
+
+	return instruction->arg1;
+}
+
+void add_phi_argument(const quad_pointer& instruction,
+					const address_pointer& value,
+					const address_pointer& pred_label){
+	// PRE
+	#ifdef __DEBUG
+		assert(instruction->type == quad_type::PHI);
+		assert(pred_label->type == address_type::ADDRESS_LABEL);
+	#endif
+
+	phi_argument argument;
+	argument.value = value;
+	argument.label = pred_label;
+	get_phi_arguments(instruction).push_back(argument);
+}
+
+address_pointer get_phi_argument(const quad_pointer& instruction,
+								const std::string& pred_label){
+	// PRE
+	#ifdef __DEBUG
+		assert(instruction->type == quad_type::PHI);
+	#endif
+
+	address_pointer ret = nullptr;
+	const std::vector<phi_argument>& args = get_phi_arguments(instruction);
+
+	for(std::vector<phi_argument>::const_iterator it = args.begin();
+	it != args.end(); ++it){
+		if(get_label_address_value(it->label) == pred_label){
+			ret = it->value;
+			break;
+		}
+	}
+
+	return ret;
+}
+
+std::vector<phi_argument>& get_phi_arguments(const quad_pointer& instruction){
+	// PRE
+	#ifdef __DEBUG
+		assert(instruction->type == quad_type::PHI);
+	#endif
+
+	return static_cast<phi_quad&>(*instruction).args;
+}
+
+
+/////////////////////////
+// @DEFINITIONS AND USES
+/////////////////////////
+address_pointer get_inst_definition(const quad_pointer& instruction){
+	address_pointer ret = nullptr;
+
+	switch(instruction->type){
+		case quad_type::BINARY_ASSIGN:
+		case quad_type::UNARY_ASSIGN:
+		case quad_type::COPY:
+		case quad_type::INDEXED_COPY_FROM:
+		case quad_type::FUNCTION_CALL:
+		case quad_type::PHI:
+			ret = instruction->result;
+			break;
+
+		default:
+			// {the instruction defines no variable}
+			break;
+	}
+
+	return ret;
+}
+
+std::vector<address_pointer*> get_inst_uses(const quad_pointer& instruction){
+	std::vector<address_pointer*> ret;
+
+	switch(instruction->type){
+		case quad_type::BINARY_ASSIGN:
+		case quad_type::INDEXED_COPY_FROM:
+			ret.push_back(&instruction->arg1);
+			ret.push_back(&instruction->arg2);
+			break;
+
+		case quad_type::INDEXED_COPY_TO:
+			ret.push_back(&instruction->result);
+			ret.push_back(&instruction->arg1);
+			ret.push_back(&instruction->arg2);
+			break;
+
+		case quad_type::RELATIONAL_JUMP:
+			ret.push_back(&instruction->arg1);
+			ret.push_back(&instruction->arg2);
+			break;
+
+		case quad_type::UNARY_ASSIGN:
+		case quad_type::COPY:
+		case quad_type::CONDITIONAL_JUMP:
+		case quad_type::PARAMETER:
+			ret.push_back(&instruction->arg1);
+			break;
+
+		case quad_type::RETURN:
+			if(instruction->arg1 != nullptr){
+				ret.push_back(&instruction->arg1);
+			}
+			break;
+
+		case quad_type::PHI:{
+			std::vector<phi_argument>& args = get_phi_arguments(instruction);
+
+			for(std::vector<phi_argument>::iterator it = args.begin();
+			it != args.end(); ++it){
+				ret.push_back(&it->value);
+			}
+			break;
+		}
+
+		default:
+			// {the instruction reads no operand}
+			break;
+	}
+
+	return ret;
+}
+
+bool may_fail(const quad_pointer& instruction){
+	bool ret = false;
+
+	switch(instruction->type){
+		case quad_type::BINARY_ASSIGN:
+			if(instruction->op == quad_oper::DIVIDE ||
+			instruction->op == quad_oper::MOD){
+				address_pointer divisor = instruction->arg2;
+
+				ret = true;
+				if(get_address_type(divisor) == address_type::ADDRESS_CONSTANT){
+					switch(get_constant_address_type(divisor)){
+						case value_type::INTEGER:
+							ret = get_constant_address_integer_value(divisor) == 0
+								|| get_constant_address_integer_value(divisor) == -1;
+							break;
+
+						case value_type::FLOAT:
+							ret = false;
+							break;
+
+						default:
+							break;
+					}
+				}
+			}
+			break;
+
+		case quad_type::INDEXED_COPY_FROM:
+		case quad_type::INDEXED_COPY_TO:
+			ret = true;
+			break;
+
+		default:
+			// {the instruction can't fail}
+			break;
+	}
+
+	return ret;
+}
@@ -4,6 +4,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <cassert>
 
 // Macro to convert booleans into strings (because std::to_string does it
@@ -61,9 +62,9 @@ enum class quad_type {
 	INDEXED_COPY_FROM,	// x = y[i]
 	UNCONDITIONAL_JUMP,	// goto L
 	CONDITIONAL_JUMP,	// if x goto L || ifFalse x goto L
-						// TODO: cual es la diferencia entre esto y primero asignar
-						// en un temporal el resultado de la comparación, y luego
-						// hacer if x goto L?
+						// Comparisons into conditions are not saved into a
+						// temporary to be tested by one of these: they are
+						// translated directly into RELATIONAL_JUMPs.
 	RELATIONAL_JUMP,	// if x relop y goto L
 	PARAMETER,			// param x
 	PROCEDURE_CALL,		// call p, n
@@ -71,8 +72,9 @@ enum class quad_type {
 	RETURN,				// return [y]
 	LABEL,				// L: skip
 	// TODO: está bien?
-	ENTER_PROCEDURE		// ENTER_PROCEDURE Nmbr. of bytes for locals and
+	ENTER_PROCEDURE,	// ENTER_PROCEDURE Nmbr. of bytes for locals and
 						// temporal variables in stack frame
+	PHI					// x = phi(L1: y1, ..., Ln: yn). Only into SSA form.
 };
 
 enum class quad_oper {
@@ -97,6 +99,13 @@ enum class quad_oper {
 	NONE // Use in case the instruction doesn't need an operator
 };
 
+// Argument of a PHI: the value that flows from the predecessor block that
+// begins with label.
+struct phi_argument {
+	address_pointer value;
+	address_pointer label;
+};
+
 struct quad {
 	quad_type type;
 	quad_oper op = quad_oper::NONE;
@@ -105,6 +114,12 @@ struct quad {
 	address_pointer result = nullptr;
 };
 
+// PHIs are the only quads with a list of arguments: they keep it apart, so
+// the rest of the quads don't grow with it. Built by new_phi_inst.
+struct phi_quad : public quad {
+	std::vector<phi_argument> args;
+};
+
 typedef std::shared_ptr<quad> quad_pointer;
 
 class instructions_list : public std::vector<quad_pointer> {};
@@ -125,11 +140,16 @@ quad_oper get_inst_op(const quad_pointer&);
 
 quad_type get_inst_type(const quad_pointer&);
 
+// A new quad equal to the given one (the arguments of a PHI, included).
+quad_pointer copy_instruction(const quad_pointer&);
+
 bool are_equal_quad_pointers(const quad_pointer&, const quad_pointer&);
 
 bool are_equal_instructions_list(const instructions_list& x,
 								const instructions_list& y);
 
+std::string print_instruction(const quad_pointer&);
+
 std::string print_instructions_list(const instructions_list&);
 
 
@@ -155,6 +175,9 @@ std::string get_label_inst_class_name(const quad_pointer&);
 bool is_label(const quad_pointer& instruction,
 				const std::string& label);
 
+// Is it the label that begins a method's definition?
+bool is_method_label_inst(const quad_pointer& instruction);
+
 /////////////////////////
 // @COPY
 /////////////////////////
@@ -311,6 +334,37 @@ bool is_procedure_call(const quad_pointer& instruction,
 						const address_pointer& proc_label,
 						int param_quantity);
 
+/* Number of parameters of a call, as given by the call (it doesn't count
+ * "this").
+ * PRE : {quad->type == quad_type::PROCEDURE_CALL or
+ * 			quad->type == quad_type::FUNCTION_CALL} */
+unsigned int get_call_param_quantity(const quad_pointer&);
+
+/* Puts into positions the PARAMETER quads of the call at position call of
+ * code ("this" first), skipping those of the calls made while computing the
+ * arguments. Returns false if they are not found into the block of the call.
+ * PRE : {code[call] is a PROCEDURE_CALL or a FUNCTION_CALL} */
+bool find_call_parameters(const instructions_list& code,
+						unsigned int call,
+						std::vector<unsigned int>& positions);
+
+/* Positions into code of the labels of the method that begins at position
+ * method (its own label included).
+ * PRE : {code[method] is the label of a method} */
+std::unordered_map<std::string, unsigned int> get_label_positions(
+													const instructions_list& code,
+													unsigned int method);
+
+/* Is the call at position call of code in tail position? That is, after it,
+ * the method returns its result (or just returns, for a procedure call)
+ * without doing anything else: only labels, gotos and the return (or the end
+ * of the method) follow. labels are the positions of the labels of the
+ * method (see get_label_positions).
+ * PRE : {code[call] is a PROCEDURE_CALL or a FUNCTION_CALL} */
+bool is_tail_call(const instructions_list& code,
+				unsigned int call,
+				const std::unordered_map<std::string, unsigned int>& labels);
+
 
 /////////////////////////
 // @CONDITIONAL JUMP
@@ -360,6 +414,10 @@ bool is_relational_jump_inst(const quad_pointer& instruction,
 							quad_oper relop,
 							const address_pointer& label);
 
+/* Returns the relational operator that holds exactly when relop doesn't.
+ * PRE : {relop is a relational operator} */
+quad_oper get_negated_relop(quad_oper relop);
+
 
 /////////////////////////
 // RETURN
@@ -370,6 +428,55 @@ bool is_return_inst(const quad_pointer& instruction,
 					const address_pointer& ret_value);
 
 
+/////////////////////////
+// @PHI
+/////////////////////////
+// dest = phi(...), where variable is the name of dest before renaming.
+quad_pointer new_phi_inst(const address_pointer& dest,
+						const address_pointer& variable);
+
+/* PRE : {quad->type == quad_type::PHI} */
+address_pointer get_phi_inst_dest(const quad_pointer&);
+
+/* PRE : {quad->type == quad_type::PHI} */
+address_pointer get_phi_inst_variable(const quad_pointer&);
+
+/* PRE : {quad->type == quad_type::PHI and
+ * 			pred_label->type == address_type::ADDRESS_LABEL} */
+void add_phi_argument(const quad_pointer&,
+					const address_pointer& value,
+					const address_pointer& pred_label);
+
+/* Returns the value that flows from the predecessor that begins with
+ * pred_label, or nullptr if there is no such argument.
+ * PRE : {quad->type == quad_type::PHI} */
+address_pointer get_phi_argument(const quad_pointer&,
+								const std::string& pred_label);
+
+/* PRE : {quad->type == quad_type::PHI} */
+std::vector<phi_argument>& get_phi_arguments(const quad_pointer&);
+
+
+/////////////////////////
+// @DEFINITIONS AND USES
+/////////////////////////
+/* Returns the variable whose value is defined by the instruction (x, in
+ * x = ...), or nullptr if there is none. A store into an array or object
+ * (x[i] = y) doesn't define x. */
+address_pointer get_inst_definition(const quad_pointer&);
+
+/* Returns the fields of the instruction that hold operands read by it
+ * (including the base of indexed copies, the operand of an ADDRESS_OF and the
+ * arguments of a PHI), so they can be replaced. Labels and the number of
+ * parameters of a call are not included. */
+std::vector<address_pointer*> get_inst_uses(const quad_pointer&);
+
+/* Could the execution of the instruction fail at run time? True for indexed
+ * copies (memory accesses), and for divisions whose divisor is not a constant
+ * different from 0 and -1 (INT_MIN / -1 overflows). */
+bool may_fail(const quad_pointer&);
+
+
 /////////////////////////
 // @ADDRESS
 /////////////////////////
@@ -0,0 +1,427 @@
+#include <iomanip>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include "value_numbering.h"
+#include "control_flow_graph.h"
+#include "ssa.h"
+
+typedef std::unordered_map<std::string, address_pointer> value_table;
+
+/////////////////////////
+// @EXPRESSIONS
+/////////////////////////
+bool is_commutative(quad_oper op){
+	return op == quad_oper::PLUS || op == quad_oper::TIMES ||
+		   op == quad_oper::EQUAL || op == quad_oper::DISTINCT ||
+		   op == quad_oper::AND || op == quad_oper::OR;
+}
+
+/* Returns the key of a constant operand: its type and value (floats, in
+ * hexadecimal notation, to distinguish every value). */
+std::string get_constant_key(const address_pointer& constant){
+	std::ostringstream ret;
+
+	switch(get_constant_address_type(constant)){
+		case value_type::INTEGER:
+			ret << "i" << get_constant_address_integer_value(constant);
+			break;
+
+		case value_type::FLOAT:
+			ret << "f" << std::hexfloat
+				<< get_constant_address_float_value(constant);
+			break;
+
+		case value_type::BOOLEAN:
+			ret << "b" << get_constant_address_boolean_value(constant);
+			break;
+
+		default:
+			// {get_constant_address_type(constant) == value_type::STRING}
+			ret << "s" << get_constant_address_string_value(constant);
+	}
+
+	return ret.str();
+}
+
+/* Numbering of the values of a method, walking its dominator tree. */
+class value_numbering {
+public:
+	value_numbering(instructions_list& method);
+
+	// Returns the number of quads replaced or removed.
+	unsigned int run();
+
+private:
+	instructions_list& method;
+	control_flow_graph cfg;
+	std::unordered_set<std::string> ssa_values;
+	// Operand that represents the value number of each SSA value.
+	value_table numbers;
+	// SSA values whose definition is redundant: the variable reused.
+	value_table replacements;
+	// Expressions available at the actual block: the variable that holds them.
+	value_table expressions;
+	// Keys added to expressions, to remove them when leaving a block.
+	std::vector<std::string> pushed;
+	// Loads available, since the last store or call of the actual block.
+	value_table loads;
+	std::vector<bool> removed;
+	unsigned int changes;
+
+	bool is_ssa_value(const address_pointer&) const;
+
+	/* Returns the key of the value number of operand, or an empty string if
+	 * operand can't be part of an expression (its value can change through
+	 * pointers). */
+	std::string get_operand_key(const address_pointer& operand) const;
+
+	/* Returns the key of the expression computed by instruction, or an empty
+	 * string if it can't be numbered. */
+	std::string get_expression_key(const quad_pointer& instruction) const;
+
+	// Replaces the operand by the variable reused, if any.
+	void replace(address_pointer& operand) const;
+
+	/* Records that the value of the SSA value name is the one held by
+	 * variable. */
+	void reuse(const address_pointer& name, const address_pointer& variable);
+
+	void number_phi(unsigned int i, const std::string& label);
+	void number_instruction(unsigned int i);
+	void visit_block(unsigned int block);
+};
+
+value_numbering::value_numbering(instructions_list& _method) :
+method(_method), cfg(_method) {
+
+	// Values that never change: defined once, or never (parameters).
+	std::unordered_set<std::string> entry_values =
+											get_entry_values(this->method);
+	this->ssa_values = get_ssa_values(this->method);
+	this->ssa_values.insert(entry_values.begin(), entry_values.end());
+	this->removed.assign(this->method.size(), false);
+	this->changes = 0;
+
+	// Quads are modified: they could be shared with other lists.
+	for(instructions_list::iterator it = this->method.begin();
+	it != this->method.end(); ++it){
+		*it = copy_instruction(*it);
+	}
+}
+
+bool value_numbering::is_ssa_value(const address_pointer& operand) const{
+	return operand != nullptr &&
+		   get_address_type(operand) == address_type::ADDRESS_NAME &&
+		   this->ssa_values.find(get_address_name(operand)) !=
+		   this->ssa_values.end();
+}
+
+std::string value_numbering::get_operand_key(
+										const address_pointer& operand) const{
+	std::string ret;
+
+	if(operand == nullptr){
+		return ret;
+	}
+
+	if(get_address_type(operand) == address_type::ADDRESS_CONSTANT){
+		ret = get_constant_key(operand);
+	}
+	else if(this->is_ssa_value(operand)){
+		value_table::const_iterator it =
+								this->numbers.find(get_address_name(operand));
+
+		// Values not numbered yet (e.g.: defined into a loop's body, and used
+		// by a PHI of its header) are their own number.
+		address_pointer number = it != this->numbers.end() ? it->second :
+															operand;
+		ret = get_address_type(number) == address_type::ADDRESS_CONSTANT ?
+			  get_constant_key(number) : "v" + get_address_name(number);
+	}
+
+	return ret;
+}
+
+std::string value_numbering::get_expression_key(
+									const quad_pointer& instruction) const{
+	std::string ret;
+
+	switch(get_inst_type(instruction)){
+		case quad_type::BINARY_ASSIGN:{
+			quad_oper op = get_inst_op(instruction);
+			std::string x = this->get_operand_key(instruction->arg1);
+			std::string y = this->get_operand_key(instruction->arg2);
+
+			if(x.empty() || y.empty()){
+				break;
+			}
+
+			// x > y is y < x, and x >= y is y <= x.
+			if(op == quad_oper::GREATER || op == quad_oper::GREATER_EQUAL){
+				op = op == quad_oper::GREATER ? quad_oper::LESS :
+												quad_oper::LESS_EQUAL;
+				std::swap(x, y);
+			}
+			else if(is_commutative(op) && y < x){
+				std::swap(x, y);
+			}
+			ret = std::to_string((int)op) + "(" + x + "," + y + ")";
+			break;
+		}
+
+		case quad_type::UNARY_ASSIGN:
+			if(get_inst_op(instruction) == quad_oper::ADDRESS_OF){
+				// The address of a variable never changes.
+				ret = "&" + get_address_name(instruction->arg1);
+			}
+			else{
+				std::string x = this->get_operand_key(instruction->arg1);
+
+				if(!x.empty()){
+					ret = std::to_string((int)get_inst_op(instruction)) +
+						  "(" + x + ")";
+				}
+			}
+			break;
+
+		case quad_type::INDEXED_COPY_FROM:{
+			std::string index = this->get_operand_key(
+									get_indexed_copy_from_index(instruction));
+
+			if(!index.empty()){
+				ret = get_address_name(get_indexed_copy_from_src(instruction)) +
+					  "[" + index + "]";
+			}
+			break;
+		}
+
+		default:
+			break;
+	}
+
+	return ret;
+}
+
+void value_numbering::replace(address_pointer& operand) const{
+	if(this->is_ssa_value(operand)){
+		value_table::const_iterator it =
+						this->replacements.find(get_address_name(operand));
+
+		if(it != this->replacements.end()){
+			operand = it->second;
+		}
+	}
+}
+
+void value_numbering::reuse(const address_pointer& name,
+							const address_pointer& variable){
+	std::string key = get_address_name(name);
+
+	this->replacements[key] = variable;
+	this->numbers[key] = is_ssa_value(variable) &&
+						this->numbers.find(get_address_name(variable)) !=
+						this->numbers.end() ?
+						this->numbers[get_address_name(variable)] : variable;
+	this->changes++;
+}
+
+void value_numbering::number_phi(unsigned int i, const std::string& label){
+	const quad_pointer& phi = this->method[i];
+	address_pointer same = nullptr;
+	bool meaningless = true;
+	std::string key = "phi " + label;
+
+	std::vector<phi_argument>& args = get_phi_arguments(phi);
+
+	for(std::vector<phi_argument>::iterator it = args.begin();
+	it != args.end(); ++it){
+		std::string value = this->get_operand_key(it->value);
+
+		key += " " + get_label_address_value(it->label) + ":" + value;
+		if(value.empty()){
+			meaningless = false;
+		}
+		// Arguments equal to the result (loops that don't modify the
+		// variable) don't count.
+		else if(!are_equal_address_pointers(it->value, phi->result)){
+			if(same == nullptr){
+				same = it->value;
+			}
+			else if(this->get_operand_key(same) != value){
+				meaningless = false;
+			}
+		}
+	}
+
+	value_table::iterator available = this->expressions.find(key);
+	if(meaningless && same != nullptr){
+		// {every argument has the same value}
+		// same could be defined only along one of the predecessors (e.g.: by a
+		// copy into one branch): the PHI is replaced by the operand that
+		// represents the value number, whose definition dominates every
+		// predecessor, and so the PHI.
+		value_table::const_iterator leader = this->is_ssa_value(same) ?
+									this->numbers.find(get_address_name(same)) :
+									this->numbers.end();
+
+		this->reuse(phi->result, leader != this->numbers.end() ?
+								leader->second : same);
+		this->removed[i] = true;
+	}
+	else if(available != this->expressions.end()){
+		this->reuse(phi->result, available->second);
+		this->removed[i] = true;
+	}
+	else{
+		this->numbers[get_address_name(phi->result)] = phi->result;
+		this->expressions[key] = phi->result;
+		this->pushed.push_back(key);
+	}
+}
+
+void value_numbering::number_instruction(unsigned int i){
+	quad_pointer& instruction = this->method[i];
+	std::vector<address_pointer*> uses = get_inst_uses(instruction);
+
+	for(std::vector<address_pointer*>::iterator it = uses.begin();
+	it != uses.end(); ++it){
+		this->replace(**it);
+	}
+
+	address_pointer definition = get_inst_definition(instruction);
+	quad_type type = get_inst_type(instruction);
+
+	if(type == quad_type::INDEXED_COPY_TO ||
+	type == quad_type::PROCEDURE_CALL || type == quad_type::FUNCTION_CALL ||
+	(definition != nullptr && !this->is_ssa_value(definition))){
+		// Memory could be modified.
+		this->loads.clear();
+	}
+
+	if(!this->is_ssa_value(definition)){
+		return;
+	}
+
+	std::string name = get_address_name(definition);
+	std::string key = this->get_expression_key(instruction);
+	value_table& available = type == quad_type::INDEXED_COPY_FROM ?
+							this->loads : this->expressions;
+	value_table::iterator it = available.find(key);
+
+	if(type == quad_type::COPY && !this->get_operand_key(
+											instruction->arg1).empty()){
+		// Copies propagate the value number of their source.
+		this->numbers[name] = this->is_ssa_value(instruction->arg1) &&
+							this->numbers.find(get_address_name(
+							instruction->arg1)) != this->numbers.end() ?
+							this->numbers[get_address_name(instruction->arg1)] :
+							instruction->arg1;
+	}
+	else if(!key.empty() && it != available.end()){
+		this->reuse(definition, it->second);
+		instruction = new_copy(definition, it->second);
+	}
+	else{
+		this->numbers[name] = definition;
+		if(!key.empty()){
+			available[key] = definition;
+			if(type != quad_type::INDEXED_COPY_FROM){
+				this->pushed.push_back(key);
+			}
+		}
+	}
+}
+
+void value_numbering::visit_block(unsigned int b){
+	const basic_block& block = this->cfg.get_block(b);
+	address_pointer label = this->method[block.first]->arg1;
+
+	this->loads.clear();
+	for(unsigned int i = block.first; i < block.last; i++){
+		if(get_inst_type(this->method[i]) == quad_type::PHI){
+			this->number_phi(i, get_label_address_value(label));
+		}
+		else{
+			this->number_instruction(i);
+		}
+	}
+
+	// Arguments of the PHIs of the successors, that flow from the block.
+	for(std::vector<unsigned int>::const_iterator s = block.successors.begin();
+	s != block.successors.end(); ++s){
+		const basic_block& successor = this->cfg.get_block(*s);
+
+		for(unsigned int i = successor.first; i < successor.last; i++){
+			if(get_inst_type(this->method[i]) != quad_type::PHI){
+				continue;
+			}
+
+			std::vector<phi_argument>& args =
+										get_phi_arguments(this->method[i]);
+
+			for(std::vector<phi_argument>::iterator it = args.begin();
+			it != args.end(); ++it){
+				if(label != nullptr && get_label_address_value(it->label) ==
+				get_label_address_value(label)){
+					this->replace(it->value);
+				}
+			}
+		}
+	}
+}
+
+unsigned int value_numbering::run(){
+	if(this->cfg.size() == 0){
+		return 0;
+	}
+
+	// Block, next child to visit and size of pushed when entering the block.
+	struct frame {
+		unsigned int block;
+		unsigned int next;
+		unsigned int pushed;
+	};
+	std::vector<frame> stack;
+	stack.push_back({0, 0, 0});
+
+	while(!stack.empty()){
+		frame& actual = stack.back();
+		const basic_block& block = this->cfg.get_block(actual.block);
+
+		if(actual.next == 0){
+			this->visit_block(actual.block);
+		}
+
+		if(actual.next < block.dominated.size()){
+			unsigned int child = block.dominated[actual.next];
+			actual.next++;
+			// actual could be invalidated by push_back.
+			stack.push_back({child, 0, (unsigned int)this->pushed.size()});
+		}
+		else{
+			// {every child of the block has been visited}
+			while(this->pushed.size() > actual.pushed){
+				this->expressions.erase(this->pushed.back());
+				this->pushed.pop_back();
+			}
+			stack.pop_back();
+		}
+	}
+
+	instructions_list numbered;
+	for(unsigned int i = 0; i < this->method.size(); i++){
+		if(!this->removed[i]){
+			numbered.push_back(this->method[i]);
+		}
+	}
+	this->method = numbered;
+
+	return this->changes;
+}
+
+unsigned int number_values(instructions_list& method){
+	value_numbering numbering(method);
+
+	return numbering.run();
+}
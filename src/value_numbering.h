@@ -0,0 +1,30 @@
+#ifndef VALUE_NUMBERING_H_
+#define VALUE_NUMBERING_H_
+
+#include "three_address_code.h"
+
+/* Bibliography adopted:
+ * [1] "Value Numbering", Preston Briggs, Keith D. Cooper and L. Taylor
+ * 		Simpson. Software: Practice and Experience, 1997.
+ * */
+
+/* Dominator-based value numbering ([1]) over a method into SSA form. Walking
+ * the dominator tree, each expression computed (arithmetic, relational and
+ * logical operations, unary operations, addresses of variables and PHIs) is
+ * looked up among the ones computed by the dominators of the quad; operands
+ * of commutative operators are put into a canonical order, and x > y is
+ * treated as y < x (the same with >=). When an equivalent expression is
+ * available:
+ * 		_ the quad becomes a copy of the variable that holds it (the PHI is
+ * 		removed),
+ *
+ * 		_ the following uses of the variable defined by the quad are replaced
+ * 		by the one reused.
+ *
+ * Copies propagate the value number of their source. Loads through indexed
+ * copies are reused only into the same block, and until a store or a call.
+ * Returns the number of quads replaced or removed.
+ * PRE : {method is the code of a single method, into SSA form} */
+unsigned int number_values(instructions_list& method);
+
+#endif // VALUE_NUMBERING_H_